@@ -2,9 +2,59 @@
 
 #include "pch.h"
 #include "adler32.h"
+#include "misc.h"
+#include "cpu.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
+#if CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE
+
+// process blocks*32 bytes, with s1 and s2 kept in 32-bit lanes and reduced only once every
+// NMAX bytes, the largest count for which s2 can't overflow 32 bits
+static void SSSE3_Adler32_Update(unsigned long &s1, unsigned long &s2, const byte *input, size_t blocks)
+{
+	const unsigned long BASE = 65521, NMAX = 5552;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ones = _mm_set1_epi16(1);
+	// byte j of a 32-byte block is added into s2 (32-j) times
+	const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+	const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+
+	while (blocks)
+	{
+		size_t n = STDMIN(blocks, size_t(NMAX/32));
+		blocks -= n;
+
+		// vps accumulates the value of s1 before each block, each of which adds 32*s1 to s2
+		__m128i vps = _mm_cvtsi32_si128(int(s1*n));
+		__m128i vs1 = zero;
+		__m128i vs2 = _mm_cvtsi32_si128(int(s2));
+
+		do
+		{
+			__m128i bytes1 = _mm_loadu_si128((const __m128i *)input);
+			__m128i bytes2 = _mm_loadu_si128((const __m128i *)(input+16));
+			vps = _mm_add_epi32(vps, vs1);
+			vs1 = _mm_add_epi32(vs1, _mm_add_epi32(_mm_sad_epu8(bytes1, zero), _mm_sad_epu8(bytes2, zero)));
+			vs2 = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+			vs2 = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+			input += 32;
+		}
+		while (--n);
+
+		vs2 = _mm_add_epi32(vs2, _mm_slli_epi32(vps, 5));
+
+		// sum the lanes
+		vs1 = _mm_add_epi32(vs1, _mm_shuffle_epi32(vs1, _MM_SHUFFLE(1,0,3,2)));
+		vs2 = _mm_add_epi32(vs2, _mm_shuffle_epi32(vs2, _MM_SHUFFLE(1,0,3,2)));
+		vs2 = _mm_add_epi32(vs2, _mm_shuffle_epi32(vs2, _MM_SHUFFLE(2,3,0,1)));
+		s1 = (s1 + word32(_mm_cvtsi128_si32(vs1))) % BASE;
+		s2 = word32(_mm_cvtsi128_si32(vs2)) % BASE;
+	}
+}
+
+#endif
+
 void Adler32::Update(const byte *input, size_t length)
 {
 	const unsigned long BASE = 65521;
@@ -12,6 +62,15 @@ void Adler32::Update(const byte *input, size_t length)
 	unsigned long s1 = m_s1;
 	unsigned long s2 = m_s2;
 
+#if CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE
+	if (length >= 64 && HasSSSE3())
+	{
+		SSSE3_Adler32_Update(s1, s2, input, length/32);
+		input += length & ~size_t(31);
+		length %= 32;
+	}
+#endif
+
 	if (length % 8 != 0)
 	{
 		do
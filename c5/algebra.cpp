@@ -169,6 +169,34 @@ template <class T> T AbstractGroup<T>::CascadeScalarMultiply(const Element &x, c
 	return result;
 }
 
+// Bos and Coster's method, which repeatedly replaces the largest exponent by its remainder modulo the next largest
+template <class Element, class Iterator> Element BosCosterMultiplication(const AbstractGroup<Element> &group, Iterator begin, Iterator end)
+{
+	Integer q, t;
+	Iterator last = end;
+	--last;
+
+	std::make_heap(begin, end);
+	std::pop_heap(begin, end);
+
+	while (!!begin->exponent)
+	{
+		// last->exponent is largest exponent, begin->exponent is next largest
+		t = last->exponent;
+		Integer::Divide(last->exponent, q, t, begin->exponent);
+
+		if (q == Integer::One())
+			group.Accumulate(begin->base, last->base);	// avoid overhead of ScalarMultiply()
+		else
+			group.Accumulate(begin->base, group.ScalarMultiply(last->base, q));
+
+		std::push_heap(begin, end);
+		std::pop_heap(begin, end);
+	}
+
+	return group.ScalarMultiply(last->base, last->exponent);
+}
+
 template <class Element, class Iterator> Element GeneralCascadeMultiplication(const AbstractGroup<Element> &group, Iterator begin, Iterator end)
 {
 	if (end-begin == 1)
@@ -177,29 +205,16 @@ template <class Element, class Iterator> Element GeneralCascadeMultiplication(co
 		return group.CascadeScalarMultiply(begin->base, begin->exponent, (begin+1)->base, (begin+1)->exponent);
 	else
 	{
-		Integer q, t;
-		Iterator last = end;
-		--last;
-
-		std::make_heap(begin, end);
-		std::pop_heap(begin, end);
-
-		while (!!begin->exponent)
+		std::vector<Element> bases;
+		std::vector<Integer> exponents;
+		bases.reserve(end-begin);
+		exponents.reserve(end-begin);
+		for (Iterator it = begin; it != end; ++it)
 		{
-			// last->exponent is largest exponent, begin->exponent is next largest
-			t = last->exponent;
-			Integer::Divide(last->exponent, q, t, begin->exponent);
-
-			if (q == Integer::One())
-				group.Accumulate(begin->base, last->base);	// avoid overhead of ScalarMultiply()
-			else
-				group.Accumulate(begin->base, group.ScalarMultiply(last->base, q));
-
-			std::push_heap(begin, end);
-			std::pop_heap(begin, end);
+			bases.push_back(it->base);
+			exponents.push_back(it->exponent);
 		}
-
-		return group.ScalarMultiply(last->base, last->exponent);
+		return group.MultiScalarMultiply(&bases[0], &exponents[0], (unsigned int)bases.size());
 	}
 }
 
@@ -312,6 +327,209 @@ void AbstractGroup<T>::SimultaneousMultiply(T *results, const T &base, const Int
 	}
 }
 
+// the window size for Straus' method that takes the fewest group operations, counting the odd multiples of the base that are added up first
+inline unsigned int StrausWindowSize(unsigned int expLen)
+{
+	unsigned int w = 1;
+	while (w < 8 && (1U << w) + expLen/(w+2) < (1U << (w-1)) + expLen/(w+1))
+		w++;
+	return w;
+}
+
+// the window size with which Pippenger's buckets take fewer group operations than Straus' interleaved windows, or 0 if there is none,
+// counting the two additions per bucket that sum the buckets of each window
+inline unsigned int PippengerWindowSize(unsigned int count, unsigned int expLen, bool signedDigits)
+{
+	const unsigned int strausWindowSize = StrausWindowSize(expLen);
+	lword bestCost = lword(count) * ((1 << (strausWindowSize-1)) + expLen/(strausWindowSize+1));
+	unsigned int bestWindowSize = 0;
+
+	for (unsigned int w=2; w<=16; w++)
+	{
+		lword windowCount = signedDigits ? expLen/w + 1 : (expLen+w-1)/w;
+		lword bucketCount = signedDigits ? (1 << (w-1)) : (1 << w) - 1;
+		lword cost = windowCount * (count + 2*bucketCount);
+		if (cost < bestCost)
+		{
+			bestCost = cost;
+			bestWindowSize = w;
+		}
+	}
+	return bestWindowSize;
+}
+
+// digits[j*count+i] is the j-th digit of exponents[i] in base 2**windowSize, and is in (-2**(windowSize-1), 2**(windowSize-1)] if signedDigits
+inline void PippengerDigits(const Integer *exponents, unsigned int count, unsigned int windowSize, unsigned int windowCount, bool signedDigits, std::vector<int> &digits)
+{
+	const int half = 1 << (windowSize-1);
+	digits.resize(count*windowCount);
+	for (unsigned int i=0; i<count; i++)
+	{
+		int carry = 0;
+		for (unsigned int j=0; j<windowCount; j++)
+		{
+			int digit = int(exponents[i].GetBits(j*windowSize, windowSize)) + carry;
+			carry = 0;
+			if (signedDigits && digit > half)
+			{
+				digit -= 2*half;
+				carry = 1;
+			}
+			digits[j*count+i] = digit;
+		}
+	}
+}
+
+struct StrausWindow
+{
+	bool operator<(const StrausWindow &rhs) const {return position > rhs.position;}
+	unsigned int position, base;
+	word32 window;
+	bool negate;
+};
+
+template <class T>
+T AbstractGroup<T>::MultiScalarMultiply(const Element *bases, const Integer *exponents, unsigned int count) const
+{
+	if (count == 0)
+		return Identity();
+	if (count == 1)
+		return ScalarMultiply(bases[0], exponents[0]);
+	if (count == 2)
+		return CascadeScalarMultiply(bases[0], exponents[0], bases[1], exponents[1]);
+
+	unsigned int i, expLen = 0;
+	for (i=0; i<count; i++)
+	{
+		assert(exponents[i].NotNegative());
+		expLen = STDMAX(expLen, exponents[i].BitCount());
+	}
+
+	const bool fastNegate = InversionIsFast();
+	const unsigned int windowSize = PippengerWindowSize(count, expLen, fastNegate);
+	Element result = Identity();
+	bool started = false;
+
+	if (windowSize == 0)
+	{
+		// with many short exponents, taking remainders cancels more of them than Straus' windows do
+		if (2*count > expLen)
+		{
+			std::vector<BaseAndExponent<Element> > eb(count);
+			for (i=0; i<count; i++)
+				eb[i] = BaseAndExponent<Element>(bases[i], exponents[i]);
+			return BosCosterMultiplication<Element>(*this, eb.begin(), eb.end());
+		}
+
+		// Straus: the windows of all of the exponents are added in from the top, between doublings of the result
+		std::vector<std::vector<Element> > tables(count);
+		std::vector<StrausWindow> windows;
+		for (i=0; i<count; i++)
+		{
+			WindowSlider slider(exponents[i], fastNegate, StrausWindowSize(exponents[i].BitCount()));
+			for (slider.FindNextWindow(); !slider.finished; slider.FindNextWindow())
+			{
+				StrausWindow w = {slider.windowBegin, i, slider.expWindow, slider.negateNext};
+				windows.push_back(w);
+			}
+
+			std::vector<Element> &table = tables[i];
+			table.resize(1<<(slider.windowSize-1));
+			table[0] = bases[i];
+			if (table.size() > 1)
+			{
+				Element d = Double(bases[i]);
+				for (unsigned int k=1; k<table.size(); k++)
+					table[k] = Add(table[k-1], d);
+			}
+		}
+		std::sort(windows.begin(), windows.end());
+
+		unsigned int position = expLen;
+		for (i=0; i<windows.size(); i++)
+		{
+			const StrausWindow &w = windows[i];
+			for (; position > w.position; position--)
+				if (started)
+					result = Double(result);
+			const Element &P = tables[w.base][w.window/2];
+			if (started)
+				Accumulate(result, w.negate ? Inverse(P) : P);
+			else
+				result = w.negate ? Inverse(P) : P;
+			started = true;
+		}
+		for (; position > 0; position--)
+			result = Double(result);
+		return result;
+	}
+
+	// Pippenger: in each window, the bases are put into buckets by their digits, and the buckets are summed with their weights
+	const unsigned int windowCount = fastNegate ? expLen/windowSize + 1 : (expLen+windowSize-1)/windowSize;
+	const unsigned int bucketCount = fastNegate ? 1 << (windowSize-1) : (1 << windowSize) - 1;
+	std::vector<int> digits;
+	PippengerDigits(exponents, count, windowSize, windowCount, fastNegate, digits);
+
+	std::vector<Element> buckets(bucketCount);
+	std::vector<bool> filled(bucketCount);
+	for (int j=int(windowCount)-1; j>=0; j--)
+	{
+		if (started)
+			for (unsigned int k=0; k<windowSize; k++)
+				result = Double(result);
+
+		std::fill(filled.begin(), filled.end(), false);
+		for (i=0; i<count; i++)
+		{
+			const int digit = digits[j*count+i];
+			if (digit == 0)
+				continue;
+			const unsigned int b = (digit > 0 ? digit : -digit) - 1;
+			const Element &P = digit > 0 ? bases[i] : Inverse(bases[i]);
+			if (filled[b])
+				Accumulate(buckets[b], P);
+			else
+			{
+				buckets[b] = P;
+				filled[b] = true;
+			}
+		}
+
+		// sum = 1*bucket[0] + 2*bucket[1] + ..., as the sum of the running sums from the top bucket down
+		Element running, sum;
+		bool runningSet = false, sumSet = false;
+		for (int b=int(bucketCount)-1; b>=0; b--)
+		{
+			if (filled[b])
+			{
+				if (runningSet)
+					Accumulate(running, buckets[b]);
+				else
+					running = buckets[b];
+				runningSet = true;
+			}
+			if (runningSet)
+			{
+				if (sumSet)
+					Accumulate(sum, running);
+				else
+					sum = running;
+				sumSet = true;
+			}
+		}
+
+		if (sumSet)
+		{
+			if (started)
+				Accumulate(result, sum);
+			else
+				result = sum;
+			started = true;
+		}
+	}
+	return result;
+}
+
 template <class T> T AbstractRing<T>::Exponentiate(const Element &base, const Integer &exponent) const
 {
 	Element result;
@@ -335,6 +553,11 @@ void AbstractRing<T>::SimultaneousExponentiate(T *results, const T &base, const
 	MultiplicativeGroup().AbstractGroup<T>::SimultaneousMultiply(results, base, exponents, expCount);
 }
 
+template <class T> T AbstractRing<T>::MultiExponentiate(const Element *bases, const Integer *exponents, unsigned int count) const
+{
+	return MultiplicativeGroup().AbstractGroup<T>::MultiScalarMultiply(bases, exponents, count);
+}
+
 NAMESPACE_END
 
 #endif
@@ -38,6 +38,8 @@ public:
 	virtual Element CascadeScalarMultiply(const Element &x, const Integer &e1, const Element &y, const Integer &e2) const;
 
 	virtual void SimultaneousMultiply(Element *results, const Element &base, const Integer *exponents, unsigned int exponentsCount) const;
+	//! returns the sum of exponents[i]*bases[i], using Straus' interleaved windows for a few bases and Pippenger's buckets for many
+	virtual Element MultiScalarMultiply(const Element *bases, const Integer *exponents, unsigned int count) const;
 };
 
 //! Abstract Ring
@@ -62,6 +64,8 @@ public:
 	virtual Element CascadeExponentiate(const Element &x, const Integer &e1, const Element &y, const Integer &e2) const;
 
 	virtual void SimultaneousExponentiate(Element *results, const Element &base, const Integer *exponents, unsigned int exponentsCount) const;
+	//! returns the product of bases[i]**exponents[i]
+	virtual Element MultiExponentiate(const Element *bases, const Integer *exponents, unsigned int count) const;
 
 	virtual const AbstractGroup<T>& MultiplicativeGroup() const
 		{return m_mg;}
@@ -106,6 +110,9 @@ private:
 		void SimultaneousMultiply(Element *results, const Element &base, const Integer *exponents, unsigned int exponentsCount) const
 			{GetRing().SimultaneousExponentiate(results, base, exponents, exponentsCount);}
 
+		Element MultiScalarMultiply(const Element *bases, const Integer *exponents, unsigned int count) const
+			{return GetRing().MultiExponentiate(bases, exponents, count);}
+
 		const AbstractRing<T> *m_pRing;
 	};
 
@@ -18,9 +18,12 @@
 #include "mqv.h"
 #include "xtrcrypt.h"
 #include "esign.h"
+#include "curve25519.h"
 #include "pssr.h"
 #include "oids.h"
 #include "randpool.h"
+#include "taskexec.h"
+#include "hrtimer.h"
 
 #include <time.h>
 #include <math.h>
@@ -227,6 +230,93 @@ void BenchMarkKeyAgreement(const char *filename, const char *name, double timeTo
 	BenchMarkAgreement(name, d, timeTotal);
 }
 
+#if defined(CRYPTOPP_INTEGER_ARENA) && defined(CRYPTOPP_THREAD_POOL_AVAILABLE)
+
+// each task signs or verifies with key objects and a random pool of its own, so the threads share nothing but the heap
+struct ArenaContentionTest
+{
+	enum {OPERATIONS_PER_TASK = 32};
+
+	ArenaContentionTest(size_t threads)
+		: signers(threads), verifiers(threads), rngs(threads), signatures(threads), verify(false), useArena(false) {}
+
+	static void Run(void *context, size_t index)
+	{
+		ArenaContentionTest &t = *(ArenaContentionTest *)context;
+		member_ptr<IntegerArena> arena(t.useArena ? new IntegerArena : NULL);
+		for (unsigned int i=0; i<OPERATIONS_PER_TASK; i++)
+		{
+			if (t.verify)
+				t.verifiers[index]->VerifyMessage(t.message, t.message.size(), t.signatures[index], t.signatures[index].size());
+			else
+				t.signers[index]->SignMessage(*t.rngs[index], t.message, t.message.size(), t.signatures[index]);
+		}
+	}
+
+	vector_member_ptrs<PK_Signer> signers;
+	vector_member_ptrs<PK_Verifier> verifiers;
+	vector_member_ptrs<RandomPool> rngs;
+	std::vector<SecByteBlock> signatures;
+	SecByteBlock message;
+	bool verify, useArena;
+};
+
+// measures wall clock time, since the point is how much the threads slow each other down
+void BenchMarkArenaContention(const char *name, ArenaContentionTest &t, const TaskExecutor &executor, double timeTotal)
+{
+	const size_t threads = t.signers.size();
+	std::string operation = std::string(t.verify ? "Verification" : "Signature") + " on " + IntToString(threads) + " threads";
+	if (t.useArena)
+		operation += " with IntegerArena";
+
+	Timer timer;
+	timer.StartTimer();
+	unsigned long i = 0;
+	double timeTaken;
+	do
+	{
+		executor.Run(&ArenaContentionTest::Run, &t, threads);
+		i += threads * ArenaContentionTest::OPERATIONS_PER_TASK;
+		timeTaken = timer.ElapsedTimeAsDouble();
+	}
+	while (timeTaken < timeTotal);
+
+	OutputResultOperations(name, operation.c_str(), false, i, timeTaken);
+}
+
+//VC60 workaround: compiler bug triggered without the extra dummy parameters
+template <class SCHEME>
+void BenchMarkArenaContention(const char *name, const typename SCHEME::Signer &priv, double timeTotal, SCHEME *x=NULL)
+{
+	ThreadPoolTaskExecutor pool;
+	const size_t threads = pool.GetConcurrency();
+	ArenaContentionTest t(threads);
+	t.message.resize(16);
+	GlobalRNG().GenerateBlock(t.message, t.message.size());
+
+	SecByteBlock seed(32);
+	for (size_t i=0; i<threads; i++)
+	{
+		t.signers[i].reset(new typename SCHEME::Signer(priv));
+		t.verifiers[i].reset(new typename SCHEME::Verifier(priv));
+		GlobalRNG().GenerateBlock(seed, seed.size());
+		t.rngs[i].reset(new RandomPool);
+		t.rngs[i]->IncorporateEntropy(seed, seed.size());
+		t.signatures[i].resize(priv.SignatureLength());
+		priv.SignMessage(GlobalRNG(), t.message, t.message.size(), t.signatures[i]);
+	}
+
+	for (unsigned int verify=0; verify<2; verify++)
+		for (unsigned int useArena=0; useArena<2; useArena++)
+		{
+			t.verify = verify != 0;
+			t.useArena = useArena != 0;
+			BenchMarkArenaContention(name, t, pool, timeTotal);
+		}
+}
+
+#endif
+
 extern double g_hertz;
 
 void BenchmarkAll2(double t, double hertz)
@@ -313,5 +403,29 @@ void BenchmarkAll2(double t, double hertz)
 		BenchMarkKeyGen("ECMQVC over GF(2^n) 233", ecmqvc, t);
 		BenchMarkAgreement("ECMQVC over GF(2^n) 233", ecmqvc, t);
 	}
+
+	cout << "<TBODY style=\"background: white\">" << endl;
+	{
+		Ed25519::Signer spriv(GlobalRNG());
+		Ed25519::Verifier spub(spriv);
+		X25519 x25519;
+
+		BenchMarkSigning("Ed25519", spriv, t);
+		BenchMarkVerification("Ed25519", spriv, spub, t);
+		BenchMarkKeyGen("X25519", x25519, t);
+		BenchMarkAgreement("X25519", x25519, t);
+	}
+
+#if defined(CRYPTOPP_INTEGER_ARENA) && defined(CRYPTOPP_THREAD_POOL_AVAILABLE)
+	cout << "<TBODY style=\"background: yellow\">" << endl;
+	{
+		FileSource f("TestData/rsa2048.dat", true, new HexDecoder());
+		RSASS<PSSR, SHA>::Signer rsa(f);
+		ECDSA<ECP, SHA256>::Signer ecdsa(GlobalRNG(), ASN1::secp256r1());
+
+		BenchMarkArenaContention<RSASS<PSSR, SHA> >("RSA 2048", rsa, t);
+		BenchMarkArenaContention<ECDSA<ECP, SHA256> >("ECDSA over GF(p) 256", ecdsa, t);
+	}
+#endif
 	cout << "</TABLE>" << endl;
 }
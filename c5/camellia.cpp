@@ -14,6 +14,7 @@ See comments at top of rijndael.cpp for more details.
 #include "camellia.h"
 #include "misc.h"
 #include "cpu.h"
+#include "multiblock.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -52,6 +53,12 @@ NAMESPACE_BEGIN(CryptoPP)
 	ROUND(lh, ll, rh, rl, k0, k1)						\
 	ROUND(rh, rl, lh, ll, k2, k3)
 
+#define DOUBLE_ROUND_2(lh, ll, rh, rl, lh2, ll2, rh2, rl2, k0, k1, k2, k3)	\
+	ROUND(lh, ll, rh, rl, k0, k1)						\
+	ROUND(lh2, ll2, rh2, rl2, k0, k1)					\
+	ROUND(rh, rl, lh, ll, k2, k3)						\
+	ROUND(rh2, rl2, lh2, ll2, k2, k3)
+
 #ifdef IS_LITTLE_ENDIAN
 #define EFI(i) (1-(i))
 #else
@@ -233,6 +240,66 @@ void Camellia::Base::ProcessAndXorBlock(const byte *inBlock, const byte *xorBloc
 	Block::Put(xorBlock, outBlock)(rh)(rl)(lh)(ll);
 }
 
+// same as ProcessAndXorBlock(), but with the rounds of two blocks interleaved so
+// their table lookups overlap, and with the timing countermeasure done once for both
+void Camellia::Base::Process2Blocks(const byte *inBlocks, byte *outBlocks) const
+{
+#define FL_2(klh, kll, krh, krl)		\
+	ll2 ^= rotlFixed(lh2 & klh, 1);	\
+	lh2 ^= (ll2 | kll);				\
+	rh2 ^= (rl2 | krl);				\
+	rl2 ^= rotlFixed(rh2 & krh, 1);
+
+	word32 lh, ll, rh, rl, lh2, ll2, rh2, rl2;
+	typedef BlockGetAndPut<word32, BigEndian> Block;
+	Block::Get(inBlocks)(lh)(ll)(rh)(rl)(lh2)(ll2)(rh2)(rl2);
+	const word32 *ks = m_key.data();
+	lh ^= KS(0,0); lh2 ^= KS(0,0);
+	ll ^= KS(0,1); ll2 ^= KS(0,1);
+	rh ^= KS(0,2); rh2 ^= KS(0,2);
+	rl ^= KS(0,3); rl2 ^= KS(0,3);
+
+	// timing attack countermeasure. see comments at top for more details
+	const int cacheLineSize = GetCacheLineSize();
+	unsigned int i;
+	word32 u = 0;
+	for (i=0; i<256; i+=cacheLineSize)
+		u &= *(const word32 *)(s1+i);
+	u &= *(const word32 *)(s1+252);
+	lh |= u; ll |= u;
+	lh2 |= u; ll2 |= u;
+
+	SLOW_ROUND(lh, ll, rh, rl, KS(1,0), KS(1,1))
+	SLOW_ROUND(lh2, ll2, rh2, rl2, KS(1,0), KS(1,1))
+	SLOW_ROUND(rh, rl, lh, ll, KS(1,2), KS(1,3))
+	SLOW_ROUND(rh2, rl2, lh2, ll2, KS(1,2), KS(1,3))
+	for (i = m_rounds-1; i > 0; --i)
+	{
+		DOUBLE_ROUND_2(lh, ll, rh, rl, lh2, ll2, rh2, rl2, KS(2,0), KS(2,1), KS(2,2), KS(2,3))
+		DOUBLE_ROUND_2(lh, ll, rh, rl, lh2, ll2, rh2, rl2, KS(3,0), KS(3,1), KS(3,2), KS(3,3))
+		FL(KS(4,0), KS(4,1), KS(4,2), KS(4,3));
+		FL_2(KS(4,0), KS(4,1), KS(4,2), KS(4,3));
+		DOUBLE_ROUND_2(lh, ll, rh, rl, lh2, ll2, rh2, rl2, KS(5,0), KS(5,1), KS(5,2), KS(5,3))
+		ks += 16;
+	}
+	DOUBLE_ROUND_2(lh, ll, rh, rl, lh2, ll2, rh2, rl2, KS(2,0), KS(2,1), KS(2,2), KS(2,3))
+	ROUND(lh, ll, rh, rl, KS(3,0), KS(3,1))
+	ROUND(lh2, ll2, rh2, rl2, KS(3,0), KS(3,1))
+	SLOW_ROUND(rh, rl, lh, ll, KS(3,2), KS(3,3))
+	SLOW_ROUND(rh2, rl2, lh2, ll2, KS(3,2), KS(3,3))
+	lh ^= KS(4,0); lh2 ^= KS(4,0);
+	ll ^= KS(4,1); ll2 ^= KS(4,1);
+	rh ^= KS(4,2); rh2 ^= KS(4,2);
+	rl ^= KS(4,3); rl2 ^= KS(4,3);
+	Block::Put(NULL, outBlocks)(rh)(rl)(lh)(ll)(rh2)(rl2)(lh2)(ll2);
+#undef FL_2
+}
+
+size_t Camellia::Base::AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const
+{
+	return AdvancedProcessBlocksInParallel<2, BLOCKSIZE>(*this, &Base::Process2Blocks, inBlocks, xorBlocks, outBlocks, length, flags);
+}
+
 // The Camellia s-boxes
 
 const byte Camellia::Base::s1[256] =
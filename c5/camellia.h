@@ -25,8 +25,12 @@ class Camellia : public Camellia_Info, public BlockCipherDocumentation
 	public:
 		void UncheckedSetKey(const byte *key, unsigned int keylen, const NameValuePairs &params);
 		void ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const;
+		unsigned int OptimalNumberOfParallelBlocks() const {return 2;}
+		size_t AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const;
 
 	protected:
+		void Process2Blocks(const byte *inBlocks, byte *outBlocks) const;
+
 		static const byte s1[256];
 		static const word32 SP[4][256];
 
@@ -39,6 +39,12 @@
 // CACM paper.
 // #define LCRNG_ORIGINAL_NUMBERS
 
+// Define this to make IntegerArena available. Integers on a thread with an arena in scope then
+// reuse the storage freed there instead of going to the heap, which can help when many threads
+// do public key operations at once and contend for the heap. Every Integer allocation and free
+// also looks up the calling thread's arena, which costs a few percent where no arena is used.
+// #define CRYPTOPP_INTEGER_ARENA
+
 // choose which style of sockets to wrap (mostly useful for cygwin which has both)
 #define PREFER_BERKELEY_STYLE_SOCKETS
 // #define PREFER_WINDOWS_STYLE_SOCKETS
@@ -101,9 +107,11 @@ typedef unsigned int word32;
 
 #if defined(_MSC_VER) || defined(__BORLANDC__)
 	typedef unsigned __int64 word64;
+	typedef signed __int64 sword64;
 	#define W64LIT(x) x##ui64
 #else
 	typedef unsigned long long word64;
+	typedef signed long long sword64;
 	#define W64LIT(x) x##ULL
 #endif
 
@@ -194,6 +202,11 @@ NAMESPACE_END
 	#endif
 #endif
 
+// rvalue references and std::move, for move constructors and for operators that reuse the storage of temporaries
+#if !defined(CRYPTOPP_CXX11_RVALUES) && (__cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__) || _MSC_VER >= 1600)
+	#define CRYPTOPP_CXX11_RVALUES
+#endif
+
 #if defined(_MSC_VER) || defined(__fastcall)
 	#define CRYPTOPP_FASTCALL __fastcall
 #else
@@ -290,6 +303,20 @@ NAMESPACE_END
 	#define CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE 0
 #endif
 
+// the SHA extensions need GNU as 2.24 or later, which is checked in GNUmakefile
+#if !defined(CRYPTOPP_DISABLE_SHA) && CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE && (CRYPTOPP_GCC_VERSION >= 40400 || _MSC_VER >= 1900 || __INTEL_COMPILER >= 1400)
+	#define CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE 1
+#else
+	#define CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE 0
+#endif
+
+// MULX, ADCX and ADOX need GNU as 2.23 or later, which is checked in GNUmakefile
+#if !defined(CRYPTOPP_DISABLE_ADX) && defined(CRYPTOPP_X64_ASM_AVAILABLE)
+	#define CRYPTOPP_BOOL_ADX_ASM_AVAILABLE 1
+#else
+	#define CRYPTOPP_BOOL_ADX_ASM_AVAILABLE 0
+#endif
+
 #if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE || CRYPTOPP_BOOL_SSE2_ASM_AVAILABLE || defined(CRYPTOPP_X64_MASM_AVAILABLE)
 	#define CRYPTOPP_BOOL_ALIGN16_ENABLED 1
 #else
@@ -26,6 +26,18 @@ _mm_shuffle_epi8 (__m128i a, __m128i b)
 	asm ("pshufb %1, %0" : "+x"(a) : "xm"(b));
   	return a;
 }
+__inline __m128i __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_alignr_epi8 (__m128i a, __m128i b, const int i)
+{
+	asm ("palignr %2, %1, %0" : "+x"(a) : "xm"(b), "i"(i));
+  	return a;
+}
+__inline __m128i __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_maddubs_epi16 (__m128i a, __m128i b)
+{
+	asm ("pmaddubsw %1, %0" : "+x"(a) : "xm"(b));
+  	return a;
+}
 #endif
 #if !defined(__GNUC__) || defined(__SSE4_1__) || defined(__INTEL_COMPILER)
 #include <smmintrin.h>
@@ -44,6 +56,30 @@ _mm_insert_epi32 (__m128i a, int b, const int i)
   	return a;
 }
 #endif
+#if !defined(__GNUC__) || defined(__SSE4_2__) || defined(__INTEL_COMPILER)
+#include <nmmintrin.h>
+#else
+__inline unsigned int __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_crc32_u8 (unsigned int crc, unsigned char v)
+{
+	asm ("crc32b %1, %0" : "+r"(crc) : "rm"(v));
+  	return crc;
+}
+__inline unsigned int __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_crc32_u32 (unsigned int crc, unsigned int v)
+{
+	asm ("crc32l %1, %0" : "+r"(crc) : "rm"(v));
+  	return crc;
+}
+#if CRYPTOPP_BOOL_X64
+__inline unsigned long long __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_crc32_u64 (unsigned long long crc, unsigned long long v)
+{
+	asm ("crc32q %1, %0" : "+r"(crc) : "rm"(v));
+  	return crc;
+}
+#endif
+#endif
 #if !defined(__GNUC__) || (defined(__AES__) && defined(__PCLMUL__)) || defined(__INTEL_COMPILER)
 #include <wmmintrin.h>
 #else
@@ -92,6 +128,55 @@ _mm_aesdeclast_si128 (__m128i a, __m128i b)
   	return a;
 }
 #endif
+#if CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE
+#if !defined(__GNUC__) || defined(__SHA__) || defined(__INTEL_COMPILER)
+#include <immintrin.h>
+#else
+__inline __m128i __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_sha1rnds4_epu32 (__m128i a, __m128i b, const int i)
+{
+	asm ("sha1rnds4 %2, %1, %0" : "+x"(a) : "xm"(b), "i"(i));
+  	return a;
+}
+__inline __m128i __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_sha1nexte_epu32 (__m128i a, __m128i b)
+{
+	asm ("sha1nexte %1, %0" : "+x"(a) : "xm"(b));
+  	return a;
+}
+__inline __m128i __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_sha1msg1_epu32 (__m128i a, __m128i b)
+{
+	asm ("sha1msg1 %1, %0" : "+x"(a) : "xm"(b));
+  	return a;
+}
+__inline __m128i __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_sha1msg2_epu32 (__m128i a, __m128i b)
+{
+	asm ("sha1msg2 %1, %0" : "+x"(a) : "xm"(b));
+  	return a;
+}
+__inline __m128i __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_sha256rnds2_epu32 (__m128i a, __m128i b, __m128i k)
+{
+	// the round constants plus message words are an implicit operand in xmm0
+	asm ("sha256rnds2 %2, %1, %0" : "+x"(a) : "xm"(b), "Yz"(k));
+  	return a;
+}
+__inline __m128i __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_sha256msg1_epu32 (__m128i a, __m128i b)
+{
+	asm ("sha256msg1 %1, %0" : "+x"(a) : "xm"(b));
+  	return a;
+}
+__inline __m128i __attribute__((__gnu_inline__, __always_inline__, __artificial__))
+_mm_sha256msg2_epu32 (__m128i a, __m128i b)
+{
+	asm ("sha256msg2 %1, %0" : "+x"(a) : "xm"(b));
+  	return a;
+}
+#endif
+#endif
 #endif
 
 NAMESPACE_BEGIN(CryptoPP)
@@ -103,8 +188,12 @@ NAMESPACE_BEGIN(CryptoPP)
 // these should not be used directly
 extern CRYPTOPP_DLL bool g_x86DetectionDone;
 extern CRYPTOPP_DLL bool g_hasSSSE3;
+extern CRYPTOPP_DLL bool g_hasSSE42;
 extern CRYPTOPP_DLL bool g_hasAESNI;
 extern CRYPTOPP_DLL bool g_hasCLMUL;
+extern CRYPTOPP_DLL bool g_hasSHA;
+extern CRYPTOPP_DLL bool g_hasBMI2;
+extern CRYPTOPP_DLL bool g_hasADX;
 extern CRYPTOPP_DLL bool g_isP4;
 extern CRYPTOPP_DLL word32 g_cacheLineSize;
 CRYPTOPP_DLL void CRYPTOPP_API DetectX86Features();
@@ -150,6 +239,13 @@ inline bool HasSSSE3()
 	return g_hasSSSE3;
 }
 
+inline bool HasSSE42()
+{
+	if (!g_x86DetectionDone)
+		DetectX86Features();
+	return g_hasSSE42;
+}
+
 inline bool HasAESNI()
 {
 	if (!g_x86DetectionDone)
@@ -164,6 +260,27 @@ inline bool HasCLMUL()
 	return g_hasCLMUL;
 }
 
+inline bool HasSHA()
+{
+	if (!g_x86DetectionDone)
+		DetectX86Features();
+	return g_hasSHA;
+}
+
+inline bool HasBMI2()
+{
+	if (!g_x86DetectionDone)
+		DetectX86Features();
+	return g_hasBMI2;
+}
+
+inline bool HasADX()
+{
+	if (!g_x86DetectionDone)
+		DetectX86Features();
+	return g_hasADX;
+}
+
 inline bool IsP4()
 {
 	if (!g_x86DetectionDone)
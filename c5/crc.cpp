@@ -3,6 +3,7 @@
 #include "pch.h"
 #include "crc.h"
 #include "misc.h"
+#include "cpu.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -122,6 +123,949 @@ CRC32::CRC32()
 	Reset();
 }
 
+#ifdef IS_LITTLE_ENDIAN
+
+// slicing-by-8 tables, slices[k][i] is the CRC of byte i followed by k zero bytes (slices[0] is m_tab)
+static const word32 s_crc32Slices[8][256] = {
+	{
+	0x00000000L, 0x77073096L, 0xee0e612cL, 0x990951baL, 0x076dc419L,
+	0x706af48fL, 0xe963a535L, 0x9e6495a3L, 0x0edb8832L, 0x79dcb8a4L,
+	0xe0d5e91eL, 0x97d2d988L, 0x09b64c2bL, 0x7eb17cbdL, 0xe7b82d07L,
+	0x90bf1d91L, 0x1db71064L, 0x6ab020f2L, 0xf3b97148L, 0x84be41deL,
+	0x1adad47dL, 0x6ddde4ebL, 0xf4d4b551L, 0x83d385c7L, 0x136c9856L,
+	0x646ba8c0L, 0xfd62f97aL, 0x8a65c9ecL, 0x14015c4fL, 0x63066cd9L,
+	0xfa0f3d63L, 0x8d080df5L, 0x3b6e20c8L, 0x4c69105eL, 0xd56041e4L,
+	0xa2677172L, 0x3c03e4d1L, 0x4b04d447L, 0xd20d85fdL, 0xa50ab56bL,
+	0x35b5a8faL, 0x42b2986cL, 0xdbbbc9d6L, 0xacbcf940L, 0x32d86ce3L,
+	0x45df5c75L, 0xdcd60dcfL, 0xabd13d59L, 0x26d930acL, 0x51de003aL,
+	0xc8d75180L, 0xbfd06116L, 0x21b4f4b5L, 0x56b3c423L, 0xcfba9599L,
+	0xb8bda50fL, 0x2802b89eL, 0x5f058808L, 0xc60cd9b2L, 0xb10be924L,
+	0x2f6f7c87L, 0x58684c11L, 0xc1611dabL, 0xb6662d3dL, 0x76dc4190L,
+	0x01db7106L, 0x98d220bcL, 0xefd5102aL, 0x71b18589L, 0x06b6b51fL,
+	0x9fbfe4a5L, 0xe8b8d433L, 0x7807c9a2L, 0x0f00f934L, 0x9609a88eL,
+	0xe10e9818L, 0x7f6a0dbbL, 0x086d3d2dL, 0x91646c97L, 0xe6635c01L,
+	0x6b6b51f4L, 0x1c6c6162L, 0x856530d8L, 0xf262004eL, 0x6c0695edL,
+	0x1b01a57bL, 0x8208f4c1L, 0xf50fc457L, 0x65b0d9c6L, 0x12b7e950L,
+	0x8bbeb8eaL, 0xfcb9887cL, 0x62dd1ddfL, 0x15da2d49L, 0x8cd37cf3L,
+	0xfbd44c65L, 0x4db26158L, 0x3ab551ceL, 0xa3bc0074L, 0xd4bb30e2L,
+	0x4adfa541L, 0x3dd895d7L, 0xa4d1c46dL, 0xd3d6f4fbL, 0x4369e96aL,
+	0x346ed9fcL, 0xad678846L, 0xda60b8d0L, 0x44042d73L, 0x33031de5L,
+	0xaa0a4c5fL, 0xdd0d7cc9L, 0x5005713cL, 0x270241aaL, 0xbe0b1010L,
+	0xc90c2086L, 0x5768b525L, 0x206f85b3L, 0xb966d409L, 0xce61e49fL,
+	0x5edef90eL, 0x29d9c998L, 0xb0d09822L, 0xc7d7a8b4L, 0x59b33d17L,
+	0x2eb40d81L, 0xb7bd5c3bL, 0xc0ba6cadL, 0xedb88320L, 0x9abfb3b6L,
+	0x03b6e20cL, 0x74b1d29aL, 0xead54739L, 0x9dd277afL, 0x04db2615L,
+	0x73dc1683L, 0xe3630b12L, 0x94643b84L, 0x0d6d6a3eL, 0x7a6a5aa8L,
+	0xe40ecf0bL, 0x9309ff9dL, 0x0a00ae27L, 0x7d079eb1L, 0xf00f9344L,
+	0x8708a3d2L, 0x1e01f268L, 0x6906c2feL, 0xf762575dL, 0x806567cbL,
+	0x196c3671L, 0x6e6b06e7L, 0xfed41b76L, 0x89d32be0L, 0x10da7a5aL,
+	0x67dd4accL, 0xf9b9df6fL, 0x8ebeeff9L, 0x17b7be43L, 0x60b08ed5L,
+	0xd6d6a3e8L, 0xa1d1937eL, 0x38d8c2c4L, 0x4fdff252L, 0xd1bb67f1L,
+	0xa6bc5767L, 0x3fb506ddL, 0x48b2364bL, 0xd80d2bdaL, 0xaf0a1b4cL,
+	0x36034af6L, 0x41047a60L, 0xdf60efc3L, 0xa867df55L, 0x316e8eefL,
+	0x4669be79L, 0xcb61b38cL, 0xbc66831aL, 0x256fd2a0L, 0x5268e236L,
+	0xcc0c7795L, 0xbb0b4703L, 0x220216b9L, 0x5505262fL, 0xc5ba3bbeL,
+	0xb2bd0b28L, 0x2bb45a92L, 0x5cb36a04L, 0xc2d7ffa7L, 0xb5d0cf31L,
+	0x2cd99e8bL, 0x5bdeae1dL, 0x9b64c2b0L, 0xec63f226L, 0x756aa39cL,
+	0x026d930aL, 0x9c0906a9L, 0xeb0e363fL, 0x72076785L, 0x05005713L,
+	0x95bf4a82L, 0xe2b87a14L, 0x7bb12baeL, 0x0cb61b38L, 0x92d28e9bL,
+	0xe5d5be0dL, 0x7cdcefb7L, 0x0bdbdf21L, 0x86d3d2d4L, 0xf1d4e242L,
+	0x68ddb3f8L, 0x1fda836eL, 0x81be16cdL, 0xf6b9265bL, 0x6fb077e1L,
+	0x18b74777L, 0x88085ae6L, 0xff0f6a70L, 0x66063bcaL, 0x11010b5cL,
+	0x8f659effL, 0xf862ae69L, 0x616bffd3L, 0x166ccf45L, 0xa00ae278L,
+	0xd70dd2eeL, 0x4e048354L, 0x3903b3c2L, 0xa7672661L, 0xd06016f7L,
+	0x4969474dL, 0x3e6e77dbL, 0xaed16a4aL, 0xd9d65adcL, 0x40df0b66L,
+	0x37d83bf0L, 0xa9bcae53L, 0xdebb9ec5L, 0x47b2cf7fL, 0x30b5ffe9L,
+	0xbdbdf21cL, 0xcabac28aL, 0x53b39330L, 0x24b4a3a6L, 0xbad03605L,
+	0xcdd70693L, 0x54de5729L, 0x23d967bfL, 0xb3667a2eL, 0xc4614ab8L,
+	0x5d681b02L, 0x2a6f2b94L, 0xb40bbe37L, 0xc30c8ea1L, 0x5a05df1bL,
+	0x2d02ef8dL
+	},
+	{
+	0x00000000L, 0x191b3141L, 0x32366282L, 0x2b2d53c3L, 0x646cc504L,
+	0x7d77f445L, 0x565aa786L, 0x4f4196c7L, 0xc8d98a08L, 0xd1c2bb49L,
+	0xfaefe88aL, 0xe3f4d9cbL, 0xacb54f0cL, 0xb5ae7e4dL, 0x9e832d8eL,
+	0x87981ccfL, 0x4ac21251L, 0x53d92310L, 0x78f470d3L, 0x61ef4192L,
+	0x2eaed755L, 0x37b5e614L, 0x1c98b5d7L, 0x05838496L, 0x821b9859L,
+	0x9b00a918L, 0xb02dfadbL, 0xa936cb9aL, 0xe6775d5dL, 0xff6c6c1cL,
+	0xd4413fdfL, 0xcd5a0e9eL, 0x958424a2L, 0x8c9f15e3L, 0xa7b24620L,
+	0xbea97761L, 0xf1e8e1a6L, 0xe8f3d0e7L, 0xc3de8324L, 0xdac5b265L,
+	0x5d5daeaaL, 0x44469febL, 0x6f6bcc28L, 0x7670fd69L, 0x39316baeL,
+	0x202a5aefL, 0x0b07092cL, 0x121c386dL, 0xdf4636f3L, 0xc65d07b2L,
+	0xed705471L, 0xf46b6530L, 0xbb2af3f7L, 0xa231c2b6L, 0x891c9175L,
+	0x9007a034L, 0x179fbcfbL, 0x0e848dbaL, 0x25a9de79L, 0x3cb2ef38L,
+	0x73f379ffL, 0x6ae848beL, 0x41c51b7dL, 0x58de2a3cL, 0xf0794f05L,
+	0xe9627e44L, 0xc24f2d87L, 0xdb541cc6L, 0x94158a01L, 0x8d0ebb40L,
+	0xa623e883L, 0xbf38d9c2L, 0x38a0c50dL, 0x21bbf44cL, 0x0a96a78fL,
+	0x138d96ceL, 0x5ccc0009L, 0x45d73148L, 0x6efa628bL, 0x77e153caL,
+	0xbabb5d54L, 0xa3a06c15L, 0x888d3fd6L, 0x91960e97L, 0xded79850L,
+	0xc7cca911L, 0xece1fad2L, 0xf5facb93L, 0x7262d75cL, 0x6b79e61dL,
+	0x4054b5deL, 0x594f849fL, 0x160e1258L, 0x0f152319L, 0x243870daL,
+	0x3d23419bL, 0x65fd6ba7L, 0x7ce65ae6L, 0x57cb0925L, 0x4ed03864L,
+	0x0191aea3L, 0x188a9fe2L, 0x33a7cc21L, 0x2abcfd60L, 0xad24e1afL,
+	0xb43fd0eeL, 0x9f12832dL, 0x8609b26cL, 0xc94824abL, 0xd05315eaL,
+	0xfb7e4629L, 0xe2657768L, 0x2f3f79f6L, 0x362448b7L, 0x1d091b74L,
+	0x04122a35L, 0x4b53bcf2L, 0x52488db3L, 0x7965de70L, 0x607eef31L,
+	0xe7e6f3feL, 0xfefdc2bfL, 0xd5d0917cL, 0xcccba03dL, 0x838a36faL,
+	0x9a9107bbL, 0xb1bc5478L, 0xa8a76539L, 0x3b83984bL, 0x2298a90aL,
+	0x09b5fac9L, 0x10aecb88L, 0x5fef5d4fL, 0x46f46c0eL, 0x6dd93fcdL,
+	0x74c20e8cL, 0xf35a1243L, 0xea412302L, 0xc16c70c1L, 0xd8774180L,
+	0x9736d747L, 0x8e2de606L, 0xa500b5c5L, 0xbc1b8484L, 0x71418a1aL,
+	0x685abb5bL, 0x4377e898L, 0x5a6cd9d9L, 0x152d4f1eL, 0x0c367e5fL,
+	0x271b2d9cL, 0x3e001cddL, 0xb9980012L, 0xa0833153L, 0x8bae6290L,
+	0x92b553d1L, 0xddf4c516L, 0xc4eff457L, 0xefc2a794L, 0xf6d996d5L,
+	0xae07bce9L, 0xb71c8da8L, 0x9c31de6bL, 0x852aef2aL, 0xca6b79edL,
+	0xd37048acL, 0xf85d1b6fL, 0xe1462a2eL, 0x66de36e1L, 0x7fc507a0L,
+	0x54e85463L, 0x4df36522L, 0x02b2f3e5L, 0x1ba9c2a4L, 0x30849167L,
+	0x299fa026L, 0xe4c5aeb8L, 0xfdde9ff9L, 0xd6f3cc3aL, 0xcfe8fd7bL,
+	0x80a96bbcL, 0x99b25afdL, 0xb29f093eL, 0xab84387fL, 0x2c1c24b0L,
+	0x350715f1L, 0x1e2a4632L, 0x07317773L, 0x4870e1b4L, 0x516bd0f5L,
+	0x7a468336L, 0x635db277L, 0xcbfad74eL, 0xd2e1e60fL, 0xf9ccb5ccL,
+	0xe0d7848dL, 0xaf96124aL, 0xb68d230bL, 0x9da070c8L, 0x84bb4189L,
+	0x03235d46L, 0x1a386c07L, 0x31153fc4L, 0x280e0e85L, 0x674f9842L,
+	0x7e54a903L, 0x5579fac0L, 0x4c62cb81L, 0x8138c51fL, 0x9823f45eL,
+	0xb30ea79dL, 0xaa1596dcL, 0xe554001bL, 0xfc4f315aL, 0xd7626299L,
+	0xce7953d8L, 0x49e14f17L, 0x50fa7e56L, 0x7bd72d95L, 0x62cc1cd4L,
+	0x2d8d8a13L, 0x3496bb52L, 0x1fbbe891L, 0x06a0d9d0L, 0x5e7ef3ecL,
+	0x4765c2adL, 0x6c48916eL, 0x7553a02fL, 0x3a1236e8L, 0x230907a9L,
+	0x0824546aL, 0x113f652bL, 0x96a779e4L, 0x8fbc48a5L, 0xa4911b66L,
+	0xbd8a2a27L, 0xf2cbbce0L, 0xebd08da1L, 0xc0fdde62L, 0xd9e6ef23L,
+	0x14bce1bdL, 0x0da7d0fcL, 0x268a833fL, 0x3f91b27eL, 0x70d024b9L,
+	0x69cb15f8L, 0x42e6463bL, 0x5bfd777aL, 0xdc656bb5L, 0xc57e5af4L,
+	0xee530937L, 0xf7483876L, 0xb809aeb1L, 0xa1129ff0L, 0x8a3fcc33L,
+	0x9324fd72L
+	},
+	{
+	0x00000000L, 0x01c26a37L, 0x0384d46eL, 0x0246be59L, 0x0709a8dcL,
+	0x06cbc2ebL, 0x048d7cb2L, 0x054f1685L, 0x0e1351b8L, 0x0fd13b8fL,
+	0x0d9785d6L, 0x0c55efe1L, 0x091af964L, 0x08d89353L, 0x0a9e2d0aL,
+	0x0b5c473dL, 0x1c26a370L, 0x1de4c947L, 0x1fa2771eL, 0x1e601d29L,
+	0x1b2f0bacL, 0x1aed619bL, 0x18abdfc2L, 0x1969b5f5L, 0x1235f2c8L,
+	0x13f798ffL, 0x11b126a6L, 0x10734c91L, 0x153c5a14L, 0x14fe3023L,
+	0x16b88e7aL, 0x177ae44dL, 0x384d46e0L, 0x398f2cd7L, 0x3bc9928eL,
+	0x3a0bf8b9L, 0x3f44ee3cL, 0x3e86840bL, 0x3cc03a52L, 0x3d025065L,
+	0x365e1758L, 0x379c7d6fL, 0x35dac336L, 0x3418a901L, 0x3157bf84L,
+	0x3095d5b3L, 0x32d36beaL, 0x331101ddL, 0x246be590L, 0x25a98fa7L,
+	0x27ef31feL, 0x262d5bc9L, 0x23624d4cL, 0x22a0277bL, 0x20e69922L,
+	0x2124f315L, 0x2a78b428L, 0x2bbade1fL, 0x29fc6046L, 0x283e0a71L,
+	0x2d711cf4L, 0x2cb376c3L, 0x2ef5c89aL, 0x2f37a2adL, 0x709a8dc0L,
+	0x7158e7f7L, 0x731e59aeL, 0x72dc3399L, 0x7793251cL, 0x76514f2bL,
+	0x7417f172L, 0x75d59b45L, 0x7e89dc78L, 0x7f4bb64fL, 0x7d0d0816L,
+	0x7ccf6221L, 0x798074a4L, 0x78421e93L, 0x7a04a0caL, 0x7bc6cafdL,
+	0x6cbc2eb0L, 0x6d7e4487L, 0x6f38fadeL, 0x6efa90e9L, 0x6bb5866cL,
+	0x6a77ec5bL, 0x68315202L, 0x69f33835L, 0x62af7f08L, 0x636d153fL,
+	0x612bab66L, 0x60e9c151L, 0x65a6d7d4L, 0x6464bde3L, 0x662203baL,
+	0x67e0698dL, 0x48d7cb20L, 0x4915a117L, 0x4b531f4eL, 0x4a917579L,
+	0x4fde63fcL, 0x4e1c09cbL, 0x4c5ab792L, 0x4d98dda5L, 0x46c49a98L,
+	0x4706f0afL, 0x45404ef6L, 0x448224c1L, 0x41cd3244L, 0x400f5873L,
+	0x4249e62aL, 0x438b8c1dL, 0x54f16850L, 0x55330267L, 0x5775bc3eL,
+	0x56b7d609L, 0x53f8c08cL, 0x523aaabbL, 0x507c14e2L, 0x51be7ed5L,
+	0x5ae239e8L, 0x5b2053dfL, 0x5966ed86L, 0x58a487b1L, 0x5deb9134L,
+	0x5c29fb03L, 0x5e6f455aL, 0x5fad2f6dL, 0xe1351b80L, 0xe0f771b7L,
+	0xe2b1cfeeL, 0xe373a5d9L, 0xe63cb35cL, 0xe7fed96bL, 0xe5b86732L,
+	0xe47a0d05L, 0xef264a38L, 0xeee4200fL, 0xeca29e56L, 0xed60f461L,
+	0xe82fe2e4L, 0xe9ed88d3L, 0xebab368aL, 0xea695cbdL, 0xfd13b8f0L,
+	0xfcd1d2c7L, 0xfe976c9eL, 0xff5506a9L, 0xfa1a102cL, 0xfbd87a1bL,
+	0xf99ec442L, 0xf85cae75L, 0xf300e948L, 0xf2c2837fL, 0xf0843d26L,
+	0xf1465711L, 0xf4094194L, 0xf5cb2ba3L, 0xf78d95faL, 0xf64fffcdL,
+	0xd9785d60L, 0xd8ba3757L, 0xdafc890eL, 0xdb3ee339L, 0xde71f5bcL,
+	0xdfb39f8bL, 0xddf521d2L, 0xdc374be5L, 0xd76b0cd8L, 0xd6a966efL,
+	0xd4efd8b6L, 0xd52db281L, 0xd062a404L, 0xd1a0ce33L, 0xd3e6706aL,
+	0xd2241a5dL, 0xc55efe10L, 0xc49c9427L, 0xc6da2a7eL, 0xc7184049L,
+	0xc25756ccL, 0xc3953cfbL, 0xc1d382a2L, 0xc011e895L, 0xcb4dafa8L,
+	0xca8fc59fL, 0xc8c97bc6L, 0xc90b11f1L, 0xcc440774L, 0xcd866d43L,
+	0xcfc0d31aL, 0xce02b92dL, 0x91af9640L, 0x906dfc77L, 0x922b422eL,
+	0x93e92819L, 0x96a63e9cL, 0x976454abL, 0x9522eaf2L, 0x94e080c5L,
+	0x9fbcc7f8L, 0x9e7eadcfL, 0x9c381396L, 0x9dfa79a1L, 0x98b56f24L,
+	0x99770513L, 0x9b31bb4aL, 0x9af3d17dL, 0x8d893530L, 0x8c4b5f07L,
+	0x8e0de15eL, 0x8fcf8b69L, 0x8a809decL, 0x8b42f7dbL, 0x89044982L,
+	0x88c623b5L, 0x839a6488L, 0x82580ebfL, 0x801eb0e6L, 0x81dcdad1L,
+	0x8493cc54L, 0x8551a663L, 0x8717183aL, 0x86d5720dL, 0xa9e2d0a0L,
+	0xa820ba97L, 0xaa6604ceL, 0xaba46ef9L, 0xaeeb787cL, 0xaf29124bL,
+	0xad6fac12L, 0xacadc625L, 0xa7f18118L, 0xa633eb2fL, 0xa4755576L,
+	0xa5b73f41L, 0xa0f829c4L, 0xa13a43f3L, 0xa37cfdaaL, 0xa2be979dL,
+	0xb5c473d0L, 0xb40619e7L, 0xb640a7beL, 0xb782cd89L, 0xb2cddb0cL,
+	0xb30fb13bL, 0xb1490f62L, 0xb08b6555L, 0xbbd72268L, 0xba15485fL,
+	0xb853f606L, 0xb9919c31L, 0xbcde8ab4L, 0xbd1ce083L, 0xbf5a5edaL,
+	0xbe9834edL
+	},
+	{
+	0x00000000L, 0xb8bc6765L, 0xaa09c88bL, 0x12b5afeeL, 0x8f629757L,
+	0x37def032L, 0x256b5fdcL, 0x9dd738b9L, 0xc5b428efL, 0x7d084f8aL,
+	0x6fbde064L, 0xd7018701L, 0x4ad6bfb8L, 0xf26ad8ddL, 0xe0df7733L,
+	0x58631056L, 0x5019579fL, 0xe8a530faL, 0xfa109f14L, 0x42acf871L,
+	0xdf7bc0c8L, 0x67c7a7adL, 0x75720843L, 0xcdce6f26L, 0x95ad7f70L,
+	0x2d111815L, 0x3fa4b7fbL, 0x8718d09eL, 0x1acfe827L, 0xa2738f42L,
+	0xb0c620acL, 0x087a47c9L, 0xa032af3eL, 0x188ec85bL, 0x0a3b67b5L,
+	0xb28700d0L, 0x2f503869L, 0x97ec5f0cL, 0x8559f0e2L, 0x3de59787L,
+	0x658687d1L, 0xdd3ae0b4L, 0xcf8f4f5aL, 0x7733283fL, 0xeae41086L,
+	0x525877e3L, 0x40edd80dL, 0xf851bf68L, 0xf02bf8a1L, 0x48979fc4L,
+	0x5a22302aL, 0xe29e574fL, 0x7f496ff6L, 0xc7f50893L, 0xd540a77dL,
+	0x6dfcc018L, 0x359fd04eL, 0x8d23b72bL, 0x9f9618c5L, 0x272a7fa0L,
+	0xbafd4719L, 0x0241207cL, 0x10f48f92L, 0xa848e8f7L, 0x9b14583dL,
+	0x23a83f58L, 0x311d90b6L, 0x89a1f7d3L, 0x1476cf6aL, 0xaccaa80fL,
+	0xbe7f07e1L, 0x06c36084L, 0x5ea070d2L, 0xe61c17b7L, 0xf4a9b859L,
+	0x4c15df3cL, 0xd1c2e785L, 0x697e80e0L, 0x7bcb2f0eL, 0xc377486bL,
+	0xcb0d0fa2L, 0x73b168c7L, 0x6104c729L, 0xd9b8a04cL, 0x446f98f5L,
+	0xfcd3ff90L, 0xee66507eL, 0x56da371bL, 0x0eb9274dL, 0xb6054028L,
+	0xa4b0efc6L, 0x1c0c88a3L, 0x81dbb01aL, 0x3967d77fL, 0x2bd27891L,
+	0x936e1ff4L, 0x3b26f703L, 0x839a9066L, 0x912f3f88L, 0x299358edL,
+	0xb4446054L, 0x0cf80731L, 0x1e4da8dfL, 0xa6f1cfbaL, 0xfe92dfecL,
+	0x462eb889L, 0x549b1767L, 0xec277002L, 0x71f048bbL, 0xc94c2fdeL,
+	0xdbf98030L, 0x6345e755L, 0x6b3fa09cL, 0xd383c7f9L, 0xc1366817L,
+	0x798a0f72L, 0xe45d37cbL, 0x5ce150aeL, 0x4e54ff40L, 0xf6e89825L,
+	0xae8b8873L, 0x1637ef16L, 0x048240f8L, 0xbc3e279dL, 0x21e91f24L,
+	0x99557841L, 0x8be0d7afL, 0x335cb0caL, 0xed59b63bL, 0x55e5d15eL,
+	0x47507eb0L, 0xffec19d5L, 0x623b216cL, 0xda874609L, 0xc832e9e7L,
+	0x708e8e82L, 0x28ed9ed4L, 0x9051f9b1L, 0x82e4565fL, 0x3a58313aL,
+	0xa78f0983L, 0x1f336ee6L, 0x0d86c108L, 0xb53aa66dL, 0xbd40e1a4L,
+	0x05fc86c1L, 0x1749292fL, 0xaff54e4aL, 0x322276f3L, 0x8a9e1196L,
+	0x982bbe78L, 0x2097d91dL, 0x78f4c94bL, 0xc048ae2eL, 0xd2fd01c0L,
+	0x6a4166a5L, 0xf7965e1cL, 0x4f2a3979L, 0x5d9f9697L, 0xe523f1f2L,
+	0x4d6b1905L, 0xf5d77e60L, 0xe762d18eL, 0x5fdeb6ebL, 0xc2098e52L,
+	0x7ab5e937L, 0x680046d9L, 0xd0bc21bcL, 0x88df31eaL, 0x3063568fL,
+	0x22d6f961L, 0x9a6a9e04L, 0x07bda6bdL, 0xbf01c1d8L, 0xadb46e36L,
+	0x15080953L, 0x1d724e9aL, 0xa5ce29ffL, 0xb77b8611L, 0x0fc7e174L,
+	0x9210d9cdL, 0x2aacbea8L, 0x38191146L, 0x80a57623L, 0xd8c66675L,
+	0x607a0110L, 0x72cfaefeL, 0xca73c99bL, 0x57a4f122L, 0xef189647L,
+	0xfdad39a9L, 0x45115eccL, 0x764dee06L, 0xcef18963L, 0xdc44268dL,
+	0x64f841e8L, 0xf92f7951L, 0x41931e34L, 0x5326b1daL, 0xeb9ad6bfL,
+	0xb3f9c6e9L, 0x0b45a18cL, 0x19f00e62L, 0xa14c6907L, 0x3c9b51beL,
+	0x842736dbL, 0x96929935L, 0x2e2efe50L, 0x2654b999L, 0x9ee8defcL,
+	0x8c5d7112L, 0x34e11677L, 0xa9362eceL, 0x118a49abL, 0x033fe645L,
+	0xbb838120L, 0xe3e09176L, 0x5b5cf613L, 0x49e959fdL, 0xf1553e98L,
+	0x6c820621L, 0xd43e6144L, 0xc68bceaaL, 0x7e37a9cfL, 0xd67f4138L,
+	0x6ec3265dL, 0x7c7689b3L, 0xc4caeed6L, 0x591dd66fL, 0xe1a1b10aL,
+	0xf3141ee4L, 0x4ba87981L, 0x13cb69d7L, 0xab770eb2L, 0xb9c2a15cL,
+	0x017ec639L, 0x9ca9fe80L, 0x241599e5L, 0x36a0360bL, 0x8e1c516eL,
+	0x866616a7L, 0x3eda71c2L, 0x2c6fde2cL, 0x94d3b949L, 0x090481f0L,
+	0xb1b8e695L, 0xa30d497bL, 0x1bb12e1eL, 0x43d23e48L, 0xfb6e592dL,
+	0xe9dbf6c3L, 0x516791a6L, 0xccb0a91fL, 0x740cce7aL, 0x66b96194L,
+	0xde0506f1L
+	},
+	{
+	0x00000000L, 0x3d6029b0L, 0x7ac05360L, 0x47a07ad0L, 0xf580a6c0L,
+	0xc8e08f70L, 0x8f40f5a0L, 0xb220dc10L, 0x30704bc1L, 0x0d106271L,
+	0x4ab018a1L, 0x77d03111L, 0xc5f0ed01L, 0xf890c4b1L, 0xbf30be61L,
+	0x825097d1L, 0x60e09782L, 0x5d80be32L, 0x1a20c4e2L, 0x2740ed52L,
+	0x95603142L, 0xa80018f2L, 0xefa06222L, 0xd2c04b92L, 0x5090dc43L,
+	0x6df0f5f3L, 0x2a508f23L, 0x1730a693L, 0xa5107a83L, 0x98705333L,
+	0xdfd029e3L, 0xe2b00053L, 0xc1c12f04L, 0xfca106b4L, 0xbb017c64L,
+	0x866155d4L, 0x344189c4L, 0x0921a074L, 0x4e81daa4L, 0x73e1f314L,
+	0xf1b164c5L, 0xccd14d75L, 0x8b7137a5L, 0xb6111e15L, 0x0431c205L,
+	0x3951ebb5L, 0x7ef19165L, 0x4391b8d5L, 0xa121b886L, 0x9c419136L,
+	0xdbe1ebe6L, 0xe681c256L, 0x54a11e46L, 0x69c137f6L, 0x2e614d26L,
+	0x13016496L, 0x9151f347L, 0xac31daf7L, 0xeb91a027L, 0xd6f18997L,
+	0x64d15587L, 0x59b17c37L, 0x1e1106e7L, 0x23712f57L, 0x58f35849L,
+	0x659371f9L, 0x22330b29L, 0x1f532299L, 0xad73fe89L, 0x9013d739L,
+	0xd7b3ade9L, 0xead38459L, 0x68831388L, 0x55e33a38L, 0x124340e8L,
+	0x2f236958L, 0x9d03b548L, 0xa0639cf8L, 0xe7c3e628L, 0xdaa3cf98L,
+	0x3813cfcbL, 0x0573e67bL, 0x42d39cabL, 0x7fb3b51bL, 0xcd93690bL,
+	0xf0f340bbL, 0xb7533a6bL, 0x8a3313dbL, 0x0863840aL, 0x3503adbaL,
+	0x72a3d76aL, 0x4fc3fedaL, 0xfde322caL, 0xc0830b7aL, 0x872371aaL,
+	0xba43581aL, 0x9932774dL, 0xa4525efdL, 0xe3f2242dL, 0xde920d9dL,
+	0x6cb2d18dL, 0x51d2f83dL, 0x167282edL, 0x2b12ab5dL, 0xa9423c8cL,
+	0x9422153cL, 0xd3826fecL, 0xeee2465cL, 0x5cc29a4cL, 0x61a2b3fcL,
+	0x2602c92cL, 0x1b62e09cL, 0xf9d2e0cfL, 0xc4b2c97fL, 0x8312b3afL,
+	0xbe729a1fL, 0x0c52460fL, 0x31326fbfL, 0x7692156fL, 0x4bf23cdfL,
+	0xc9a2ab0eL, 0xf4c282beL, 0xb362f86eL, 0x8e02d1deL, 0x3c220dceL,
+	0x0142247eL, 0x46e25eaeL, 0x7b82771eL, 0xb1e6b092L, 0x8c869922L,
+	0xcb26e3f2L, 0xf646ca42L, 0x44661652L, 0x79063fe2L, 0x3ea64532L,
+	0x03c66c82L, 0x8196fb53L, 0xbcf6d2e3L, 0xfb56a833L, 0xc6368183L,
+	0x74165d93L, 0x49767423L, 0x0ed60ef3L, 0x33b62743L, 0xd1062710L,
+	0xec660ea0L, 0xabc67470L, 0x96a65dc0L, 0x248681d0L, 0x19e6a860L,
+	0x5e46d2b0L, 0x6326fb00L, 0xe1766cd1L, 0xdc164561L, 0x9bb63fb1L,
+	0xa6d61601L, 0x14f6ca11L, 0x2996e3a1L, 0x6e369971L, 0x5356b0c1L,
+	0x70279f96L, 0x4d47b626L, 0x0ae7ccf6L, 0x3787e546L, 0x85a73956L,
+	0xb8c710e6L, 0xff676a36L, 0xc2074386L, 0x4057d457L, 0x7d37fde7L,
+	0x3a978737L, 0x07f7ae87L, 0xb5d77297L, 0x88b75b27L, 0xcf1721f7L,
+	0xf2770847L, 0x10c70814L, 0x2da721a4L, 0x6a075b74L, 0x576772c4L,
+	0xe547aed4L, 0xd8278764L, 0x9f87fdb4L, 0xa2e7d404L, 0x20b743d5L,
+	0x1dd76a65L, 0x5a7710b5L, 0x67173905L, 0xd537e515L, 0xe857cca5L,
+	0xaff7b675L, 0x92979fc5L, 0xe915e8dbL, 0xd475c16bL, 0x93d5bbbbL,
+	0xaeb5920bL, 0x1c954e1bL, 0x21f567abL, 0x66551d7bL, 0x5b3534cbL,
+	0xd965a31aL, 0xe4058aaaL, 0xa3a5f07aL, 0x9ec5d9caL, 0x2ce505daL,
+	0x11852c6aL, 0x562556baL, 0x6b457f0aL, 0x89f57f59L, 0xb49556e9L,
+	0xf3352c39L, 0xce550589L, 0x7c75d999L, 0x4115f029L, 0x06b58af9L,
+	0x3bd5a349L, 0xb9853498L, 0x84e51d28L, 0xc34567f8L, 0xfe254e48L,
+	0x4c059258L, 0x7165bbe8L, 0x36c5c138L, 0x0ba5e888L, 0x28d4c7dfL,
+	0x15b4ee6fL, 0x521494bfL, 0x6f74bd0fL, 0xdd54611fL, 0xe03448afL,
+	0xa794327fL, 0x9af41bcfL, 0x18a48c1eL, 0x25c4a5aeL, 0x6264df7eL,
+	0x5f04f6ceL, 0xed242adeL, 0xd044036eL, 0x97e479beL, 0xaa84500eL,
+	0x4834505dL, 0x755479edL, 0x32f4033dL, 0x0f942a8dL, 0xbdb4f69dL,
+	0x80d4df2dL, 0xc774a5fdL, 0xfa148c4dL, 0x78441b9cL, 0x4524322cL,
+	0x028448fcL, 0x3fe4614cL, 0x8dc4bd5cL, 0xb0a494ecL, 0xf704ee3cL,
+	0xca64c78cL
+	},
+	{
+	0x00000000L, 0xcb5cd3a5L, 0x4dc8a10bL, 0x869472aeL, 0x9b914216L,
+	0x50cd91b3L, 0xd659e31dL, 0x1d0530b8L, 0xec53826dL, 0x270f51c8L,
+	0xa19b2366L, 0x6ac7f0c3L, 0x77c2c07bL, 0xbc9e13deL, 0x3a0a6170L,
+	0xf156b2d5L, 0x03d6029bL, 0xc88ad13eL, 0x4e1ea390L, 0x85427035L,
+	0x9847408dL, 0x531b9328L, 0xd58fe186L, 0x1ed33223L, 0xef8580f6L,
+	0x24d95353L, 0xa24d21fdL, 0x6911f258L, 0x7414c2e0L, 0xbf481145L,
+	0x39dc63ebL, 0xf280b04eL, 0x07ac0536L, 0xccf0d693L, 0x4a64a43dL,
+	0x81387798L, 0x9c3d4720L, 0x57619485L, 0xd1f5e62bL, 0x1aa9358eL,
+	0xebff875bL, 0x20a354feL, 0xa6372650L, 0x6d6bf5f5L, 0x706ec54dL,
+	0xbb3216e8L, 0x3da66446L, 0xf6fab7e3L, 0x047a07adL, 0xcf26d408L,
+	0x49b2a6a6L, 0x82ee7503L, 0x9feb45bbL, 0x54b7961eL, 0xd223e4b0L,
+	0x197f3715L, 0xe82985c0L, 0x23755665L, 0xa5e124cbL, 0x6ebdf76eL,
+	0x73b8c7d6L, 0xb8e41473L, 0x3e7066ddL, 0xf52cb578L, 0x0f580a6cL,
+	0xc404d9c9L, 0x4290ab67L, 0x89cc78c2L, 0x94c9487aL, 0x5f959bdfL,
+	0xd901e971L, 0x125d3ad4L, 0xe30b8801L, 0x28575ba4L, 0xaec3290aL,
+	0x659ffaafL, 0x789aca17L, 0xb3c619b2L, 0x35526b1cL, 0xfe0eb8b9L,
+	0x0c8e08f7L, 0xc7d2db52L, 0x4146a9fcL, 0x8a1a7a59L, 0x971f4ae1L,
+	0x5c439944L, 0xdad7ebeaL, 0x118b384fL, 0xe0dd8a9aL, 0x2b81593fL,
+	0xad152b91L, 0x6649f834L, 0x7b4cc88cL, 0xb0101b29L, 0x36846987L,
+	0xfdd8ba22L, 0x08f40f5aL, 0xc3a8dcffL, 0x453cae51L, 0x8e607df4L,
+	0x93654d4cL, 0x58399ee9L, 0xdeadec47L, 0x15f13fe2L, 0xe4a78d37L,
+	0x2ffb5e92L, 0xa96f2c3cL, 0x6233ff99L, 0x7f36cf21L, 0xb46a1c84L,
+	0x32fe6e2aL, 0xf9a2bd8fL, 0x0b220dc1L, 0xc07ede64L, 0x46eaaccaL,
+	0x8db67f6fL, 0x90b34fd7L, 0x5bef9c72L, 0xdd7beedcL, 0x16273d79L,
+	0xe7718facL, 0x2c2d5c09L, 0xaab92ea7L, 0x61e5fd02L, 0x7ce0cdbaL,
+	0xb7bc1e1fL, 0x31286cb1L, 0xfa74bf14L, 0x1eb014d8L, 0xd5ecc77dL,
+	0x5378b5d3L, 0x98246676L, 0x852156ceL, 0x4e7d856bL, 0xc8e9f7c5L,
+	0x03b52460L, 0xf2e396b5L, 0x39bf4510L, 0xbf2b37beL, 0x7477e41bL,
+	0x6972d4a3L, 0xa22e0706L, 0x24ba75a8L, 0xefe6a60dL, 0x1d661643L,
+	0xd63ac5e6L, 0x50aeb748L, 0x9bf264edL, 0x86f75455L, 0x4dab87f0L,
+	0xcb3ff55eL, 0x006326fbL, 0xf135942eL, 0x3a69478bL, 0xbcfd3525L,
+	0x77a1e680L, 0x6aa4d638L, 0xa1f8059dL, 0x276c7733L, 0xec30a496L,
+	0x191c11eeL, 0xd240c24bL, 0x54d4b0e5L, 0x9f886340L, 0x828d53f8L,
+	0x49d1805dL, 0xcf45f2f3L, 0x04192156L, 0xf54f9383L, 0x3e134026L,
+	0xb8873288L, 0x73dbe12dL, 0x6eded195L, 0xa5820230L, 0x2316709eL,
+	0xe84aa33bL, 0x1aca1375L, 0xd196c0d0L, 0x5702b27eL, 0x9c5e61dbL,
+	0x815b5163L, 0x4a0782c6L, 0xcc93f068L, 0x07cf23cdL, 0xf6999118L,
+	0x3dc542bdL, 0xbb513013L, 0x700de3b6L, 0x6d08d30eL, 0xa65400abL,
+	0x20c07205L, 0xeb9ca1a0L, 0x11e81eb4L, 0xdab4cd11L, 0x5c20bfbfL,
+	0x977c6c1aL, 0x8a795ca2L, 0x41258f07L, 0xc7b1fda9L, 0x0ced2e0cL,
+	0xfdbb9cd9L, 0x36e74f7cL, 0xb0733dd2L, 0x7b2fee77L, 0x662adecfL,
+	0xad760d6aL, 0x2be27fc4L, 0xe0beac61L, 0x123e1c2fL, 0xd962cf8aL,
+	0x5ff6bd24L, 0x94aa6e81L, 0x89af5e39L, 0x42f38d9cL, 0xc467ff32L,
+	0x0f3b2c97L, 0xfe6d9e42L, 0x35314de7L, 0xb3a53f49L, 0x78f9ececL,
+	0x65fcdc54L, 0xaea00ff1L, 0x28347d5fL, 0xe368aefaL, 0x16441b82L,
+	0xdd18c827L, 0x5b8cba89L, 0x90d0692cL, 0x8dd55994L, 0x46898a31L,
+	0xc01df89fL, 0x0b412b3aL, 0xfa1799efL, 0x314b4a4aL, 0xb7df38e4L,
+	0x7c83eb41L, 0x6186dbf9L, 0xaada085cL, 0x2c4e7af2L, 0xe712a957L,
+	0x15921919L, 0xdececabcL, 0x585ab812L, 0x93066bb7L, 0x8e035b0fL,
+	0x455f88aaL, 0xc3cbfa04L, 0x089729a1L, 0xf9c19b74L, 0x329d48d1L,
+	0xb4093a7fL, 0x7f55e9daL, 0x6250d962L, 0xa90c0ac7L, 0x2f987869L,
+	0xe4c4abccL
+	},
+	{
+	0x00000000L, 0xa6770bb4L, 0x979f1129L, 0x31e81a9dL, 0xf44f2413L,
+	0x52382fa7L, 0x63d0353aL, 0xc5a73e8eL, 0x33ef4e67L, 0x959845d3L,
+	0xa4705f4eL, 0x020754faL, 0xc7a06a74L, 0x61d761c0L, 0x503f7b5dL,
+	0xf64870e9L, 0x67de9cceL, 0xc1a9977aL, 0xf0418de7L, 0x56368653L,
+	0x9391b8ddL, 0x35e6b369L, 0x040ea9f4L, 0xa279a240L, 0x5431d2a9L,
+	0xf246d91dL, 0xc3aec380L, 0x65d9c834L, 0xa07ef6baL, 0x0609fd0eL,
+	0x37e1e793L, 0x9196ec27L, 0xcfbd399cL, 0x69ca3228L, 0x582228b5L,
+	0xfe552301L, 0x3bf21d8fL, 0x9d85163bL, 0xac6d0ca6L, 0x0a1a0712L,
+	0xfc5277fbL, 0x5a257c4fL, 0x6bcd66d2L, 0xcdba6d66L, 0x081d53e8L,
+	0xae6a585cL, 0x9f8242c1L, 0x39f54975L, 0xa863a552L, 0x0e14aee6L,
+	0x3ffcb47bL, 0x998bbfcfL, 0x5c2c8141L, 0xfa5b8af5L, 0xcbb39068L,
+	0x6dc49bdcL, 0x9b8ceb35L, 0x3dfbe081L, 0x0c13fa1cL, 0xaa64f1a8L,
+	0x6fc3cf26L, 0xc9b4c492L, 0xf85cde0fL, 0x5e2bd5bbL, 0x440b7579L,
+	0xe27c7ecdL, 0xd3946450L, 0x75e36fe4L, 0xb044516aL, 0x16335adeL,
+	0x27db4043L, 0x81ac4bf7L, 0x77e43b1eL, 0xd19330aaL, 0xe07b2a37L,
+	0x460c2183L, 0x83ab1f0dL, 0x25dc14b9L, 0x14340e24L, 0xb2430590L,
+	0x23d5e9b7L, 0x85a2e203L, 0xb44af89eL, 0x123df32aL, 0xd79acda4L,
+	0x71edc610L, 0x4005dc8dL, 0xe672d739L, 0x103aa7d0L, 0xb64dac64L,
+	0x87a5b6f9L, 0x21d2bd4dL, 0xe47583c3L, 0x42028877L, 0x73ea92eaL,
+	0xd59d995eL, 0x8bb64ce5L, 0x2dc14751L, 0x1c295dccL, 0xba5e5678L,
+	0x7ff968f6L, 0xd98e6342L, 0xe86679dfL, 0x4e11726bL, 0xb8590282L,
+	0x1e2e0936L, 0x2fc613abL, 0x89b1181fL, 0x4c162691L, 0xea612d25L,
+	0xdb8937b8L, 0x7dfe3c0cL, 0xec68d02bL, 0x4a1fdb9fL, 0x7bf7c102L,
+	0xdd80cab6L, 0x1827f438L, 0xbe50ff8cL, 0x8fb8e511L, 0x29cfeea5L,
+	0xdf879e4cL, 0x79f095f8L, 0x48188f65L, 0xee6f84d1L, 0x2bc8ba5fL,
+	0x8dbfb1ebL, 0xbc57ab76L, 0x1a20a0c2L, 0x8816eaf2L, 0x2e61e146L,
+	0x1f89fbdbL, 0xb9fef06fL, 0x7c59cee1L, 0xda2ec555L, 0xebc6dfc8L,
+	0x4db1d47cL, 0xbbf9a495L, 0x1d8eaf21L, 0x2c66b5bcL, 0x8a11be08L,
+	0x4fb68086L, 0xe9c18b32L, 0xd82991afL, 0x7e5e9a1bL, 0xefc8763cL,
+	0x49bf7d88L, 0x78576715L, 0xde206ca1L, 0x1b87522fL, 0xbdf0599bL,
+	0x8c184306L, 0x2a6f48b2L, 0xdc27385bL, 0x7a5033efL, 0x4bb82972L,
+	0xedcf22c6L, 0x28681c48L, 0x8e1f17fcL, 0xbff70d61L, 0x198006d5L,
+	0x47abd36eL, 0xe1dcd8daL, 0xd034c247L, 0x7643c9f3L, 0xb3e4f77dL,
+	0x1593fcc9L, 0x247be654L, 0x820cede0L, 0x74449d09L, 0xd23396bdL,
+	0xe3db8c20L, 0x45ac8794L, 0x800bb91aL, 0x267cb2aeL, 0x1794a833L,
+	0xb1e3a387L, 0x20754fa0L, 0x86024414L, 0xb7ea5e89L, 0x119d553dL,
+	0xd43a6bb3L, 0x724d6007L, 0x43a57a9aL, 0xe5d2712eL, 0x139a01c7L,
+	0xb5ed0a73L, 0x840510eeL, 0x22721b5aL, 0xe7d525d4L, 0x41a22e60L,
+	0x704a34fdL, 0xd63d3f49L, 0xcc1d9f8bL, 0x6a6a943fL, 0x5b828ea2L,
+	0xfdf58516L, 0x3852bb98L, 0x9e25b02cL, 0xafcdaab1L, 0x09baa105L,
+	0xfff2d1ecL, 0x5985da58L, 0x686dc0c5L, 0xce1acb71L, 0x0bbdf5ffL,
+	0xadcafe4bL, 0x9c22e4d6L, 0x3a55ef62L, 0xabc30345L, 0x0db408f1L,
+	0x3c5c126cL, 0x9a2b19d8L, 0x5f8c2756L, 0xf9fb2ce2L, 0xc813367fL,
+	0x6e643dcbL, 0x982c4d22L, 0x3e5b4696L, 0x0fb35c0bL, 0xa9c457bfL,
+	0x6c636931L, 0xca146285L, 0xfbfc7818L, 0x5d8b73acL, 0x03a0a617L,
+	0xa5d7ada3L, 0x943fb73eL, 0x3248bc8aL, 0xf7ef8204L, 0x519889b0L,
+	0x6070932dL, 0xc6079899L, 0x304fe870L, 0x9638e3c4L, 0xa7d0f959L,
+	0x01a7f2edL, 0xc400cc63L, 0x6277c7d7L, 0x539fdd4aL, 0xf5e8d6feL,
+	0x647e3ad9L, 0xc209316dL, 0xf3e12bf0L, 0x55962044L, 0x90311ecaL,
+	0x3646157eL, 0x07ae0fe3L, 0xa1d90457L, 0x579174beL, 0xf1e67f0aL,
+	0xc00e6597L, 0x66796e23L, 0xa3de50adL, 0x05a95b19L, 0x34414184L,
+	0x92364a30L
+	},
+	{
+	0x00000000L, 0xccaa009eL, 0x4225077dL, 0x8e8f07e3L, 0x844a0efaL,
+	0x48e00e64L, 0xc66f0987L, 0x0ac50919L, 0xd3e51bb5L, 0x1f4f1b2bL,
+	0x91c01cc8L, 0x5d6a1c56L, 0x57af154fL, 0x9b0515d1L, 0x158a1232L,
+	0xd92012acL, 0x7cbb312bL, 0xb01131b5L, 0x3e9e3656L, 0xf23436c8L,
+	0xf8f13fd1L, 0x345b3f4fL, 0xbad438acL, 0x767e3832L, 0xaf5e2a9eL,
+	0x63f42a00L, 0xed7b2de3L, 0x21d12d7dL, 0x2b142464L, 0xe7be24faL,
+	0x69312319L, 0xa59b2387L, 0xf9766256L, 0x35dc62c8L, 0xbb53652bL,
+	0x77f965b5L, 0x7d3c6cacL, 0xb1966c32L, 0x3f196bd1L, 0xf3b36b4fL,
+	0x2a9379e3L, 0xe639797dL, 0x68b67e9eL, 0xa41c7e00L, 0xaed97719L,
+	0x62737787L, 0xecfc7064L, 0x205670faL, 0x85cd537dL, 0x496753e3L,
+	0xc7e85400L, 0x0b42549eL, 0x01875d87L, 0xcd2d5d19L, 0x43a25afaL,
+	0x8f085a64L, 0x562848c8L, 0x9a824856L, 0x140d4fb5L, 0xd8a74f2bL,
+	0xd2624632L, 0x1ec846acL, 0x9047414fL, 0x5ced41d1L, 0x299dc2edL,
+	0xe537c273L, 0x6bb8c590L, 0xa712c50eL, 0xadd7cc17L, 0x617dcc89L,
+	0xeff2cb6aL, 0x2358cbf4L, 0xfa78d958L, 0x36d2d9c6L, 0xb85dde25L,
+	0x74f7debbL, 0x7e32d7a2L, 0xb298d73cL, 0x3c17d0dfL, 0xf0bdd041L,
+	0x5526f3c6L, 0x998cf358L, 0x1703f4bbL, 0xdba9f425L, 0xd16cfd3cL,
+	0x1dc6fda2L, 0x9349fa41L, 0x5fe3fadfL, 0x86c3e873L, 0x4a69e8edL,
+	0xc4e6ef0eL, 0x084cef90L, 0x0289e689L, 0xce23e617L, 0x40ace1f4L,
+	0x8c06e16aL, 0xd0eba0bbL, 0x1c41a025L, 0x92cea7c6L, 0x5e64a758L,
+	0x54a1ae41L, 0x980baedfL, 0x1684a93cL, 0xda2ea9a2L, 0x030ebb0eL,
+	0xcfa4bb90L, 0x412bbc73L, 0x8d81bcedL, 0x8744b5f4L, 0x4beeb56aL,
+	0xc561b289L, 0x09cbb217L, 0xac509190L, 0x60fa910eL, 0xee7596edL,
+	0x22df9673L, 0x281a9f6aL, 0xe4b09ff4L, 0x6a3f9817L, 0xa6959889L,
+	0x7fb58a25L, 0xb31f8abbL, 0x3d908d58L, 0xf13a8dc6L, 0xfbff84dfL,
+	0x37558441L, 0xb9da83a2L, 0x7570833cL, 0x533b85daL, 0x9f918544L,
+	0x111e82a7L, 0xddb48239L, 0xd7718b20L, 0x1bdb8bbeL, 0x95548c5dL,
+	0x59fe8cc3L, 0x80de9e6fL, 0x4c749ef1L, 0xc2fb9912L, 0x0e51998cL,
+	0x04949095L, 0xc83e900bL, 0x46b197e8L, 0x8a1b9776L, 0x2f80b4f1L,
+	0xe32ab46fL, 0x6da5b38cL, 0xa10fb312L, 0xabcaba0bL, 0x6760ba95L,
+	0xe9efbd76L, 0x2545bde8L, 0xfc65af44L, 0x30cfafdaL, 0xbe40a839L,
+	0x72eaa8a7L, 0x782fa1beL, 0xb485a120L, 0x3a0aa6c3L, 0xf6a0a65dL,
+	0xaa4de78cL, 0x66e7e712L, 0xe868e0f1L, 0x24c2e06fL, 0x2e07e976L,
+	0xe2ade9e8L, 0x6c22ee0bL, 0xa088ee95L, 0x79a8fc39L, 0xb502fca7L,
+	0x3b8dfb44L, 0xf727fbdaL, 0xfde2f2c3L, 0x3148f25dL, 0xbfc7f5beL,
+	0x736df520L, 0xd6f6d6a7L, 0x1a5cd639L, 0x94d3d1daL, 0x5879d144L,
+	0x52bcd85dL, 0x9e16d8c3L, 0x1099df20L, 0xdc33dfbeL, 0x0513cd12L,
+	0xc9b9cd8cL, 0x4736ca6fL, 0x8b9ccaf1L, 0x8159c3e8L, 0x4df3c376L,
+	0xc37cc495L, 0x0fd6c40bL, 0x7aa64737L, 0xb60c47a9L, 0x3883404aL,
+	0xf42940d4L, 0xfeec49cdL, 0x32464953L, 0xbcc94eb0L, 0x70634e2eL,
+	0xa9435c82L, 0x65e95c1cL, 0xeb665bffL, 0x27cc5b61L, 0x2d095278L,
+	0xe1a352e6L, 0x6f2c5505L, 0xa386559bL, 0x061d761cL, 0xcab77682L,
+	0x44387161L, 0x889271ffL, 0x825778e6L, 0x4efd7878L, 0xc0727f9bL,
+	0x0cd87f05L, 0xd5f86da9L, 0x19526d37L, 0x97dd6ad4L, 0x5b776a4aL,
+	0x51b26353L, 0x9d1863cdL, 0x1397642eL, 0xdf3d64b0L, 0x83d02561L,
+	0x4f7a25ffL, 0xc1f5221cL, 0x0d5f2282L, 0x079a2b9bL, 0xcb302b05L,
+	0x45bf2ce6L, 0x89152c78L, 0x50353ed4L, 0x9c9f3e4aL, 0x121039a9L,
+	0xdeba3937L, 0xd47f302eL, 0x18d530b0L, 0x965a3753L, 0x5af037cdL,
+	0xff6b144aL, 0x33c114d4L, 0xbd4e1337L, 0x71e413a9L, 0x7b211ab0L,
+	0xb78b1a2eL, 0x39041dcdL, 0xf5ae1d53L, 0x2c8e0fffL, 0xe0240f61L,
+	0x6eab0882L, 0xa201081cL, 0xa8c40105L, 0x646e019bL, 0xeae10678L,
+	0x264b06e6L
+	}
+};
+
+static const word32 s_crc32cSlices[8][256] = {
+	{
+	0x00000000L, 0xf26b8303L, 0xe13b70f7L, 0x1350f3f4L, 0xc79a971fL,
+	0x35f1141cL, 0x26a1e7e8L, 0xd4ca64ebL, 0x8ad958cfL, 0x78b2dbccL,
+	0x6be22838L, 0x9989ab3bL, 0x4d43cfd0L, 0xbf284cd3L, 0xac78bf27L,
+	0x5e133c24L, 0x105ec76fL, 0xe235446cL, 0xf165b798L, 0x030e349bL,
+	0xd7c45070L, 0x25afd373L, 0x36ff2087L, 0xc494a384L, 0x9a879fa0L,
+	0x68ec1ca3L, 0x7bbcef57L, 0x89d76c54L, 0x5d1d08bfL, 0xaf768bbcL,
+	0xbc267848L, 0x4e4dfb4bL, 0x20bd8edeL, 0xd2d60dddL, 0xc186fe29L,
+	0x33ed7d2aL, 0xe72719c1L, 0x154c9ac2L, 0x061c6936L, 0xf477ea35L,
+	0xaa64d611L, 0x580f5512L, 0x4b5fa6e6L, 0xb93425e5L, 0x6dfe410eL,
+	0x9f95c20dL, 0x8cc531f9L, 0x7eaeb2faL, 0x30e349b1L, 0xc288cab2L,
+	0xd1d83946L, 0x23b3ba45L, 0xf779deaeL, 0x05125dadL, 0x1642ae59L,
+	0xe4292d5aL, 0xba3a117eL, 0x4851927dL, 0x5b016189L, 0xa96ae28aL,
+	0x7da08661L, 0x8fcb0562L, 0x9c9bf696L, 0x6ef07595L, 0x417b1dbcL,
+	0xb3109ebfL, 0xa0406d4bL, 0x522bee48L, 0x86e18aa3L, 0x748a09a0L,
+	0x67dafa54L, 0x95b17957L, 0xcba24573L, 0x39c9c670L, 0x2a993584L,
+	0xd8f2b687L, 0x0c38d26cL, 0xfe53516fL, 0xed03a29bL, 0x1f682198L,
+	0x5125dad3L, 0xa34e59d0L, 0xb01eaa24L, 0x42752927L, 0x96bf4dccL,
+	0x64d4cecfL, 0x77843d3bL, 0x85efbe38L, 0xdbfc821cL, 0x2997011fL,
+	0x3ac7f2ebL, 0xc8ac71e8L, 0x1c661503L, 0xee0d9600L, 0xfd5d65f4L,
+	0x0f36e6f7L, 0x61c69362L, 0x93ad1061L, 0x80fde395L, 0x72966096L,
+	0xa65c047dL, 0x5437877eL, 0x4767748aL, 0xb50cf789L, 0xeb1fcbadL,
+	0x197448aeL, 0x0a24bb5aL, 0xf84f3859L, 0x2c855cb2L, 0xdeeedfb1L,
+	0xcdbe2c45L, 0x3fd5af46L, 0x7198540dL, 0x83f3d70eL, 0x90a324faL,
+	0x62c8a7f9L, 0xb602c312L, 0x44694011L, 0x5739b3e5L, 0xa55230e6L,
+	0xfb410cc2L, 0x092a8fc1L, 0x1a7a7c35L, 0xe811ff36L, 0x3cdb9bddL,
+	0xceb018deL, 0xdde0eb2aL, 0x2f8b6829L, 0x82f63b78L, 0x709db87bL,
+	0x63cd4b8fL, 0x91a6c88cL, 0x456cac67L, 0xb7072f64L, 0xa457dc90L,
+	0x563c5f93L, 0x082f63b7L, 0xfa44e0b4L, 0xe9141340L, 0x1b7f9043L,
+	0xcfb5f4a8L, 0x3dde77abL, 0x2e8e845fL, 0xdce5075cL, 0x92a8fc17L,
+	0x60c37f14L, 0x73938ce0L, 0x81f80fe3L, 0x55326b08L, 0xa759e80bL,
+	0xb4091bffL, 0x466298fcL, 0x1871a4d8L, 0xea1a27dbL, 0xf94ad42fL,
+	0x0b21572cL, 0xdfeb33c7L, 0x2d80b0c4L, 0x3ed04330L, 0xccbbc033L,
+	0xa24bb5a6L, 0x502036a5L, 0x4370c551L, 0xb11b4652L, 0x65d122b9L,
+	0x97baa1baL, 0x84ea524eL, 0x7681d14dL, 0x2892ed69L, 0xdaf96e6aL,
+	0xc9a99d9eL, 0x3bc21e9dL, 0xef087a76L, 0x1d63f975L, 0x0e330a81L,
+	0xfc588982L, 0xb21572c9L, 0x407ef1caL, 0x532e023eL, 0xa145813dL,
+	0x758fe5d6L, 0x87e466d5L, 0x94b49521L, 0x66df1622L, 0x38cc2a06L,
+	0xcaa7a905L, 0xd9f75af1L, 0x2b9cd9f2L, 0xff56bd19L, 0x0d3d3e1aL,
+	0x1e6dcdeeL, 0xec064eedL, 0xc38d26c4L, 0x31e6a5c7L, 0x22b65633L,
+	0xd0ddd530L, 0x0417b1dbL, 0xf67c32d8L, 0xe52cc12cL, 0x1747422fL,
+	0x49547e0bL, 0xbb3ffd08L, 0xa86f0efcL, 0x5a048dffL, 0x8ecee914L,
+	0x7ca56a17L, 0x6ff599e3L, 0x9d9e1ae0L, 0xd3d3e1abL, 0x21b862a8L,
+	0x32e8915cL, 0xc083125fL, 0x144976b4L, 0xe622f5b7L, 0xf5720643L,
+	0x07198540L, 0x590ab964L, 0xab613a67L, 0xb831c993L, 0x4a5a4a90L,
+	0x9e902e7bL, 0x6cfbad78L, 0x7fab5e8cL, 0x8dc0dd8fL, 0xe330a81aL,
+	0x115b2b19L, 0x020bd8edL, 0xf0605beeL, 0x24aa3f05L, 0xd6c1bc06L,
+	0xc5914ff2L, 0x37faccf1L, 0x69e9f0d5L, 0x9b8273d6L, 0x88d28022L,
+	0x7ab90321L, 0xae7367caL, 0x5c18e4c9L, 0x4f48173dL, 0xbd23943eL,
+	0xf36e6f75L, 0x0105ec76L, 0x12551f82L, 0xe03e9c81L, 0x34f4f86aL,
+	0xc69f7b69L, 0xd5cf889dL, 0x27a40b9eL, 0x79b737baL, 0x8bdcb4b9L,
+	0x988c474dL, 0x6ae7c44eL, 0xbe2da0a5L, 0x4c4623a6L, 0x5f16d052L,
+	0xad7d5351L
+	},
+	{
+	0x00000000L, 0x13a29877L, 0x274530eeL, 0x34e7a899L, 0x4e8a61dcL,
+	0x5d28f9abL, 0x69cf5132L, 0x7a6dc945L, 0x9d14c3b8L, 0x8eb65bcfL,
+	0xba51f356L, 0xa9f36b21L, 0xd39ea264L, 0xc03c3a13L, 0xf4db928aL,
+	0xe7790afdL, 0x3fc5f181L, 0x2c6769f6L, 0x1880c16fL, 0x0b225918L,
+	0x714f905dL, 0x62ed082aL, 0x560aa0b3L, 0x45a838c4L, 0xa2d13239L,
+	0xb173aa4eL, 0x859402d7L, 0x96369aa0L, 0xec5b53e5L, 0xfff9cb92L,
+	0xcb1e630bL, 0xd8bcfb7cL, 0x7f8be302L, 0x6c297b75L, 0x58ced3ecL,
+	0x4b6c4b9bL, 0x310182deL, 0x22a31aa9L, 0x1644b230L, 0x05e62a47L,
+	0xe29f20baL, 0xf13db8cdL, 0xc5da1054L, 0xd6788823L, 0xac154166L,
+	0xbfb7d911L, 0x8b507188L, 0x98f2e9ffL, 0x404e1283L, 0x53ec8af4L,
+	0x670b226dL, 0x74a9ba1aL, 0x0ec4735fL, 0x1d66eb28L, 0x298143b1L,
+	0x3a23dbc6L, 0xdd5ad13bL, 0xcef8494cL, 0xfa1fe1d5L, 0xe9bd79a2L,
+	0x93d0b0e7L, 0x80722890L, 0xb4958009L, 0xa737187eL, 0xff17c604L,
+	0xecb55e73L, 0xd852f6eaL, 0xcbf06e9dL, 0xb19da7d8L, 0xa23f3fafL,
+	0x96d89736L, 0x857a0f41L, 0x620305bcL, 0x71a19dcbL, 0x45463552L,
+	0x56e4ad25L, 0x2c896460L, 0x3f2bfc17L, 0x0bcc548eL, 0x186eccf9L,
+	0xc0d23785L, 0xd370aff2L, 0xe797076bL, 0xf4359f1cL, 0x8e585659L,
+	0x9dface2eL, 0xa91d66b7L, 0xbabffec0L, 0x5dc6f43dL, 0x4e646c4aL,
+	0x7a83c4d3L, 0x69215ca4L, 0x134c95e1L, 0x00ee0d96L, 0x3409a50fL,
+	0x27ab3d78L, 0x809c2506L, 0x933ebd71L, 0xa7d915e8L, 0xb47b8d9fL,
+	0xce1644daL, 0xddb4dcadL, 0xe9537434L, 0xfaf1ec43L, 0x1d88e6beL,
+	0x0e2a7ec9L, 0x3acdd650L, 0x296f4e27L, 0x53028762L, 0x40a01f15L,
+	0x7447b78cL, 0x67e52ffbL, 0xbf59d487L, 0xacfb4cf0L, 0x981ce469L,
+	0x8bbe7c1eL, 0xf1d3b55bL, 0xe2712d2cL, 0xd69685b5L, 0xc5341dc2L,
+	0x224d173fL, 0x31ef8f48L, 0x050827d1L, 0x16aabfa6L, 0x6cc776e3L,
+	0x7f65ee94L, 0x4b82460dL, 0x5820de7aL, 0xfbc3faf9L, 0xe861628eL,
+	0xdc86ca17L, 0xcf245260L, 0xb5499b25L, 0xa6eb0352L, 0x920cabcbL,
+	0x81ae33bcL, 0x66d73941L, 0x7575a136L, 0x419209afL, 0x523091d8L,
+	0x285d589dL, 0x3bffc0eaL, 0x0f186873L, 0x1cbaf004L, 0xc4060b78L,
+	0xd7a4930fL, 0xe3433b96L, 0xf0e1a3e1L, 0x8a8c6aa4L, 0x992ef2d3L,
+	0xadc95a4aL, 0xbe6bc23dL, 0x5912c8c0L, 0x4ab050b7L, 0x7e57f82eL,
+	0x6df56059L, 0x1798a91cL, 0x043a316bL, 0x30dd99f2L, 0x237f0185L,
+	0x844819fbL, 0x97ea818cL, 0xa30d2915L, 0xb0afb162L, 0xcac27827L,
+	0xd960e050L, 0xed8748c9L, 0xfe25d0beL, 0x195cda43L, 0x0afe4234L,
+	0x3e19eaadL, 0x2dbb72daL, 0x57d6bb9fL, 0x447423e8L, 0x70938b71L,
+	0x63311306L, 0xbb8de87aL, 0xa82f700dL, 0x9cc8d894L, 0x8f6a40e3L,
+	0xf50789a6L, 0xe6a511d1L, 0xd242b948L, 0xc1e0213fL, 0x26992bc2L,
+	0x353bb3b5L, 0x01dc1b2cL, 0x127e835bL, 0x68134a1eL, 0x7bb1d269L,
+	0x4f567af0L, 0x5cf4e287L, 0x04d43cfdL, 0x1776a48aL, 0x23910c13L,
+	0x30339464L, 0x4a5e5d21L, 0x59fcc556L, 0x6d1b6dcfL, 0x7eb9f5b8L,
+	0x99c0ff45L, 0x8a626732L, 0xbe85cfabL, 0xad2757dcL, 0xd74a9e99L,
+	0xc4e806eeL, 0xf00fae77L, 0xe3ad3600L, 0x3b11cd7cL, 0x28b3550bL,
+	0x1c54fd92L, 0x0ff665e5L, 0x759baca0L, 0x663934d7L, 0x52de9c4eL,
+	0x417c0439L, 0xa6050ec4L, 0xb5a796b3L, 0x81403e2aL, 0x92e2a65dL,
+	0xe88f6f18L, 0xfb2df76fL, 0xcfca5ff6L, 0xdc68c781L, 0x7b5fdfffL,
+	0x68fd4788L, 0x5c1aef11L, 0x4fb87766L, 0x35d5be23L, 0x26772654L,
+	0x12908ecdL, 0x013216baL, 0xe64b1c47L, 0xf5e98430L, 0xc10e2ca9L,
+	0xd2acb4deL, 0xa8c17d9bL, 0xbb63e5ecL, 0x8f844d75L, 0x9c26d502L,
+	0x449a2e7eL, 0x5738b609L, 0x63df1e90L, 0x707d86e7L, 0x0a104fa2L,
+	0x19b2d7d5L, 0x2d557f4cL, 0x3ef7e73bL, 0xd98eedc6L, 0xca2c75b1L,
+	0xfecbdd28L, 0xed69455fL, 0x97048c1aL, 0x84a6146dL, 0xb041bcf4L,
+	0xa3e32483L
+	},
+	{
+	0x00000000L, 0xa541927eL, 0x4f6f520dL, 0xea2ec073L, 0x9edea41aL,
+	0x3b9f3664L, 0xd1b1f617L, 0x74f06469L, 0x38513ec5L, 0x9d10acbbL,
+	0x773e6cc8L, 0xd27ffeb6L, 0xa68f9adfL, 0x03ce08a1L, 0xe9e0c8d2L,
+	0x4ca15aacL, 0x70a27d8aL, 0xd5e3eff4L, 0x3fcd2f87L, 0x9a8cbdf9L,
+	0xee7cd990L, 0x4b3d4beeL, 0xa1138b9dL, 0x045219e3L, 0x48f3434fL,
+	0xedb2d131L, 0x079c1142L, 0xa2dd833cL, 0xd62de755L, 0x736c752bL,
+	0x9942b558L, 0x3c032726L, 0xe144fb14L, 0x4405696aL, 0xae2ba919L,
+	0x0b6a3b67L, 0x7f9a5f0eL, 0xdadbcd70L, 0x30f50d03L, 0x95b49f7dL,
+	0xd915c5d1L, 0x7c5457afL, 0x967a97dcL, 0x333b05a2L, 0x47cb61cbL,
+	0xe28af3b5L, 0x08a433c6L, 0xade5a1b8L, 0x91e6869eL, 0x34a714e0L,
+	0xde89d493L, 0x7bc846edL, 0x0f382284L, 0xaa79b0faL, 0x40577089L,
+	0xe516e2f7L, 0xa9b7b85bL, 0x0cf62a25L, 0xe6d8ea56L, 0x43997828L,
+	0x37691c41L, 0x92288e3fL, 0x78064e4cL, 0xdd47dc32L, 0xc76580d9L,
+	0x622412a7L, 0x880ad2d4L, 0x2d4b40aaL, 0x59bb24c3L, 0xfcfab6bdL,
+	0x16d476ceL, 0xb395e4b0L, 0xff34be1cL, 0x5a752c62L, 0xb05bec11L,
+	0x151a7e6fL, 0x61ea1a06L, 0xc4ab8878L, 0x2e85480bL, 0x8bc4da75L,
+	0xb7c7fd53L, 0x12866f2dL, 0xf8a8af5eL, 0x5de93d20L, 0x29195949L,
+	0x8c58cb37L, 0x66760b44L, 0xc337993aL, 0x8f96c396L, 0x2ad751e8L,
+	0xc0f9919bL, 0x65b803e5L, 0x1148678cL, 0xb409f5f2L, 0x5e273581L,
+	0xfb66a7ffL, 0x26217bcdL, 0x8360e9b3L, 0x694e29c0L, 0xcc0fbbbeL,
+	0xb8ffdfd7L, 0x1dbe4da9L, 0xf7908ddaL, 0x52d11fa4L, 0x1e704508L,
+	0xbb31d776L, 0x511f1705L, 0xf45e857bL, 0x80aee112L, 0x25ef736cL,
+	0xcfc1b31fL, 0x6a802161L, 0x56830647L, 0xf3c29439L, 0x19ec544aL,
+	0xbcadc634L, 0xc85da25dL, 0x6d1c3023L, 0x8732f050L, 0x2273622eL,
+	0x6ed23882L, 0xcb93aafcL, 0x21bd6a8fL, 0x84fcf8f1L, 0xf00c9c98L,
+	0x554d0ee6L, 0xbf63ce95L, 0x1a225cebL, 0x8b277743L, 0x2e66e53dL,
+	0xc448254eL, 0x6109b730L, 0x15f9d359L, 0xb0b84127L, 0x5a968154L,
+	0xffd7132aL, 0xb3764986L, 0x1637dbf8L, 0xfc191b8bL, 0x595889f5L,
+	0x2da8ed9cL, 0x88e97fe2L, 0x62c7bf91L, 0xc7862defL, 0xfb850ac9L,
+	0x5ec498b7L, 0xb4ea58c4L, 0x11abcabaL, 0x655baed3L, 0xc01a3cadL,
+	0x2a34fcdeL, 0x8f756ea0L, 0xc3d4340cL, 0x6695a672L, 0x8cbb6601L,
+	0x29faf47fL, 0x5d0a9016L, 0xf84b0268L, 0x1265c21bL, 0xb7245065L,
+	0x6a638c57L, 0xcf221e29L, 0x250cde5aL, 0x804d4c24L, 0xf4bd284dL,
+	0x51fcba33L, 0xbbd27a40L, 0x1e93e83eL, 0x5232b292L, 0xf77320ecL,
+	0x1d5de09fL, 0xb81c72e1L, 0xccec1688L, 0x69ad84f6L, 0x83834485L,
+	0x26c2d6fbL, 0x1ac1f1ddL, 0xbf8063a3L, 0x55aea3d0L, 0xf0ef31aeL,
+	0x841f55c7L, 0x215ec7b9L, 0xcb7007caL, 0x6e3195b4L, 0x2290cf18L,
+	0x87d15d66L, 0x6dff9d15L, 0xc8be0f6bL, 0xbc4e6b02L, 0x190ff97cL,
+	0xf321390fL, 0x5660ab71L, 0x4c42f79aL, 0xe90365e4L, 0x032da597L,
+	0xa66c37e9L, 0xd29c5380L, 0x77ddc1feL, 0x9df3018dL, 0x38b293f3L,
+	0x7413c95fL, 0xd1525b21L, 0x3b7c9b52L, 0x9e3d092cL, 0xeacd6d45L,
+	0x4f8cff3bL, 0xa5a23f48L, 0x00e3ad36L, 0x3ce08a10L, 0x99a1186eL,
+	0x738fd81dL, 0xd6ce4a63L, 0xa23e2e0aL, 0x077fbc74L, 0xed517c07L,
+	0x4810ee79L, 0x04b1b4d5L, 0xa1f026abL, 0x4bdee6d8L, 0xee9f74a6L,
+	0x9a6f10cfL, 0x3f2e82b1L, 0xd50042c2L, 0x7041d0bcL, 0xad060c8eL,
+	0x08479ef0L, 0xe2695e83L, 0x4728ccfdL, 0x33d8a894L, 0x96993aeaL,
+	0x7cb7fa99L, 0xd9f668e7L, 0x9557324bL, 0x3016a035L, 0xda386046L,
+	0x7f79f238L, 0x0b899651L, 0xaec8042fL, 0x44e6c45cL, 0xe1a75622L,
+	0xdda47104L, 0x78e5e37aL, 0x92cb2309L, 0x378ab177L, 0x437ad51eL,
+	0xe63b4760L, 0x0c158713L, 0xa954156dL, 0xe5f54fc1L, 0x40b4ddbfL,
+	0xaa9a1dccL, 0x0fdb8fb2L, 0x7b2bebdbL, 0xde6a79a5L, 0x3444b9d6L,
+	0x91052ba8L
+	},
+	{
+	0x00000000L, 0xdd45aab8L, 0xbf672381L, 0x62228939L, 0x7b2231f3L,
+	0xa6679b4bL, 0xc4451272L, 0x1900b8caL, 0xf64463e6L, 0x2b01c95eL,
+	0x49234067L, 0x9466eadfL, 0x8d665215L, 0x5023f8adL, 0x32017194L,
+	0xef44db2cL, 0xe964b13dL, 0x34211b85L, 0x560392bcL, 0x8b463804L,
+	0x924680ceL, 0x4f032a76L, 0x2d21a34fL, 0xf06409f7L, 0x1f20d2dbL,
+	0xc2657863L, 0xa047f15aL, 0x7d025be2L, 0x6402e328L, 0xb9474990L,
+	0xdb65c0a9L, 0x06206a11L, 0xd725148bL, 0x0a60be33L, 0x6842370aL,
+	0xb5079db2L, 0xac072578L, 0x71428fc0L, 0x136006f9L, 0xce25ac41L,
+	0x2161776dL, 0xfc24ddd5L, 0x9e0654ecL, 0x4343fe54L, 0x5a43469eL,
+	0x8706ec26L, 0xe524651fL, 0x3861cfa7L, 0x3e41a5b6L, 0xe3040f0eL,
+	0x81268637L, 0x5c632c8fL, 0x45639445L, 0x98263efdL, 0xfa04b7c4L,
+	0x27411d7cL, 0xc805c650L, 0x15406ce8L, 0x7762e5d1L, 0xaa274f69L,
+	0xb327f7a3L, 0x6e625d1bL, 0x0c40d422L, 0xd1057e9aL, 0xaba65fe7L,
+	0x76e3f55fL, 0x14c17c66L, 0xc984d6deL, 0xd0846e14L, 0x0dc1c4acL,
+	0x6fe34d95L, 0xb2a6e72dL, 0x5de23c01L, 0x80a796b9L, 0xe2851f80L,
+	0x3fc0b538L, 0x26c00df2L, 0xfb85a74aL, 0x99a72e73L, 0x44e284cbL,
+	0x42c2eedaL, 0x9f874462L, 0xfda5cd5bL, 0x20e067e3L, 0x39e0df29L,
+	0xe4a57591L, 0x8687fca8L, 0x5bc25610L, 0xb4868d3cL, 0x69c32784L,
+	0x0be1aebdL, 0xd6a40405L, 0xcfa4bccfL, 0x12e11677L, 0x70c39f4eL,
+	0xad8635f6L, 0x7c834b6cL, 0xa1c6e1d4L, 0xc3e468edL, 0x1ea1c255L,
+	0x07a17a9fL, 0xdae4d027L, 0xb8c6591eL, 0x6583f3a6L, 0x8ac7288aL,
+	0x57828232L, 0x35a00b0bL, 0xe8e5a1b3L, 0xf1e51979L, 0x2ca0b3c1L,
+	0x4e823af8L, 0x93c79040L, 0x95e7fa51L, 0x48a250e9L, 0x2a80d9d0L,
+	0xf7c57368L, 0xeec5cba2L, 0x3380611aL, 0x51a2e823L, 0x8ce7429bL,
+	0x63a399b7L, 0xbee6330fL, 0xdcc4ba36L, 0x0181108eL, 0x1881a844L,
+	0xc5c402fcL, 0xa7e68bc5L, 0x7aa3217dL, 0x52a0c93fL, 0x8fe56387L,
+	0xedc7eabeL, 0x30824006L, 0x2982f8ccL, 0xf4c75274L, 0x96e5db4dL,
+	0x4ba071f5L, 0xa4e4aad9L, 0x79a10061L, 0x1b838958L, 0xc6c623e0L,
+	0xdfc69b2aL, 0x02833192L, 0x60a1b8abL, 0xbde41213L, 0xbbc47802L,
+	0x6681d2baL, 0x04a35b83L, 0xd9e6f13bL, 0xc0e649f1L, 0x1da3e349L,
+	0x7f816a70L, 0xa2c4c0c8L, 0x4d801be4L, 0x90c5b15cL, 0xf2e73865L,
+	0x2fa292ddL, 0x36a22a17L, 0xebe780afL, 0x89c50996L, 0x5480a32eL,
+	0x8585ddb4L, 0x58c0770cL, 0x3ae2fe35L, 0xe7a7548dL, 0xfea7ec47L,
+	0x23e246ffL, 0x41c0cfc6L, 0x9c85657eL, 0x73c1be52L, 0xae8414eaL,
+	0xcca69dd3L, 0x11e3376bL, 0x08e38fa1L, 0xd5a62519L, 0xb784ac20L,
+	0x6ac10698L, 0x6ce16c89L, 0xb1a4c631L, 0xd3864f08L, 0x0ec3e5b0L,
+	0x17c35d7aL, 0xca86f7c2L, 0xa8a47efbL, 0x75e1d443L, 0x9aa50f6fL,
+	0x47e0a5d7L, 0x25c22ceeL, 0xf8878656L, 0xe1873e9cL, 0x3cc29424L,
+	0x5ee01d1dL, 0x83a5b7a5L, 0xf90696d8L, 0x24433c60L, 0x4661b559L,
+	0x9b241fe1L, 0x8224a72bL, 0x5f610d93L, 0x3d4384aaL, 0xe0062e12L,
+	0x0f42f53eL, 0xd2075f86L, 0xb025d6bfL, 0x6d607c07L, 0x7460c4cdL,
+	0xa9256e75L, 0xcb07e74cL, 0x16424df4L, 0x106227e5L, 0xcd278d5dL,
+	0xaf050464L, 0x7240aedcL, 0x6b401616L, 0xb605bcaeL, 0xd4273597L,
+	0x09629f2fL, 0xe6264403L, 0x3b63eebbL, 0x59416782L, 0x8404cd3aL,
+	0x9d0475f0L, 0x4041df48L, 0x22635671L, 0xff26fcc9L, 0x2e238253L,
+	0xf36628ebL, 0x9144a1d2L, 0x4c010b6aL, 0x5501b3a0L, 0x88441918L,
+	0xea669021L, 0x37233a99L, 0xd867e1b5L, 0x05224b0dL, 0x6700c234L,
+	0xba45688cL, 0xa345d046L, 0x7e007afeL, 0x1c22f3c7L, 0xc167597fL,
+	0xc747336eL, 0x1a0299d6L, 0x782010efL, 0xa565ba57L, 0xbc65029dL,
+	0x6120a825L, 0x0302211cL, 0xde478ba4L, 0x31035088L, 0xec46fa30L,
+	0x8e647309L, 0x5321d9b1L, 0x4a21617bL, 0x9764cbc3L, 0xf54642faL,
+	0x2803e842L
+	},
+	{
+	0x00000000L, 0x38116facL, 0x7022df58L, 0x4833b0f4L, 0xe045beb0L,
+	0xd854d11cL, 0x906761e8L, 0xa8760e44L, 0xc5670b91L, 0xfd76643dL,
+	0xb545d4c9L, 0x8d54bb65L, 0x2522b521L, 0x1d33da8dL, 0x55006a79L,
+	0x6d1105d5L, 0x8f2261d3L, 0xb7330e7fL, 0xff00be8bL, 0xc711d127L,
+	0x6f67df63L, 0x5776b0cfL, 0x1f45003bL, 0x27546f97L, 0x4a456a42L,
+	0x725405eeL, 0x3a67b51aL, 0x0276dab6L, 0xaa00d4f2L, 0x9211bb5eL,
+	0xda220baaL, 0xe2336406L, 0x1ba8b557L, 0x23b9dafbL, 0x6b8a6a0fL,
+	0x539b05a3L, 0xfbed0be7L, 0xc3fc644bL, 0x8bcfd4bfL, 0xb3debb13L,
+	0xdecfbec6L, 0xe6ded16aL, 0xaeed619eL, 0x96fc0e32L, 0x3e8a0076L,
+	0x069b6fdaL, 0x4ea8df2eL, 0x76b9b082L, 0x948ad484L, 0xac9bbb28L,
+	0xe4a80bdcL, 0xdcb96470L, 0x74cf6a34L, 0x4cde0598L, 0x04edb56cL,
+	0x3cfcdac0L, 0x51eddf15L, 0x69fcb0b9L, 0x21cf004dL, 0x19de6fe1L,
+	0xb1a861a5L, 0x89b90e09L, 0xc18abefdL, 0xf99bd151L, 0x37516aaeL,
+	0x0f400502L, 0x4773b5f6L, 0x7f62da5aL, 0xd714d41eL, 0xef05bbb2L,
+	0xa7360b46L, 0x9f2764eaL, 0xf236613fL, 0xca270e93L, 0x8214be67L,
+	0xba05d1cbL, 0x1273df8fL, 0x2a62b023L, 0x625100d7L, 0x5a406f7bL,
+	0xb8730b7dL, 0x806264d1L, 0xc851d425L, 0xf040bb89L, 0x5836b5cdL,
+	0x6027da61L, 0x28146a95L, 0x10050539L, 0x7d1400ecL, 0x45056f40L,
+	0x0d36dfb4L, 0x3527b018L, 0x9d51be5cL, 0xa540d1f0L, 0xed736104L,
+	0xd5620ea8L, 0x2cf9dff9L, 0x14e8b055L, 0x5cdb00a1L, 0x64ca6f0dL,
+	0xccbc6149L, 0xf4ad0ee5L, 0xbc9ebe11L, 0x848fd1bdL, 0xe99ed468L,
+	0xd18fbbc4L, 0x99bc0b30L, 0xa1ad649cL, 0x09db6ad8L, 0x31ca0574L,
+	0x79f9b580L, 0x41e8da2cL, 0xa3dbbe2aL, 0x9bcad186L, 0xd3f96172L,
+	0xebe80edeL, 0x439e009aL, 0x7b8f6f36L, 0x33bcdfc2L, 0x0badb06eL,
+	0x66bcb5bbL, 0x5eadda17L, 0x169e6ae3L, 0x2e8f054fL, 0x86f90b0bL,
+	0xbee864a7L, 0xf6dbd453L, 0xcecabbffL, 0x6ea2d55cL, 0x56b3baf0L,
+	0x1e800a04L, 0x269165a8L, 0x8ee76becL, 0xb6f60440L, 0xfec5b4b4L,
+	0xc6d4db18L, 0xabc5decdL, 0x93d4b161L, 0xdbe70195L, 0xe3f66e39L,
+	0x4b80607dL, 0x73910fd1L, 0x3ba2bf25L, 0x03b3d089L, 0xe180b48fL,
+	0xd991db23L, 0x91a26bd7L, 0xa9b3047bL, 0x01c50a3fL, 0x39d46593L,
+	0x71e7d567L, 0x49f6bacbL, 0x24e7bf1eL, 0x1cf6d0b2L, 0x54c56046L,
+	0x6cd40feaL, 0xc4a201aeL, 0xfcb36e02L, 0xb480def6L, 0x8c91b15aL,
+	0x750a600bL, 0x4d1b0fa7L, 0x0528bf53L, 0x3d39d0ffL, 0x954fdebbL,
+	0xad5eb117L, 0xe56d01e3L, 0xdd7c6e4fL, 0xb06d6b9aL, 0x887c0436L,
+	0xc04fb4c2L, 0xf85edb6eL, 0x5028d52aL, 0x6839ba86L, 0x200a0a72L,
+	0x181b65deL, 0xfa2801d8L, 0xc2396e74L, 0x8a0ade80L, 0xb21bb12cL,
+	0x1a6dbf68L, 0x227cd0c4L, 0x6a4f6030L, 0x525e0f9cL, 0x3f4f0a49L,
+	0x075e65e5L, 0x4f6dd511L, 0x777cbabdL, 0xdf0ab4f9L, 0xe71bdb55L,
+	0xaf286ba1L, 0x9739040dL, 0x59f3bff2L, 0x61e2d05eL, 0x29d160aaL,
+	0x11c00f06L, 0xb9b60142L, 0x81a76eeeL, 0xc994de1aL, 0xf185b1b6L,
+	0x9c94b463L, 0xa485dbcfL, 0xecb66b3bL, 0xd4a70497L, 0x7cd10ad3L,
+	0x44c0657fL, 0x0cf3d58bL, 0x34e2ba27L, 0xd6d1de21L, 0xeec0b18dL,
+	0xa6f30179L, 0x9ee26ed5L, 0x36946091L, 0x0e850f3dL, 0x46b6bfc9L,
+	0x7ea7d065L, 0x13b6d5b0L, 0x2ba7ba1cL, 0x63940ae8L, 0x5b856544L,
+	0xf3f36b00L, 0xcbe204acL, 0x83d1b458L, 0xbbc0dbf4L, 0x425b0aa5L,
+	0x7a4a6509L, 0x3279d5fdL, 0x0a68ba51L, 0xa21eb415L, 0x9a0fdbb9L,
+	0xd23c6b4dL, 0xea2d04e1L, 0x873c0134L, 0xbf2d6e98L, 0xf71ede6cL,
+	0xcf0fb1c0L, 0x6779bf84L, 0x5f68d028L, 0x175b60dcL, 0x2f4a0f70L,
+	0xcd796b76L, 0xf56804daL, 0xbd5bb42eL, 0x854adb82L, 0x2d3cd5c6L,
+	0x152dba6aL, 0x5d1e0a9eL, 0x650f6532L, 0x081e60e7L, 0x300f0f4bL,
+	0x783cbfbfL, 0x402dd013L, 0xe85bde57L, 0xd04ab1fbL, 0x9879010fL,
+	0xa0686ea3L
+	},
+	{
+	0x00000000L, 0xef306b19L, 0xdb8ca0c3L, 0x34bccbdaL, 0xb2f53777L,
+	0x5dc55c6eL, 0x697997b4L, 0x8649fcadL, 0x6006181fL, 0x8f367306L,
+	0xbb8ab8dcL, 0x54bad3c5L, 0xd2f32f68L, 0x3dc34471L, 0x097f8fabL,
+	0xe64fe4b2L, 0xc00c303eL, 0x2f3c5b27L, 0x1b8090fdL, 0xf4b0fbe4L,
+	0x72f90749L, 0x9dc96c50L, 0xa975a78aL, 0x4645cc93L, 0xa00a2821L,
+	0x4f3a4338L, 0x7b8688e2L, 0x94b6e3fbL, 0x12ff1f56L, 0xfdcf744fL,
+	0xc973bf95L, 0x2643d48cL, 0x85f4168dL, 0x6ac47d94L, 0x5e78b64eL,
+	0xb148dd57L, 0x370121faL, 0xd8314ae3L, 0xec8d8139L, 0x03bdea20L,
+	0xe5f20e92L, 0x0ac2658bL, 0x3e7eae51L, 0xd14ec548L, 0x570739e5L,
+	0xb83752fcL, 0x8c8b9926L, 0x63bbf23fL, 0x45f826b3L, 0xaac84daaL,
+	0x9e748670L, 0x7144ed69L, 0xf70d11c4L, 0x183d7addL, 0x2c81b107L,
+	0xc3b1da1eL, 0x25fe3eacL, 0xcace55b5L, 0xfe729e6fL, 0x1142f576L,
+	0x970b09dbL, 0x783b62c2L, 0x4c87a918L, 0xa3b7c201L, 0x0e045bebL,
+	0xe13430f2L, 0xd588fb28L, 0x3ab89031L, 0xbcf16c9cL, 0x53c10785L,
+	0x677dcc5fL, 0x884da746L, 0x6e0243f4L, 0x813228edL, 0xb58ee337L,
+	0x5abe882eL, 0xdcf77483L, 0x33c71f9aL, 0x077bd440L, 0xe84bbf59L,
+	0xce086bd5L, 0x213800ccL, 0x1584cb16L, 0xfab4a00fL, 0x7cfd5ca2L,
+	0x93cd37bbL, 0xa771fc61L, 0x48419778L, 0xae0e73caL, 0x413e18d3L,
+	0x7582d309L, 0x9ab2b810L, 0x1cfb44bdL, 0xf3cb2fa4L, 0xc777e47eL,
+	0x28478f67L, 0x8bf04d66L, 0x64c0267fL, 0x507ceda5L, 0xbf4c86bcL,
+	0x39057a11L, 0xd6351108L, 0xe289dad2L, 0x0db9b1cbL, 0xebf65579L,
+	0x04c63e60L, 0x307af5baL, 0xdf4a9ea3L, 0x5903620eL, 0xb6330917L,
+	0x828fc2cdL, 0x6dbfa9d4L, 0x4bfc7d58L, 0xa4cc1641L, 0x9070dd9bL,
+	0x7f40b682L, 0xf9094a2fL, 0x16392136L, 0x2285eaecL, 0xcdb581f5L,
+	0x2bfa6547L, 0xc4ca0e5eL, 0xf076c584L, 0x1f46ae9dL, 0x990f5230L,
+	0x763f3929L, 0x4283f2f3L, 0xadb399eaL, 0x1c08b7d6L, 0xf338dccfL,
+	0xc7841715L, 0x28b47c0cL, 0xaefd80a1L, 0x41cdebb8L, 0x75712062L,
+	0x9a414b7bL, 0x7c0eafc9L, 0x933ec4d0L, 0xa7820f0aL, 0x48b26413L,
+	0xcefb98beL, 0x21cbf3a7L, 0x1577387dL, 0xfa475364L, 0xdc0487e8L,
+	0x3334ecf1L, 0x0788272bL, 0xe8b84c32L, 0x6ef1b09fL, 0x81c1db86L,
+	0xb57d105cL, 0x5a4d7b45L, 0xbc029ff7L, 0x5332f4eeL, 0x678e3f34L,
+	0x88be542dL, 0x0ef7a880L, 0xe1c7c399L, 0xd57b0843L, 0x3a4b635aL,
+	0x99fca15bL, 0x76ccca42L, 0x42700198L, 0xad406a81L, 0x2b09962cL,
+	0xc439fd35L, 0xf08536efL, 0x1fb55df6L, 0xf9fab944L, 0x16cad25dL,
+	0x22761987L, 0xcd46729eL, 0x4b0f8e33L, 0xa43fe52aL, 0x90832ef0L,
+	0x7fb345e9L, 0x59f09165L, 0xb6c0fa7cL, 0x827c31a6L, 0x6d4c5abfL,
+	0xeb05a612L, 0x0435cd0bL, 0x308906d1L, 0xdfb96dc8L, 0x39f6897aL,
+	0xd6c6e263L, 0xe27a29b9L, 0x0d4a42a0L, 0x8b03be0dL, 0x6433d514L,
+	0x508f1eceL, 0xbfbf75d7L, 0x120cec3dL, 0xfd3c8724L, 0xc9804cfeL,
+	0x26b027e7L, 0xa0f9db4aL, 0x4fc9b053L, 0x7b757b89L, 0x94451090L,
+	0x720af422L, 0x9d3a9f3bL, 0xa98654e1L, 0x46b63ff8L, 0xc0ffc355L,
+	0x2fcfa84cL, 0x1b736396L, 0xf443088fL, 0xd200dc03L, 0x3d30b71aL,
+	0x098c7cc0L, 0xe6bc17d9L, 0x60f5eb74L, 0x8fc5806dL, 0xbb794bb7L,
+	0x544920aeL, 0xb206c41cL, 0x5d36af05L, 0x698a64dfL, 0x86ba0fc6L,
+	0x00f3f36bL, 0xefc39872L, 0xdb7f53a8L, 0x344f38b1L, 0x97f8fab0L,
+	0x78c891a9L, 0x4c745a73L, 0xa344316aL, 0x250dcdc7L, 0xca3da6deL,
+	0xfe816d04L, 0x11b1061dL, 0xf7fee2afL, 0x18ce89b6L, 0x2c72426cL,
+	0xc3422975L, 0x450bd5d8L, 0xaa3bbec1L, 0x9e87751bL, 0x71b71e02L,
+	0x57f4ca8eL, 0xb8c4a197L, 0x8c786a4dL, 0x63480154L, 0xe501fdf9L,
+	0x0a3196e0L, 0x3e8d5d3aL, 0xd1bd3623L, 0x37f2d291L, 0xd8c2b988L,
+	0xec7e7252L, 0x034e194bL, 0x8507e5e6L, 0x6a378effL, 0x5e8b4525L,
+	0xb1bb2e3cL
+	},
+	{
+	0x00000000L, 0x68032cc8L, 0xd0065990L, 0xb8057558L, 0xa5e0c5d1L,
+	0xcde3e919L, 0x75e69c41L, 0x1de5b089L, 0x4e2dfd53L, 0x262ed19bL,
+	0x9e2ba4c3L, 0xf628880bL, 0xebcd3882L, 0x83ce144aL, 0x3bcb6112L,
+	0x53c84ddaL, 0x9c5bfaa6L, 0xf458d66eL, 0x4c5da336L, 0x245e8ffeL,
+	0x39bb3f77L, 0x51b813bfL, 0xe9bd66e7L, 0x81be4a2fL, 0xd27607f5L,
+	0xba752b3dL, 0x02705e65L, 0x6a7372adL, 0x7796c224L, 0x1f95eeecL,
+	0xa7909bb4L, 0xcf93b77cL, 0x3d5b83bdL, 0x5558af75L, 0xed5dda2dL,
+	0x855ef6e5L, 0x98bb466cL, 0xf0b86aa4L, 0x48bd1ffcL, 0x20be3334L,
+	0x73767eeeL, 0x1b755226L, 0xa370277eL, 0xcb730bb6L, 0xd696bb3fL,
+	0xbe9597f7L, 0x0690e2afL, 0x6e93ce67L, 0xa100791bL, 0xc90355d3L,
+	0x7106208bL, 0x19050c43L, 0x04e0bccaL, 0x6ce39002L, 0xd4e6e55aL,
+	0xbce5c992L, 0xef2d8448L, 0x872ea880L, 0x3f2bddd8L, 0x5728f110L,
+	0x4acd4199L, 0x22ce6d51L, 0x9acb1809L, 0xf2c834c1L, 0x7ab7077aL,
+	0x12b42bb2L, 0xaab15eeaL, 0xc2b27222L, 0xdf57c2abL, 0xb754ee63L,
+	0x0f519b3bL, 0x6752b7f3L, 0x349afa29L, 0x5c99d6e1L, 0xe49ca3b9L,
+	0x8c9f8f71L, 0x917a3ff8L, 0xf9791330L, 0x417c6668L, 0x297f4aa0L,
+	0xe6ecfddcL, 0x8eefd114L, 0x36eaa44cL, 0x5ee98884L, 0x430c380dL,
+	0x2b0f14c5L, 0x930a619dL, 0xfb094d55L, 0xa8c1008fL, 0xc0c22c47L,
+	0x78c7591fL, 0x10c475d7L, 0x0d21c55eL, 0x6522e996L, 0xdd279cceL,
+	0xb524b006L, 0x47ec84c7L, 0x2fefa80fL, 0x97eadd57L, 0xffe9f19fL,
+	0xe20c4116L, 0x8a0f6ddeL, 0x320a1886L, 0x5a09344eL, 0x09c17994L,
+	0x61c2555cL, 0xd9c72004L, 0xb1c40cccL, 0xac21bc45L, 0xc422908dL,
+	0x7c27e5d5L, 0x1424c91dL, 0xdbb77e61L, 0xb3b452a9L, 0x0bb127f1L,
+	0x63b20b39L, 0x7e57bbb0L, 0x16549778L, 0xae51e220L, 0xc652cee8L,
+	0x959a8332L, 0xfd99affaL, 0x459cdaa2L, 0x2d9ff66aL, 0x307a46e3L,
+	0x58796a2bL, 0xe07c1f73L, 0x887f33bbL, 0xf56e0ef4L, 0x9d6d223cL,
+	0x25685764L, 0x4d6b7bacL, 0x508ecb25L, 0x388de7edL, 0x808892b5L,
+	0xe88bbe7dL, 0xbb43f3a7L, 0xd340df6fL, 0x6b45aa37L, 0x034686ffL,
+	0x1ea33676L, 0x76a01abeL, 0xcea56fe6L, 0xa6a6432eL, 0x6935f452L,
+	0x0136d89aL, 0xb933adc2L, 0xd130810aL, 0xccd53183L, 0xa4d61d4bL,
+	0x1cd36813L, 0x74d044dbL, 0x27180901L, 0x4f1b25c9L, 0xf71e5091L,
+	0x9f1d7c59L, 0x82f8ccd0L, 0xeafbe018L, 0x52fe9540L, 0x3afdb988L,
+	0xc8358d49L, 0xa036a181L, 0x1833d4d9L, 0x7030f811L, 0x6dd54898L,
+	0x05d66450L, 0xbdd31108L, 0xd5d03dc0L, 0x8618701aL, 0xee1b5cd2L,
+	0x561e298aL, 0x3e1d0542L, 0x23f8b5cbL, 0x4bfb9903L, 0xf3feec5bL,
+	0x9bfdc093L, 0x546e77efL, 0x3c6d5b27L, 0x84682e7fL, 0xec6b02b7L,
+	0xf18eb23eL, 0x998d9ef6L, 0x2188ebaeL, 0x498bc766L, 0x1a438abcL,
+	0x7240a674L, 0xca45d32cL, 0xa246ffe4L, 0xbfa34f6dL, 0xd7a063a5L,
+	0x6fa516fdL, 0x07a63a35L, 0x8fd9098eL, 0xe7da2546L, 0x5fdf501eL,
+	0x37dc7cd6L, 0x2a39cc5fL, 0x423ae097L, 0xfa3f95cfL, 0x923cb907L,
+	0xc1f4f4ddL, 0xa9f7d815L, 0x11f2ad4dL, 0x79f18185L, 0x6414310cL,
+	0x0c171dc4L, 0xb412689cL, 0xdc114454L, 0x1382f328L, 0x7b81dfe0L,
+	0xc384aab8L, 0xab878670L, 0xb66236f9L, 0xde611a31L, 0x66646f69L,
+	0x0e6743a1L, 0x5daf0e7bL, 0x35ac22b3L, 0x8da957ebL, 0xe5aa7b23L,
+	0xf84fcbaaL, 0x904ce762L, 0x2849923aL, 0x404abef2L, 0xb2828a33L,
+	0xda81a6fbL, 0x6284d3a3L, 0x0a87ff6bL, 0x17624fe2L, 0x7f61632aL,
+	0xc7641672L, 0xaf673abaL, 0xfcaf7760L, 0x94ac5ba8L, 0x2ca92ef0L,
+	0x44aa0238L, 0x594fb2b1L, 0x314c9e79L, 0x8949eb21L, 0xe14ac7e9L,
+	0x2ed97095L, 0x46da5c5dL, 0xfedf2905L, 0x96dc05cdL, 0x8b39b544L,
+	0xe33a998cL, 0x5b3fecd4L, 0x333cc01cL, 0x60f48dc6L, 0x08f7a10eL,
+	0xb0f2d456L, 0xd8f1f89eL, 0xc5144817L, 0xad1764dfL, 0x15121187L,
+	0x7d113d4fL
+	},
+	{
+	0x00000000L, 0x493c7d27L, 0x9278fa4eL, 0xdb448769L, 0x211d826dL,
+	0x6821ff4aL, 0xb3657823L, 0xfa590504L, 0x423b04daL, 0x0b0779fdL,
+	0xd043fe94L, 0x997f83b3L, 0x632686b7L, 0x2a1afb90L, 0xf15e7cf9L,
+	0xb86201deL, 0x847609b4L, 0xcd4a7493L, 0x160ef3faL, 0x5f328eddL,
+	0xa56b8bd9L, 0xec57f6feL, 0x37137197L, 0x7e2f0cb0L, 0xc64d0d6eL,
+	0x8f717049L, 0x5435f720L, 0x1d098a07L, 0xe7508f03L, 0xae6cf224L,
+	0x7528754dL, 0x3c14086aL, 0x0d006599L, 0x443c18beL, 0x9f789fd7L,
+	0xd644e2f0L, 0x2c1de7f4L, 0x65219ad3L, 0xbe651dbaL, 0xf759609dL,
+	0x4f3b6143L, 0x06071c64L, 0xdd439b0dL, 0x947fe62aL, 0x6e26e32eL,
+	0x271a9e09L, 0xfc5e1960L, 0xb5626447L, 0x89766c2dL, 0xc04a110aL,
+	0x1b0e9663L, 0x5232eb44L, 0xa86bee40L, 0xe1579367L, 0x3a13140eL,
+	0x732f6929L, 0xcb4d68f7L, 0x827115d0L, 0x593592b9L, 0x1009ef9eL,
+	0xea50ea9aL, 0xa36c97bdL, 0x782810d4L, 0x31146df3L, 0x1a00cb32L,
+	0x533cb615L, 0x8878317cL, 0xc1444c5bL, 0x3b1d495fL, 0x72213478L,
+	0xa965b311L, 0xe059ce36L, 0x583bcfe8L, 0x1107b2cfL, 0xca4335a6L,
+	0x837f4881L, 0x79264d85L, 0x301a30a2L, 0xeb5eb7cbL, 0xa262caecL,
+	0x9e76c286L, 0xd74abfa1L, 0x0c0e38c8L, 0x453245efL, 0xbf6b40ebL,
+	0xf6573dccL, 0x2d13baa5L, 0x642fc782L, 0xdc4dc65cL, 0x9571bb7bL,
+	0x4e353c12L, 0x07094135L, 0xfd504431L, 0xb46c3916L, 0x6f28be7fL,
+	0x2614c358L, 0x1700aeabL, 0x5e3cd38cL, 0x857854e5L, 0xcc4429c2L,
+	0x361d2cc6L, 0x7f2151e1L, 0xa465d688L, 0xed59abafL, 0x553baa71L,
+	0x1c07d756L, 0xc743503fL, 0x8e7f2d18L, 0x7426281cL, 0x3d1a553bL,
+	0xe65ed252L, 0xaf62af75L, 0x9376a71fL, 0xda4ada38L, 0x010e5d51L,
+	0x48322076L, 0xb26b2572L, 0xfb575855L, 0x2013df3cL, 0x692fa21bL,
+	0xd14da3c5L, 0x9871dee2L, 0x4335598bL, 0x0a0924acL, 0xf05021a8L,
+	0xb96c5c8fL, 0x6228dbe6L, 0x2b14a6c1L, 0x34019664L, 0x7d3deb43L,
+	0xa6796c2aL, 0xef45110dL, 0x151c1409L, 0x5c20692eL, 0x8764ee47L,
+	0xce589360L, 0x763a92beL, 0x3f06ef99L, 0xe44268f0L, 0xad7e15d7L,
+	0x572710d3L, 0x1e1b6df4L, 0xc55fea9dL, 0x8c6397baL, 0xb0779fd0L,
+	0xf94be2f7L, 0x220f659eL, 0x6b3318b9L, 0x916a1dbdL, 0xd856609aL,
+	0x0312e7f3L, 0x4a2e9ad4L, 0xf24c9b0aL, 0xbb70e62dL, 0x60346144L,
+	0x29081c63L, 0xd3511967L, 0x9a6d6440L, 0x4129e329L, 0x08159e0eL,
+	0x3901f3fdL, 0x703d8edaL, 0xab7909b3L, 0xe2457494L, 0x181c7190L,
+	0x51200cb7L, 0x8a648bdeL, 0xc358f6f9L, 0x7b3af727L, 0x32068a00L,
+	0xe9420d69L, 0xa07e704eL, 0x5a27754aL, 0x131b086dL, 0xc85f8f04L,
+	0x8163f223L, 0xbd77fa49L, 0xf44b876eL, 0x2f0f0007L, 0x66337d20L,
+	0x9c6a7824L, 0xd5560503L, 0x0e12826aL, 0x472eff4dL, 0xff4cfe93L,
+	0xb67083b4L, 0x6d3404ddL, 0x240879faL, 0xde517cfeL, 0x976d01d9L,
+	0x4c2986b0L, 0x0515fb97L, 0x2e015d56L, 0x673d2071L, 0xbc79a718L,
+	0xf545da3fL, 0x0f1cdf3bL, 0x4620a21cL, 0x9d642575L, 0xd4585852L,
+	0x6c3a598cL, 0x250624abL, 0xfe42a3c2L, 0xb77edee5L, 0x4d27dbe1L,
+	0x041ba6c6L, 0xdf5f21afL, 0x96635c88L, 0xaa7754e2L, 0xe34b29c5L,
+	0x380faeacL, 0x7133d38bL, 0x8b6ad68fL, 0xc256aba8L, 0x19122cc1L,
+	0x502e51e6L, 0xe84c5038L, 0xa1702d1fL, 0x7a34aa76L, 0x3308d751L,
+	0xc951d255L, 0x806daf72L, 0x5b29281bL, 0x1215553cL, 0x230138cfL,
+	0x6a3d45e8L, 0xb179c281L, 0xf845bfa6L, 0x021cbaa2L, 0x4b20c785L,
+	0x906440ecL, 0xd9583dcbL, 0x613a3c15L, 0x28064132L, 0xf342c65bL,
+	0xba7ebb7cL, 0x4027be78L, 0x091bc35fL, 0xd25f4436L, 0x9b633911L,
+	0xa777317bL, 0xee4b4c5cL, 0x350fcb35L, 0x7c33b612L, 0x866ab316L,
+	0xcf56ce31L, 0x14124958L, 0x5d2e347fL, 0xe54c35a1L, 0xac704886L,
+	0x7734cfefL, 0x3e08b2c8L, 0xc451b7ccL, 0x8d6dcaebL, 0x56294d82L,
+	0x1f1530a5L
+	}
+};
+
+// process n bytes, n must be a multiple of 8 and s must be aligned for word32
+static word32 UpdateSlicingBy8(word32 crc, const word32 slices[8][256], const byte *s, size_t n)
+{
+	for (; n; n-=8, s+=8)
+	{
+		word32 one = ((const word32 *)s)[0] ^ crc;
+		word32 two = ((const word32 *)s)[1];
+		crc = slices[7][GETBYTE(one, 0)] ^ slices[6][GETBYTE(one, 1)] ^ slices[5][GETBYTE(one, 2)] ^ slices[4][GETBYTE(one, 3)]
+			^ slices[3][GETBYTE(two, 0)] ^ slices[2][GETBYTE(two, 1)] ^ slices[1][GETBYTE(two, 2)] ^ slices[0][GETBYTE(two, 3)];
+	}
+	return crc;
+}
+
+#endif
+
+#if CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE
+
+// folding constants for the CRC-32 polynomial, see Intel's "Fast CRC Computation for Generic
+// Polynomials Using PCLMULQDQ Instruction", with bits reflected as the CRC is
+static CRYPTOPP_ALIGN_DATA(16) const word64 s_clmulCRC32Constants64[] = {
+	W64LIT(0x0000000154442bd4), W64LIT(0x00000001c6e41596),	// x^(4*128+32) mod P, x^(4*128-32) mod P
+	W64LIT(0x00000001751997d0), W64LIT(0x00000000ccaa009e),	// x^(128+32) mod P, x^(128-32) mod P
+	W64LIT(0x0000000163cd6124), W64LIT(0x0000000000000000),	// x^64 mod P
+	W64LIT(0x00000001db710641), W64LIT(0x00000001f7011641)};	// P, floor(x^64 / P)
+static const __m128i *s_clmulCRC32Constants = (const __m128i *)s_clmulCRC32Constants64;
+
+// fold n bytes into crc, n must be a multiple of 16 and at least 64
+static word32 CLMUL_CRC32_Update(word32 crc, const byte *s, size_t n)
+{
+	const __m128i *p = (const __m128i *)s;
+	const __m128i mask32 = _mm_set_epi32(0, 0, 0, -1);
+	__m128i k = s_clmulCRC32Constants[0];
+	__m128i x0 = _mm_xor_si128(_mm_loadu_si128(p), _mm_cvtsi32_si128(crc));
+	__m128i x1 = _mm_loadu_si128(p+1);
+	__m128i x2 = _mm_loadu_si128(p+2);
+	__m128i x3 = _mm_loadu_si128(p+3);
+
+#define CLMUL_CRC32_FOLD(x, k, y)	\
+	x = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), y)
+
+	// fold 4 blocks at a time, keeping 4 independent chains
+	for (p+=4, n-=64; n>=64; p+=4, n-=64)
+	{
+		CLMUL_CRC32_FOLD(x0, k, _mm_loadu_si128(p));
+		CLMUL_CRC32_FOLD(x1, k, _mm_loadu_si128(p+1));
+		CLMUL_CRC32_FOLD(x2, k, _mm_loadu_si128(p+2));
+		CLMUL_CRC32_FOLD(x3, k, _mm_loadu_si128(p+3));
+	}
+
+	// fold them into one, then fold in the remaining blocks
+	k = s_clmulCRC32Constants[1];
+	CLMUL_CRC32_FOLD(x0, k, x1);
+	CLMUL_CRC32_FOLD(x0, k, x2);
+	CLMUL_CRC32_FOLD(x0, k, x3);
+	for (; n; p++, n-=16)
+		CLMUL_CRC32_FOLD(x0, k, _mm_loadu_si128(p));
+
+#undef CLMUL_CRC32_FOLD
+
+	// reduce 128 bits to 64, then to 32 with a Barrett reduction
+	x0 = _mm_xor_si128(_mm_srli_si128(x0, 8), _mm_clmulepi64_si128(k, x0, 0x01));
+	x0 = _mm_xor_si128(_mm_srli_si128(x0, 4), _mm_clmulepi64_si128(_mm_and_si128(x0, mask32), s_clmulCRC32Constants[2], 0x00));
+	k = s_clmulCRC32Constants[3];
+	__m128i t = _mm_and_si128(_mm_clmulepi64_si128(_mm_and_si128(x0, mask32), k, 0x10), mask32);
+	x0 = _mm_xor_si128(x0, _mm_clmulepi64_si128(t, k, 0x00));
+	return (word32)_mm_cvtsi128_si32(_mm_srli_si128(x0, 4));
+}
+
+#endif
+
 void CRC32::Update(const byte *s, size_t n)
 {
 	word32 crc = m_crc;
@@ -129,6 +1073,25 @@ void CRC32::Update(const byte *s, size_t n)
 	for(; !IsAligned<word32>(s) && n > 0; n--)
 		crc = m_tab[CRC32_INDEX(crc) ^ *s++] ^ CRC32_SHIFTED(crc);
 
+#if CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE
+	if (n >= 64 && HasCLMUL())
+	{
+		size_t len = n & ~size_t(15);
+		crc = CLMUL_CRC32_Update(crc, s, len);
+		s += len;
+		n -= len;
+	}
+#endif
+
+#ifdef IS_LITTLE_ENDIAN
+	if (n >= 8)
+	{
+		size_t len = n & ~size_t(7);
+		crc = UpdateSlicingBy8(crc, s_crc32Slices, s, len);
+		s += len;
+		n -= len;
+	}
+#else
 	while (n >= 4)
 	{
 		crc ^= *(const word32 *)s;
@@ -139,6 +1102,7 @@ void CRC32::Update(const byte *s, size_t n)
 		n -= 4;
 		s += 4;
 	}
+#endif
 
 	while (n--)
 		crc = m_tab[CRC32_INDEX(crc) ^ *s++] ^ CRC32_SHIFTED(crc);
@@ -157,4 +1121,174 @@ void CRC32::TruncatedFinal(byte *hash, size_t size)
 	Reset();
 }
 
+// *************************************************************
+
+/* Table of CRC-32C's of all single byte values */
+const word32 CRC32C::m_tab[] = {
+#ifdef IS_LITTLE_ENDIAN
+	0x00000000L, 0xf26b8303L, 0xe13b70f7L, 0x1350f3f4L, 0xc79a971fL,
+	0x35f1141cL, 0x26a1e7e8L, 0xd4ca64ebL, 0x8ad958cfL, 0x78b2dbccL,
+	0x6be22838L, 0x9989ab3bL, 0x4d43cfd0L, 0xbf284cd3L, 0xac78bf27L,
+	0x5e133c24L, 0x105ec76fL, 0xe235446cL, 0xf165b798L, 0x030e349bL,
+	0xd7c45070L, 0x25afd373L, 0x36ff2087L, 0xc494a384L, 0x9a879fa0L,
+	0x68ec1ca3L, 0x7bbcef57L, 0x89d76c54L, 0x5d1d08bfL, 0xaf768bbcL,
+	0xbc267848L, 0x4e4dfb4bL, 0x20bd8edeL, 0xd2d60dddL, 0xc186fe29L,
+	0x33ed7d2aL, 0xe72719c1L, 0x154c9ac2L, 0x061c6936L, 0xf477ea35L,
+	0xaa64d611L, 0x580f5512L, 0x4b5fa6e6L, 0xb93425e5L, 0x6dfe410eL,
+	0x9f95c20dL, 0x8cc531f9L, 0x7eaeb2faL, 0x30e349b1L, 0xc288cab2L,
+	0xd1d83946L, 0x23b3ba45L, 0xf779deaeL, 0x05125dadL, 0x1642ae59L,
+	0xe4292d5aL, 0xba3a117eL, 0x4851927dL, 0x5b016189L, 0xa96ae28aL,
+	0x7da08661L, 0x8fcb0562L, 0x9c9bf696L, 0x6ef07595L, 0x417b1dbcL,
+	0xb3109ebfL, 0xa0406d4bL, 0x522bee48L, 0x86e18aa3L, 0x748a09a0L,
+	0x67dafa54L, 0x95b17957L, 0xcba24573L, 0x39c9c670L, 0x2a993584L,
+	0xd8f2b687L, 0x0c38d26cL, 0xfe53516fL, 0xed03a29bL, 0x1f682198L,
+	0x5125dad3L, 0xa34e59d0L, 0xb01eaa24L, 0x42752927L, 0x96bf4dccL,
+	0x64d4cecfL, 0x77843d3bL, 0x85efbe38L, 0xdbfc821cL, 0x2997011fL,
+	0x3ac7f2ebL, 0xc8ac71e8L, 0x1c661503L, 0xee0d9600L, 0xfd5d65f4L,
+	0x0f36e6f7L, 0x61c69362L, 0x93ad1061L, 0x80fde395L, 0x72966096L,
+	0xa65c047dL, 0x5437877eL, 0x4767748aL, 0xb50cf789L, 0xeb1fcbadL,
+	0x197448aeL, 0x0a24bb5aL, 0xf84f3859L, 0x2c855cb2L, 0xdeeedfb1L,
+	0xcdbe2c45L, 0x3fd5af46L, 0x7198540dL, 0x83f3d70eL, 0x90a324faL,
+	0x62c8a7f9L, 0xb602c312L, 0x44694011L, 0x5739b3e5L, 0xa55230e6L,
+	0xfb410cc2L, 0x092a8fc1L, 0x1a7a7c35L, 0xe811ff36L, 0x3cdb9bddL,
+	0xceb018deL, 0xdde0eb2aL, 0x2f8b6829L, 0x82f63b78L, 0x709db87bL,
+	0x63cd4b8fL, 0x91a6c88cL, 0x456cac67L, 0xb7072f64L, 0xa457dc90L,
+	0x563c5f93L, 0x082f63b7L, 0xfa44e0b4L, 0xe9141340L, 0x1b7f9043L,
+	0xcfb5f4a8L, 0x3dde77abL, 0x2e8e845fL, 0xdce5075cL, 0x92a8fc17L,
+	0x60c37f14L, 0x73938ce0L, 0x81f80fe3L, 0x55326b08L, 0xa759e80bL,
+	0xb4091bffL, 0x466298fcL, 0x1871a4d8L, 0xea1a27dbL, 0xf94ad42fL,
+	0x0b21572cL, 0xdfeb33c7L, 0x2d80b0c4L, 0x3ed04330L, 0xccbbc033L,
+	0xa24bb5a6L, 0x502036a5L, 0x4370c551L, 0xb11b4652L, 0x65d122b9L,
+	0x97baa1baL, 0x84ea524eL, 0x7681d14dL, 0x2892ed69L, 0xdaf96e6aL,
+	0xc9a99d9eL, 0x3bc21e9dL, 0xef087a76L, 0x1d63f975L, 0x0e330a81L,
+	0xfc588982L, 0xb21572c9L, 0x407ef1caL, 0x532e023eL, 0xa145813dL,
+	0x758fe5d6L, 0x87e466d5L, 0x94b49521L, 0x66df1622L, 0x38cc2a06L,
+	0xcaa7a905L, 0xd9f75af1L, 0x2b9cd9f2L, 0xff56bd19L, 0x0d3d3e1aL,
+	0x1e6dcdeeL, 0xec064eedL, 0xc38d26c4L, 0x31e6a5c7L, 0x22b65633L,
+	0xd0ddd530L, 0x0417b1dbL, 0xf67c32d8L, 0xe52cc12cL, 0x1747422fL,
+	0x49547e0bL, 0xbb3ffd08L, 0xa86f0efcL, 0x5a048dffL, 0x8ecee914L,
+	0x7ca56a17L, 0x6ff599e3L, 0x9d9e1ae0L, 0xd3d3e1abL, 0x21b862a8L,
+	0x32e8915cL, 0xc083125fL, 0x144976b4L, 0xe622f5b7L, 0xf5720643L,
+	0x07198540L, 0x590ab964L, 0xab613a67L, 0xb831c993L, 0x4a5a4a90L,
+	0x9e902e7bL, 0x6cfbad78L, 0x7fab5e8cL, 0x8dc0dd8fL, 0xe330a81aL,
+	0x115b2b19L, 0x020bd8edL, 0xf0605beeL, 0x24aa3f05L, 0xd6c1bc06L,
+	0xc5914ff2L, 0x37faccf1L, 0x69e9f0d5L, 0x9b8273d6L, 0x88d28022L,
+	0x7ab90321L, 0xae7367caL, 0x5c18e4c9L, 0x4f48173dL, 0xbd23943eL,
+	0xf36e6f75L, 0x0105ec76L, 0x12551f82L, 0xe03e9c81L, 0x34f4f86aL,
+	0xc69f7b69L, 0xd5cf889dL, 0x27a40b9eL, 0x79b737baL, 0x8bdcb4b9L,
+	0x988c474dL, 0x6ae7c44eL, 0xbe2da0a5L, 0x4c4623a6L, 0x5f16d052L,
+	0xad7d5351L
+#else
+	0x00000000L, 0x03836bf2L, 0xf7703be1L, 0xf4f35013L, 0x1f979ac7L,
+	0x1c14f135L, 0xe8e7a126L, 0xeb64cad4L, 0xcf58d98aL, 0xccdbb278L,
+	0x3828e26bL, 0x3bab8999L, 0xd0cf434dL, 0xd34c28bfL, 0x27bf78acL,
+	0x243c135eL, 0x6fc75e10L, 0x6c4435e2L, 0x98b765f1L, 0x9b340e03L,
+	0x7050c4d7L, 0x73d3af25L, 0x8720ff36L, 0x84a394c4L, 0xa09f879aL,
+	0xa31cec68L, 0x57efbc7bL, 0x546cd789L, 0xbf081d5dL, 0xbc8b76afL,
+	0x487826bcL, 0x4bfb4d4eL, 0xde8ebd20L, 0xdd0dd6d2L, 0x29fe86c1L,
+	0x2a7ded33L, 0xc11927e7L, 0xc29a4c15L, 0x36691c06L, 0x35ea77f4L,
+	0x11d664aaL, 0x12550f58L, 0xe6a65f4bL, 0xe52534b9L, 0x0e41fe6dL,
+	0x0dc2959fL, 0xf931c58cL, 0xfab2ae7eL, 0xb149e330L, 0xb2ca88c2L,
+	0x4639d8d1L, 0x45bab323L, 0xaede79f7L, 0xad5d1205L, 0x59ae4216L,
+	0x5a2d29e4L, 0x7e113abaL, 0x7d925148L, 0x8961015bL, 0x8ae26aa9L,
+	0x6186a07dL, 0x6205cb8fL, 0x96f69b9cL, 0x9575f06eL, 0xbc1d7b41L,
+	0xbf9e10b3L, 0x4b6d40a0L, 0x48ee2b52L, 0xa38ae186L, 0xa0098a74L,
+	0x54fada67L, 0x5779b195L, 0x7345a2cbL, 0x70c6c939L, 0x8435992aL,
+	0x87b6f2d8L, 0x6cd2380cL, 0x6f5153feL, 0x9ba203edL, 0x9821681fL,
+	0xd3da2551L, 0xd0594ea3L, 0x24aa1eb0L, 0x27297542L, 0xcc4dbf96L,
+	0xcfced464L, 0x3b3d8477L, 0x38beef85L, 0x1c82fcdbL, 0x1f019729L,
+	0xebf2c73aL, 0xe871acc8L, 0x0315661cL, 0x00960deeL, 0xf4655dfdL,
+	0xf7e6360fL, 0x6293c661L, 0x6110ad93L, 0x95e3fd80L, 0x96609672L,
+	0x7d045ca6L, 0x7e873754L, 0x8a746747L, 0x89f70cb5L, 0xadcb1febL,
+	0xae487419L, 0x5abb240aL, 0x59384ff8L, 0xb25c852cL, 0xb1dfeedeL,
+	0x452cbecdL, 0x46afd53fL, 0x0d549871L, 0x0ed7f383L, 0xfa24a390L,
+	0xf9a7c862L, 0x12c302b6L, 0x11406944L, 0xe5b33957L, 0xe63052a5L,
+	0xc20c41fbL, 0xc18f2a09L, 0x357c7a1aL, 0x36ff11e8L, 0xdd9bdb3cL,
+	0xde18b0ceL, 0x2aebe0ddL, 0x29688b2fL, 0x783bf682L, 0x7bb89d70L,
+	0x8f4bcd63L, 0x8cc8a691L, 0x67ac6c45L, 0x642f07b7L, 0x90dc57a4L,
+	0x935f3c56L, 0xb7632f08L, 0xb4e044faL, 0x401314e9L, 0x43907f1bL,
+	0xa8f4b5cfL, 0xab77de3dL, 0x5f848e2eL, 0x5c07e5dcL, 0x17fca892L,
+	0x147fc360L, 0xe08c9373L, 0xe30ff881L, 0x086b3255L, 0x0be859a7L,
+	0xff1b09b4L, 0xfc986246L, 0xd8a47118L, 0xdb271aeaL, 0x2fd44af9L,
+	0x2c57210bL, 0xc733ebdfL, 0xc4b0802dL, 0x3043d03eL, 0x33c0bbccL,
+	0xa6b54ba2L, 0xa5362050L, 0x51c57043L, 0x52461bb1L, 0xb922d165L,
+	0xbaa1ba97L, 0x4e52ea84L, 0x4dd18176L, 0x69ed9228L, 0x6a6ef9daL,
+	0x9e9da9c9L, 0x9d1ec23bL, 0x767a08efL, 0x75f9631dL, 0x810a330eL,
+	0x828958fcL, 0xc97215b2L, 0xcaf17e40L, 0x3e022e53L, 0x3d8145a1L,
+	0xd6e58f75L, 0xd566e487L, 0x2195b494L, 0x2216df66L, 0x062acc38L,
+	0x05a9a7caL, 0xf15af7d9L, 0xf2d99c2bL, 0x19bd56ffL, 0x1a3e3d0dL,
+	0xeecd6d1eL, 0xed4e06ecL, 0xc4268dc3L, 0xc7a5e631L, 0x3356b622L,
+	0x30d5ddd0L, 0xdbb11704L, 0xd8327cf6L, 0x2cc12ce5L, 0x2f424717L,
+	0x0b7e5449L, 0x08fd3fbbL, 0xfc0e6fa8L, 0xff8d045aL, 0x14e9ce8eL,
+	0x176aa57cL, 0xe399f56fL, 0xe01a9e9dL, 0xabe1d3d3L, 0xa862b821L,
+	0x5c91e832L, 0x5f1283c0L, 0xb4764914L, 0xb7f522e6L, 0x430672f5L,
+	0x40851907L, 0x64b90a59L, 0x673a61abL, 0x93c931b8L, 0x904a5a4aL,
+	0x7b2e909eL, 0x78adfb6cL, 0x8c5eab7fL, 0x8fddc08dL, 0x1aa830e3L,
+	0x192b5b11L, 0xedd80b02L, 0xee5b60f0L, 0x053faa24L, 0x06bcc1d6L,
+	0xf24f91c5L, 0xf1ccfa37L, 0xd5f0e969L, 0xd673829bL, 0x2280d288L,
+	0x2103b97aL, 0xca6773aeL, 0xc9e4185cL, 0x3d17484fL, 0x3e9423bdL,
+	0x756f6ef3L, 0x76ec0501L, 0x821f5512L, 0x819c3ee0L, 0x6af8f434L,
+	0x697b9fc6L, 0x9d88cfd5L, 0x9e0ba427L, 0xba37b779L, 0xb9b4dc8bL,
+	0x4d478c98L, 0x4ec4e76aL, 0xa5a02dbeL, 0xa623464cL, 0x52d0165fL,
+	0x51537dadL
+#endif
+};
+
+CRC32C::CRC32C()
+{
+	Reset();
+}
+
+void CRC32C::Update(const byte *s, size_t n)
+{
+	word32 crc = m_crc;
+
+#if CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE
+	if (HasSSE42())
+	{
+		for(; !IsAligned<word32>(s) && n > 0; n--)
+			crc = _mm_crc32_u8(crc, *s++);
+#if CRYPTOPP_BOOL_X64
+		for(; n >= 8; n-=8, s+=8)
+			crc = (word32)_mm_crc32_u64(crc, *(const word64 *)s);
+#endif
+		for(; n >= 4; n-=4, s+=4)
+			crc = _mm_crc32_u32(crc, *(const word32 *)s);
+		for(; n > 0; n--)
+			crc = _mm_crc32_u8(crc, *s++);
+		m_crc = crc;
+		return;
+	}
+#endif
+
+	for(; !IsAligned<word32>(s) && n > 0; n--)
+		crc = m_tab[CRC32_INDEX(crc) ^ *s++] ^ CRC32_SHIFTED(crc);
+
+#ifdef IS_LITTLE_ENDIAN
+	if (n >= 8)
+	{
+		size_t len = n & ~size_t(7);
+		crc = UpdateSlicingBy8(crc, s_crc32cSlices, s, len);
+		s += len;
+		n -= len;
+	}
+#endif
+
+	while (n--)
+		crc = m_tab[CRC32_INDEX(crc) ^ *s++] ^ CRC32_SHIFTED(crc);
+
+	m_crc = crc;
+}
+
+void CRC32C::TruncatedFinal(byte *hash, size_t size)
+{
+	ThrowIfInvalidTruncatedSize(size);
+
+	m_crc ^= CRC32_NEGL;
+	for (size_t i=0; i<size; i++)
+		hash[i] = GetCrcByte(i);
+
+	Reset();
+}
+
 NAMESPACE_END
@@ -37,6 +37,28 @@ private:
 	word32 m_crc;
 };
 
+//! CRC-32C (Castagnoli) Checksum Calculation, as used by iSCSI and SCTP
+class CRC32C : public HashTransformation
+{
+public:
+	CRYPTOPP_CONSTANT(DIGESTSIZE = 4)
+	CRC32C();
+	void Update(const byte *input, size_t length);
+	void TruncatedFinal(byte *hash, size_t size);
+	unsigned int DigestSize() const {return DIGESTSIZE;}
+    static const char * StaticAlgorithmName() {return "CRC32C";}
+    std::string AlgorithmName() const {return StaticAlgorithmName();}
+
+	void UpdateByte(byte b) {m_crc = m_tab[CRC32_INDEX(m_crc) ^ b] ^ CRC32_SHIFTED(m_crc);}
+	byte GetCrcByte(size_t i) const {return ((byte *)&(m_crc))[i];}
+
+private:
+	void Reset() {m_crc = CRC32_NEGL;}
+	
+	static const word32 m_tab[256];
+	word32 m_crc;
+};
+
 NAMESPACE_END
 
 #endif
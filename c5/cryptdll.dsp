@@ -339,6 +339,10 @@ SOURCE=.\strciphr.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\taskexec.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\trdlocal.cpp
 # End Source File
 # End Group
@@ -587,6 +591,10 @@ SOURCE=.\strciphr.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\taskexec.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\trdlocal.h
 # End Source File
 # Begin Source File
@@ -766,6 +766,24 @@ size_t PK_Signer::SignMessage(RandomNumberGenerator &rng, const byte *message, s
 	return SignAndRestart(rng, *m, signature, false);
 }
 
+size_t PK_Signer::SignMessageBatch(RandomNumberGenerator &rng, const byte *const *messages, const size_t *messageLengths, byte *const *signatures, size_t *signatureLengths, size_t count) const
+{
+	size_t failures = 0;
+	for (size_t i=0; i<count; i++)
+	{
+		try
+		{
+			signatureLengths[i] = SignMessage(rng, messages[i], messageLengths[i], signatures[i]);
+		}
+		catch (const Exception &)
+		{
+			signatureLengths[i] = 0;
+			failures++;
+		}
+	}
+	return failures;
+}
+
 size_t PK_Signer::SignMessageWithRecovery(RandomNumberGenerator &rng, const byte *recoverableMessage, size_t recoverableMessageLength, 
 	const byte *nonrecoverableMessage, size_t nonrecoverableMessageLength, byte *signature) const
 {
@@ -789,6 +807,25 @@ bool PK_Verifier::VerifyMessage(const byte *message, size_t messageLen, const by
 	return VerifyAndRestart(*m);
 }
 
+size_t PK_Verifier::VerifyMessageBatch(const byte *const *messages, const size_t *messageLengths, const byte *const *signatures, const size_t *signatureLengths, bool *results, size_t count) const
+{
+	size_t failures = 0;
+	for (size_t i=0; i<count; i++)
+	{
+		try
+		{
+			results[i] = VerifyMessage(messages[i], messageLengths[i], signatures[i], signatureLengths[i]);
+		}
+		catch (const Exception &)
+		{
+			results[i] = false;
+		}
+		if (!results[i])
+			failures++;
+	}
+	return failures;
+}
+
 DecodingResult PK_Verifier::Recover(byte *recoveredMessage, PK_MessageAccumulator *messageAccumulator) const
 {
 	std::auto_ptr<PK_MessageAccumulator> m(messageAccumulator);
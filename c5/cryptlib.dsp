@@ -278,6 +278,10 @@ SOURCE=.\cryptlib.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\curve25519.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\default.cpp
 # End Source File
 # Begin Source File
@@ -609,6 +613,10 @@ SOURCE=.\strciphr.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\taskexec.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\tea.cpp
 # End Source File
 # Begin Source File
@@ -773,6 +781,10 @@ SOURCE=.\cryptlib.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\curve25519.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\default.h
 # End Source File
 # Begin Source File
@@ -1125,6 +1137,10 @@ SOURCE=.\strciphr.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\taskexec.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\tea.h
 # End Source File
 # Begin Source File
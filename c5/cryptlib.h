@@ -1376,6 +1376,12 @@ public:
 	*/
 	virtual size_t SignMessageWithRecovery(RandomNumberGenerator &rng, const byte *recoverableMessage, size_t recoverableMessageLength, 
 		const byte *nonrecoverableMessage, size_t nonrecoverableMessageLength, byte *signature) const;
+
+	//! sign count messages
+	/*! \pre size of signatures[i] == MaxSignatureLength()
+		\return number of messages that could not be signed, and whose signatureLengths[i] are set to 0
+	*/
+	virtual size_t SignMessageBatch(RandomNumberGenerator &rng, const byte *const *messages, const size_t *messageLengths, byte *const *signatures, size_t *signatureLengths, size_t count) const;
 };
 
 //! interface for public-key signature verifiers
@@ -1404,6 +1410,10 @@ public:
 	virtual bool VerifyMessage(const byte *message, size_t messageLen, 
 		const byte *signature, size_t signatureLength) const;
 
+	//! check count signatures, setting results[i] to whether signature i is valid for message i
+	/*! \return number of invalid signatures */
+	virtual size_t VerifyMessageBatch(const byte *const *messages, const size_t *messageLengths, const byte *const *signatures, const size_t *signatureLengths, bool *results, size_t count) const;
+
 	//! recover a message from its signature
 	/*! \pre size of recoveredMessage == MaxRecoverableLengthFromSignatureLength(signatureLength)
 	*/
@@ -0,0 +1,1280 @@
+// curve25519.cpp - written and placed in the public domain
+
+#include "pch.h"
+#include "curve25519.h"
+#include "integer.h"
+#include "nbtheory.h"
+#include "sha.h"
+#include "oids.h"
+#include "misc.h"
+#include "algparam.h"
+#include "argnames.h"
+
+#include <algorithm>
+
+NAMESPACE_BEGIN(CryptoPP)
+
+ANONYMOUS_NAMESPACE_BEGIN
+
+// ******************** GF(2^255-19) ********************
+
+// an element is sum(v[i] * 2^(51*i)), with limbs that may run a few bits over 51 between reductions
+struct FieldElement
+{
+	word64 v[5];
+};
+
+const word64 MASK51 = (W64LIT(1) << 51) - 1;
+
+#ifdef CRYPTOPP_WORD128_AVAILABLE
+typedef word128 Product;
+
+inline Product Multiply64(word64 a, word64 b) {return Product(a) * b;}
+inline word64 LowWord(const Product &p) {return word64(p);}
+inline word64 Shift51(const Product &p) {return word64(p >> 51);}
+#else
+// a 128-bit accumulator for compilers without a native type
+struct Product
+{
+	Product(word64 low=0, word64 high=0) : lo(low), hi(high) {}
+	Product & operator+=(const Product &b) {lo += b.lo; hi += b.hi + (lo < b.lo); return *this;}
+	Product operator+(const Product &b) const {Product r(*this); return r += b;}
+
+	word64 lo, hi;
+};
+
+inline Product Multiply64(word64 a, word64 b)
+{
+	word64 a0 = word32(a), a1 = a >> 32, b0 = word32(b), b1 = b >> 32;
+	word64 p00 = a0*b0, p01 = a0*b1, p10 = a1*b0, p11 = a1*b1;
+	word64 middle = (p00 >> 32) + word32(p01) + word32(p10);
+	return Product((middle << 32) | word32(p00), p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32));
+}
+inline word64 LowWord(const Product &p) {return p.lo;}
+inline word64 Shift51(const Product &p) {return (p.lo >> 51) | (p.hi << 13);}
+#endif
+
+inline void SetSmall(FieldElement &h, word64 x)
+{
+	h.v[0] = x;
+	h.v[1] = h.v[2] = h.v[3] = h.v[4] = 0;
+}
+
+// limbs of the sum are at most one bit longer than the longer input's
+inline void Add(FieldElement &h, const FieldElement &f, const FieldElement &g)
+{
+	for (unsigned int i=0; i<5; i++)
+		h.v[i] = f.v[i] + g.v[i];
+}
+
+inline void Carry(FieldElement &h)
+{
+	word64 c;
+	c = h.v[0] >> 51; h.v[0] &= MASK51; h.v[1] += c;
+	c = h.v[1] >> 51; h.v[1] &= MASK51; h.v[2] += c;
+	c = h.v[2] >> 51; h.v[2] &= MASK51; h.v[3] += c;
+	c = h.v[3] >> 51; h.v[3] &= MASK51; h.v[4] += c;
+	c = h.v[4] >> 51; h.v[4] &= MASK51; h.v[0] += 19*c;
+}
+
+// adds 8p first, so limbs of g may be almost 2^54
+inline void Subtract(FieldElement &h, const FieldElement &f, const FieldElement &g)
+{
+	h.v[0] = f.v[0] + W64LIT(0x3FFFFFFFFFFF68) - g.v[0];
+	for (unsigned int i=1; i<5; i++)
+		h.v[i] = f.v[i] + W64LIT(0x3FFFFFFFFFFFF8) - g.v[i];
+	Carry(h);
+}
+
+inline void Negate(FieldElement &h, const FieldElement &f)
+{
+	FieldElement zero;
+	SetSmall(zero, 0);
+	Subtract(h, zero, f);
+}
+
+// products of limbs below 2^54 leave every r[i] below 2^115
+inline void Reduce(FieldElement &h, Product &r0, Product &r1, Product &r2, Product &r3, Product &r4)
+{
+	word64 h0, h1, h2, h3;
+	r1 += Shift51(r0); h0 = LowWord(r0) & MASK51;
+	r2 += Shift51(r1); h1 = LowWord(r1) & MASK51;
+	r3 += Shift51(r2); h2 = LowWord(r2) & MASK51;
+	r4 += Shift51(r3); h3 = LowWord(r3) & MASK51;
+	Product t = Multiply64(Shift51(r4), 19) + Product(h0);
+	h.v[0] = LowWord(t) & MASK51;
+	h.v[1] = h1 + Shift51(t);
+	h.v[2] = h2;
+	h.v[3] = h3;
+	h.v[4] = LowWord(r4) & MASK51;
+}
+
+void Multiply(FieldElement &h, const FieldElement &f, const FieldElement &g)
+{
+	const word64 f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+	const word64 g0 = g.v[0], g1 = g.v[1], g2 = g.v[2], g3 = g.v[3], g4 = g.v[4];
+	const word64 g1_19 = 19*g1, g2_19 = 19*g2, g3_19 = 19*g3, g4_19 = 19*g4;
+
+	Product r0 = Multiply64(f0, g0) + Multiply64(f1, g4_19) + Multiply64(f2, g3_19) + Multiply64(f3, g2_19) + Multiply64(f4, g1_19);
+	Product r1 = Multiply64(f0, g1) + Multiply64(f1, g0) + Multiply64(f2, g4_19) + Multiply64(f3, g3_19) + Multiply64(f4, g2_19);
+	Product r2 = Multiply64(f0, g2) + Multiply64(f1, g1) + Multiply64(f2, g0) + Multiply64(f3, g4_19) + Multiply64(f4, g3_19);
+	Product r3 = Multiply64(f0, g3) + Multiply64(f1, g2) + Multiply64(f2, g1) + Multiply64(f3, g0) + Multiply64(f4, g4_19);
+	Product r4 = Multiply64(f0, g4) + Multiply64(f1, g3) + Multiply64(f2, g2) + Multiply64(f3, g1) + Multiply64(f4, g0);
+	Reduce(h, r0, r1, r2, r3, r4);
+}
+
+void Square(FieldElement &h, const FieldElement &f)
+{
+	const word64 f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+	const word64 f0_2 = 2*f0, f1_2 = 2*f1, f2_2 = 2*f2, f3_2 = 2*f3;
+	const word64 f3_19 = 19*f3, f4_19 = 19*f4;
+
+	Product r0 = Multiply64(f0, f0) + Multiply64(f1_2, f4_19) + Multiply64(f2_2, f3_19);
+	Product r1 = Multiply64(f0_2, f1) + Multiply64(f2_2, f4_19) + Multiply64(f3, f3_19);
+	Product r2 = Multiply64(f0_2, f2) + Multiply64(f1, f1) + Multiply64(f3_2, f4_19);
+	Product r3 = Multiply64(f0_2, f3) + Multiply64(f1_2, f2) + Multiply64(f4, f4_19);
+	Product r4 = Multiply64(f0_2, f4) + Multiply64(f1_2, f3) + Multiply64(f2, f2);
+	Reduce(h, r0, r1, r2, r3, r4);
+}
+
+void SquareN(FieldElement &h, const FieldElement &f, unsigned int n)
+{
+	Square(h, f);
+	while (--n)
+		Square(h, h);
+}
+
+void MultiplySmall(FieldElement &h, const FieldElement &f, word32 k)
+{
+	Product r0 = Multiply64(f.v[0], k), r1 = Multiply64(f.v[1], k), r2 = Multiply64(f.v[2], k), r3 = Multiply64(f.v[3], k), r4 = Multiply64(f.v[4], k);
+	Reduce(h, r0, r1, r2, r3, r4);
+}
+
+// h = z^(2^250-1), and z11 = z^11 for the caller's last step
+void Power2To250Minus1(FieldElement &h, FieldElement &z11, const FieldElement &z)
+{
+	FieldElement z2, t, z9, z5_0, z10_0, z20_0, z50_0, z100_0;
+
+	Square(z2, z);
+	SquareN(t, z2, 2);
+	Multiply(z9, t, z);
+	Multiply(z11, z9, z2);
+	Square(t, z11);
+	Multiply(z5_0, t, z9);
+	SquareN(t, z5_0, 5);
+	Multiply(z10_0, t, z5_0);
+	SquareN(t, z10_0, 10);
+	Multiply(z20_0, t, z10_0);
+	SquareN(t, z20_0, 20);
+	Multiply(t, t, z20_0);
+	SquareN(t, t, 10);
+	Multiply(z50_0, t, z10_0);
+	SquareN(t, z50_0, 50);
+	Multiply(z100_0, t, z50_0);
+	SquareN(t, z100_0, 100);
+	Multiply(t, t, z100_0);
+	SquareN(t, t, 50);
+	Multiply(h, t, z50_0);
+}
+
+// h = z^(p-2) = 1/z
+void Invert(FieldElement &h, const FieldElement &z)
+{
+	FieldElement t, z11;
+	Power2To250Minus1(t, z11, z);
+	SquareN(t, t, 5);
+	Multiply(h, t, z11);
+}
+
+// h = z^((p-5)/8), for square roots
+void Power22523(FieldElement &h, const FieldElement &z)
+{
+	FieldElement t, z11;
+	Power2To250Minus1(t, z11, z);
+	SquareN(t, t, 2);
+	Multiply(h, t, z);
+}
+
+void Decode(FieldElement &h, const byte *s)
+{
+	word64 w0 = GetWord<word64>(false, LITTLE_ENDIAN_ORDER, s);
+	word64 w1 = GetWord<word64>(false, LITTLE_ENDIAN_ORDER, s+8);
+	word64 w2 = GetWord<word64>(false, LITTLE_ENDIAN_ORDER, s+16);
+	word64 w3 = GetWord<word64>(false, LITTLE_ENDIAN_ORDER, s+24);
+
+	// the top bit is ignored
+	h.v[0] = w0 & MASK51;
+	h.v[1] = ((w0 >> 51) | (w1 << 13)) & MASK51;
+	h.v[2] = ((w1 >> 38) | (w2 << 26)) & MASK51;
+	h.v[3] = ((w2 >> 25) | (w3 << 39)) & MASK51;
+	h.v[4] = (w3 >> 12) & MASK51;
+}
+
+// writes the unique representative below p
+void Encode(byte *s, const FieldElement &f)
+{
+	FieldElement h = f;
+	Carry(h);
+	Carry(h);
+
+	// q is 1 if h >= p
+	word64 q = (h.v[0] + 19) >> 51;
+	q = (h.v[1] + q) >> 51;
+	q = (h.v[2] + q) >> 51;
+	q = (h.v[3] + q) >> 51;
+	q = (h.v[4] + q) >> 51;
+
+	h.v[0] += 19*q;
+	h.v[1] += h.v[0] >> 51; h.v[0] &= MASK51;
+	h.v[2] += h.v[1] >> 51; h.v[1] &= MASK51;
+	h.v[3] += h.v[2] >> 51; h.v[2] &= MASK51;
+	h.v[4] += h.v[3] >> 51; h.v[3] &= MASK51;
+	h.v[4] &= MASK51;
+
+	PutWord(false, LITTLE_ENDIAN_ORDER, s, h.v[0] | (h.v[1] << 51));
+	PutWord(false, LITTLE_ENDIAN_ORDER, s+8, (h.v[1] >> 13) | (h.v[2] << 38));
+	PutWord(false, LITTLE_ENDIAN_ORDER, s+16, (h.v[2] >> 26) | (h.v[3] << 25));
+	PutWord(false, LITTLE_ENDIAN_ORDER, s+24, (h.v[3] >> 39) | (h.v[4] << 12));
+}
+
+bool IsNegative(const FieldElement &f)
+{
+	byte s[32];
+	Encode(s, f);
+	return (s[0] & 1) != 0;
+}
+
+bool IsZero(const FieldElement &f)
+{
+	byte s[32], acc = 0;
+	Encode(s, f);
+	for (unsigned int i=0; i<32; i++)
+		acc |= s[i];
+	return acc == 0;
+}
+
+// swap f and g if b is 1, without branching on b
+inline void ConditionalSwap(FieldElement &f, FieldElement &g, word64 b)
+{
+	const word64 mask = 0 - b;
+	for (unsigned int i=0; i<5; i++)
+	{
+		word64 x = mask & (f.v[i] ^ g.v[i]);
+		f.v[i] ^= x;
+		g.v[i] ^= x;
+	}
+}
+
+// set f to g if b is 1, without branching on b
+inline void ConditionalMove(FieldElement &f, const FieldElement &g, word64 b)
+{
+	const word64 mask = 0 - b;
+	for (unsigned int i=0; i<5; i++)
+		f.v[i] ^= mask & (f.v[i] ^ g.v[i]);
+}
+
+Integer DecodeLittleEndian(const byte *input, size_t length)
+{
+	SecByteBlock reversed(length);
+	std::reverse_copy(input, input+length, reversed.begin());
+	return Integer(reversed, length);
+}
+
+void EncodeLittleEndian(byte *output, size_t length, const Integer &x)
+{
+	x.Encode(output, length);
+	std::reverse(output, output+length);
+}
+
+// ******************** integers modulo the group order ********************
+
+// a scalar is sum(s[i] * 2^(21*i)), with signed limbs; this is the scalar arithmetic of the ref10 implementation,
+// which runs the same sequence of operations for every value, so the secret scalar and nonce don't affect its timing
+
+const sword64 LIMB21 = sword64(1) << 21;
+
+// loads a 32 or 64-byte little-endian number as 12 or 24 limbs of 21 bits, leaving the bits above them in the last limb
+void LoadScalarLimbs(sword64 *s, const byte *input, unsigned int count)
+{
+	for (unsigned int i=0; i<count; i++)
+	{
+		s[i] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, input + 21*i/8) >> (21*i%8);
+		if (i < count-1)
+			s[i] &= LIMB21-1;
+	}
+}
+
+// s[i] -= c*2^(21*i) and s[i+1] += c, where c is s[i]/2^21 rounded to the nearest integer
+inline void CarryRounded(sword64 *s, unsigned int i)
+{
+	const sword64 carry = (s[i] + (LIMB21 >> 1)) >> 21;
+	s[i+1] += carry;
+	s[i] -= carry * LIMB21;
+}
+
+// s[i] -= c*2^(21*i) and s[i+1] += c, where c is s[i]/2^21 rounded down, which leaves s[i] in [0, 2^21)
+inline void CarryFloor(sword64 *s, unsigned int i)
+{
+	const sword64 carry = s[i] >> 21;
+	s[i+1] += carry;
+	s[i] -= carry * LIMB21;
+}
+
+// folds s[i] into the six limbs below s[i-6] using 2^252 = -27742317777372353535851937790883648493 mod L
+inline void FoldScalarLimb(sword64 *s, unsigned int i)
+{
+	s[i-12] += s[i] * 666643;
+	s[i-11] += s[i] * 470296;
+	s[i-10] += s[i] * 654183;
+	s[i-9] -= s[i] * 997805;
+	s[i-8] += s[i] * 136657;
+	s[i-7] -= s[i] * 683901;
+	s[i] = 0;
+}
+
+// writes the 24 limbs of s reduced mod L as 32 little-endian bytes, and wipes s
+void ReduceScalarLimbs(byte *output, sword64 *s)
+{
+	unsigned int i;
+
+	for (i=23; i>=18; i--)
+		FoldScalarLimb(s, i);
+	for (i=6; i<=16; i+=2)
+		CarryRounded(s, i);
+	for (i=7; i<=15; i+=2)
+		CarryRounded(s, i);
+
+	for (i=17; i>=12; i--)
+		FoldScalarLimb(s, i);
+	for (i=0; i<=10; i+=2)
+		CarryRounded(s, i);
+	for (i=1; i<=11; i+=2)
+		CarryRounded(s, i);
+
+	FoldScalarLimb(s, 12);
+	for (i=0; i<=11; i++)
+		CarryFloor(s, i);
+	FoldScalarLimb(s, 12);
+	for (i=0; i<=10; i++)
+		CarryFloor(s, i);
+
+	word64 buffer = 0;
+	unsigned int bits = 0, j = 0;
+	for (i=0; i<12; i++)
+	{
+		buffer |= word64(s[i]) << bits;
+		for (bits += 21; bits >= 8; bits -= 8, buffer >>= 8)
+			output[j++] = byte(buffer);
+	}
+	output[j] = byte(buffer);
+	SecureWipeArray(s, 24);
+}
+
+// output = input mod L, for a 64-byte input
+void ReduceScalar(byte *output, const byte *input)
+{
+	sword64 s[24];
+	LoadScalarLimbs(s, input, 24);
+	ReduceScalarLimbs(output, s);
+}
+
+// output = a*b + c mod L, for 32-byte a, b and c
+void MultiplyAddScalars(byte *output, const byte *a, const byte *b, const byte *c)
+{
+	sword64 x[12], y[12], s[24];
+	LoadScalarLimbs(x, a, 12);
+	LoadScalarLimbs(y, b, 12);
+	LoadScalarLimbs(s, c, 12);
+
+	unsigned int i, j;
+	for (i=12; i<24; i++)
+		s[i] = 0;
+	for (i=0; i<12; i++)
+		for (j=0; j<12; j++)
+			s[i+j] += x[i] * y[j];
+	SecureWipeArray(x, 12);
+	SecureWipeArray(y, 12);
+
+	for (i=0; i<=22; i+=2)
+		CarryRounded(s, i);
+	for (i=1; i<=21; i+=2)
+		CarryRounded(s, i);
+	ReduceScalarLimbs(output, s);
+}
+
+// ******************** edwards25519 ********************
+
+// -x^2 + y^2 = 1 + d*x^2*y^2, with the base point and group order of RFC 8032
+struct CurveConstants
+{
+	CurveConstants();
+
+	FieldElement d, d2, sqrtm1;
+	Integer order;
+};
+
+CurveConstants::CurveConstants()
+{
+	const Integer p = Integer::Power2(255) - 19;
+	byte s[32];
+
+	EncodeLittleEndian(s, 32, (p - 121665) * Integer(121666).InverseMod(p) % p);
+	Decode(d, s);
+	Add(d2, d, d);
+	Carry(d2);
+	// 2 is not a square mod p, so 2^((p-1)/4) squares to -1
+	EncodeLittleEndian(s, 32, a_exp_b_mod_c(2, (p-1)/4, p));
+	Decode(sqrtm1, s);
+
+	order = Integer::Power2(252) + Integer("27742317777372353535851937790883648493");
+}
+
+const CurveConstants & Constants()
+{
+	return Singleton<CurveConstants>().Ref();
+}
+
+// extended coordinates: x = X/Z, y = Y/Z, x*y = T/Z
+struct EdwardsPoint
+{
+	FieldElement X, Y, Z, T;
+};
+
+// x = X/Z, y = Y/Z
+struct EdwardsProjective
+{
+	FieldElement X, Y, Z;
+};
+
+// the result of an addition or doubling: x = X/Z, y = Y/T
+struct EdwardsCompleted
+{
+	FieldElement X, Y, Z, T;
+};
+
+// an addend prepared from extended coordinates
+struct EdwardsCached
+{
+	FieldElement YplusX, YminusX, Z, T2d;
+};
+
+// an addend prepared from affine coordinates, for tables
+struct EdwardsNiels
+{
+	FieldElement yplusx, yminusx, xy2d;
+};
+
+void SetIdentity(EdwardsPoint &h)
+{
+	SetSmall(h.X, 0);
+	SetSmall(h.Y, 1);
+	SetSmall(h.Z, 1);
+	SetSmall(h.T, 0);
+}
+
+void SetIdentity(EdwardsProjective &h)
+{
+	SetSmall(h.X, 0);
+	SetSmall(h.Y, 1);
+	SetSmall(h.Z, 1);
+}
+
+void SetIdentity(EdwardsNiels &h)
+{
+	SetSmall(h.yplusx, 1);
+	SetSmall(h.yminusx, 1);
+	SetSmall(h.xy2d, 0);
+}
+
+inline void ToProjective(EdwardsProjective &r, const EdwardsCompleted &p)
+{
+	Multiply(r.X, p.X, p.T);
+	Multiply(r.Y, p.Y, p.Z);
+	Multiply(r.Z, p.Z, p.T);
+}
+
+inline void ToProjective(EdwardsProjective &r, const EdwardsPoint &p)
+{
+	r.X = p.X;
+	r.Y = p.Y;
+	r.Z = p.Z;
+}
+
+inline void ToExtended(EdwardsPoint &r, const EdwardsCompleted &p)
+{
+	Multiply(r.X, p.X, p.T);
+	Multiply(r.Y, p.Y, p.Z);
+	Multiply(r.Z, p.Z, p.T);
+	Multiply(r.T, p.X, p.Y);
+}
+
+void ToCached(EdwardsCached &r, const EdwardsPoint &p)
+{
+	Add(r.YplusX, p.Y, p.X);
+	Subtract(r.YminusX, p.Y, p.X);
+	r.Z = p.Z;
+	Multiply(r.T2d, p.T, Constants().d2);
+}
+
+void Double(EdwardsCompleted &r, const EdwardsProjective &p)
+{
+	FieldElement t0;
+	Square(r.X, p.X);
+	Square(r.Z, p.Y);
+	Square(r.T, p.Z);
+	Add(r.T, r.T, r.T);
+	Add(r.Y, p.X, p.Y);
+	Square(t0, r.Y);
+	Add(r.Y, r.Z, r.X);
+	Subtract(r.Z, r.Z, r.X);
+	Subtract(r.X, t0, r.Y);
+	Subtract(r.T, r.T, r.Z);
+}
+
+// p + q, or p - q if subtract is set; the sign only changes which operands are paired
+void Add(EdwardsCompleted &r, const EdwardsPoint &p, const EdwardsCached &q, bool subtract=false)
+{
+	FieldElement t0;
+	Add(r.X, p.Y, p.X);
+	Subtract(r.Y, p.Y, p.X);
+	Multiply(r.Z, r.X, subtract ? q.YminusX : q.YplusX);
+	Multiply(r.Y, r.Y, subtract ? q.YplusX : q.YminusX);
+	Multiply(r.T, q.T2d, p.T);
+	Multiply(r.X, p.Z, q.Z);
+	Add(t0, r.X, r.X);
+	Subtract(r.X, r.Z, r.Y);
+	Add(r.Y, r.Z, r.Y);
+	if (subtract)
+	{
+		Subtract(r.Z, t0, r.T);
+		Add(r.T, t0, r.T);
+	}
+	else
+	{
+		Add(r.Z, t0, r.T);
+		Subtract(r.T, t0, r.T);
+	}
+}
+
+void Add(EdwardsCompleted &r, const EdwardsPoint &p, const EdwardsNiels &q, bool subtract=false)
+{
+	FieldElement t0;
+	Add(r.X, p.Y, p.X);
+	Subtract(r.Y, p.Y, p.X);
+	Multiply(r.Z, r.X, subtract ? q.yminusx : q.yplusx);
+	Multiply(r.Y, r.Y, subtract ? q.yplusx : q.yminusx);
+	Multiply(r.T, q.xy2d, p.T);
+	Add(t0, p.Z, p.Z);
+	Subtract(r.X, r.Z, r.Y);
+	Add(r.Y, r.Z, r.Y);
+	if (subtract)
+	{
+		Subtract(r.Z, t0, r.T);
+		Add(r.T, t0, r.T);
+	}
+	else
+	{
+		Add(r.Z, t0, r.T);
+		Subtract(r.T, t0, r.T);
+	}
+}
+
+void EncodePoint(byte *s, const FieldElement &X, const FieldElement &Y, const FieldElement &Z)
+{
+	FieldElement recip, x, y;
+	Invert(recip, Z);
+	Multiply(x, X, recip);
+	Multiply(y, Y, recip);
+	Encode(s, y);
+	s[31] ^= byte(IsNegative(x)) << 7;
+}
+
+// returns false if s isn't the canonical encoding of a curve point
+bool DecodePoint(EdwardsPoint &h, const byte *s)
+{
+	const CurveConstants &c = Constants();
+	FieldElement one, u, v, v3, vxx, check;
+	byte canonical[32];
+
+	Decode(h.Y, s);
+	Encode(canonical, h.Y);
+	if (memcmp(canonical, s, 31) != 0 || canonical[31] != (s[31] & 0x7f))
+		return false;
+
+	// x^2 = u/v, and x = u*v^3*(u*v^7)^((p-5)/8) up to a factor of sqrt(-1)
+	SetSmall(one, 1);
+	Square(u, h.Y);
+	Multiply(v, u, c.d);
+	Subtract(u, u, one);
+	Add(v, v, one);
+	Square(v3, v);
+	Multiply(v3, v3, v);
+	Square(h.X, v3);
+	Multiply(h.X, h.X, v);
+	Multiply(h.X, h.X, u);
+	Power22523(h.X, h.X);
+	Multiply(h.X, h.X, v3);
+	Multiply(h.X, h.X, u);
+
+	Square(vxx, h.X);
+	Multiply(vxx, vxx, v);
+	Subtract(check, vxx, u);
+	if (!IsZero(check))
+	{
+		Add(check, vxx, u);
+		if (!IsZero(check))
+			return false;
+		Multiply(h.X, h.X, c.sqrtm1);
+	}
+
+	bool negative = (s[31] >> 7) != 0;
+	if (negative && IsZero(h.X))
+		return false;
+	if (IsNegative(h.X) != negative)
+		Negate(h.X, h.X);
+
+	SetSmall(h.Z, 1);
+	Multiply(h.T, h.X, h.Y);
+	return true;
+}
+
+// multiples of the base point: comb[i][j] = (j+1)*256^i*B, and odd[j] = (2j+1)*B for verification
+struct BaseTables
+{
+	BaseTables();
+
+	EdwardsNiels comb[32][8];
+	EdwardsNiels odd[32];
+};
+
+BaseTables::BaseTables()
+{
+	const Integer p = Integer::Power2(255) - 19;
+	byte s[32];
+	EncodeLittleEndian(s, 32, Integer(4) * Integer(5).InverseMod(p) % p);
+	EdwardsPoint B;
+	DecodePoint(B, s);
+
+	std::vector<EdwardsPoint> points(256+32);
+	EdwardsCompleted t;
+	EdwardsProjective q;
+	EdwardsCached addend;
+	EdwardsPoint P = B;
+	unsigned int i, j;
+
+	for (i=0; i<32; i++)
+	{
+		points[8*i] = P;
+		ToCached(addend, P);
+		for (j=1; j<8; j++)
+		{
+			Add(t, points[8*i+j-1], addend);
+			ToExtended(points[8*i+j], t);
+		}
+
+		ToProjective(q, P);
+		for (j=0; j<7; j++)
+		{
+			Double(t, q);
+			ToProjective(q, t);
+		}
+		Double(t, q);
+		ToExtended(P, t);
+	}
+
+	points[256] = B;
+	ToProjective(q, B);
+	Double(t, q);
+	ToExtended(P, t);
+	ToCached(addend, P);
+	for (j=1; j<32; j++)
+	{
+		Add(t, points[256+j-1], addend);
+		ToExtended(points[256+j], t);
+	}
+
+	// convert to affine coordinates with one inversion
+	std::vector<FieldElement> prefix(points.size());
+	prefix[0] = points[0].Z;
+	for (i=1; i<points.size(); i++)
+		Multiply(prefix[i], prefix[i-1], points[i].Z);
+	FieldElement inverse, zinv, x, y;
+	Invert(inverse, prefix.back());
+	for (i=(unsigned int)points.size(); i--; )
+	{
+		if (i > 0)
+		{
+			Multiply(zinv, inverse, prefix[i-1]);
+			Multiply(inverse, inverse, points[i].Z);
+		}
+		else
+			zinv = inverse;
+
+		EdwardsNiels &entry = i < 256 ? comb[i/8][i%8] : odd[i-256];
+		Multiply(x, points[i].X, zinv);
+		Multiply(y, points[i].Y, zinv);
+		Add(entry.yplusx, y, x);
+		Carry(entry.yplusx);
+		Subtract(entry.yminusx, y, x);
+		Multiply(entry.xy2d, x, y);
+		Multiply(entry.xy2d, entry.xy2d, Constants().d2);
+	}
+}
+
+const BaseTables & Tables()
+{
+	return Singleton<BaseTables>().Ref();
+}
+
+// t = b*table[0] for b in [-8, 8], reading every entry so the access pattern doesn't depend on b
+void Select(EdwardsNiels &t, const EdwardsNiels *table, signed char b)
+{
+	const word32 negative = byte(b) >> 7;
+	const word32 babs = (word32(b) ^ (0 - negative)) + negative;
+
+	SetIdentity(t);
+	for (unsigned int j=0; j<8; j++)
+	{
+		const word64 equal = ((babs ^ (j+1)) - 1) >> 31;
+		ConditionalMove(t.yplusx, table[j].yplusx, equal);
+		ConditionalMove(t.yminusx, table[j].yminusx, equal);
+		ConditionalMove(t.xy2d, table[j].xy2d, equal);
+	}
+
+	EdwardsNiels minus;
+	minus.yplusx = t.yminusx;
+	minus.yminusx = t.yplusx;
+	Negate(minus.xy2d, t.xy2d);
+	ConditionalMove(t.yplusx, minus.yplusx, negative);
+	ConditionalMove(t.yminusx, minus.yminusx, negative);
+	ConditionalMove(t.xy2d, minus.xy2d, negative);
+}
+
+// h = a*B for a 32-byte little-endian scalar a below 2^255, in constant time
+void ScalarMultiplyBase(EdwardsPoint &h, const byte *a)
+{
+	const BaseTables &tables = Tables();
+	signed char e[64];
+	int i;
+
+	// signed radix 16 digits in [-8, 8]
+	for (i=0; i<32; i++)
+	{
+		e[2*i] = a[i] & 15;
+		e[2*i+1] = (a[i] >> 4) & 15;
+	}
+	signed char carry = 0;
+	for (i=0; i<63; i++)
+	{
+		e[i] += carry;
+		carry = (e[i] + 8) >> 4;
+		e[i] -= carry << 4;
+	}
+	e[63] += carry;
+
+	// add the odd digits, multiply by 16, then add the even ones
+	EdwardsCompleted r;
+	EdwardsProjective s;
+	EdwardsNiels t;
+	SetIdentity(h);
+	for (i=1; i<64; i+=2)
+	{
+		Select(t, tables.comb[i/2], e[i]);
+		Add(r, h, t);
+		ToExtended(h, r);
+	}
+
+	ToProjective(s, h);
+	Double(r, s);
+	ToProjective(s, r);
+	Double(r, s);
+	ToProjective(s, r);
+	Double(r, s);
+	ToProjective(s, r);
+	Double(r, s);
+	ToExtended(h, r);
+
+	for (i=0; i<64; i+=2)
+	{
+		Select(t, tables.comb[i/2], e[i]);
+		Add(r, h, t);
+		ToExtended(h, r);
+	}
+}
+
+// width w non-adjacent form of a scalar below 2^253: odd digits below 2^(w-1) in absolute value, at least w apart
+void ComputeNAF(signed char *naf, const byte *scalar, unsigned int w)
+{
+	word32 k[9];
+	unsigned int i, j;
+	for (i=0; i<8; i++)
+		k[i] = GetWord<word32>(false, LITTLE_ENDIAN_ORDER, scalar+4*i);
+	k[8] = 0;
+	memset(naf, 0, 256);
+
+	const int width = 1 << w;
+	for (i=0; i<256; )
+	{
+		if (((k[i/32] >> (i%32)) & 1) == 0)
+		{
+			i++;
+			continue;
+		}
+
+		int digit = int((((word64(k[i/32+1]) << 32) | k[i/32]) >> (i%32)) & (width-1));
+		for (j=i; j<i+w; j++)
+			k[j/32] &= ~(word32(1) << (j%32));
+		if (digit >= width/2)
+		{
+			// borrow 2^(i+w) from the higher digits
+			digit -= width;
+			word32 add = word32(1) << ((i+w)%32);
+			for (j=(i+w)/32; j<9 && add; j++)
+			{
+				k[j] += add;
+				add = k[j] < add;
+			}
+		}
+		naf[i] = (signed char)digit;
+		i += w;
+	}
+}
+
+// r = a*A + b*B, in variable time
+void DoubleScalarMultiplyVartime(EdwardsProjective &r, const byte *a, const EdwardsPoint &A, const byte *b)
+{
+	const BaseTables &tables = Tables();
+	signed char aNAF[256], bNAF[256];
+	ComputeNAF(aNAF, a, 5);
+	ComputeNAF(bNAF, b, 7);
+
+	// odd multiples A, 3A, ..., 15A
+	EdwardsCached oddA[8];
+	EdwardsCompleted t;
+	EdwardsPoint u, A2;
+	ToCached(oddA[0], A);
+	ToProjective(r, A);
+	Double(t, r);
+	ToExtended(A2, t);
+	u = A;
+	for (unsigned int j=1; j<8; j++)
+	{
+		Add(t, A2, oddA[j-1]);
+		ToExtended(u, t);
+		ToCached(oddA[j], u);
+	}
+
+	SetIdentity(r);
+	int i = 255;
+	while (i >= 0 && !aNAF[i] && !bNAF[i])
+		i--;
+
+	for (; i>=0; i--)
+	{
+		Double(t, r);
+		if (aNAF[i])
+		{
+			ToExtended(u, t);
+			Add(t, u, oddA[(aNAF[i] < 0 ? -aNAF[i] : aNAF[i])/2], aNAF[i] < 0);
+		}
+		if (bNAF[i])
+		{
+			ToExtended(u, t);
+			Add(t, u, tables.odd[(bNAF[i] < 0 ? -bNAF[i] : bNAF[i])/2], bNAF[i] < 0);
+		}
+		ToProjective(r, t);
+	}
+}
+
+// checks a signature on a message whose hash has absorbed R || A || M
+bool VerifySignature(const byte *publicKey, const byte *signature, SHA512 &hash)
+{
+	const CurveConstants &c = Constants();
+	byte digest[SHA512::DIGESTSIZE];
+	hash.Final(digest);
+
+	if (DecodeLittleEndian(signature+32, 32) >= c.order)
+		return false;
+	EdwardsPoint A;
+	if (!DecodePoint(A, publicKey))
+		return false;
+	Negate(A.X, A.X);
+	Negate(A.T, A.T);
+
+	// R == S*B - k*A
+	byte k[32], check[32];
+	ReduceScalar(k, digest);
+	EdwardsProjective R;
+	DoubleScalarMultiplyVartime(R, k, A, signature+32);
+	EncodePoint(check, R.X, R.Y, R.Z);
+	return VerifyBufsEqual(check, signature, 32);
+}
+
+// ******************** X25519 ********************
+
+inline void Clamp(byte *scalar)
+{
+	scalar[0] &= 248;
+	scalar[31] &= 127;
+	scalar[31] |= 64;
+}
+
+// the Montgomery ladder of RFC 7748, section 5
+void MontgomeryLadder(byte *output, const byte *scalar, const byte *point)
+{
+	FixedSizeSecBlock<byte, 32> e;
+	memcpy(e, scalar, 32);
+	Clamp(e);
+
+	FieldElement x1, x2, z2, x3, z3, A, AA, B, BB, E, C, D, DA, CB;
+	Decode(x1, point);
+	SetSmall(x2, 1);
+	SetSmall(z2, 0);
+	x3 = x1;
+	SetSmall(z3, 1);
+
+	word64 swap = 0;
+	for (int t=254; t>=0; t--)
+	{
+		const word64 bit = (e[t/8] >> (t%8)) & 1;
+		swap ^= bit;
+		ConditionalSwap(x2, x3, swap);
+		ConditionalSwap(z2, z3, swap);
+		swap = bit;
+
+		Add(A, x2, z2);
+		Square(AA, A);
+		Subtract(B, x2, z2);
+		Square(BB, B);
+		Subtract(E, AA, BB);
+		Add(C, x3, z3);
+		Subtract(D, x3, z3);
+		Multiply(DA, D, A);
+		Multiply(CB, C, B);
+		Add(x3, DA, CB);
+		Square(x3, x3);
+		Subtract(z3, DA, CB);
+		Square(z3, z3);
+		Multiply(z3, z3, x1);
+		Multiply(x2, AA, BB);
+		MultiplySmall(z2, E, 121665);
+		Add(z2, z2, AA);
+		Multiply(z2, z2, E);
+	}
+	ConditionalSwap(x2, x3, swap);
+	ConditionalSwap(z2, z3, swap);
+
+	Invert(z2, z2);
+	Multiply(x2, x2, z2);
+	Encode(output, x2);
+}
+
+// ******************** Ed25519 accumulators ********************
+
+class Ed25519SigningAccumulator : public PK_MessageAccumulator
+{
+public:
+	void Update(const byte *input, size_t length)
+		{m_message.insert(m_message.end(), input, input+length);}
+
+	std::vector<byte> m_message;
+};
+
+class Ed25519VerificationAccumulator : public PK_MessageAccumulator
+{
+public:
+	Ed25519VerificationAccumulator() : m_signatureInput(false) {}
+
+	void Update(const byte *input, size_t length)
+	{
+		if (m_signatureInput)
+			m_hash.Update(input, length);
+		else
+			m_message.insert(m_message.end(), input, input+length);
+	}
+
+	SHA512 m_hash;
+	std::vector<byte> m_message;
+	SecByteBlock m_signature;
+	bool m_signatureInput;
+};
+
+NAMESPACE_END
+
+// ******************** X25519 ********************
+
+void X25519::GeneratePrivateKey(RandomNumberGenerator &rng, byte *privateKey) const
+{
+	rng.GenerateBlock(privateKey, SECRET_KEYLENGTH);
+	Clamp(privateKey);
+}
+
+void X25519::GeneratePublicKey(RandomNumberGenerator &rng, const byte *privateKey, byte *publicKey) const
+{
+	FixedSizeSecBlock<byte, SECRET_KEYLENGTH> e;
+	memcpy(e, privateKey, SECRET_KEYLENGTH);
+	Clamp(e);
+
+	// the base point u = 9 is the image of the Ed25519 base point under u = (1+y)/(1-y)
+	EdwardsPoint P;
+	ScalarMultiplyBase(P, e);
+	FieldElement u, denominator;
+	Add(u, P.Z, P.Y);
+	Subtract(denominator, P.Z, P.Y);
+	Invert(denominator, denominator);
+	Multiply(u, u, denominator);
+	Encode(publicKey, u);
+}
+
+bool X25519::Agree(byte *agreedValue, const byte *privateKey, const byte *otherPublicKey, bool validateOtherPublicKey) const
+{
+	MontgomeryLadder(agreedValue, privateKey, otherPublicKey);
+
+	// every 32-byte string is a usable public key, but points of small order give an all zero value
+	byte acc = 0;
+	for (unsigned int i=0; i<SHARED_KEYLENGTH; i++)
+		acc |= agreedValue[i];
+	return acc != 0;
+}
+
+// ******************** Ed25519 keys ********************
+
+OID Ed25519PublicKey::GetAlgorithmID() const
+{
+	return ASN1::id_Ed25519();
+}
+
+bool Ed25519PublicKey::BERDecodeAlgorithmParameters(BufferedTransformation &bt)
+{
+	// RFC 8410 says the parameters must be absent
+	BERDecodeError();
+	return false;
+}
+
+void Ed25519PublicKey::BERDecodePublicKey(BufferedTransformation &bt, bool parametersPresent, size_t size)
+{
+	if (size != PUBLIC_KEYLENGTH || bt.Get(m_publicKey, PUBLIC_KEYLENGTH) != PUBLIC_KEYLENGTH)
+		BERDecodeError();
+}
+
+void Ed25519PublicKey::DEREncodePublicKey(BufferedTransformation &bt) const
+{
+	bt.Put(m_publicKey, PUBLIC_KEYLENGTH);
+}
+
+bool Ed25519PublicKey::Validate(RandomNumberGenerator &rng, unsigned int level) const
+{
+	if (level == 0)
+		return true;
+
+	EdwardsPoint A;
+	if (!DecodePoint(A, m_publicKey))
+		return false;
+	if (level < 3)
+		return true;
+
+	// the key must be in the subgroup of prime order
+	byte order[32], zero[32] = {0}, check[32], identity[32] = {1};
+	EncodeLittleEndian(order, 32, Constants().order);
+	EdwardsProjective R;
+	DoubleScalarMultiplyVartime(R, order, A, zero);
+	EncodePoint(check, R.X, R.Y, R.Z);
+	return memcmp(check, identity, 32) == 0;
+}
+
+bool Ed25519PublicKey::GetVoidValue(const char *name, const std::type_info &valueType, void *pValue) const
+{
+	if (strcmp(name, Name::PublicElement()) == 0)
+	{
+		ThrowIfTypeMismatch(name, typeid(ConstByteArrayParameter), valueType);
+		*reinterpret_cast<ConstByteArrayParameter *>(pValue) = ConstByteArrayParameter(m_publicKey, PUBLIC_KEYLENGTH, false);
+		return true;
+	}
+	return false;
+}
+
+void Ed25519PublicKey::AssignFrom(const NameValuePairs &source)
+{
+	ConstByteArrayParameter publicKey;
+	if (!source.GetValue(Name::PublicElement(), publicKey) || publicKey.size() != PUBLIC_KEYLENGTH)
+		throw InvalidArgument("Ed25519PublicKey: missing or invalid parameter 'PublicElement'");
+	Initialize(publicKey.begin());
+}
+
+void Ed25519PrivateKey::Initialize(const byte *seed)
+{
+	memcpy(m_seed, seed, SECRET_KEYLENGTH);
+
+	FixedSizeSecBlock<byte, SHA512::DIGESTSIZE> h;
+	SHA512().CalculateDigest(h, seed, SECRET_KEYLENGTH);
+	memcpy(m_scalar, h, SECRET_KEYLENGTH);
+	Clamp(m_scalar);
+	memcpy(m_prefix, h+32, 32);
+
+	EdwardsPoint A;
+	ScalarMultiplyBase(A, m_scalar);
+	EncodePoint(m_publicKey, A.X, A.Y, A.Z);
+}
+
+OID Ed25519PrivateKey::GetAlgorithmID() const
+{
+	return ASN1::id_Ed25519();
+}
+
+bool Ed25519PrivateKey::BERDecodeAlgorithmParameters(BufferedTransformation &bt)
+{
+	// RFC 8410 says the parameters must be absent
+	BERDecodeError();
+	return false;
+}
+
+void Ed25519PrivateKey::BERDecodePrivateKey(BufferedTransformation &bt, bool parametersPresent, size_t size)
+{
+	SecByteBlock seed;
+	BERDecodeOctetString(bt, seed);
+	if (seed.size() != SECRET_KEYLENGTH)
+		BERDecodeError();
+	Initialize(seed);
+}
+
+void Ed25519PrivateKey::DEREncodePrivateKey(BufferedTransformation &bt) const
+{
+	DEREncodeOctetString(bt, m_seed, SECRET_KEYLENGTH);
+}
+
+void Ed25519PrivateKey::GenerateRandom(RandomNumberGenerator &rng, const NameValuePairs &params)
+{
+	FixedSizeSecBlock<byte, SECRET_KEYLENGTH> seed;
+	rng.GenerateBlock(seed, SECRET_KEYLENGTH);
+	Initialize(seed);
+}
+
+bool Ed25519PrivateKey::Validate(RandomNumberGenerator &rng, unsigned int level) const
+{
+	if (level == 0)
+		return true;
+
+	// any seed is a key, so just check that the public key still belongs to it
+	byte publicKey[PUBLIC_KEYLENGTH];
+	EdwardsPoint A;
+	ScalarMultiplyBase(A, m_scalar);
+	EncodePoint(publicKey, A.X, A.Y, A.Z);
+	return memcmp(publicKey, m_publicKey, PUBLIC_KEYLENGTH) == 0;
+}
+
+bool Ed25519PrivateKey::GetVoidValue(const char *name, const std::type_info &valueType, void *pValue) const
+{
+	if (strcmp(name, Name::Seed()) == 0 || strcmp(name, Name::PublicElement()) == 0)
+	{
+		ThrowIfTypeMismatch(name, typeid(ConstByteArrayParameter), valueType);
+		*reinterpret_cast<ConstByteArrayParameter *>(pValue) = strcmp(name, Name::Seed()) == 0
+			? ConstByteArrayParameter(m_seed, SECRET_KEYLENGTH, false)
+			: ConstByteArrayParameter(m_publicKey, PUBLIC_KEYLENGTH, false);
+		return true;
+	}
+	return false;
+}
+
+void Ed25519PrivateKey::AssignFrom(const NameValuePairs &source)
+{
+	ConstByteArrayParameter seed;
+	if (!source.GetValue(Name::Seed(), seed) || seed.size() != SECRET_KEYLENGTH)
+		throw InvalidArgument("Ed25519PrivateKey: missing or invalid parameter 'Seed'");
+	Initialize(seed.begin());
+}
+
+// ******************** Ed25519 signatures ********************
+
+PK_MessageAccumulator * Ed25519Signer::NewSignatureAccumulator(RandomNumberGenerator &rng) const
+{
+	return new Ed25519SigningAccumulator;
+}
+
+void Ed25519Signer::InputRecoverableMessage(PK_MessageAccumulator &messageAccumulator, const byte *recoverableMessage, size_t recoverableMessageLength) const
+{
+	throw NotImplemented("Ed25519Signer: this object does not support message recovery");
+}
+
+size_t Ed25519Signer::SignAndRestart(RandomNumberGenerator &rng, PK_MessageAccumulator &messageAccumulator, byte *signature, bool restart) const
+{
+	Ed25519SigningAccumulator &ma = static_cast<Ed25519SigningAccumulator &>(messageAccumulator);
+	size_t signatureLength = SignMessage(rng, ma.m_message.empty() ? NULL : &ma.m_message[0], ma.m_message.size(), signature);
+	if (restart)
+		ma.m_message.clear();
+	return signatureLength;
+}
+
+size_t Ed25519Signer::SignMessage(RandomNumberGenerator &rng, const byte *message, size_t messageLen, byte *signature) const
+{
+	SHA512 hash;
+	FixedSizeSecBlock<byte, SHA512::DIGESTSIZE> digest;
+	FixedSizeSecBlock<byte, 32> nonce;
+	byte k[32];
+
+	// R = r*B, with r derived from the key and the message
+	hash.Update(m_key.m_prefix, 32);
+	hash.Update(message, messageLen);
+	hash.Final(digest);
+	ReduceScalar(nonce, digest);
+	EdwardsPoint R;
+	ScalarMultiplyBase(R, nonce);
+	EncodePoint(signature, R.X, R.Y, R.Z);
+
+	// S = r + k*a, with k = H(R || A || M)
+	hash.Update(signature, 32);
+	hash.Update(m_key.m_publicKey, Ed25519PrivateKey::PUBLIC_KEYLENGTH);
+	hash.Update(message, messageLen);
+	hash.Final(digest);
+	ReduceScalar(k, digest);
+	MultiplyAddScalars(signature+32, k, m_key.m_scalar, nonce);
+
+	return SIGNATURE_LENGTH;
+}
+
+PK_MessageAccumulator * Ed25519Verifier::NewVerificationAccumulator() const
+{
+	return new Ed25519VerificationAccumulator;
+}
+
+void Ed25519Verifier::InputSignature(PK_MessageAccumulator &messageAccumulator, const byte *signature, size_t signatureLength) const
+{
+	Ed25519VerificationAccumulator &ma = static_cast<Ed25519VerificationAccumulator &>(messageAccumulator);
+	ma.m_signature.Assign(signature, signatureLength);
+	ma.m_hash.Restart();
+	ma.m_hash.Update(signature, STDMIN(signatureLength, size_t(32)));
+	ma.m_hash.Update(m_key.GetPublicKeyBytes(), Ed25519PublicKey::PUBLIC_KEYLENGTH);
+	if (!ma.m_message.empty())
+		ma.m_hash.Update(&ma.m_message[0], ma.m_message.size());
+	ma.m_message.clear();
+	ma.m_signatureInput = true;
+}
+
+bool Ed25519Verifier::VerifyAndRestart(PK_MessageAccumulator &messageAccumulator) const
+{
+	Ed25519VerificationAccumulator &ma = static_cast<Ed25519VerificationAccumulator &>(messageAccumulator);
+	bool result = ma.m_signatureInput && ma.m_signature.size() == SIGNATURE_LENGTH
+		&& VerifySignature(m_key.GetPublicKeyBytes(), ma.m_signature, ma.m_hash);
+	ma.m_hash.Restart();
+	ma.m_message.clear();
+	ma.m_signatureInput = false;
+	return result;
+}
+
+bool Ed25519Verifier::VerifyMessage(const byte *message, size_t messageLen, const byte *signature, size_t signatureLength) const
+{
+	if (signatureLength != SIGNATURE_LENGTH)
+		return false;
+
+	SHA512 hash;
+	hash.Update(signature, 32);
+	hash.Update(m_key.GetPublicKeyBytes(), Ed25519PublicKey::PUBLIC_KEYLENGTH);
+	hash.Update(message, messageLen);
+	return VerifySignature(m_key.GetPublicKeyBytes(), signature, hash);
+}
+
+DecodingResult Ed25519Verifier::RecoverAndRestart(byte *recoveredMessage, PK_MessageAccumulator &messageAccumulator) const
+{
+	throw NotImplemented("Ed25519Verifier: this object does not support message recovery");
+}
+
+NAMESPACE_END
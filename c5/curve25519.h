@@ -0,0 +1,193 @@
+#ifndef CRYPTOPP_CURVE25519_H
+#define CRYPTOPP_CURVE25519_H
+
+/** \file
+	X25519 key agreement (RFC 7748) and Ed25519 signatures (RFC 8032)
+
+	Unlike the ECP based schemes in eccrypto.h, these work directly on
+	GF(2^255-19) elements held in five 51-bit limbs, use the Montgomery
+	ladder for key agreement and a comb table of multiples of the base
+	point for key and signature generation.
+*/
+
+#include "cryptlib.h"
+#include "secblock.h"
+#include "asn.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+//! X25519 key agreement domain, see RFC 7748
+/*! Private keys, public keys and agreed values are all 32 bytes. Private keys are
+	clamped when they're generated and again when they're used, so any 32 bytes
+	make a usable private key. Agree() returns false if the other public key is
+	a point of small order, since the agreed value is then all zero. */
+class X25519 : public SimpleKeyAgreementDomain
+{
+public:
+	enum {SECRET_KEYLENGTH = 32, PUBLIC_KEYLENGTH = 32, SHARED_KEYLENGTH = 32};
+
+	static std::string CRYPTOPP_API StaticAlgorithmName() {return "X25519";}
+	std::string AlgorithmName() const {return StaticAlgorithmName();}
+
+	CryptoParameters & AccessCryptoParameters() {return m_parameters;}
+
+	unsigned int AgreedValueLength() const {return SHARED_KEYLENGTH;}
+	unsigned int PrivateKeyLength() const {return SECRET_KEYLENGTH;}
+	unsigned int PublicKeyLength() const {return PUBLIC_KEYLENGTH;}
+
+	void GeneratePrivateKey(RandomNumberGenerator &rng, byte *privateKey) const;
+	void GeneratePublicKey(RandomNumberGenerator &rng, const byte *privateKey, byte *publicKey) const;
+	bool Agree(byte *agreedValue, const byte *privateKey, const byte *otherPublicKey, bool validateOtherPublicKey=true) const;
+
+private:
+	// the curve is fixed, so there is nothing to assign or check
+	class Parameters : public CryptoParameters
+	{
+	public:
+		void AssignFrom(const NameValuePairs &source) {}
+		bool Validate(RandomNumberGenerator &rng, unsigned int level) const {return true;}
+		bool GetVoidValue(const char *name, const std::type_info &valueType, void *pValue) const {return false;}
+	};
+
+	Parameters m_parameters;
+};
+
+//! Ed25519 public key, encoded as a subjectPublicKeyInfo as in RFC 8410
+class Ed25519PublicKey : public X509PublicKey
+{
+public:
+	enum {PUBLIC_KEYLENGTH = 32};
+
+	void Initialize(const byte *publicKey) {memcpy(m_publicKey, publicKey, PUBLIC_KEYLENGTH);}
+	const byte * GetPublicKeyBytes() const {return m_publicKey;}
+
+	// X509PublicKey
+	OID GetAlgorithmID() const;
+	bool BERDecodeAlgorithmParameters(BufferedTransformation &bt);
+	bool DEREncodeAlgorithmParameters(BufferedTransformation &bt) const {return false;}
+	void BERDecodePublicKey(BufferedTransformation &bt, bool parametersPresent, size_t size);
+	void DEREncodePublicKey(BufferedTransformation &bt) const;
+
+	// CryptoMaterial
+	bool Validate(RandomNumberGenerator &rng, unsigned int level) const;
+	bool GetVoidValue(const char *name, const std::type_info &valueType, void *pValue) const;
+	void AssignFrom(const NameValuePairs &source);
+
+private:
+	FixedSizeSecBlock<byte, PUBLIC_KEYLENGTH> m_publicKey;
+};
+
+//! Ed25519 private key, a 32-byte seed encoded as a privateKeyInfo as in RFC 8410
+/*! The signing scalar, the nonce prefix and the public key are derived from the seed when it's set. */
+class Ed25519PrivateKey : public PKCS8PrivateKey
+{
+public:
+	enum {SECRET_KEYLENGTH = 32, PUBLIC_KEYLENGTH = 32};
+
+	void Initialize(const byte *seed);
+	const byte * GetPublicKeyBytes() const {return m_publicKey;}
+
+	// PKCS8PrivateKey
+	OID GetAlgorithmID() const;
+	bool BERDecodeAlgorithmParameters(BufferedTransformation &bt);
+	bool DEREncodeAlgorithmParameters(BufferedTransformation &bt) const {return false;}
+	void BERDecodePrivateKey(BufferedTransformation &bt, bool parametersPresent, size_t size);
+	void DEREncodePrivateKey(BufferedTransformation &bt) const;
+
+	// GeneratableCryptoMaterial
+	void GenerateRandom(RandomNumberGenerator &rng, const NameValuePairs &params = g_nullNameValuePairs);
+	bool Validate(RandomNumberGenerator &rng, unsigned int level) const;
+	bool GetVoidValue(const char *name, const std::type_info &valueType, void *pValue) const;
+	void AssignFrom(const NameValuePairs &source);
+
+private:
+	friend class Ed25519Signer;
+
+	FixedSizeSecBlock<byte, SECRET_KEYLENGTH> m_seed, m_scalar, m_prefix;
+	FixedSizeSecBlock<byte, PUBLIC_KEYLENGTH> m_publicKey;
+};
+
+//! Ed25519 signer
+/*! Signing hashes the message twice, so a message given to an accumulator is buffered until
+	the signature is made. SignMessage() reads the message in place. */
+class Ed25519Signer : public PK_Signer
+{
+public:
+	enum {SIGNATURE_LENGTH = 64};
+
+	Ed25519Signer() {}
+	Ed25519Signer(RandomNumberGenerator &rng) {m_key.GenerateRandom(rng);}
+	Ed25519Signer(const byte *seed) {m_key.Initialize(seed);}
+	Ed25519Signer(BufferedTransformation &bt) {m_key.Load(bt);}
+
+	static std::string CRYPTOPP_API StaticAlgorithmName() {return "Ed25519";}
+	std::string AlgorithmName() const {return StaticAlgorithmName();}
+
+	PrivateKey & AccessPrivateKey() {return m_key;}
+	const PrivateKey & GetPrivateKey() const {return m_key;}
+	const Ed25519PrivateKey & GetKey() const {return m_key;}
+
+	size_t SignatureLength() const {return SIGNATURE_LENGTH;}
+	size_t MaxRecoverableLength() const {return 0;}
+	size_t MaxRecoverableLengthFromSignatureLength(size_t signatureLength) const {return 0;}
+	bool IsProbabilistic() const {return false;}
+	bool AllowNonrecoverablePart() const {return true;}
+	bool RecoverablePartFirst() const {return false;}
+
+	PK_MessageAccumulator * NewSignatureAccumulator(RandomNumberGenerator &rng) const;
+	void InputRecoverableMessage(PK_MessageAccumulator &messageAccumulator, const byte *recoverableMessage, size_t recoverableMessageLength) const;
+	size_t SignAndRestart(RandomNumberGenerator &rng, PK_MessageAccumulator &messageAccumulator, byte *signature, bool restart=true) const;
+	size_t SignMessage(RandomNumberGenerator &rng, const byte *message, size_t messageLen, byte *signature) const;
+
+private:
+	Ed25519PrivateKey m_key;
+};
+
+//! Ed25519 verifier
+/*! The message is hashed as it arrives once the signature has been input, and is buffered until then. */
+class Ed25519Verifier : public PK_Verifier
+{
+public:
+	enum {SIGNATURE_LENGTH = 64};
+
+	Ed25519Verifier() {}
+	Ed25519Verifier(const byte *publicKey) {m_key.Initialize(publicKey);}
+	Ed25519Verifier(const Ed25519Signer &signer) {m_key.AssignFrom(signer.GetKey());}
+	Ed25519Verifier(BufferedTransformation &bt) {m_key.Load(bt);}
+
+	static std::string CRYPTOPP_API StaticAlgorithmName() {return "Ed25519";}
+	std::string AlgorithmName() const {return StaticAlgorithmName();}
+
+	PublicKey & AccessPublicKey() {return m_key;}
+	const PublicKey & GetPublicKey() const {return m_key;}
+	const Ed25519PublicKey & GetKey() const {return m_key;}
+
+	size_t SignatureLength() const {return SIGNATURE_LENGTH;}
+	size_t MaxRecoverableLength() const {return 0;}
+	size_t MaxRecoverableLengthFromSignatureLength(size_t signatureLength) const {return 0;}
+	bool IsProbabilistic() const {return false;}
+	bool AllowNonrecoverablePart() const {return true;}
+	bool RecoverablePartFirst() const {return false;}
+
+	PK_MessageAccumulator * NewVerificationAccumulator() const;
+	void InputSignature(PK_MessageAccumulator &messageAccumulator, const byte *signature, size_t signatureLength) const;
+	bool VerifyAndRestart(PK_MessageAccumulator &messageAccumulator) const;
+	bool VerifyMessage(const byte *message, size_t messageLen, const byte *signature, size_t signatureLength) const;
+	DecodingResult RecoverAndRestart(byte *recoveredMessage, PK_MessageAccumulator &messageAccumulator) const;
+
+private:
+	Ed25519PublicKey m_key;
+};
+
+//! <a href="http://tools.ietf.org/html/rfc8032">Ed25519</a>, pure EdDSA over the twisted Edwards form of Curve25519
+struct Ed25519
+{
+	static std::string CRYPTOPP_API StaticAlgorithmName() {return "Ed25519";}
+
+	typedef Ed25519Signer Signer;
+	typedef Ed25519Verifier Verifier;
+};
+
+NAMESPACE_END
+
+#endif
@@ -94,6 +94,7 @@ template<> class EcPrecomputation<EC2N> : public DL_GroupPrecomputation<EC2N::Po
 {
 public:
 	typedef EC2N EllipticCurve;
+	typedef DL_FixedBasePrecomputationImpl<EC2N::Point> BasePrecomputation;
 
 	// DL_GroupPrecomputation
 	const AbstractGroup<Element> & GetGroup() const {return m_ec;}
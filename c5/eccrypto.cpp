@@ -103,6 +103,18 @@ template<> struct EcRecommendedParameters<ECP>
 	unsigned int h;
 };
 
+// curves with an endomorphism that ECP can use to speed up point multiplication
+inline void SetEndomorphism(EC2N &, const OID &, const Integer &)
+{
+}
+
+inline void SetEndomorphism(ECP &ec, const OID &oid, const Integer &n)
+{
+	// beta and lambda are the cube roots of 1 modulo p and n that go together
+	if (oid == ASN1::secp256k1())
+		ec.SetEndomorphism(Integer("7AE96A2B657C07106E64479EAC3434E99CF0497512F58995C1396C28719501EEh"), Integer("5363AD4CC05C30E0A5261C028812645A122E22EA20816678DF02967C1B23BD72h"), n);
+}
+
 struct OIDLessThan
 {
 	template <typename T>
@@ -429,7 +441,12 @@ template <class EC> void DL_GroupParameters_EC<EC>::Initialize(const OID &oid)
 
 	const EcRecommendedParameters<EllipticCurve> &param = *it;
 	m_oid = oid;
+	StringSource ssN(param.n, true, new HexDecoder);
+	m_n.Decode(ssN, (size_t)ssN.MaxRetrievable());
+	m_k = param.h;
+
 	std::auto_ptr<EllipticCurve> ec(param.NewEC());
+	SetEndomorphism(*ec, oid, m_n);
 	this->m_groupPrecomputation.SetCurve(*ec);
 
 	StringSource ssG(param.g, true, new HexDecoder);
@@ -437,10 +454,6 @@ template <class EC> void DL_GroupParameters_EC<EC>::Initialize(const OID &oid)
 	bool result = GetCurve().DecodePoint(G, ssG, (size_t)ssG.MaxRetrievable());
 	this->SetSubgroupGenerator(G);
 	assert(result);
-
-	StringSource ssN(param.n, true, new HexDecoder);
-	m_n.Decode(ssN, (size_t)ssN.MaxRetrievable());
-	m_k = param.h;
 }
 
 template <class EC>
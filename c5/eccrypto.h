@@ -22,7 +22,7 @@ NAMESPACE_BEGIN(CryptoPP)
     in ANSI X9.62 (also SEC 1).
 */
 template <class EC>
-class DL_GroupParameters_EC : public DL_GroupParametersImpl<EcPrecomputation<EC> >
+class DL_GroupParameters_EC : public DL_GroupParametersImpl<EcPrecomputation<EC>, CPP_TYPENAME EcPrecomputation<EC>::BasePrecomputation>
 {
 	typedef DL_GroupParameters_EC<EC> ThisClass;
 
@@ -7,6 +7,8 @@
 #include "ecp.h"
 #include "asn.h"
 #include "nbtheory.h"
+#include "taskexec.h"
+#include <map>
 
 #include "algebra.cpp"
 
@@ -22,15 +24,28 @@ static inline ECP::Point FromMontgomery(const ModularArithmetic &mr, const ECP::
 {
 	return P.identity ? P : ECP::Point(mr.ConvertOut(P.x), mr.ConvertOut(P.y));
 }
+
+// whether the field is already one that point multiplication should be done in
+static inline bool IsFastRepresentation(const ModularArithmetic &field)
+{
+	return field.IsMontgomeryRepresentation() || dynamic_cast<const SolinasArithmetic *>(&field) != NULL;
+}
 NAMESPACE_END
 
 ECP::ECP(const ECP &ecp, bool convertToMontgomeryRepresentation)
 {
-	if (convertToMontgomeryRepresentation && !ecp.GetField().IsMontgomeryRepresentation())
+	if (convertToMontgomeryRepresentation && !IsFastRepresentation(ecp.GetField()))
 	{
-		m_fieldPtr.reset(new MontgomeryRepresentation(ecp.GetField().GetModulus()));
+		const Integer &modulus = ecp.GetField().GetModulus();
+		if (SolinasArithmetic::IsSupportedModulus(modulus))
+			m_fieldPtr.reset(new SolinasArithmetic(modulus));
+		else
+			m_fieldPtr.reset(new MontgomeryRepresentation(modulus));
 		m_a = GetField().ConvertIn(ecp.m_a);
 		m_b = GetField().ConvertIn(ecp.m_b);
+		m_endomorphism = ecp.m_endomorphism;
+		if (HasEndomorphism())
+			m_endomorphism->beta = GetField().ConvertIn(ecp.m_endomorphism->beta);
 	}
 	else
 		operator=(ecp);
@@ -183,6 +198,54 @@ bool ECP::VerifyPoint(const Point &P) const
 		&& !(((x*x+m_a)*x+m_b-y*y)%p));
 }
 
+void ECP::SetEndomorphism(const FieldElement &beta, const Integer &lambda, const Integer &order)
+{
+	m_endomorphism.reset(new Endomorphism);
+	Endomorphism &e = *m_endomorphism;
+	e.beta = beta;
+	e.lambda = lambda;
+	e.order = order;
+
+	// the remainders r of the extended Euclidean algorithm on order and lambda satisfy r = t*lambda mod order,
+	// and the vectors (r, -t) on either side of sqrt(order) are the short basis (Guide to Elliptic Curve Cryptography, algorithm 3.74)
+	Integer r0 = order, r1 = lambda, t0 = Integer::Zero(), t1 = Integer::One(), q, r2, t2;
+	while (r1.Squared() >= order)
+	{
+		q = r0 / r1;
+		r2 = r0 - q*r1;
+		t2 = t0 - q*t1;
+		r0.swap(r1); r1.swap(r2);
+		t0.swap(t1); t1.swap(t2);
+	}
+	q = r0 / r1;
+	r2 = r0 - q*r1;
+	t2 = t0 - q*t1;
+
+	e.a1 = r1;
+	e.b1 = -t1;
+	if (r0.Squared() + t0.Squared() <= r2.Squared() + t2.Squared())
+	{
+		e.a2 = r0;
+		e.b2 = -t0;
+	}
+	else
+	{
+		e.a2 = r2;
+		e.b2 = -t2;
+	}
+}
+
+// k = k1 + k2*lambda mod order, with k1 and k2 about half as long as the order
+void ECP::SplitExponent(const Integer &k, Integer &k1, Integer &k2) const
+{
+	const Endomorphism &e = *m_endomorphism;
+	const Integer twiceOrder = e.order << 1;
+	const Integer c1 = ((e.b2*k << 1) + e.order) / twiceOrder;
+	const Integer c2 = ((-e.b1*k << 1) + e.order) / twiceOrder;
+	k1 = k - c1*e.a1 - c2*e.a2;
+	k2 = -c1*e.b1 - c2*e.b2;
+}
+
 bool ECP::Equal(const Point &P, const Point &Q) const
 {
 	if (P.identity && Q.identity)
@@ -348,19 +411,468 @@ struct ZIterator
 	std::vector<ProjectivePoint>::iterator it;
 };
 
+// point arithmetic in Jacobian coordinates, where (x, y, z) represents the affine point (x/z^2, y/z^3), and z = 0 the identity
+class JacobianArithmetic
+{
+public:
+	JacobianArithmetic(const ModularArithmetic &mr, const Integer &a)
+		: mr(mr), a(a), aIsMinus3(mr.Equal(a, mr.Inverse(mr.ConvertIn(Integer(3))))) {}
+
+	void SetAffine(ProjectivePoint &P, const ECPPoint &Q) const
+	{
+		if (Q.identity)
+			P.z = Integer::Zero();
+		else
+		{
+			P.x = Q.x;
+			P.y = Q.y;
+			P.z = mr.MultiplicativeIdentity();
+		}
+	}
+
+	void Double(ProjectivePoint &P)
+	{
+		if (P.z.IsZero() || P.y.IsZero())
+		{
+			P.z = Integer::Zero();
+			return;
+		}
+
+		// M = 3x^2 + az^4, which is 3(x-z^2)(x+z^2) when a = -3
+		t1 = mr.Square(P.z);
+		if (aIsMinus3)
+		{
+			M = mr.Subtract(P.x, t1);
+			t1 = mr.Add(P.x, t1);
+			M = mr.Multiply(M, t1);
+		}
+		else
+		{
+			t1 = mr.Square(t1);
+			t1 = mr.Multiply(t1, a);
+			M = mr.Square(P.x);
+		}
+		t2 = mr.Double(M);
+		mr.Accumulate(M, t2);
+		if (!aIsMinus3)
+			mr.Accumulate(M, t1);
+
+		P.z = mr.Multiply(P.z, P.y);
+		P.z = mr.Double(P.z);
+		t1 = mr.Square(P.y);
+		S = mr.Multiply(P.x, t1);
+		S = mr.Double(S);
+		S = mr.Double(S);			// S = 4xy^2
+		t1 = mr.Square(t1);
+		t1 = mr.Double(t1);
+		t1 = mr.Double(t1);
+		t1 = mr.Double(t1);			// 8y^4
+		P.x = mr.Square(M);
+		mr.Reduce(P.x, S);
+		mr.Reduce(P.x, S);
+		mr.Reduce(S, P.x);
+		P.y = mr.Multiply(M, S);
+		mr.Reduce(P.y, t1);
+	}
+
+	// P += Q, where Q is affine and not the identity
+	void AddAffine(ProjectivePoint &P, const ECPPoint &Q)
+	{
+		if (P.z.IsZero())
+		{
+			SetAffine(P, Q);
+			return;
+		}
+
+		t1 = mr.Square(P.z);
+		t2 = mr.Multiply(Q.x, t1);
+		t1 = mr.Multiply(t1, P.z);
+		t1 = mr.Multiply(t1, Q.y);
+		mr.Reduce(t2, P.x);			// H = x2 z1^2 - x1
+		mr.Reduce(t1, P.y);			// r = y2 z1^3 - y1
+		if (t2.IsZero())
+		{
+			if (t1.IsZero())
+			{
+				SetAffine(P, Q);
+				Double(P);
+			}
+			else
+				P.z = Integer::Zero();
+			return;
+		}
+
+		P.z = mr.Multiply(P.z, t2);
+		S = mr.Square(t2);
+		t2 = mr.Multiply(t2, S);		// H^3
+		S = mr.Multiply(P.x, S);		// V = x1 H^2
+		P.x = mr.Square(t1);
+		mr.Reduce(P.x, t2);
+		mr.Reduce(P.x, S);
+		mr.Reduce(P.x, S);
+		mr.Reduce(S, P.x);
+		S = mr.Multiply(t1, S);
+		t2 = mr.Multiply(P.y, t2);
+		P.y = mr.Subtract(S, t2);
+	}
+
+	// P += Q
+	void Add(ProjectivePoint &P, const ProjectivePoint &Q)
+	{
+		if (Q.z.IsZero())
+			return;
+		if (P.z.IsZero())
+		{
+			P = Q;
+			return;
+		}
+
+		t1 = mr.Square(Q.z);
+		S = mr.Multiply(P.x, t1);		// U1 = x1 z2^2
+		t1 = mr.Multiply(t1, Q.z);
+		M = mr.Multiply(P.y, t1);		// S1 = y1 z2^3
+		t2 = mr.Square(P.z);
+		t3 = mr.Multiply(Q.x, t2);
+		t2 = mr.Multiply(t2, P.z);
+		t4 = mr.Multiply(Q.y, t2);
+		mr.Reduce(t3, S);			// H = x2 z1^2 - U1
+		mr.Reduce(t4, M);			// r = y2 z1^3 - S1
+		if (t3.IsZero())
+		{
+			if (t4.IsZero())
+				Double(P);
+			else
+				P.z = Integer::Zero();
+			return;
+		}
+
+		P.z = mr.Multiply(P.z, Q.z);
+		P.z = mr.Multiply(P.z, t3);
+		t2 = mr.Square(t3);
+		t1 = mr.Multiply(t3, t2);		// H^3
+		S = mr.Multiply(S, t2);		// V = U1 H^2
+		P.x = mr.Square(t4);
+		mr.Reduce(P.x, t1);
+		mr.Reduce(P.x, S);
+		mr.Reduce(P.x, S);
+		mr.Reduce(S, P.x);
+		P.y = mr.Multiply(t4, S);
+		t1 = mr.Multiply(M, t1);
+		mr.Reduce(P.y, t1);
+	}
+
+	ECPPoint ToAffine(const ProjectivePoint &P) const
+	{
+		if (P.z.IsZero())
+			return ECPPoint();
+
+		Integer z = mr.MultiplicativeInverse(P.z);
+		Integer z2 = mr.Square(z);
+		Integer x = mr.Multiply(P.x, z2);
+		z2 = mr.Multiply(z2, z);
+		return ECPPoint(x, mr.Multiply(P.y, z2));
+	}
+
+	// convert points to affine coordinates, with one field inversion for all of them
+	void ToAffine(std::vector<ProjectivePoint> &points, std::vector<ECPPoint> &results) const
+	{
+		ParallelInvert(mr, ZIterator(points.begin()), ZIterator(points.end()));
+		results.resize(points.size());
+		for (unsigned int i=0; i<points.size(); i++)
+		{
+			ProjectivePoint &P = points[i];
+			if (P.z.IsZero())
+				results[i] = ECPPoint();
+			else
+			{
+				Integer z2 = mr.Square(P.z);
+				results[i].identity = false;
+				results[i].x = mr.Multiply(P.x, z2);
+				z2 = mr.Multiply(z2, P.z);
+				results[i].y = mr.Multiply(P.y, z2);
+			}
+		}
+	}
+
+private:
+	const ModularArithmetic &mr;
+	const Integer &a;
+	bool aIsMinus3;
+	Integer t1, t2, t3, t4, S, M;
+};
+
+// bases without combs are added in signed windows of up to this many bits, from tables of their odd multiples
+const unsigned int s_strausWindowSize = 4;
+const unsigned int s_oddMultiplesCount = 1 << (s_strausWindowSize-1);
+
+// tables[2*(i*s_oddMultiplesCount+k)] = (2k+1)*bases[i], and the entry after it is its inverse
+// all of the tables are made with two field inversions
+static void ComputeOddMultiples(JacobianArithmetic &ja, const ModularArithmetic &field, const std::vector<ECPPoint> &bases, std::vector<ECPPoint> &tables)
+{
+	std::vector<ProjectivePoint> doubles(bases.size()), multiples(bases.size()*s_oddMultiplesCount);
+	std::vector<ECPPoint> affineDoubles, affineMultiples;
+
+	for (unsigned int i=0; i<bases.size(); i++)
+	{
+		ja.SetAffine(doubles[i], bases[i]);
+		ja.Double(doubles[i]);
+	}
+	ja.ToAffine(doubles, affineDoubles);
+
+	for (unsigned int i=0; i<bases.size(); i++)
+	{
+		ProjectivePoint *P = &multiples[i*s_oddMultiplesCount];
+		ja.SetAffine(P[0], bases[i]);
+		for (unsigned int k=1; k<s_oddMultiplesCount; k++)
+		{
+			P[k] = P[k-1];
+			if (!affineDoubles[i].identity)
+				ja.AddAffine(P[k], affineDoubles[i]);
+		}
+	}
+	ja.ToAffine(multiples, affineMultiples);
+
+	tables.resize(2*affineMultiples.size());
+	for (unsigned int i=0; i<affineMultiples.size(); i++)
+	{
+		tables[2*i] = tables[2*i+1] = affineMultiples[i];
+		if (!affineMultiples[i].identity)
+			tables[2*i+1].y = field.Inverse(affineMultiples[i].y);
+	}
+}
+
+// one of the scalar multiples that StrausMultiply() adds up
+struct StrausTerm
+{
+	const Integer *exponent;
+	// the sums of a comb, spread over the exponent as in ECPFixedBasePrecomputation::Exponentiate(), or NULL
+	const std::vector<ECPPoint> *combs;
+	unsigned int combTeeth, windowSize;
+	// the odd multiples of the base, as made by ComputeOddMultiples(), if there are no combs
+	const ECPPoint *multiples;
+};
+
+// R = the sum of the terms, with the doublings shared between them
+static void StrausMultiply(JacobianArithmetic &ja, ProjectivePoint &R, const StrausTerm *terms, unsigned int termCount)
+{
+	std::vector<std::vector<int> > windows(termCount);	// windows[t][b] is the signed window of term t that starts at bit b
+	unsigned int length = 0;
+	for (unsigned int t=0; t<termCount; t++)
+	{
+		if (terms[t].combs)
+			length = STDMAX(length, terms[t].windowSize);
+		else
+		{
+			WindowSlider slider(*terms[t].exponent, true, s_strausWindowSize);
+			for (slider.FindNextWindow(); !slider.finished; slider.FindNextWindow())
+			{
+				windows[t].resize(slider.windowBegin+1, 0);
+				windows[t][slider.windowBegin] = slider.negateNext ? -int(slider.expWindow) : int(slider.expWindow);
+			}
+			length = STDMAX(length, (unsigned int)windows[t].size());
+		}
+	}
+
+	R.z = Integer::Zero();
+	for (int b=int(length)-1; b>=0; b--)
+	{
+		ja.Double(R);
+		for (unsigned int t=0; t<termCount; t++)
+		{
+			const StrausTerm &term = terms[t];
+			if (term.combs)
+			{
+				if ((unsigned int)b >= term.windowSize)
+					continue;
+				const unsigned int combSize = 1 << term.combTeeth;
+				const unsigned int combCount = (unsigned int)term.combs->size() / combSize;
+				for (unsigned int c=0; c<combCount; c++)
+				{
+					unsigned int i = 0;
+					for (unsigned int j=0; j<term.combTeeth; j++)
+						i |= (unsigned int)term.exponent->GetBit((c*term.combTeeth + j)*term.windowSize + b) << j;
+					if (i && !(*term.combs)[c*combSize + i].identity)
+						ja.AddAffine(R, (*term.combs)[c*combSize + i]);
+				}
+			}
+			else if ((unsigned int)b < windows[t].size() && windows[t][b] != 0)
+			{
+				// the odd multiple |w| is entry |w|-1, and its inverse the one after it
+				const int w = windows[t][b];
+				const ECPPoint &P = term.multiples[w > 0 ? w-1 : -w];
+				if (!P.identity)
+					ja.AddAffine(R, P);
+			}
+		}
+	}
+}
+
+// the pairs of terms of a batch, split up among tasks that each have their own copy of the field
+struct StrausBatch
+{
+	static void Task(void *context, size_t task)
+	{
+		const StrausBatch &batch = *(const StrausBatch *)context;
+		const size_t begin = batch.count*task/batch.taskCount, end = batch.count*(task+1)/batch.taskCount;
+
+		member_ptr<ModularArithmetic> field(batch.ec->GetField().Clone());
+		JacobianArithmetic ja(*field, batch.ec->GetA());
+		std::vector<ProjectivePoint> sums(end-begin);
+		std::vector<ECPPoint> affine;
+		for (size_t i=begin; i<end; i++)
+			StrausMultiply(ja, sums[i-begin], batch.terms+2*i, 2);
+		ja.ToAffine(sums, affine);
+		for (size_t i=begin; i<end; i++)
+			batch.results[i] = FromMontgomery(*field, affine[i-begin]);
+	}
+
+	const ECP *ec;
+	const StrausTerm *terms;
+	ECPPoint *results;
+	size_t count, taskCount;
+};
+
+ECP::Point ECP::MultiScalarMultiply(const Point *bases, const Integer *exponents, unsigned int count) const
+{
+	if (count == 0)
+		return Identity();
+
+	if (!IsFastRepresentation(GetField()))
+	{
+		ECP ecpmr(*this, true);
+		const ModularArithmetic &mr = ecpmr.GetField();
+		std::vector<Point> mrBases(count);
+		for (unsigned int i=0; i<count; i++)
+			mrBases[i] = ToMontgomery(mr, bases[i]);
+		return FromMontgomery(mr, ecpmr.MultiScalarMultiply(&mrBases[0], exponents, count));
+	}
+
+	unsigned int i, expLen = 0;
+
+	// with the endomorphism, each long exponent k makes way for k1 and k2, applied to the base and to its image,
+	// which are negated when k1 or k2 is negative
+	std::vector<Point> splitBases;
+	std::vector<Integer> splitExponents;
+	if (HasEndomorphism())
+	{
+		const Integer &order = m_endomorphism->order;
+		Integer k1, k2;
+		for (i=0; i<count; i++)
+		{
+			const Point &P = bases[i];
+			const Integer &k = exponents[i];
+			if (k.IsNegative() || k >= order || k.BitCount() <= order.BitCount()/2)
+			{
+				splitBases.push_back(P);
+				splitExponents.push_back(k);
+				continue;
+			}
+
+			SplitExponent(k, k1, k2);
+			splitBases.push_back(P);
+			splitBases.push_back(P);
+			if (!P.identity)
+			{
+				Point &P1 = splitBases[splitBases.size()-2], &P2 = splitBases.back();
+				P2.x = GetField().Multiply(P.x, m_endomorphism->beta);
+				if (k1.IsNegative())
+					P1.y = GetField().Inverse(P.y);
+				if (k2.IsNegative())
+					P2.y = GetField().Inverse(P.y);
+			}
+			splitExponents.push_back(k1.AbsoluteValue());
+			splitExponents.push_back(k2.AbsoluteValue());
+		}
+		bases = &splitBases[0];
+		exponents = &splitExponents[0];
+		count = (unsigned int)splitBases.size();
+	}
+	for (i=0; i<count; i++)
+	{
+		assert(exponents[i].NotNegative());
+		expLen = STDMAX(expLen, exponents[i].BitCount());
+	}
+
+	JacobianArithmetic ja(GetField(), m_a);
+	ProjectivePoint R;
+	R.z = Integer::Zero();
+	const unsigned int windowSize = PippengerWindowSize(count, expLen, true);
+
+	if (windowSize == 0)
+	{
+		std::vector<ECPPoint> baseVector(bases, bases+count), tables;
+		ComputeOddMultiples(ja, GetField(), baseVector, tables);
+		std::vector<StrausTerm> terms(count);
+		for (i=0; i<count; i++)
+		{
+			terms[i].exponent = exponents+i;
+			terms[i].combs = NULL;
+			terms[i].combTeeth = terms[i].windowSize = 0;
+			terms[i].multiples = &tables[2*i*s_oddMultiplesCount];
+		}
+		StrausMultiply(ja, R, &terms[0], count);
+		return ja.ToAffine(R);
+	}
+
+	// the bases go into the buckets with mixed additions, and the buckets are summed in Jacobian coordinates
+	const unsigned int windowCount = expLen/windowSize + 1, bucketCount = 1 << (windowSize-1);
+	std::vector<int> digits;
+	PippengerDigits(exponents, count, windowSize, windowCount, true, digits);
+
+	std::vector<ECPPoint> negatedBases(bases, bases+count);
+	for (i=0; i<count; i++)
+		if (!bases[i].identity)
+			negatedBases[i].y = GetField().Inverse(bases[i].y);
+
+	std::vector<ProjectivePoint> buckets(bucketCount);
+	ProjectivePoint running, sum;
+	for (int j=int(windowCount)-1; j>=0; j--)
+	{
+		for (unsigned int k=0; k<windowSize; k++)
+			ja.Double(R);
+
+		for (unsigned int b=0; b<bucketCount; b++)
+			buckets[b].z = Integer::Zero();
+		for (i=0; i<count; i++)
+		{
+			const int digit = digits[j*count+i];
+			if (digit > 0 && !bases[i].identity)
+				ja.AddAffine(buckets[digit-1], bases[i]);
+			else if (digit < 0 && !bases[i].identity)
+				ja.AddAffine(buckets[-digit-1], negatedBases[i]);
+		}
+
+		running.z = sum.z = Integer::Zero();
+		for (int b=int(bucketCount)-1; b>=0; b--)
+		{
+			ja.Add(running, buckets[b]);
+			ja.Add(sum, running);
+		}
+		ja.Add(R, sum);
+	}
+
+	return ja.ToAffine(R);
+}
+
 ECP::Point ECP::ScalarMultiply(const Point &P, const Integer &k) const
 {
 	Element result;
 	if (k.BitCount() <= 5)
 		AbstractGroup<ECPPoint>::SimultaneousMultiply(&result, P, &k, 1);
 	else
-		ECP::SimultaneousMultiply(&result, P, &k, 1);
+		result = MultiScalarMultiply(&P, &k, 1);
 	return result;
 }
 
 void ECP::SimultaneousMultiply(ECP::Point *results, const ECP::Point &P, const Integer *expBegin, unsigned int expCount) const
 {
-	if (!GetField().IsMontgomeryRepresentation())
+	if (expCount == 1)
+	{
+		results[0] = ScalarMultiply(P, expBegin[0]);
+		return;
+	}
+
+	if (!IsFastRepresentation(GetField()))
 	{
 		ECP ecpmr(*this, true);
 		const ModularArithmetic &mr = ecpmr.GetField();
@@ -432,40 +944,211 @@ void ECP::SimultaneousMultiply(ECP::Point *results, const ECP::Point &P, const I
 		}
 	}
 
-	std::vector<BaseAndExponent<Point, Integer> > finalCascade;
+	// the bases of each result go into buckets by their odd windows, the buckets are summed in Jacobian coordinates,
+	// and the results are converted to affine coordinates together
+	JacobianArithmetic ja(GetField(), m_a);
+	std::vector<ProjectivePoint> sums(expCount), buckets(16);
+	std::vector<ECPPoint> affineSums;
+	ProjectivePoint running;
+	ECPPoint base;
 	for (i=0; i<expCount; i++)
 	{
-		finalCascade.resize(baseIndices[i].size());
+		for (unsigned int b=0; b<buckets.size(); b++)
+			buckets[b].z = Integer::Zero();
 		for (unsigned int j=0; j<baseIndices[i].size(); j++)
 		{
-			ProjectivePoint &base = bases[baseIndices[i][j]];
-			if (base.z.IsZero())
-				finalCascade[j].base.identity = true;
-			else
-			{
-				finalCascade[j].base.identity = false;
-				finalCascade[j].base.x = base.x;
-				if (negateBase[i][j])
-					finalCascade[j].base.y = GetField().Inverse(base.y);
-				else
-					finalCascade[j].base.y = base.y;
-			}
-			finalCascade[j].exponent = Integer(Integer::POSITIVE, 0, exponentWindows[i][j]);
+			const ProjectivePoint &B = bases[baseIndices[i][j]];
+			if (B.z.IsZero())
+				continue;
+			base.identity = false;
+			base.x = B.x;
+			base.y = negateBase[i][j] ? GetField().Inverse(B.y) : B.y;
+			ja.AddAffine(buckets[exponentWindows[i][j]/2], base);
+		}
+
+		// sum = 1*buckets[0] + 2*buckets[1] + ..., and running = buckets[0] + buckets[1] + ..., so 2*sum - running has the odd weights
+		ProjectivePoint &sum = sums[i];
+		sum.z = running.z = Integer::Zero();
+		for (int b=(int)buckets.size()-1; b>=0; b--)
+		{
+			ja.Add(running, buckets[b]);
+			ja.Add(sum, running);
+		}
+		ja.Double(sum);
+		if (running.z.NotZero())
+		{
+			running.y = GetField().Inverse(running.y);
+			ja.Add(sum, running);
 		}
-		results[i] = GeneralCascadeMultiplication(*this, finalCascade.begin(), finalCascade.end());
 	}
+
+	ja.ToAffine(sums, affineSums);
+	std::copy(affineSums.begin(), affineSums.end(), results);
 }
 
 ECP::Point ECP::CascadeScalarMultiply(const Point &P, const Integer &k1, const Point &Q, const Integer &k2) const
 {
-	if (!GetField().IsMontgomeryRepresentation())
+	const Point bases[] = {P, Q};
+	const Integer exponents[] = {k1, k2};
+	return MultiScalarMultiply(bases, exponents, 2);
+}
+
+void ECPFixedBasePrecomputation::SetBase(const DL_GroupPrecomputation<Element> &group, const Element &base)
+{
+	DL_FixedBasePrecomputationImpl<Element>::SetBase(group, base);
+	m_combTeeth = 0;
+	m_combs.clear();
+}
+
+void ECPFixedBasePrecomputation::Precompute(const DL_GroupPrecomputation<Element> &group, unsigned int maxExpBits, unsigned int storage)
+{
+	assert(m_bases.size() > 0);
+	assert(storage <= maxExpBits);
+
+	if (storage > 1)
 	{
-		ECP ecpmr(*this, true);
-		const ModularArithmetic &mr = ecpmr.GetField();
-		return FromMontgomery(mr, ecpmr.CascadeScalarMultiply(ToMontgomery(mr, P), k1, ToMontgomery(mr, Q), k2));
+		m_windowSize = (maxExpBits+storage-1)/storage;
+		m_exponentBase = Integer::Power2(m_windowSize);
 	}
-	else
-		return AbstractGroup<Point>::CascadeScalarMultiply(P, k1, Q, k2);
+
+	// the same bases as DL_FixedBasePrecomputationImpl computes, each doubled from the one before in Jacobian coordinates,
+	// and converted to affine coordinates together
+	const ECP &ec = static_cast<const ECP &>(group.GetGroup());
+	JacobianArithmetic ja(ec.GetField(), ec.GetA());
+	std::vector<ProjectivePoint> bases(storage);
+	ja.SetAffine(bases[0], m_bases[0]);
+	for (unsigned int i=1; i<storage; i++)
+	{
+		bases[i] = bases[i-1];
+		for (unsigned int j=0; j<m_windowSize; j++)
+			ja.Double(bases[i]);
+	}
+	ja.ToAffine(bases, m_bases);
+
+	PrecomputeCombs(group);
+}
+
+void ECPFixedBasePrecomputation::Load(const DL_GroupPrecomputation<Element> &group, BufferedTransformation &bt)
+{
+	DL_FixedBasePrecomputationImpl<Element>::Load(group, bt);
+	PrecomputeCombs(group);
+}
+
+void ECPFixedBasePrecomputation::PrecomputeCombs(const DL_GroupPrecomputation<Element> &group)
+{
+	m_combTeeth = 0;
+	m_combs.clear();
+	if (m_bases.size() < 2 || m_windowSize == 0)
+		return;
+
+	const ECP &ec = static_cast<const ECP &>(group.GetGroup());
+
+	// 6 bases per comb keeps the table of a 256-bit exponent with 16 bases to 3*64 points
+	m_combTeeth = STDMIN((unsigned int)m_bases.size(), 6U);
+	const unsigned int combCount = ((unsigned int)m_bases.size() + m_combTeeth - 1) / m_combTeeth;
+	const unsigned int combSize = 1 << m_combTeeth;
+
+	JacobianArithmetic ja(ec.GetField(), ec.GetA());
+	std::vector<ProjectivePoint> sums(combCount*combSize);
+	for (unsigned int c=0; c<combCount; c++)
+	{
+		sums[c*combSize].z = Integer::Zero();
+		for (unsigned int i=1; i<combSize; i++)
+		{
+			// add the base for the lowest set bit to the sum for the others, which has already been computed
+			unsigned int j = 0;
+			while (!(i & (1<<j)))
+				j++;
+			ProjectivePoint &P = sums[c*combSize + i];
+			P = sums[c*combSize + (i ^ (1<<j))];
+			if (c*m_combTeeth + j < m_bases.size() && !m_bases[c*m_combTeeth + j].identity)
+				ja.AddAffine(P, m_bases[c*m_combTeeth + j]);
+		}
+	}
+
+	ja.ToAffine(sums, m_combs);
+}
+
+ECP::Point ECPFixedBasePrecomputation::Exponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent) const
+{
+	if (m_combs.empty() || exponent.IsNegative() || exponent.BitCount() > m_windowSize*m_bases.size())
+		return DL_FixedBasePrecomputationImpl<Element>::Exponentiate(group, exponent);
+
+	const ECP &ec = static_cast<const ECP &>(group.GetGroup());
+	const unsigned int combSize = 1 << m_combTeeth;
+	const unsigned int combCount = (unsigned int)m_combs.size() / combSize;
+	JacobianArithmetic ja(ec.GetField(), ec.GetA());
+	ProjectivePoint R;
+	R.z = Integer::Zero();
+
+	// bit k of the exponent selects base k/m_windowSize in the sum that is doubled k%m_windowSize times
+	for (int b=(int)m_windowSize-1; b>=0; b--)
+	{
+		ja.Double(R);
+		for (unsigned int c=0; c<combCount; c++)
+		{
+			unsigned int i = 0;
+			for (unsigned int j=0; j<m_combTeeth; j++)
+				i |= (unsigned int)exponent.GetBit((c*m_combTeeth + j)*m_windowSize + b) << j;
+			if (i && !m_combs[c*combSize + i].identity)
+				ja.AddAffine(R, m_combs[c*combSize + i]);
+		}
+	}
+
+	return group.ConvertOut(ja.ToAffine(R));
+}
+
+void ECPFixedBasePrecomputation::CascadeExponentiateBatch(const DL_GroupPrecomputation<Element> &group, Element *results, const Integer *exponents, const DL_FixedBasePrecomputation<Element> *const *others, const Integer *otherExponents, size_t count) const
+{
+	if (count == 0)
+		return;
+
+	for (size_t i=0; i<count; i++)
+		if (exponents[i].IsNegative() || otherExponents[i].IsNegative())
+		{
+			DL_FixedBasePrecomputationImpl<Element>::CascadeExponentiateBatch(group, results, exponents, others, otherExponents, count);
+			return;
+		}
+
+	const ECP &ec = static_cast<const ECP &>(group.GetGroup());
+	JacobianArithmetic ja(ec.GetField(), ec.GetA());
+
+	// terms[2*i] and terms[2*i+1] make up results[i], and every distinct base without combs gets one table of odd multiples
+	std::vector<StrausTerm> terms(2*count);
+	std::vector<size_t> tableIndices(2*count);
+	std::vector<Element> bases;
+	std::map<const DL_FixedBasePrecomputation<Element> *, size_t> baseIndices;
+	for (size_t i=0; i<2*count; i++)
+	{
+		const DL_FixedBasePrecomputation<Element> *pc = i%2 ? others[i/2] : this;
+		StrausTerm &term = terms[i];
+		term.exponent = i%2 ? &otherExponents[i/2] : &exponents[i/2];
+
+		const ECPFixedBasePrecomputation *ecpc = dynamic_cast<const ECPFixedBasePrecomputation *>(pc);
+		if (ecpc && !ecpc->m_combs.empty() && term.exponent->BitCount() <= ecpc->m_windowSize*ecpc->m_bases.size())
+		{
+			term.combs = &ecpc->m_combs;
+			term.combTeeth = ecpc->m_combTeeth;
+			term.windowSize = ecpc->m_windowSize;
+		}
+		else
+		{
+			term.combs = NULL;
+			std::pair<std::map<const DL_FixedBasePrecomputation<Element> *, size_t>::iterator, bool> p = baseIndices.insert(std::make_pair(pc, bases.size()));
+			if (p.second)
+				bases.push_back(group.ConvertIn(pc->GetBase(group)));
+			tableIndices[i] = p.first->second;
+		}
+	}
+
+	std::vector<Element> tables;
+	ComputeOddMultiples(ja, ec.GetField(), bases, tables);
+	for (size_t i=0; i<2*count; i++)
+		if (!terms[i].combs)
+			terms[i].multiples = &tables[2*s_oddMultiplesCount*tableIndices[i]];
+
+	StrausBatch batch = {&ec, &terms[0], results, count, STDMIN(count, (size_t)GetDefaultTaskExecutor().GetConcurrency())};
+	GetDefaultTaskExecutor().Run(&StrausBatch::Task, &batch, batch.taskCount);
 }
 
 NAMESPACE_END
@@ -35,6 +35,8 @@ public:
 	typedef ECPPoint Point;
 
 	ECP() {}
+	// convertToMontgomeryRepresentation converts the field to the representation that's fastest for point multiplication,
+	// which is SolinasArithmetic for P-384 and MontgomeryRepresentation otherwise
 	ECP(const ECP &ecp, bool convertToMontgomeryRepresentation = false);
 	ECP(const Integer &modulus, const FieldElement &a, const FieldElement &b)
 		: m_fieldPtr(new Field(modulus)), m_a(a.IsNegative() ? modulus+a : a), m_b(b) {}
@@ -54,6 +56,8 @@ public:
 	Point ScalarMultiply(const Point &P, const Integer &k) const;
 	Point CascadeScalarMultiply(const Point &P, const Integer &k1, const Point &Q, const Integer &k2) const;
 	void SimultaneousMultiply(Point *results, const Point &base, const Integer *exponents, unsigned int exponentsCount) const;
+	//! works in Jacobian coordinates, with one field inversion at the end
+	Point MultiScalarMultiply(const Point *bases, const Integer *exponents, unsigned int count) const;
 
 	Point Multiply(const Integer &k, const Point &P) const
 		{return ScalarMultiply(P, k);}
@@ -82,15 +86,57 @@ public:
 	bool operator==(const ECP &rhs) const
 		{return GetField() == rhs.GetField() && m_a == rhs.m_a && m_b == rhs.m_b;}
 
+	//! tell the curve that (x, y) -> (beta*x, y) multiplies the points of the subgroup of this order by lambda
+	/*! Multiplications by exponents shorter than the order are then split into two of half the length, as
+		described by Gallant, Lambert and Vanstone. All of the points that are multiplied must be in the subgroup,
+		which is the case for curves with cofactor 1. */
+	void SetEndomorphism(const FieldElement &beta, const Integer &lambda, const Integer &order);
+	bool HasEndomorphism() const {return m_endomorphism.get() != NULL;}
+
 private:
+	struct Endomorphism
+	{
+		FieldElement beta;
+		Integer lambda, order;
+		// short vectors (a1, b1) and (a2, b2) with a + b*lambda = 0 mod order
+		Integer a1, b1, a2, b2;
+	};
+
+	void SplitExponent(const Integer &k, Integer &k1, Integer &k2) const;
+
 	clonable_ptr<Field> m_fieldPtr;
 	FieldElement m_a, m_b;
+	value_ptr<Endomorphism> m_endomorphism;
 	mutable Point m_R;
 };
 
 CRYPTOPP_DLL_TEMPLATE_CLASS DL_FixedBasePrecomputationImpl<ECP::Point>;
 CRYPTOPP_DLL_TEMPLATE_CLASS DL_GroupPrecomputation<ECP::Point>;
 
+//! ECP fixed-base precomputation using combs
+/*! The precomputed bases are grouped into combs, and the sums of all subsets of the bases in each comb are
+	stored as affine points, so that exponentiation takes one mixed Jacobian-affine addition per comb per bit
+	of the window. The combs are rebuilt from the bases, which are saved and loaded in the same format as
+	DL_FixedBasePrecomputationImpl. */
+class CRYPTOPP_DLL ECPFixedBasePrecomputation : public DL_FixedBasePrecomputationImpl<ECP::Point>
+{
+public:
+	ECPFixedBasePrecomputation() : m_combTeeth(0) {}
+
+	void SetBase(const DL_GroupPrecomputation<Element> &group, const Element &base);
+	void Precompute(const DL_GroupPrecomputation<Element> &group, unsigned int maxExpBits, unsigned int storage);
+	void Load(const DL_GroupPrecomputation<Element> &group, BufferedTransformation &storedPrecomputation);
+	Element Exponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent) const;
+	//! interleaves the combs, and signed windows of the bases without combs, so that each pair of exponents shares one chain of doublings
+	void CascadeExponentiateBatch(const DL_GroupPrecomputation<Element> &group, Element *results, const Integer *exponents, const DL_FixedBasePrecomputation<Element> *const *others, const Integer *otherExponents, size_t count) const;
+
+private:
+	void PrecomputeCombs(const DL_GroupPrecomputation<Element> &group);
+
+	unsigned int m_combTeeth;		// number of bases in each comb
+	std::vector<Element> m_combs;	// m_combs[(c<<m_combTeeth) + i] is the sum of the bases of comb c selected by the bits of i
+};
+
 template <class T> class EcPrecomputation;
 
 //! ECP precomputation
@@ -98,6 +144,7 @@ template<> class EcPrecomputation<ECP> : public DL_GroupPrecomputation<ECP::Poin
 {
 public:
 	typedef ECP EllipticCurve;
+	typedef ECPFixedBasePrecomputation BasePrecomputation;
 	
 	// DL_GroupPrecomputation
 	bool NeedConversions() const {return true;}
@@ -35,6 +35,14 @@ public:
 	virtual void Save(const DL_GroupPrecomputation<Element> &group, BufferedTransformation &storedPrecomputation) const =0;
 	virtual Element Exponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent) const =0;
 	virtual Element CascadeExponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent, const DL_FixedBasePrecomputation<Element> &pc2, const Integer &exponent2) const =0;
+
+	//! results[i] = CascadeExponentiate(group, exponents[i], *others[i], otherExponents[i]), for count pairs of exponents
+	/*! implementations may share work between the pairs, such as conversions out of projective coordinates */
+	virtual void CascadeExponentiateBatch(const DL_GroupPrecomputation<Element> &group, Element *results, const Integer *exponents, const DL_FixedBasePrecomputation<Element> *const *others, const Integer *otherExponents, size_t count) const
+	{
+		for (size_t i=0; i<count; i++)
+			results[i] = CascadeExponentiate(group, exponents[i], *others[i], otherExponents[i]);
+	}
 };
 
 template <class T>
@@ -57,7 +65,7 @@ public:
 	Element Exponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent) const;
 	Element CascadeExponentiate(const DL_GroupPrecomputation<Element> &group, const Integer &exponent, const DL_FixedBasePrecomputation<Element> &pc2, const Integer &exponent2) const;
 
-private:
+protected:
 	void PrepareCascade(const DL_GroupPrecomputation<Element> &group, std::vector<BaseAndExponent<Element> > &eb, const Integer &exponent) const;
 
 	Element m_base;
@@ -43,7 +43,7 @@ void ESIGNFunction::DEREncode(BufferedTransformation &bt) const
 Integer ESIGNFunction::ApplyFunction(const Integer &x) const
 {
 	DoQuickSanityCheck();
-	return STDMIN(a_exp_b_mod_c(x, m_e, m_n) >> (2*GetK()+2), MaxImage());
+	return STDMIN(ModularArithmetic(m_n).ExponentiatePublic(x, m_e) >> (2*GetK()+2), MaxImage());
 }
 
 bool ESIGNFunction::Validate(RandomNumberGenerator &rng, unsigned int level) const
@@ -149,7 +149,7 @@ Integer InvertibleESIGNFunction::CalculateRandomizedInverse(RandomNumberGenerato
 	{
 		r.Randomize(rng, Integer::Zero(), pq);
 		z = x << (2*GetK()+2);
-		re = a_exp_b_mod_c(r, m_e, m_n);
+		re = ModularArithmetic(m_n).ExponentiatePublic(r, m_e);
 		a = (z - re) % m_n;
 		Integer::Divide(w1, w0, a, pq);
 		if (w1.NotZero())
@@ -9,6 +9,7 @@
 
 #include "gcm.h"
 #include "cpu.h"
+#include "rijndael.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -81,7 +82,8 @@ inline static void Xor16(byte *a, const byte *b, const byte *c)
 static CRYPTOPP_ALIGN_DATA(16) const word64 s_clmulConstants64[] = {
 	W64LIT(0xe100000000000000), W64LIT(0xc200000000000000),
 	W64LIT(0x08090a0b0c0d0e0f), W64LIT(0x0001020304050607),
-	W64LIT(0x0001020304050607), W64LIT(0x08090a0b0c0d0e0f)};
+	W64LIT(0x0001020304050607), W64LIT(0x08090a0b0c0d0e0f),
+	W64LIT(0x0706050403020100), W64LIT(0x0c0d0e0f0b0a0908)};
 static const __m128i *s_clmulConstants = (const __m128i *)s_clmulConstants64;
 static const unsigned int s_clmulTableSizeInBlocks = 8;
 
@@ -125,6 +127,129 @@ inline __m128i CLMUL_GF_Mul(const __m128i &x, const __m128i &h, const __m128i &r
 
 	return CLMUL_Reduce(c0, c1, c2, r);
 }
+
+// accumulate one block of the aggregated GHASH, using Karatsuba with precomputed (h.lo ^ h.hi)
+inline void CLMUL_GF_MulAccumulate(__m128i &c0, __m128i &c1, __m128i &c2, const __m128i &d, const __m128i &h, const __m128i &hk)
+{
+	c0 = _mm_xor_si128(c0, _mm_clmulepi64_si128(d, h, 0));
+	c2 = _mm_xor_si128(c2, _mm_clmulepi64_si128(d, h, 0x11));
+	c1 = _mm_xor_si128(c1, _mm_clmulepi64_si128(_mm_xor_si128(d, _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2))), hk, 0));
+}
+
+/*
+Encrypts blocks*16 bytes in counter mode and folds the ciphertext into the GHASH state in a
+single pass. The AES rounds of each 8-block group are interleaved with the carry-less
+multiplications of a group of ciphertext blocks, which are aggregated with H^8..H^1 so only
+one reduction is needed per group. When encrypting, the ciphertext of a group is only known
+after its last round, so it is hashed while the next group is being encrypted.
+*/
+static void AESNI_CLMUL_GCM_ProcessBlocks(const __m128i *subkeys, unsigned int rounds, const __m128i *table, byte *counter, byte *hashBuffer, byte *outBlocks, const byte *inBlocks, size_t blocks, bool hashInput)
+{
+	assert(blocks % s_clmulTableSizeInBlocks == 0);
+	const __m128i r = s_clmulConstants[0], bswapMask = s_clmulConstants[1], ctrMask = s_clmulConstants[3];
+	const __m128i one = _mm_set_epi32(1, 0, 0, 0);
+	__m128i h[8], hk[8];
+	unsigned int i;
+
+	// the multiplication table holds H^1..H^8 with the low and high halves of adjacent powers interleaved
+	for (i=0; i<8; i+=2)
+	{
+		h[i] = _mm_unpacklo_epi64(_mm_load_si128(table+i), _mm_load_si128(table+i+1));
+		h[i+1] = _mm_unpackhi_epi64(_mm_load_si128(table+i), _mm_load_si128(table+i+1));
+	}
+	for (i=0; i<8; i++)
+		hk[i] = _mm_xor_si128(h[i], _mm_shuffle_epi32(h[i], _MM_SHUFFLE(1, 0, 3, 2)));
+
+	__m128i x = _mm_load_si128((const __m128i *)hashBuffer);
+	__m128i ctr = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)counter), ctrMask);
+	const byte *pending = NULL;
+
+	for (; blocks; blocks -= 8, inBlocks += 128, outBlocks += 128)
+	{
+		const byte *hashBlocks = hashInput ? inBlocks : pending;
+		__m128i rk = subkeys[0];
+		__m128i block0 = _mm_xor_si128(_mm_shuffle_epi8(ctr, ctrMask), rk);
+		ctr = _mm_add_epi32(ctr, one);
+		__m128i block1 = _mm_xor_si128(_mm_shuffle_epi8(ctr, ctrMask), rk);
+		ctr = _mm_add_epi32(ctr, one);
+		__m128i block2 = _mm_xor_si128(_mm_shuffle_epi8(ctr, ctrMask), rk);
+		ctr = _mm_add_epi32(ctr, one);
+		__m128i block3 = _mm_xor_si128(_mm_shuffle_epi8(ctr, ctrMask), rk);
+		ctr = _mm_add_epi32(ctr, one);
+		__m128i block4 = _mm_xor_si128(_mm_shuffle_epi8(ctr, ctrMask), rk);
+		ctr = _mm_add_epi32(ctr, one);
+		__m128i block5 = _mm_xor_si128(_mm_shuffle_epi8(ctr, ctrMask), rk);
+		ctr = _mm_add_epi32(ctr, one);
+		__m128i block6 = _mm_xor_si128(_mm_shuffle_epi8(ctr, ctrMask), rk);
+		ctr = _mm_add_epi32(ctr, one);
+		__m128i block7 = _mm_xor_si128(_mm_shuffle_epi8(ctr, ctrMask), rk);
+		ctr = _mm_add_epi32(ctr, one);
+
+		__m128i c0 = _mm_setzero_si128(), c1 = _mm_setzero_si128(), c2 = _mm_setzero_si128();
+
+		// AES has at least 10 rounds, so there is a round for each of the 8 blocks to be hashed
+		for (i=1; i<rounds; i++)
+		{
+			rk = subkeys[i];
+			block0 = _mm_aesenc_si128(block0, rk);
+			block1 = _mm_aesenc_si128(block1, rk);
+			block2 = _mm_aesenc_si128(block2, rk);
+			block3 = _mm_aesenc_si128(block3, rk);
+			block4 = _mm_aesenc_si128(block4, rk);
+			block5 = _mm_aesenc_si128(block5, rk);
+			block6 = _mm_aesenc_si128(block6, rk);
+			block7 = _mm_aesenc_si128(block7, rk);
+
+			if (hashBlocks && i <= 8)
+			{
+				__m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)hashBlocks+i-1), bswapMask);
+				if (i == 1)
+					d = _mm_xor_si128(d, x);
+				CLMUL_GF_MulAccumulate(c0, c1, c2, d, h[8-i], hk[8-i]);
+			}
+		}
+
+		rk = subkeys[rounds];
+		block0 = _mm_aesenclast_si128(block0, rk);
+		block1 = _mm_aesenclast_si128(block1, rk);
+		block2 = _mm_aesenclast_si128(block2, rk);
+		block3 = _mm_aesenclast_si128(block3, rk);
+		block4 = _mm_aesenclast_si128(block4, rk);
+		block5 = _mm_aesenclast_si128(block5, rk);
+		block6 = _mm_aesenclast_si128(block6, rk);
+		block7 = _mm_aesenclast_si128(block7, rk);
+
+		if (hashBlocks)
+			x = CLMUL_Reduce(c0, _mm_xor_si128(_mm_xor_si128(c1, c0), c2), c2, r);
+
+		_mm_storeu_si128((__m128i *)outBlocks+0, _mm_xor_si128(block0, _mm_loadu_si128((const __m128i *)inBlocks+0)));
+		_mm_storeu_si128((__m128i *)outBlocks+1, _mm_xor_si128(block1, _mm_loadu_si128((const __m128i *)inBlocks+1)));
+		_mm_storeu_si128((__m128i *)outBlocks+2, _mm_xor_si128(block2, _mm_loadu_si128((const __m128i *)inBlocks+2)));
+		_mm_storeu_si128((__m128i *)outBlocks+3, _mm_xor_si128(block3, _mm_loadu_si128((const __m128i *)inBlocks+3)));
+		_mm_storeu_si128((__m128i *)outBlocks+4, _mm_xor_si128(block4, _mm_loadu_si128((const __m128i *)inBlocks+4)));
+		_mm_storeu_si128((__m128i *)outBlocks+5, _mm_xor_si128(block5, _mm_loadu_si128((const __m128i *)inBlocks+5)));
+		_mm_storeu_si128((__m128i *)outBlocks+6, _mm_xor_si128(block6, _mm_loadu_si128((const __m128i *)inBlocks+6)));
+		_mm_storeu_si128((__m128i *)outBlocks+7, _mm_xor_si128(block7, _mm_loadu_si128((const __m128i *)inBlocks+7)));
+
+		pending = outBlocks;
+	}
+
+	if (!hashInput && pending)
+	{
+		__m128i c0 = _mm_setzero_si128(), c1 = _mm_setzero_si128(), c2 = _mm_setzero_si128();
+		for (i=0; i<8; i++)
+		{
+			__m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)pending+i), bswapMask);
+			if (i == 0)
+				d = _mm_xor_si128(d, x);
+			CLMUL_GF_MulAccumulate(c0, c1, c2, d, h[7-i], hk[7-i]);
+		}
+		x = CLMUL_Reduce(c0, _mm_xor_si128(_mm_xor_si128(c1, c0), c2), c2, r);
+	}
+
+	_mm_store_si128((__m128i *)hashBuffer, x);
+	_mm_storeu_si128((__m128i *)counter, _mm_shuffle_epi8(ctr, ctrMask));
+}
 #endif
 
 void GCM_Base::SetKeyWithoutResync(const byte *userKey, size_t keylength, const NameValuePairs &params)
@@ -334,6 +459,41 @@ unsigned int GCM_Base::OptimalDataAlignment() const
 		GetBlockCipher().OptimalDataAlignment();
 }
 
+void GCM_Base::ProcessData(byte *outString, const byte *inString, size_t length)
+{
+#if CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE
+	const Rijndael::Encryption *aes;
+	if (length >= s_clmulTableSizeInBlocks*REQUIRED_BLOCKSIZE && HasCLMUL() && HasAESNI()
+		&& (m_state == State_IVSet || m_state == State_AuthUntransformed || m_state == State_AuthTransformed)
+		&& (aes = dynamic_cast<const Rijndael::Encryption *>(&GetBlockCipher())) != NULL)
+	{
+		// use up any buffered keystream so the counter is at a block boundary, this also
+		// finishes the header if necessary
+		size_t len = UnsignedMin(length, m_ctr.GetOptimalNextBlockSize());
+		AuthenticatedSymmetricCipherBase::ProcessData(outString, inString, len);
+		outString += len;
+		inString += len;
+		length -= len;
+
+		len = RoundDownToMultipleOf(length, size_t(s_clmulTableSizeInBlocks*REQUIRED_BLOCKSIZE));
+		if (len && m_bufferedDataLength == 0)
+		{
+			m_totalMessageLength += len;
+			if (m_totalMessageLength > MaxMessageLength())
+				throw InvalidArgument(AlgorithmName() + ": message length exceeds maximum");
+
+			AESNI_CLMUL_GCM_ProcessBlocks((const __m128i *)aes->GetRoundKeys(), aes->GetRounds(), (const __m128i *)MulTable(), 
+				m_ctr.CounterBlock(), HashBuffer(), outString, inString, len/REQUIRED_BLOCKSIZE, m_state == State_AuthUntransformed);
+			outString += len;
+			inString += len;
+			length -= len;
+		}
+	}
+#endif
+
+	AuthenticatedSymmetricCipherBase::ProcessData(outString, inString, length);
+}
+
 #pragma warning(disable: 4731)	// frame pointer register 'ebp' modified by inline assembly code
 
 #endif	// #ifndef CRYPTOPP_GENERATE_X64_MASM
@@ -41,6 +41,7 @@ public:
 		{return (W64LIT(1)<<61)-1;}
 	lword MaxMessageLength() const
 		{return ((W64LIT(1)<<39)-256)/8;}
+	void ProcessData(byte *outString, const byte *inString, size_t length);
 
 protected:
 	// AuthenticatedSymmetricCipherBase
@@ -67,6 +68,10 @@ protected:
 
 	class CRYPTOPP_DLL GCTR : public CTR_Mode_ExternalCipher::Encryption
 	{
+	public:
+		// used by the stitched AES-CTR/GHASH kernel, which bypasses the keystream buffer
+		byte * CounterBlock() {return m_counterArray;}
+
 	protected:
 		void IncrementCounterBy256();
 	};
@@ -9,6 +9,9 @@
 #include "algebra.h"
 
 #include <iosfwd>
+#ifdef CRYPTOPP_CXX11_RVALUES
+#include <utility>
+#endif
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -35,6 +38,10 @@ public:
 		PolynomialMod2();
 		//! copy constructor
 		PolynomialMod2(const PolynomialMod2& t);
+#ifdef CRYPTOPP_CXX11_RVALUES
+		//! move constructor, which takes the storage of t and leaves it zero
+		PolynomialMod2(PolynomialMod2&& t) {reg.swap(t.reg);}
+#endif
 
 		//! convert from word
 		/*! value should be encoded with the least significant bit as coefficient to x^0
@@ -130,6 +137,10 @@ public:
 	//@{
 		//!
 		PolynomialMod2&  operator=(const PolynomialMod2& t);
+#ifdef CRYPTOPP_CXX11_RVALUES
+		//! move assignment, which exchanges storage with t
+		PolynomialMod2&  operator=(PolynomialMod2&& t) {reg.swap(t.reg); return *this;}
+#endif
 		//!
 		PolynomialMod2&  operator&=(const PolynomialMod2& t);
 		//!
@@ -269,6 +280,28 @@ inline CryptoPP::PolynomialMod2 operator/(const CryptoPP::PolynomialMod2 &a, con
 //!
 inline CryptoPP::PolynomialMod2 operator%(const CryptoPP::PolynomialMod2 &a, const CryptoPP::PolynomialMod2 &b) {return a.Modulo(b);}
 
+#ifdef CRYPTOPP_CXX11_RVALUES
+// these work in the storage of a temporary operand instead of allocating the result
+//!
+inline CryptoPP::PolynomialMod2 operator^(CryptoPP::PolynomialMod2 &&a, const CryptoPP::PolynomialMod2 &b) {return std::move(a ^= b);}
+//!
+inline CryptoPP::PolynomialMod2 operator^(const CryptoPP::PolynomialMod2 &a, CryptoPP::PolynomialMod2 &&b) {return std::move(b ^= a);}
+//!
+inline CryptoPP::PolynomialMod2 operator^(CryptoPP::PolynomialMod2 &&a, CryptoPP::PolynomialMod2 &&b) {return std::move(a ^= b);}
+//!
+inline CryptoPP::PolynomialMod2 operator+(CryptoPP::PolynomialMod2 &&a, const CryptoPP::PolynomialMod2 &b) {return std::move(a ^= b);}
+//!
+inline CryptoPP::PolynomialMod2 operator+(const CryptoPP::PolynomialMod2 &a, CryptoPP::PolynomialMod2 &&b) {return std::move(b ^= a);}
+//!
+inline CryptoPP::PolynomialMod2 operator+(CryptoPP::PolynomialMod2 &&a, CryptoPP::PolynomialMod2 &&b) {return std::move(a ^= b);}
+//!
+inline CryptoPP::PolynomialMod2 operator-(CryptoPP::PolynomialMod2 &&a, const CryptoPP::PolynomialMod2 &b) {return std::move(a ^= b);}
+//!
+inline CryptoPP::PolynomialMod2 operator-(const CryptoPP::PolynomialMod2 &a, CryptoPP::PolynomialMod2 &&b) {return std::move(b ^= a);}
+//!
+inline CryptoPP::PolynomialMod2 operator-(CryptoPP::PolynomialMod2 &&a, CryptoPP::PolynomialMod2 &&b) {return std::move(a ^= b);}
+#endif
+
 // CodeWarrior 8 workaround: put these template instantiations after overloaded operator declarations,
 // but before the use of QuotientRing<EuclideanDomainOf<PolynomialMod2> > for VC .NET 2003
 CRYPTOPP_DLL_TEMPLATE_CLASS AbstractGroup<PolynomialMod2>;
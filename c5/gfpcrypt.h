@@ -175,6 +175,51 @@ public:
 		// verify r == (g^u1 * y^u2 mod p) mod q
 		return r == params.ConvertElementToInteger(publicKey.CascadeExponentiateBaseAndPublicElement(u1, u2)) % q;
 	}
+
+	size_t VerifyBatch(const DL_GroupParameters<T> &params, const DL_PublicKey<T> *const *publicKeys, const Integer *e, const Integer *r, const Integer *s, bool *results, size_t count) const
+	{
+		const Integer &q = params.GetSubgroupOrder();
+		std::vector<size_t> indices;
+		indices.reserve(count);
+		for (size_t i=0; i<count; i++)
+		{
+			results[i] = r[i]<q && r[i]>=1 && s[i]<q && s[i]>=1;
+			if (results[i])
+				indices.push_back(i);
+		}
+		const size_t n = indices.size();
+		if (n == 0)
+			return count;
+
+		// invert all of the s values with one inversion: w[j] = s[0]*...*s[j] on the way up, and 1/s[j] on the way down
+		std::vector<Integer> w(n), u1(n), u2(n);
+		w[0] = s[indices[0]];
+		for (size_t j=1; j<n; j++)
+			Integer::ModMul(w[j], w[j-1], s[indices[j]], q);
+		Integer inverse = w[n-1].InverseMod(q);
+		for (size_t j=n-1; j>0; j--)
+		{
+			Integer::ModMul(w[j], inverse, w[j-1], q);
+			Integer::ModMul(inverse, inverse, s[indices[j]], q);
+		}
+		w[0] = inverse;
+
+		std::vector<const DL_FixedBasePrecomputation<T> *> publicPrecomputations(n);
+		for (size_t j=0; j<n; j++)
+		{
+			Integer::ModMul(u1[j], e[indices[j]], w[j], q);
+			Integer::ModMul(u2[j], r[indices[j]], w[j], q);
+			publicPrecomputations[j] = &publicKeys[indices[j]]->GetPublicPrecomputation();
+		}
+
+		// verify r == (g^u1 * y^u2 mod p) mod q for all of them
+		std::vector<T> v(n);
+		params.GetBasePrecomputation().CascadeExponentiateBatch(params.GetGroupPrecomputation(), &v[0], &u1[0], &publicPrecomputations[0], &u2[0], n);
+		for (size_t j=0; j<n; j++)
+			results[indices[j]] = r[indices[j]] == params.ConvertElementToInteger(v[j]) % q;
+
+		return std::count(results, results+count, false);
+	}
 };
 
 CRYPTOPP_DLL_TEMPLATE_CLASS DL_Algorithm_GDSA<Integer>;
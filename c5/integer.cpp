@@ -15,6 +15,9 @@
 #include "pubkey.h"		// for P1363_KDF2
 #include "sha.h"
 #include "cpu.h"
+#ifdef CRYPTOPP_INTEGER_ARENA
+#include "trdlocal.h"
+#endif
 
 #include <iostream>
 
@@ -1934,6 +1937,237 @@ void SSE2_MultiplyTop32(word *C, const word *A, const word *B, word L)
 
 #endif	// #if CRYPTOPP_INTEGER_SSE2
 
+#if CRYPTOPP_BOOL_ADX_ASM_AVAILABLE
+
+// ADX kernels: R in rcx, A in rsi, B in rdi, the multiplier word in rdx, products in rbx:rax, and the accumulators in r8-r15
+
+#define ADX_Begin \
+	__asm__ __volatile__ \
+	( \
+		".intel_syntax noprefix;" \
+		AS2(	xor		r8d, r8d) \
+		AS2(	xor		r9d, r9d) \
+		AS2(	xor		r10d, r10d) \
+		AS2(	xor		r11d, r11d) \
+		AS2(	xor		r12d, r12d) \
+		AS2(	xor		r13d, r13d) \
+		AS2(	xor		r14d, r14d) \
+		AS2(	xor		r15d, r15d)
+
+#define ADX_End \
+		".att_syntax prefix;" \
+		: \
+		: "c" (R), "S" (A), "D" (B) \
+		: "%rax", "%rbx", "%rdx", "%r8", "%r9", "%r10", "%r11", "%r12", "%r13", "%r14", "%r15", "memory", "cc" \
+	);
+
+// c += A[i] * rdx, where c is the two words lo and hi, and the low half goes into the CF chain and the high half into the OF chain
+#define ADX_Acc(i, lo, hi) \
+	AS3(	mulx	rbx, rax, [rsi+8*(i)]) \
+	AS2(	adcx	lo, rax) \
+	AS2(	adox	hi, rbx)
+
+// the same for the last word of a row, where hi starts out empty and takes in both carries
+#define ADX_AccTop(i, lo, hi) \
+	AS3(	mulx	hi, rax, [rsi+8*(i)]) \
+	AS2(	adcx	lo, rax) \
+	AS2(	mov		eax, 0) \
+	AS2(	adox	hi, rax) \
+	AS2(	adcx	hi, rax)
+
+// the same for a word that is the last one needed, so the high half and carries are discarded
+#define ADX_AccBottom(i, lo) \
+	AS3(	mulx	rbx, rax, [rsi+8*(i)]) \
+	AS2(	adcx	lo, rax) \
+	AS2(	xor		eax, eax)
+
+// X[i+j] += M[j] * rdx, where rcx counts up from -N to 0 and r12 and rsi point just past the row in X and M,
+// carrying the high half of the previous product in prev and putting this one's in hi
+#define ADX_RedAcc(j, hi, prev) \
+	AS3(	mulx	hi, rax, [rsi+8*rcx+8*(j)]) \
+	AS2(	adcx	rax, [r12+8*rcx+8*(j)]) \
+	AS2(	adox	rax, prev) \
+	AS2(	mov		[r12+8*rcx+8*(j)], rax)
+
+#define ADX_LoadB(j)		AS2(	mov		rdx, [rdi+8*(j)])
+#define ADX_LoadA(j)		AS2(	mov		rdx, [rsi+8*(j)])
+#define ADX_Save(k, c)		AS2(	mov		[rcx+8*(k)], c)
+
+// R[2*k, 2*k+1] = 2*R[2*k, 2*k+1] + A[k]*A[k], carrying the doubling in CF and the square in OF
+#define ADX_SquDiag(k) \
+	ADX_LoadA(k) \
+	AS3(	mulx	rbx, rax, rdx) \
+	AS2(	mov		r8, [rcx+16*(k)]) \
+	AS2(	mov		r9, [rcx+16*(k)+8]) \
+	AS2(	adcx	r8, r8) \
+	AS2(	adcx	r9, r9) \
+	AS2(	adox	r8, rax) \
+	AS2(	adox	r9, rbx) \
+	ADX_Save(2*(k), r8) \
+	ADX_Save(2*(k)+1, r9)
+
+#define ADX_MulRow4(j, c0, c1, c2, c3) \
+	ADX_LoadB(j) \
+	ADX_Acc(0, c0, c1) ADX_Save(j, c0) ADX_Acc(1, c1, c2) ADX_Acc(2, c2, c3) ADX_AccTop(3, c3, c0)
+
+#define ADX_MulRow8(j, c0, c1, c2, c3, c4, c5, c6, c7) \
+	ADX_LoadB(j) \
+	ADX_Acc(0, c0, c1) ADX_Save(j, c0) ADX_Acc(1, c1, c2) ADX_Acc(2, c2, c3) ADX_Acc(3, c3, c4) \
+	ADX_Acc(4, c4, c5) ADX_Acc(5, c5, c6) ADX_Acc(6, c6, c7) ADX_AccTop(7, c7, c0)
+
+static void ADX_Multiply4(word *R, const word *A, const word *B)
+{
+	ADX_Begin
+	ADX_MulRow4(0, r8, r9, r10, r11)
+	ADX_MulRow4(1, r9, r10, r11, r8)
+	ADX_MulRow4(2, r10, r11, r8, r9)
+	ADX_MulRow4(3, r11, r8, r9, r10)
+	ADX_Save(4, r8) ADX_Save(5, r9) ADX_Save(6, r10) ADX_Save(7, r11)
+	ADX_End
+}
+
+static void ADX_Multiply8(word *R, const word *A, const word *B)
+{
+	ADX_Begin
+	ADX_MulRow8(0, r8, r9, r10, r11, r12, r13, r14, r15)
+	ADX_MulRow8(1, r9, r10, r11, r12, r13, r14, r15, r8)
+	ADX_MulRow8(2, r10, r11, r12, r13, r14, r15, r8, r9)
+	ADX_MulRow8(3, r11, r12, r13, r14, r15, r8, r9, r10)
+	ADX_MulRow8(4, r12, r13, r14, r15, r8, r9, r10, r11)
+	ADX_MulRow8(5, r13, r14, r15, r8, r9, r10, r11, r12)
+	ADX_MulRow8(6, r14, r15, r8, r9, r10, r11, r12, r13)
+	ADX_MulRow8(7, r15, r8, r9, r10, r11, r12, r13, r14)
+	ADX_Save(8, r8) ADX_Save(9, r9) ADX_Save(10, r10) ADX_Save(11, r11)
+	ADX_Save(12, r12) ADX_Save(13, r13) ADX_Save(14, r14) ADX_Save(15, r15)
+	ADX_End
+}
+
+static void ADX_MultiplyBottom4(word *R, const word *A, const word *B)
+{
+	ADX_Begin
+	ADX_LoadB(0) ADX_Acc(0, r8, r9) ADX_Save(0, r8) ADX_Acc(1, r9, r10) ADX_Acc(2, r10, r11) ADX_AccBottom(3, r11)
+	ADX_LoadB(1) ADX_Acc(0, r9, r10) ADX_Save(1, r9) ADX_Acc(1, r10, r11) ADX_AccBottom(2, r11)
+	ADX_LoadB(2) ADX_Acc(0, r10, r11) ADX_Save(2, r10) ADX_AccBottom(1, r11)
+	ADX_LoadB(3) ADX_AccBottom(0, r11) ADX_Save(3, r11)
+	ADX_End
+}
+
+static void ADX_MultiplyBottom8(word *R, const word *A, const word *B)
+{
+	ADX_Begin
+	ADX_LoadB(0) ADX_Acc(0, r8, r9) ADX_Save(0, r8) ADX_Acc(1, r9, r10) ADX_Acc(2, r10, r11) ADX_Acc(3, r11, r12)
+		ADX_Acc(4, r12, r13) ADX_Acc(5, r13, r14) ADX_Acc(6, r14, r15) ADX_AccBottom(7, r15)
+	ADX_LoadB(1) ADX_Acc(0, r9, r10) ADX_Save(1, r9) ADX_Acc(1, r10, r11) ADX_Acc(2, r11, r12)
+		ADX_Acc(3, r12, r13) ADX_Acc(4, r13, r14) ADX_Acc(5, r14, r15) ADX_AccBottom(6, r15)
+	ADX_LoadB(2) ADX_Acc(0, r10, r11) ADX_Save(2, r10) ADX_Acc(1, r11, r12)
+		ADX_Acc(2, r12, r13) ADX_Acc(3, r13, r14) ADX_Acc(4, r14, r15) ADX_AccBottom(5, r15)
+	ADX_LoadB(3) ADX_Acc(0, r11, r12) ADX_Save(3, r11)
+		ADX_Acc(1, r12, r13) ADX_Acc(2, r13, r14) ADX_Acc(3, r14, r15) ADX_AccBottom(4, r15)
+	ADX_LoadB(4) ADX_Acc(0, r12, r13) ADX_Save(4, r12) ADX_Acc(1, r13, r14) ADX_Acc(2, r14, r15) ADX_AccBottom(3, r15)
+	ADX_LoadB(5) ADX_Acc(0, r13, r14) ADX_Save(5, r13) ADX_Acc(1, r14, r15) ADX_AccBottom(2, r15)
+	ADX_LoadB(6) ADX_Acc(0, r14, r15) ADX_Save(6, r14) ADX_AccBottom(1, r15)
+	ADX_LoadB(7) ADX_AccBottom(0, r15) ADX_Save(7, r15)
+	ADX_End
+}
+
+// the products below the diagonal are added up a row at a time, with two words of the result finished after each row,
+// and then doubled while the squares on the diagonal are added in
+static void ADX_Square4(word *R, const word *A)
+{
+	const word *B = A;
+	ADX_Begin
+	ADX_Save(0, r8) ADX_Save(7, r8)
+	ADX_LoadA(0) ADX_Acc(1, r9, r10) ADX_Acc(2, r10, r11) ADX_AccTop(3, r11, r8)
+	ADX_Save(1, r9) ADX_Save(2, r10)
+	ADX_LoadA(1) ADX_Acc(2, r11, r8) ADX_AccTop(3, r8, r9)
+	ADX_Save(3, r11) ADX_Save(4, r8)
+	ADX_LoadA(2) ADX_AccTop(3, r9, r10)
+	ADX_Save(5, r9) ADX_Save(6, r10)
+	ADX_SquDiag(0) ADX_SquDiag(1) ADX_SquDiag(2) ADX_SquDiag(3)
+	ADX_End
+}
+
+static void ADX_Square8(word *R, const word *A)
+{
+	const word *B = A;
+	ADX_Begin
+	ADX_Save(0, r8) ADX_Save(15, r8)
+	ADX_LoadA(0) ADX_Acc(1, r9, r10) ADX_Acc(2, r10, r11) ADX_Acc(3, r11, r12) ADX_Acc(4, r12, r13)
+		ADX_Acc(5, r13, r14) ADX_Acc(6, r14, r15) ADX_AccTop(7, r15, r8)
+	ADX_Save(1, r9) ADX_Save(2, r10)
+	ADX_LoadA(1) ADX_Acc(2, r11, r12) ADX_Acc(3, r12, r13) ADX_Acc(4, r13, r14)
+		ADX_Acc(5, r14, r15) ADX_Acc(6, r15, r8) ADX_AccTop(7, r8, r9)
+	ADX_Save(3, r11) ADX_Save(4, r12)
+	ADX_LoadA(2) ADX_Acc(3, r13, r14) ADX_Acc(4, r14, r15) ADX_Acc(5, r15, r8) ADX_Acc(6, r8, r9) ADX_AccTop(7, r9, r10)
+	ADX_Save(5, r13) ADX_Save(6, r14)
+	ADX_LoadA(3) ADX_Acc(4, r15, r8) ADX_Acc(5, r8, r9) ADX_Acc(6, r9, r10) ADX_AccTop(7, r10, r11)
+	ADX_Save(7, r15) ADX_Save(8, r8)
+	ADX_LoadA(4) ADX_Acc(5, r9, r10) ADX_Acc(6, r10, r11) ADX_AccTop(7, r11, r12)
+	ADX_Save(9, r9) ADX_Save(10, r10)
+	ADX_LoadA(5) ADX_Acc(6, r11, r12) ADX_AccTop(7, r12, r13)
+	ADX_Save(11, r11) ADX_Save(12, r12)
+	ADX_LoadA(6) ADX_AccTop(7, r13, r14)
+	ADX_Save(13, r13) ADX_Save(14, r14)
+	ADX_SquDiag(0) ADX_SquDiag(1) ADX_SquDiag(2) ADX_SquDiag(3)
+	ADX_SquDiag(4) ADX_SquDiag(5) ADX_SquDiag(6) ADX_SquDiag(7)
+	ADX_End
+}
+
+// X[N..2*N) + carry*2**(WORD_BITS*N) = X[2*N]/(2**(WORD_BITS*N)) mod M, possibly plus M, with u = -1/M[0] mod 2**WORD_BITS
+// each pass eliminates one word of X by adding a row of M*(X[i]*u) into it, N must be a multiple of 8, and the carry is returned
+static word ADX_MontgomeryReduce(word *X, const word *M, word u, size_t N)
+{
+	word carry;
+	__asm__ __volatile__
+	(
+		".intel_syntax noprefix;"
+		AS2(	lea		r12, [rdi+8*%3])
+		AS2(	lea		rsi, [rsi+8*%3])
+		AS2(	mov		r8, %3)
+		AS1(	neg		r8)
+		AS2(	xor		r11d, r11d)
+		ASL(0)
+		AS2(	mov		rdx, [rdi])
+		AS2(	imul	rdx, %4)
+		AS2(	xor		r13d, r13d)		// clear CF and OF
+		AS2(	mov		rcx, r8)
+		ASL(1)
+		ADX_RedAcc(0, r14, r13)
+		ADX_RedAcc(1, r13, r14)
+		ADX_RedAcc(2, r14, r13)
+		ADX_RedAcc(3, r13, r14)
+		ADX_RedAcc(4, r14, r13)
+		ADX_RedAcc(5, r13, r14)
+		ADX_RedAcc(6, r14, r13)
+		ADX_RedAcc(7, r13, r14)
+		AS2(	lea		rcx, [rcx+8])
+		ASJ(	jrcxz,	2, f)
+		ASJ(	jmp,	1, b)
+		ASL(2)
+		// add the top word of the row and the carry from the last pass into X[i+N]
+		AS2(	mov		eax, 0)
+		AS2(	adcx	r13, rax)
+		AS2(	adox	r13, rax)
+		AS2(	add		r13, r11)
+		AS2(	mov		r11d, 0)
+		AS2(	adc		r11, 0)
+		AS2(	add		[r12], r13)
+		AS2(	adc		r11, 0)
+		AS2(	lea		rdi, [rdi+8])
+		AS2(	lea		r12, [r12+8])
+		AS1(	dec		%3)
+		ASJ(	jnz,	0, b)
+		AS2(	mov		rax, r11)
+		".att_syntax prefix;"
+		: "=&a" (carry), "+D" (X), "+S" (M), "+r" (N)
+		: "r" (u)
+		: "%rcx", "%rdx", "%r8", "%r11", "%r12", "%r13", "%r14", "memory", "cc"
+	);
+	return carry;
+}
+
+#endif	// #if CRYPTOPP_BOOL_ADX_ASM_AVAILABLE
+
 // ********************************************************
 
 typedef int (CRYPTOPP_FASTCALL * PAdd)(size_t N, word *C, const word *A, const word *B);
@@ -2013,6 +2247,20 @@ static void SetFunctionPointers()
 		s_pTop[4] = &Baseline_MultiplyTop16;
 #endif
 	}
+
+#if CRYPTOPP_BOOL_ADX_ASM_AVAILABLE
+	if (HasBMI2() && HasADX())
+	{
+		s_pMul[1] = &ADX_Multiply4;
+		s_pMul[2] = &ADX_Multiply8;
+
+		s_pBot[1] = &ADX_MultiplyBottom4;
+		s_pBot[2] = &ADX_MultiplyBottom8;
+
+		s_pSqu[1] = &ADX_Square4;
+		s_pSqu[2] = &ADX_Square8;
+	}
+#endif
 }
 
 inline int Add(word *C, const word *A, const word *B, size_t N)
@@ -2035,6 +2283,433 @@ inline int Subtract(word *C, const word *A, const word *B, size_t N)
 
 // ********************************************************
 
+void RecursiveMultiply(word *R, word *T, const word *A, const word *B, size_t N);
+void RecursiveSquare(word *R, word *T, const word *A, size_t N);
+
+// Toom-Cook 4-way multiplication splits the operands into four pieces and interpolates
+// the product from its values at 0, 1, -1, 2, -2, 1/2 and infinity, so seven products of
+// N/4 words replace the nine done by two levels of Karatsuba. Register sizes are powers
+// of 2 at this length, so the pieces stay valid sizes for RecursiveMultiply, which they
+// would not with a 3-way split.
+
+static const size_t s_toomThreshold = 512;
+
+// X[N+2] = X[N+2] * 2**shiftBits + A[N]
+
+static inline void ToomHorner(word *X, const word *A, unsigned int shiftBits, size_t N)
+{
+	ShiftWordsLeftByBits(X, N+2, shiftBits);
+	Increment(X+N, 2, Add(X, X, A, N));
+}
+
+// C[N] = |A[N] - B[N]|, returns 1 if A < B
+
+static inline int ToomDifference(word *C, const word *A, const word *B, size_t N)
+{
+	if (Compare(A, B, N) >= 0)
+	{
+		Subtract(C, A, B, N);
+		return 0;
+	}
+	else
+	{
+		Subtract(C, B, A, N);
+		return 1;
+	}
+}
+
+// V[5*(N+2)] - A at 1, -1, 2, -2 and 8*A at 1/2, as magnitudes of N+1 words
+// T[2*(N+2)] - temporary work space
+// A[4*N] ---- polynomial with coefficients of N words
+// returns the signs of A(-1) and A(-2) in bits 0 and 1
+
+static int ToomEvaluate(word *V, word *T, const word *A, size_t N)
+{
+	const size_t N2 = N+2;
+	word *const E = T;
+	word *const O = T+N2;
+	int signs;
+
+	E[N] = Add(E, A, A+2*N, N);
+	O[N] = Add(O, A+N, A+3*N, N);
+	E[N+1] = O[N+1] = 0;
+	Add(V, E, O, N2);
+	signs = ToomDifference(V+N2, E, O, N2);
+
+	CopyWords(E, A+2*N, N);
+	CopyWords(O, A+3*N, N);
+	E[N] = E[N+1] = O[N] = O[N+1] = 0;
+	ToomHorner(E, A, 2, N);
+	ToomHorner(O, A+N, 2, N);
+	ShiftWordsLeftByBits(O, N2, 1);
+	Add(V+2*N2, E, O, N2);
+	signs |= ToomDifference(V+3*N2, E, O, N2) << 1;
+
+	word *const H = V+4*N2;
+	CopyWords(H, A, N);
+	H[N] = H[N+1] = 0;
+	ToomHorner(H, A+N, 1, N);
+	ToomHorner(H, A+2*N, 1, N);
+	ToomHorner(H, A+3*N, 1, N);
+
+	return signs;
+}
+
+// R[2*N+2] - result = X*Y
+// T[2*N] --- temporary work space
+// X[N+1] --- multiplier, with a small top word
+// Y[N+1] --- multiplicant, with a small top word
+
+static void ToomPointMultiply(word *R, word *T, const word *X, const word *Y, size_t N)
+{
+	if (X == Y)
+		RecursiveSquare(R, T, X, N);
+	else
+		RecursiveMultiply(R, T, X, Y, N);
+	R[2*N] = R[2*N+1] = 0;
+
+	T[N] = LinearMultiply(T, Y, X[N], N);
+	T[N+1] = 0;
+	Add(R+N, R+N, T, N+2);
+	T[N] = LinearMultiply(T, X, Y[N], N);
+	Add(R+N, R+N, T, N+2);
+	Increment(R+2*N, 2, X[N]*Y[N]);
+}
+
+// A[N] = A[N] / 2**shiftBits, where A is in two's complement
+
+static inline void ToomShiftRight(word *A, size_t N, unsigned int shiftBits)
+{
+	word sign = 0 - (A[N-1] >> (WORD_BITS-1));
+	ShiftWordsRightByBits(A, N, shiftBits);
+	A[N-1] |= sign << (WORD_BITS-shiftBits);
+}
+
+// the small multipliers and divisors below are kept out of MultiplyWords, whose
+// inline assembly cannot take a constant operand
+
+#define ToomMultiplyHalves(hi, lo, a, m) \
+	lo = (a & (((word)1 << WORD_BITS/2) - 1)) * m; \
+	hi = (a >> WORD_BITS/2) * m + (lo >> WORD_BITS/2);
+
+// C[N] = A[N] * m mod 2**(WORD_BITS*N), where m is small
+
+static void ToomMultiplySmall(word *C, const word *A, word m, size_t N)
+{
+	word carry = 0, hi, lo;
+
+	for (size_t i=0; i<N; i++)
+	{
+		ToomMultiplyHalves(hi, lo, A[i], m);
+		word t = (hi << WORD_BITS/2) | (lo & (((word)1 << WORD_BITS/2) - 1));
+		C[i] = t + carry;
+		carry = (hi >> WORD_BITS/2) + (C[i] < t);
+	}
+}
+
+// A[N] = A[N] / d, where d is small and odd, divides A exactly, and A is in two's complement
+
+static void ToomDivideExact(word *A, size_t N, word d)
+{
+	const word inverse = AtomicInverseModPower2(d);
+	word borrow = 0, hi, lo;
+
+	for (size_t i=0; i<N; i++)
+	{
+		word t = A[i] - borrow;
+		borrow = (t > A[i]);
+		A[i] = t * inverse;
+
+		ToomMultiplyHalves(hi, lo, A[i], d);
+		borrow += hi >> WORD_BITS/2;
+	}
+}
+
+// R[2*N] - result = A*B
+// T[2*N] - temporary work space
+// A[N] --- multiplier
+// B[N] --- multiplicant, may be the same as A
+
+static void ToomMultiply(word *R, word *T, const word *A, const word *B, size_t N)
+{
+	assert(N%8 == 0);
+
+	const size_t N4 = N/4, N2 = N4+2, L = 2*N4+2;
+	IntegerSecBlock workspace(10*N2 + 5*L);
+	word *const VA = workspace;
+	word *const VB = (A == B) ? VA : VA+5*N2;
+	word *const W = VA+10*N2;
+
+	int signs = ToomEvaluate(VA, T, A, N4);
+	if (A != B)
+		signs ^= ToomEvaluate(VB, T, B, N4);
+	else
+		signs = 0;
+
+	// W holds the product at -2, 1, -1, 2 and 64 times the product at 1/2
+	ToomPointMultiply(W, T, VA+3*N2, VB+3*N2, N4);
+	ToomPointMultiply(W+L, T, VA, VB, N4);
+	ToomPointMultiply(W+2*L, T, VA+N2, VB+N2, N4);
+	ToomPointMultiply(W+3*L, T, VA+2*N2, VB+2*N2, N4);
+	ToomPointMultiply(W+4*L, T, VA+4*N2, VB+4*N2, N4);
+	if (signs & 2)
+		TwosComplement(W, L);
+	if (signs & 1)
+		TwosComplement(W+2*L, L);
+
+	if (A == B)
+	{
+		RecursiveSquare(R, T, A, N4);
+		RecursiveSquare(R+6*N4, T, A+3*N4, N4);
+	}
+	else
+	{
+		RecursiveMultiply(R, T, A, B, N4);
+		RecursiveMultiply(R+6*N4, T, A+3*N4, B+3*N4, N4);
+	}
+
+	word *const W0 = R, *const W1 = W, *const W2 = W+L, *const W3 = W+2*L;
+	word *const W4 = W+3*L, *const W5 = W+4*L, *const W6 = R+6*N4;
+
+	// interpolation sequence from Bodrato and Zanoni, with every intermediate value
+	// kept in two's complement and every division exact
+	Add(W5, W5, W4, L);
+	Subtract(W1, W4, W1, L);
+	ToomShiftRight(W1, L, 1);
+	Decrement(W4+2*N4, 2, Subtract(W4, W4, W0, 2*N4));
+	Subtract(W4, W4, W1, L);
+	ToomShiftRight(W4, L, 2);
+	CopyWords(T, W6, 2*N4);
+	T[2*N4] = ShiftWordsLeftByBits(T, 2*N4, 4);
+	T[2*N4+1] = 0;
+	Subtract(W4, W4, T, L);
+	Subtract(W3, W2, W3, L);
+	ToomShiftRight(W3, L, 1);
+	Subtract(W2, W2, W3, L);
+
+	ToomMultiplySmall(T, W2, 65, L);
+	Subtract(W5, W5, T, L);
+	Decrement(W2+2*N4, 2, Subtract(W2, W2, W6, 2*N4));
+	Decrement(W2+2*N4, 2, Subtract(W2, W2, W0, 2*N4));
+	ToomMultiplySmall(T, W2, 45, L);
+	Add(W5, W5, T, L);
+	ToomShiftRight(W5, L, 1);
+	Subtract(W4, W4, W2, L);
+	ToomDivideExact(W4, L, 3);
+	Subtract(W2, W2, W4, L);
+
+	Subtract(W1, W5, W1, L);
+	ToomMultiplySmall(T, W3, 8, L);
+	Subtract(W5, W5, T, L);
+	ToomDivideExact(W5, L, 9);
+	Subtract(W3, W3, W5, L);
+	ToomDivideExact(W1, L, 15);
+	Add(W1, W1, W5, L);
+	ToomShiftRight(W1, L, 1);
+	Subtract(W5, W5, W1, L);
+
+	// W1 through W5 are now the middle coefficients, all nonnegative
+	SetWords(R+2*N4, 0, 4*N4);
+	for (size_t i=1; i<=5; i++)
+	{
+		word *const Ri = R+i*N4;
+		Increment(Ri+L, 8*N4-i*N4-L, Add(Ri, Ri, W+(i-1)*L, L));
+	}
+}
+
+// Above s_nttThreshold words, products are computed with number theoretic transforms
+// modulo three primes of the form c*2**k+1 below 2**31. The operands are split into
+// 32-bit digits, so each convolution coefficient is below 2**90, which the three
+// residues determine exactly through the Chinese Remainder Theorem.
+
+static const size_t s_nttThreshold = 32768;
+
+struct NTTPrime
+{
+	word32 p, g;
+};
+
+static const NTTPrime s_nttPrimes[3] = {{2013265921, 31}, {1811939329, 13}, {469762049, 3}};
+static const unsigned int s_nttMaxLog = 26;
+
+class NTTField
+{
+public:
+	NTTField(word32 p)
+		: m_p(p)
+	{
+		word32 u = p;	// inverse of p mod 2**32
+		for (unsigned int i=0; i<5; i++)
+			u *= 2-p*u;
+		m_pInv = 0-u;
+		m_r2 = word32((0-(word64)p) % p);	// 2**64 mod p
+	}
+
+	// p < 2**31, so the top bit tells when to add p back, without a branch
+	word32 Normalize(word32 a) const
+		{return a + (m_p & (0-(a>>31)));}
+	word32 Add(word32 a, word32 b) const
+		{return Normalize(a+b-m_p);}
+	word32 Subtract(word32 a, word32 b) const
+		{return Normalize(a-b);}
+	// a*b/2**32 mod p
+	word32 MontgomeryMultiply(word32 a, word32 b) const
+	{
+		word64 t = (word64)a*b;
+		return Normalize(word32((t + (word64)(word32(t)*m_pInv)*m_p) >> 32) - m_p);
+	}
+	word32 ToMontgomery(word32 a) const
+		{return MontgomeryMultiply(a, m_r2);}
+	word32 Exponentiate(word32 a, word64 e) const
+	{
+		word32 r = ToMontgomery(1);
+		a = ToMontgomery(a);
+		for (; e; e >>= 1, a = MontgomeryMultiply(a, a))
+			if (e & 1)
+				r = MontgomeryMultiply(r, a);
+		return MontgomeryMultiply(r, 1);
+	}
+
+	word32 m_p, m_pInv, m_r2;
+};
+
+// W[M] - Montgomery forms of the powers of w used by each stage, where w is a primitive
+//          M-th root of unity, with the powers of the 2*len-th root of unity at W[len]
+// V[M] - the same for the inverse transform, which uses the powers of 1/w
+
+static void NTTRoots(word32 *W, word32 *V, const NTTField &f, word32 g, size_t M)
+{
+	const size_t M2 = M/2;
+	const word32 w = f.ToMontgomery(f.Exponentiate(g, (f.m_p-1)/M));
+
+	W[M2] = f.ToMontgomery(1);
+	for (size_t j=1; j<M2; j++)
+		W[M2+j] = f.MontgomeryMultiply(W[M2+j-1], w);
+	for (size_t len=M2/2; len>=1; len/=2)
+		for (size_t j=0; j<len; j++)
+			W[len+j] = W[2*len+2*j];
+
+	// the 2*len-th root to the power len is -1
+	for (size_t len=1; len<M; len*=2)
+	{
+		V[len] = W[len];
+		for (size_t j=1; j<len; j++)
+			V[len+j] = f.Subtract(0, W[2*len-j]);
+	}
+}
+
+// decimation in frequency, natural order in and bit reversed order out
+
+static void NTTForward(word32 *X, const word32 *W, const NTTField &f, size_t M)
+{
+	for (size_t len=M/2; len>=1; len/=2)
+		for (size_t i=0; i<M; i+=2*len)
+			for (size_t j=0; j<len; j++)
+			{
+				word32 u = X[i+j], v = X[i+j+len];
+				X[i+j] = f.Add(u, v);
+				X[i+j+len] = f.MontgomeryMultiply(f.Subtract(u, v), W[len+j]);
+			}
+}
+
+// decimation in time, bit reversed order in and natural order out, without the 1/M scaling
+
+static void NTTInverse(word32 *X, const word32 *W, const NTTField &f, size_t M)
+{
+	for (size_t len=1; len<M; len*=2)
+		for (size_t i=0; i<M; i+=2*len)
+			for (size_t j=0; j<len; j++)
+			{
+				word32 u = X[i+j], v = f.MontgomeryMultiply(X[i+j+len], W[len+j]);
+				X[i+j] = f.Add(u, v);
+				X[i+j+len] = f.Subtract(u, v);
+			}
+}
+
+// X[M] = the 32-bit digits of A in Montgomery form, padded with zeros
+
+static void NTTLoad(word32 *X, const word *A, size_t NA, const NTTField &f, size_t M)
+{
+	const size_t digits = NA*(WORD_SIZE/4);
+	for (size_t i=0; i<digits; i++)
+		X[i] = f.MontgomeryMultiply(word32(A[i/(WORD_SIZE/4)] >> (32*(i%(WORD_SIZE/4)))), f.m_r2);
+	std::fill(X+digits, X+M, word32(0));
+}
+
+static inline bool NTTAvailable(size_t NA, size_t NB)
+{
+	return (NA+NB)*(WORD_SIZE/4) <= ((size_t)1 << s_nttMaxLog);
+}
+
+// R[NA+NB] - result = A*B
+// A[NA] ---- multiplier
+// B[NB] ---- multiplicant, may be the same as A
+
+static void NTTMultiply(word *R, const word *A, size_t NA, const word *B, size_t NB)
+{
+	assert(NTTAvailable(NA, NB));
+
+	const size_t digits = (NA+NB)*(WORD_SIZE/4);
+	size_t M = 2;
+	while (M < digits)
+		M *= 2;
+
+	SecBlock<word32> residues(3*M), workspace(3*M);
+	word32 *const Y = workspace, *const W = workspace+M, *const V = workspace+2*M;
+	const bool square = (A == B && NA == NB);
+
+	for (unsigned int k=0; k<3; k++)
+	{
+		const NTTField f(s_nttPrimes[k].p);
+		word32 *const X = residues+k*M;
+
+		NTTRoots(W, V, f, s_nttPrimes[k].g, M);
+		NTTLoad(X, A, NA, f, M);
+		NTTForward(X, W, f, M);
+		if (!square)
+		{
+			NTTLoad(Y, B, NB, f, M);
+			NTTForward(Y, W, f, M);
+		}
+
+		// both transforms are in Montgomery form, so multiplying by 1/M also leaves the
+		// product in normal form
+		const word32 scale = f.Exponentiate(word32(M), f.m_p-2);
+		const word32 *const Z = square ? X : Y;
+		for (size_t i=0; i<M; i++)
+			X[i] = f.MontgomeryMultiply(f.MontgomeryMultiply(X[i], Z[i]), scale);
+
+		NTTInverse(X, V, f, M);
+	}
+
+	// Garner's algorithm: x = r0 + p0*(t1 + p1*t2), then propagate carries through the digits
+	const word32 p0 = s_nttPrimes[0].p, p1 = s_nttPrimes[1].p, p2 = s_nttPrimes[2].p;
+	const NTTField f1(p1), f2(p2);
+	const word32 p0InvModP1 = f1.ToMontgomery(f1.Exponentiate(p0 % p1, p1-2));
+	const word64 p01 = (word64)p0*p1;
+	const word32 p01InvModP2 = f2.ToMontgomery(f2.Exponentiate(word32(p01 % p2), p2-2));
+	const word32 rModP2 = f2.ToMontgomery(1), p0ModP2 = f2.ToMontgomery(p0 % p2);
+	const word32 *const R0 = residues, *const R1 = residues+M, *const R2 = residues+2*M;
+
+	word64 carry = 0;
+	SetWords(R, 0, NA+NB);
+	for (size_t i=0; i<digits; i++)
+	{
+		// p0 < 2*p1, and Montgomery multiplication by 2**32 mod p2 reduces a word32 mod p2
+		const word32 r0 = R0[i];
+		word32 t1 = f1.MontgomeryMultiply(f1.Subtract(R1[i], r0 >= p1 ? r0-p1 : r0), p0InvModP1);
+		word64 y = r0 + (word64)p0*t1;
+		word32 yModP2 = f2.Add(f2.MontgomeryMultiply(r0, rModP2), f2.MontgomeryMultiply(t1, p0ModP2));
+		word32 t2 = f2.MontgomeryMultiply(f2.Subtract(R2[i], yModP2), p01InvModP2);
+
+		word64 v0 = (y & 0xffffffff) + (p01 & 0xffffffff)*t2 + (carry & 0xffffffff);
+		word64 v1 = (y >> 32) + (p01 >> 32)*t2 + (carry >> 32) + (v0 >> 32);
+		R[i/(WORD_SIZE/4)] |= (word)word32(v0) << (32*(i%(WORD_SIZE/4)));
+		carry = v1;
+	}
+	assert(carry == 0);
+}
+
 
 #define A0		A
 #define A1		(A+N2)
@@ -2062,6 +2737,10 @@ void RecursiveMultiply(word *R, word *T, const word *A, const word *B, size_t N)
 
 	if (N <= s_recursionLimit)
 		s_pMul[N/4](R, A, B);
+	else if (N >= s_nttThreshold && NTTAvailable(N, N))
+		NTTMultiply(R, A, N, B, N);
+	else if (N >= s_toomThreshold)
+		ToomMultiply(R, T, A, B, N);
 	else
 	{
 		const size_t N2 = N/2;
@@ -2104,6 +2783,10 @@ void RecursiveSquare(word *R, word *T, const word *A, size_t N)
 
 	if (N <= s_recursionLimit)
 		s_pSqu[N/4](R, A);
+	else if (N >= s_nttThreshold && NTTAvailable(N, N))
+		NTTMultiply(R, A, N, A, N);
+	else if (N >= s_toomThreshold)
+		ToomMultiply(R, T, A, A, N);
 	else
 	{
 		const size_t N2 = N/2;
@@ -2236,6 +2919,12 @@ void AsymmetricMultiply(word *R, word *T, const word *A, size_t NA, const word *
 
 	assert(NB % NA == 0);
 
+	if (NA >= s_nttThreshold && NTTAvailable(NA, NB))
+	{
+		NTTMultiply(R, A, NA, B, NB);
+		return;
+	}
+
 	if (NA==2 && !A[1])
 	{
 		switch (A[0])
@@ -2314,6 +3003,18 @@ void RecursiveInverseModPower2(word *R, word *T, const word *A, size_t N)
 
 void MontgomeryReduce(word *R, word *T, word *X, const word *M, const word *U, size_t N)
 {
+#if CRYPTOPP_BOOL_ADX_ASM_AVAILABLE
+	// a word at a time is quicker than MultiplyBottom and MultiplyTop up to 4096 bits
+	if (N%8 == 0 && N <= 64 && HasBMI2() && HasADX())
+	{
+		word carry = ADX_MontgomeryReduce(X, M, 0-U[0], N);
+		// defend against timing attack by doing this Subtract even when not needed
+		word borrow = Subtract(X, X+N, M, N);
+		CopyWords(R, X + ((0-(borrow & ~carry)) & N), N);
+		return;
+	}
+#endif
+
 #if 1
 	MultiplyBottom(R, T, X, U, N);
 	MultiplyTop(T, T+N, X, R, M, N);
@@ -2730,15 +3431,104 @@ void MultiplyByPower2Mod(word *R, const word *A, size_t k, const word *M, size_t
 
 // ******************************************************************
 
+#ifdef CRYPTOPP_INTEGER_ARENA
+static void CreateIntegerArenaSlot();
+#endif
+
 InitializeInteger::InitializeInteger()
 {
 	if (!g_pAssignIntToInteger)
 	{
 		SetFunctionPointers();
+#ifdef CRYPTOPP_INTEGER_ARENA
+		CreateIntegerArenaSlot();
+#endif
 		g_pAssignIntToInteger = AssignIntToInteger;
 	}
 }
 
+#ifdef CRYPTOPP_INTEGER_ARENA
+
+#ifdef THREADS_AVAILABLE
+// created during static initialization, before other threads can race to create it, and never deleted,
+// since Integers are freed during static destruction
+static ThreadLocalStorage & AccessCurrentIntegerArena()
+{
+	static ThreadLocalStorage *currentArena = new ThreadLocalStorage;
+	return *currentArena;
+}
+
+static inline IntegerArena * GetCurrentIntegerArena()
+	{return (IntegerArena *)AccessCurrentIntegerArena().GetValue();}
+static inline void SetCurrentIntegerArena(IntegerArena *arena)
+	{AccessCurrentIntegerArena().SetValue(arena);}
+static void CreateIntegerArenaSlot()
+	{AccessCurrentIntegerArena();}
+#else
+static IntegerArena *s_currentIntegerArena = NULL;
+
+static inline IntegerArena * GetCurrentIntegerArena()
+	{return s_currentIntegerArena;}
+static inline void SetCurrentIntegerArena(IntegerArena *arena)
+	{s_currentIntegerArena = arena;}
+static void CreateIntegerArenaSlot() {}
+#endif
+
+// the arena's size class for a block of n words, or UINT_MAX if n isn't a power of 2
+static inline unsigned int IntegerArenaSizeClass(size_t n)
+{
+	return n && !(n & (n-1)) ? BitPrecision(n)-1 : UINT_MAX;
+}
+
+typedef AllocatorWithCleanup<word, CRYPTOPP_BOOL_X86> IntegerHeapAllocator;
+
+IntegerArena::IntegerArena()
+	: m_previous(GetCurrentIntegerArena())
+{
+	memset(m_blockCount, 0, sizeof(m_blockCount));
+	SetCurrentIntegerArena(this);
+}
+
+IntegerArena::~IntegerArena()
+{
+	assert(GetCurrentIntegerArena() == this);
+	SetCurrentIntegerArena(m_previous);
+
+	for (unsigned int i=0; i<SIZE_CLASSES; i++)
+		for (unsigned int j=0; j<m_blockCount[i]; j++)
+			IntegerHeapAllocator().deallocate(m_blocks[i][j], size_t(1) << i);
+}
+
+word * IntegerArena::Allocate(size_t n)
+{
+	IntegerArena *arena = GetCurrentIntegerArena();
+	unsigned int i = IntegerArenaSizeClass(n);
+	if (arena && i < SIZE_CLASSES && arena->m_blockCount[i])
+		return arena->m_blocks[i][--arena->m_blockCount[i]];
+
+	return IntegerHeapAllocator().allocate(n);
+}
+
+void IntegerArena::Deallocate(word *p, size_t n)
+{
+	if (p)
+	{
+		IntegerArena *arena = GetCurrentIntegerArena();
+		unsigned int i = IntegerArenaSizeClass(n);
+		if (arena && i < SIZE_CLASSES && arena->m_blockCount[i] < BLOCKS_PER_CLASS)
+		{
+			// the block may hold a secret, and the next Integer to get it may not overwrite all of it
+			SecureWipeArray(p, n);
+			arena->m_blocks[i][arena->m_blockCount[i]++] = p;
+			return;
+		}
+	}
+
+	IntegerHeapAllocator().deallocate(p, n);
+}
+
+#endif	// #ifdef CRYPTOPP_INTEGER_ARENA
+
 static const unsigned int RoundupSizeTable[] = {2, 2, 2, 4, 4, 8, 8, 8, 8};
 
 static inline size_t RoundupSize(size_t n)
@@ -3702,6 +4492,63 @@ void PositiveDivide(Integer &remainder, Integer &quotient,
 }
 */
 
+// Dividing by a divisor of more than s_newtonThreshold words uses Newton's iteration
+// for its reciprocal. After that each quotient digit, in base 2**(divisor bits - 1),
+// takes two multiplications, so division runs at the speed of multiplication.
+
+static const size_t s_newtonThreshold = 192;
+
+// returns floor(2**(2*k) / b) to within a few units, where b has k bits
+
+static Integer NewtonReciprocal(const Integer &b, unsigned int k)
+{
+	if (k <= s_newtonThreshold*WORD_BITS)
+		return Integer::Power2(2*k) / b;
+
+	// one Newton step from the reciprocal of the top h bits of b, which doubles its precision
+	const unsigned int g = WORD_BITS, h = k/2 + g;
+	const Integer y = NewtonReciprocal(b >> (k-h), h);
+	const Integer e = Integer::Power2(2*k) - ((b * y) << (k-h));
+	const Integer x = y << (k-h);
+	return x + (((x >> (h-g)) * (e >> (k-g))) >> (k-h+2*g));
+}
+
+// q = a/b and r = a%b, where b has k bits, a < b*2**(k-1), and x is from NewtonReciprocal()
+
+static void NewtonDivideStep(Integer &r, Integer &q, const Integer &a, const Integer &b, const Integer &x, unsigned int k)
+{
+	q = ((a >> (k-1)) * x) >> (k+1);
+	r = a - q*b;
+
+	while (r.IsNegative())
+	{
+		r += b;
+		--q;
+	}
+	while (r >= b)
+	{
+		r -= b;
+		++q;
+	}
+}
+
+static void NewtonDivide(Integer &remainder, Integer &quotient, const Integer &a, const Integer &b)
+{
+	const unsigned int k = b.BitCount(), digitBits = k-1;
+	const Integer x = NewtonReciprocal(b, k);
+	Integer digit, q, t;
+
+	remainder = quotient = Integer::Zero();
+	for (size_t n = a.BitCount(); n > 0; )
+	{
+		const unsigned int len = n % digitBits ? n % digitBits : digitBits;
+		n -= len;
+		Integer::DivideByPowerOf2(digit, t, a >> n, len);
+		NewtonDivideStep(remainder, q, (remainder << len) + digit, b, x, k);
+		quotient = (quotient << len) + q;
+	}
+}
+
 void PositiveDivide(Integer &remainder, Integer &quotient,
 				   const Integer &a, const Integer &b)
 {
@@ -3719,6 +4566,12 @@ void PositiveDivide(Integer &remainder, Integer &quotient,
 		return;
 	}
 
+	if (bSize > s_newtonThreshold && aSize-bSize > s_newtonThreshold/2)
+	{
+		NewtonDivide(remainder, quotient, a.AbsoluteValue(), b.AbsoluteValue());
+		return;
+	}
+
 	aSize += aSize%2;	// round up to next even number
 	bSize += bSize%2;
 
@@ -3777,6 +4630,35 @@ void Integer::DivideByPowerOf2(Integer &r, Integer &q, const Integer &a, unsigne
 	}
 }
 
+void Integer::MultiplyAdd(Integer &r, const Integer &a, const Integer &b, const Integer &c)
+{
+	if (&r == &a || &r == &b || &r == &c)
+	{
+		Integer t;
+		MultiplyAdd(t, a, b, c);
+		r.swap(t);
+		return;
+	}
+
+	Multiply(r, a, b);
+	r += c;
+}
+
+void Integer::ModMul(Integer &r, const Integer &a, const Integer &b, const Integer &m)
+{
+	// r may be a or b, since they're only read by the multiplication
+	Integer product, quotient;
+	Multiply(product, a, b);
+	if (&r == &m)
+	{
+		Integer t;
+		Divide(t, quotient, product, m);
+		r.swap(t);
+	}
+	else
+		Divide(r, quotient, product, m);
+}
+
 Integer Integer::DividedBy(const Integer &b) const
 {
 	Integer remainder, quotient;
@@ -4133,6 +5015,28 @@ const Integer& ModularArithmetic::Inverse(const Integer &a) const
 	return m_result;
 }
 
+Integer ModularArithmetic::Exponentiate(const Integer &a, const Integer &e) const
+{
+	if (m_modulus.IsOdd())
+	{
+		MontgomeryRepresentation dr(m_modulus);
+		return dr.ConvertOut(dr.Exponentiate(dr.ConvertIn(a), e));
+	}
+	else
+		return AbstractRing<Integer>::Exponentiate(a, e);
+}
+
+Integer ModularArithmetic::ExponentiatePublic(const Integer &a, const Integer &e) const
+{
+	if (m_modulus.IsOdd())
+	{
+		MontgomeryRepresentation dr(m_modulus);
+		return dr.ConvertOut(dr.ExponentiatePublic(dr.ConvertIn(a), e));
+	}
+	else
+		return AbstractRing<Integer>::Exponentiate(a, e);
+}
+
 Integer ModularArithmetic::CascadeExponentiate(const Integer &x, const Integer &e1, const Integer &y, const Integer &e2) const
 {
 	if (m_modulus.IsOdd())
@@ -4149,7 +5053,10 @@ void ModularArithmetic::SimultaneousExponentiate(Integer *results, const Integer
 	if (m_modulus.IsOdd())
 	{
 		MontgomeryRepresentation dr(m_modulus);
-		dr.SimultaneousExponentiate(results, dr.ConvertIn(base), exponents, exponentsCount);
+		if (exponentsCount == 1)
+			results[0] = dr.Exponentiate(dr.ConvertIn(base), exponents[0]);
+		else
+			dr.SimultaneousExponentiate(results, dr.ConvertIn(base), exponents, exponentsCount);
 		for (unsigned int i=0; i<exponentsCount; i++)
 			results[i] = dr.ConvertOut(results[i]);
 	}
@@ -4157,6 +5064,20 @@ void ModularArithmetic::SimultaneousExponentiate(Integer *results, const Integer
 		AbstractRing<Integer>::SimultaneousExponentiate(results, base, exponents, exponentsCount);
 }
 
+Integer ModularArithmetic::MultiExponentiate(const Integer *bases, const Integer *exponents, unsigned int count) const
+{
+	if (m_modulus.IsOdd() && count > 1)
+	{
+		MontgomeryRepresentation dr(m_modulus);
+		std::vector<Integer> drBases(count);
+		for (unsigned int i=0; i<count; i++)
+			drBases[i] = dr.ConvertIn(bases[i]);
+		return dr.ConvertOut(dr.MultiExponentiate(&drBases[0], exponents, count));
+	}
+	else
+		return AbstractRing<Integer>::MultiExponentiate(bases, exponents, count);
+}
+
 MontgomeryRepresentation::MontgomeryRepresentation(const Integer &m)	// modulus must be odd
 	: ModularArithmetic(m),
 	  m_u((word)0, m_modulus.reg.size()),
@@ -4230,6 +5151,360 @@ const Integer& MontgomeryRepresentation::MultiplicativeInverse(const Integer &a)
 	return m_result;
 }
 
+// R[N] = A*B/(2**(WORD_BITS*N)) mod M, T[5*N] is temporary work space, and R may be the same as A or B
+static inline void MontgomeryMultiply(word *R, word *T, const word *A, const word *B, const word *M, const word *U, size_t N)
+{
+	if (A == B)
+		CryptoPP::Square(T, T+2*N, A, N);
+	else
+		CryptoPP::Multiply(T, T+2*N, A, B, N);
+	MontgomeryReduce(R, T+2*N, T, M, U, N);
+}
+
+// R[N] = table[index*N..index*N+N), reading all of table[count*N] so the memory access pattern doesn't depend on index
+static void GatherWords(word *R, const word *table, size_t count, size_t index, size_t N)
+{
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+	if (HasSSE2() && N*WORD_SIZE % 16 == 0)
+	{
+		const size_t N2 = N*WORD_SIZE/16;
+		const __m128i *p = (const __m128i *)table;
+		const __m128i target = _mm_set1_epi32((int)index), one = _mm_set1_epi32(1);
+		size_t j=0;
+		// four registers of R at a time, so each mask is used on more of the table
+		for (; j+4<=N2; j+=4)
+		{
+			__m128i r0 = _mm_setzero_si128(), r1 = r0, r2 = r0, r3 = r0, k = r0;
+			const __m128i *q = p+j;
+			for (size_t i=0; i<count; i++, q+=N2, k=_mm_add_epi32(k, one))
+			{
+				const __m128i mask = _mm_cmpeq_epi32(k, target);
+				r0 = _mm_or_si128(r0, _mm_and_si128(_mm_loadu_si128(q), mask));
+				r1 = _mm_or_si128(r1, _mm_and_si128(_mm_loadu_si128(q+1), mask));
+				r2 = _mm_or_si128(r2, _mm_and_si128(_mm_loadu_si128(q+2), mask));
+				r3 = _mm_or_si128(r3, _mm_and_si128(_mm_loadu_si128(q+3), mask));
+			}
+			_mm_storeu_si128((__m128i *)R+j, r0);
+			_mm_storeu_si128((__m128i *)R+j+1, r1);
+			_mm_storeu_si128((__m128i *)R+j+2, r2);
+			_mm_storeu_si128((__m128i *)R+j+3, r3);
+		}
+		for (; j<N2; j++)
+		{
+			__m128i r = _mm_setzero_si128(), k = r;
+			for (size_t i=0; i<count; i++, k=_mm_add_epi32(k, one))
+				r = _mm_or_si128(r, _mm_and_si128(_mm_loadu_si128(p+i*N2+j), _mm_cmpeq_epi32(k, target)));
+			_mm_storeu_si128((__m128i *)R+j, r);
+		}
+		return;
+	}
+#endif
+	SetWords(R, 0, N);
+	for (size_t k=0; k<count; k++)
+	{
+		const word mask = 0 - word((k ^ index) == 0);
+		for (size_t j=0; j<N; j++)
+			R[j] |= table[k*N+j] & mask;
+	}
+}
+
+// the window size, up to 6, that needs the least work for an expBits long exponent and an N word modulus
+static unsigned int FixedWindowSize(unsigned int expBits, size_t N)
+{
+	// a table of 2**w entries takes about 2**w multiplications to make, and reading all of it for
+	// a window costs about 2**w/(8*N) of a multiplication, so count in units of that
+	unsigned int best = 0;
+	size_t bestCost = 0;
+	for (unsigned int w=1; w<=6; w++)
+	{
+		const size_t tableSize = size_t(1) << w;
+		const size_t cost = tableSize*8*N + (expBits+w-1)/w*(8*N+tableSize);
+		if (best == 0 || cost < bestCost)
+		{
+			best = w;
+			bestCost = cost;
+		}
+	}
+	return best;
+}
+
+Integer MontgomeryRepresentation::Exponentiate(const Integer &a, const Integer &e) const
+{
+	if (e.IsNegative())
+		return AbstractRing<Integer>::Exponentiate(a, e);
+
+	const size_t N = m_modulus.reg.size();
+	const size_t NA = STDMIN(a.reg.size(), N);
+	// e is gone through 32 bits at a time, so where its top bit is within them doesn't show
+	const unsigned int expBits = (e.BitCount()+31)/32*32;
+	assert(a.WordCount()<=N);
+
+	const Integer &one = MultiplicativeIdentity();
+	Integer result((word)0, N);
+	word *const R = result.reg.begin();
+	CopyWords(R, one.reg, STDMIN(one.reg.size(), N));
+	if (expBits == 0)
+		return result;
+
+	// the table and the entry read from it are kept after the workspace, which is only grown on the first call
+	const unsigned int w = FixedWindowSize(expBits, N);
+	const size_t tableSize = size_t(1) << w;
+	m_workspace.Grow((6+tableSize)*N);
+	word *const T = m_workspace.begin(), *const t = T+5*N, *const table = t+N;
+
+	// table[k] = a^k in Montgomery representation
+	CopyWords(table, R, N);
+	CopyWords(table+N, a.reg, NA);
+	SetWords(table+N+NA, 0, N-NA);
+	for (size_t k=2; k<tableSize; k++)
+	{
+		const word *h = table+(k/2)*N;
+		MontgomeryMultiply(table+k*N, T, k%2 ? h+N : h, h, m_modulus.reg, m_u.reg, N);
+	}
+
+	// every window costs w squarings and a multiplication, whether its bits are 0 or not
+	unsigned int i = (expBits-1)/w*w;
+	GatherWords(R, table, tableSize, (size_t)e.GetBits(i, w), N);
+	while (i > 0)
+	{
+		i -= w;
+		for (unsigned int j=0; j<w; j++)
+			MontgomeryMultiply(R, T, R, R, m_modulus.reg, m_u.reg, N);
+		GatherWords(t, table, tableSize, (size_t)e.GetBits(i, w), N);
+		MontgomeryMultiply(R, T, R, t, m_modulus.reg, m_u.reg, N);
+	}
+
+	return result;
+}
+
+Integer MontgomeryRepresentation::ExponentiatePublic(const Integer &a, const Integer &e) const
+{
+	// longer exponents are quickest with the bucket method, which doesn't need a table
+	if (e.IsNegative() || e.BitCount() > 64)
+		return AbstractRing<Integer>::Exponentiate(a, e);
+
+	const size_t N = m_modulus.reg.size();
+	const size_t NA = STDMIN(a.reg.size(), N);
+	const unsigned int expBits = e.BitCount();
+	assert(a.WordCount()<=N);
+
+	const Integer &one = MultiplicativeIdentity();
+	Integer result((word)0, N);
+	word *const R = result.reg.begin();
+	CopyWords(R, one.reg, STDMIN(one.reg.size(), N));
+	if (expBits == 0)
+		return result;
+
+	m_workspace.Grow(6*N);
+	word *const T = m_workspace.begin(), *const base = T+5*N;
+	CopyWords(base, a.reg, NA);
+	SetWords(base+NA, 0, N-NA);
+
+	// short exponents, such as 3 and 65537, get plain square-and-multiply
+	for (unsigned int i=expBits; i>0; i--)
+	{
+		MontgomeryMultiply(R, T, R, R, m_modulus.reg, m_u.reg, N);
+		if (e.GetBit(i-1))
+			MontgomeryMultiply(R, T, R, base, m_modulus.reg, m_u.reg, N);
+	}
+
+	return result;
+}
+
+Integer MontgomeryRepresentation::Power2(const Integer &e) const
+{
+	assert(!e.IsNegative());
+
+	word *const T = m_workspace.begin();
+	const size_t N = m_modulus.reg.size();
+	const unsigned int expBits = e.BitCount();
+
+	const Integer &one = MultiplicativeIdentity();
+	Integer result((word)0, N);
+	word *const R = result.reg.begin();
+	CopyWords(R, one.reg, STDMIN(one.reg.size(), N));
+
+	// every bit costs a squaring and a doubling, and the doubled value is kept or dropped with masks
+	IntegerSecBlock d(2*N);
+	word *const D = d, *const E = d+N;
+	for (unsigned int i=expBits; i>0; i--)
+	{
+		MontgomeryMultiply(R, T, R, R, m_modulus.reg, m_u.reg, N);
+
+		CopyWords(D, R, N);
+		word carry = ShiftWordsLeftByBits(D, N, 1);
+		word borrow = CryptoPP::Subtract(E, D, m_modulus.reg, N);
+		// 2*R >= modulus, so 2*R-modulus is the one to keep, if the shift carried or the subtraction didn't borrow
+		word reduce = 0 - ((carry | (borrow ^ 1)) & 1);
+		word keep = 0 - word(e.GetBit(i-1));
+		for (size_t j=0; j<N; j++)
+			R[j] ^= (R[j] ^ (D[j] ^ ((D[j] ^ E[j]) & reduce))) & keep;
+	}
+
+	return result;
+}
+
+// ********************************************************
+
+// the product is read and the reduced result written 32 bits at a time, whatever the word size
+static inline word32 Word32At(const word *A, unsigned int i)
+{
+	return word32(A[i/(WORD_SIZE/4)] >> (32*(i%(WORD_SIZE/4))));
+}
+
+static inline void SetWord32At(word *R, unsigned int i, word32 x)
+{
+	const unsigned int j = i%(WORD_SIZE/4);
+	R[i/(WORD_SIZE/4)] = (j ? R[i/(WORD_SIZE/4)] : 0) | (word(x) << (32*j));
+}
+
+// each 32-bit word of a number reduced modulo P-384 is a signed sum of its words, see FIPS 186-3, section D.2
+// SolinasSum() computes these sums from the words of T and writes them to R, and returns the multiple of 2^BITS left over, which is between
+// s_solinasMinCarry and s_solinasMaxCarry
+static const int s_solinasMinCarry = -4;
+static const int s_solinasMaxCarry = 5;
+template <unsigned int BITS> static sword64 SolinasSum(word *R, const word *T);
+
+#define C(i)	Word32At(T, i)
+
+template <> inline sword64 SolinasSum<384>(word *R, const word *T)
+{
+	sword64 t = 0;
+	t += sword64(C(0)) + C(12) + C(20) + C(21) - C(23);		SetWord32At(R, 0, word32(t)); t >>= 32;
+	t += sword64(C(1)) + C(13) + C(22) + C(23) - C(12) - C(20);		SetWord32At(R, 1, word32(t)); t >>= 32;
+	t += sword64(C(2)) + C(14) + C(23) - C(13) - C(21);		SetWord32At(R, 2, word32(t)); t >>= 32;
+	t += sword64(C(3)) + C(12) + C(15) + C(20) + C(21) - C(14) - C(22) - C(23);		SetWord32At(R, 3, word32(t)); t >>= 32;
+	t += sword64(C(4)) + C(12) + C(13) + C(16) + C(20) + 2*sword64(C(21)) + C(22) - C(15) - 2*sword64(C(23));		SetWord32At(R, 4, word32(t)); t >>= 32;
+	t += sword64(C(5)) + C(13) + C(14) + C(17) + C(21) + 2*sword64(C(22)) + C(23) - C(16);		SetWord32At(R, 5, word32(t)); t >>= 32;
+	t += sword64(C(6)) + C(14) + C(15) + C(18) + C(22) + 2*sword64(C(23)) - C(17);		SetWord32At(R, 6, word32(t)); t >>= 32;
+	t += sword64(C(7)) + C(15) + C(16) + C(19) + C(23) - C(18);		SetWord32At(R, 7, word32(t)); t >>= 32;
+	t += sword64(C(8)) + C(16) + C(17) + C(20) - C(19);		SetWord32At(R, 8, word32(t)); t >>= 32;
+	t += sword64(C(9)) + C(17) + C(18) + C(21) - C(20);		SetWord32At(R, 9, word32(t)); t >>= 32;
+	t += sword64(C(10)) + C(18) + C(19) + C(22) - C(21);		SetWord32At(R, 10, word32(t)); t >>= 32;
+	t += sword64(C(11)) + C(19) + C(20) + C(23) - C(22);		SetWord32At(R, 11, word32(t)); t >>= 32;
+	return t;
+}
+
+#undef C
+
+// the largest modulus size SolinasArithmetic handles, in words: P-384 rounded up to a power of 2
+static const size_t s_solinasMaxWords = 512/WORD_BITS;
+
+// R[N] = T[2*N] mod M[N], where M is P-384 and T < M^2
+// table holds K = k*2^(BITS-1) mod M and K - M + 2^BITS for each k = 2*t + h, where t is the carry out of SolinasSum()
+// and h is the top bit of its sum, see SolinasArithmetic::SolinasArithmetic()
+template <unsigned int BITS>
+static void SolinasReduce(word *R, const word *T, const word *table, size_t N)
+{
+	const unsigned int nw = BITS/WORD_BITS;
+	word r[nw], X[2*nw];
+
+	sword64 t = SolinasSum<BITS>(r, T);
+	assert(t >= s_solinasMinCarry && t <= s_solinasMaxCarry);
+
+	// with its top bit moved into the table index, r + K < 2^(BITS-1) + M < 2*M
+	const word h = r[nw-1] >> (WORD_BITS-1);
+	r[nw-1] &= word(~word(0) >> 1);
+	const word *K = table + 2*nw*(2*size_t(t-s_solinasMinCarry) + h);
+
+	// so r + K - M is either negative or the result, and the second sum carries if it's the result
+	Declare2Words(u);
+	Declare2Words(v);
+	AssignWord(u, 0);
+	AssignWord(v, 0);
+	for (unsigned int i=0; i<nw; i++)
+	{
+		AddWithCarry(u, r[i], K[i]);
+		X[i] = LowWord(u);
+		AddWithCarry(v, r[i], K[nw+i]);
+		X[nw+i] = LowWord(v);
+	}
+	// defend against timing attack by computing both sums even when one isn't needed
+	CopyWords(R, X + (nw & (0-GetCarry(v))), nw);
+	SetWords(R+nw, 0, N-nw);
+}
+
+SolinasArithmetic::SolinasArithmetic(const Integer &m)	// modulus must be P-384
+	: ModularArithmetic(m),
+	  m_modulusBits(m.BitCount())
+{
+	if (!IsSupportedModulus(m))
+		throw InvalidArgument("SolinasArithmetic: modulus must be P-384");
+
+	m_inverseR = (Integer::Power2(WORD_BITS*m_modulus.reg.size()) % m).InverseMod(m);
+
+	const size_t nw = m_modulusBits/WORD_BITS;
+	m_table.New(4*nw*(s_solinasMaxCarry-s_solinasMinCarry+1));
+	for (int k=2*s_solinasMinCarry; k<=2*s_solinasMaxCarry+1; k++)
+	{
+		const Integer K = (Integer((signed long)k) << (m_modulusBits-1)) % m;
+		const Integer L = K - m + Integer::Power2(m_modulusBits);
+		word *entry = m_table + 2*nw*size_t(k-2*s_solinasMinCarry);
+		for (size_t i=0; i<nw; i++)
+		{
+			entry[i] = i < K.reg.size() ? K.reg[i] : 0;
+			entry[nw+i] = i < L.reg.size() ? L.reg[i] : 0;
+		}
+	}
+}
+
+bool SolinasArithmetic::IsSupportedModulus(const Integer &m)
+{
+	// P-256 is left to MontgomeryRepresentation, whose multiplication measured faster than this reduction
+	return m.BitCount() == 384 && m == Integer("0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffeffffffff0000000000000000ffffffff");
+}
+
+// copy X[NX] into A[N] if it's shorter than that, and return a pointer to its N words
+static inline const word * SolinasOperand(word *A, const word *X, size_t NX, size_t N)
+{
+	assert(NX <= N);
+	if (NX == N)
+		return X;
+	CopyWords(A, X, NX);
+	SetWords(A+NX, 0, N-NX);
+	return A;
+}
+
+const Integer& SolinasArithmetic::Multiply(const Integer &a, const Integer &b) const
+{
+	word A[s_solinasMaxWords], B[s_solinasMaxWords], T[4*s_solinasMaxWords];
+	const size_t N = m_modulus.reg.size();
+	assert(N <= s_solinasMaxWords);
+
+	CryptoPP::Multiply(T, T+2*N, SolinasOperand(A, a.reg, a.reg.size(), N), SolinasOperand(B, b.reg, b.reg.size(), N), N);
+	SolinasReduce<384>(m_result.reg.begin(), T, m_table, N);
+	return m_result;
+}
+
+const Integer& SolinasArithmetic::Square(const Integer &a) const
+{
+	word A[s_solinasMaxWords], T[4*s_solinasMaxWords];
+	const size_t N = m_modulus.reg.size();
+	assert(N <= s_solinasMaxWords);
+
+	CryptoPP::Square(T, T+2*N, SolinasOperand(A, a.reg, a.reg.size(), N), N);
+	SolinasReduce<384>(m_result.reg.begin(), T, m_table, N);
+	return m_result;
+}
+
+const Integer& SolinasArithmetic::MultiplicativeInverse(const Integer &a) const
+{
+	word T[4*s_solinasMaxWords];
+	word *const R = m_result.reg.begin();
+	const size_t N = m_modulus.reg.size();
+	assert(a.reg.size()<=N && N <= s_solinasMaxWords);
+
+	unsigned k = AlmostInverse(R, T, a.reg, a.reg.size(), m_modulus.reg, N);
+
+	// shifting the rest of 2^k out one bit at a time is slow, so bring it to 2^(N*WORD_BITS) instead and multiply by its inverse
+	if (k>N*WORD_BITS)
+		DivideByPower2Mod(R, R, k-N*WORD_BITS, m_modulus.reg, N);
+	else
+		MultiplyByPower2Mod(R, R, N*WORD_BITS-k, m_modulus.reg, N);
+
+	return Multiply(m_result, m_inverseR);
+}
+
 NAMESPACE_END
 
 #endif
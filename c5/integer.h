@@ -8,6 +8,9 @@
 
 #include <iosfwd>
 #include <algorithm>
+#ifdef CRYPTOPP_CXX11_RVALUES
+#include <utility>
+#endif
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -16,7 +19,57 @@ struct InitializeInteger	// used to initialize static variables
 	InitializeInteger();
 };
 
-typedef SecBlock<word, AllocatorWithCleanup<word, CRYPTOPP_BOOL_X86> > IntegerSecBlock;
+#ifdef CRYPTOPP_INTEGER_ARENA
+
+//! keeps the storage that Integers on the calling thread free, and hands it out again to new Integers of the same size
+/*! An arena takes effect on the thread that constructs it and stays in effect there until it's destroyed.
+	Arenas nest, and the newest one on a thread is the one used. This lets a thread doing many public key
+	operations, including the temporaries inside ModularArithmetic and MontgomeryRepresentation, stop going
+	to the heap once the arena holds a block of each size it needs. Integers may outlive the arena they were
+	created under. Arenas must be destroyed on the thread that created them, in the reverse order of creation.
+	\note this class is only available if CRYPTOPP_INTEGER_ARENA is defined in config.h */
+class CRYPTOPP_DLL IntegerArena : public NotCopyable
+{
+public:
+	IntegerArena();
+	~IntegerArena();
+
+	//! allocate n words, from the calling thread's arena if it holds a block of that size
+	static word * CRYPTOPP_API Allocate(size_t n);
+	//! wipe and free n words allocated by Allocate(), keeping them in the calling thread's arena if it has room
+	static void CRYPTOPP_API Deallocate(word *p, size_t n);
+
+private:
+	// blocks of 2**i words for each i < SIZE_CLASSES are kept
+	enum {SIZE_CLASSES = 13, BLOCKS_PER_CLASS = 32};
+
+	IntegerArena *m_previous;
+	unsigned int m_blockCount[SIZE_CLASSES];
+	word *m_blocks[SIZE_CLASSES][BLOCKS_PER_CLASS];
+};
+
+//! allocator for Integer storage, which goes through IntegerArena
+class IntegerAllocator : public AllocatorBase<word>
+{
+public:
+	pointer allocate(size_type n, const void * = NULL)
+		{CheckSize(n); return IntegerArena::Allocate(n);}
+	void deallocate(void *p, size_type n)
+		{IntegerArena::Deallocate((word *)p, n);}
+	pointer reallocate(word *p, size_type oldSize, size_type newSize, bool preserve)
+		{return StandardReallocate(*this, p, oldSize, newSize, preserve);}
+};
+
+#else
+
+typedef AllocatorWithCleanup<word, CRYPTOPP_BOOL_X86> IntegerAllocator;
+
+#endif
+
+typedef SecBlock<word, IntegerAllocator> IntegerSecBlock;
+
+//! storage for the words of an Integer, which keeps values of up to 512 bits inside the Integer itself
+typedef SecBlock<word, FixedSizeAllocatorWithCleanup<word, 512/WORD_BITS, IntegerAllocator, CRYPTOPP_BOOL_X86> > IntegerRegister;
 
 //! multiple precision integer and basic arithmetics
 /*! This class can represent positive and negative integers
@@ -68,6 +121,12 @@ public:
 		//! copy constructor
 		Integer(const Integer& t);
 
+#ifdef CRYPTOPP_CXX11_RVALUES
+		//! move constructor, which takes the storage of t and leaves it zero
+		Integer(Integer&& t)
+			: reg(2), sign(POSITIVE) {reg[0] = reg[1] = 0; swap(t);}
+#endif
+
 		//! convert from signed long
 		Integer(signed long value);
 
@@ -215,6 +274,10 @@ public:
 	//@{
 		//!
 		Integer&  operator=(const Integer& t);
+#ifdef CRYPTOPP_CXX11_RVALUES
+		//! move assignment, which exchanges storage with t
+		Integer&  operator=(Integer&& t) {swap(t); return *this;}
+#endif
 
 		//!
 		Integer&  operator+=(const Integer& t);
@@ -346,6 +409,11 @@ public:
 		//! returns same result as Divide(r, q, a, Power2(n)), but faster
 		static void CRYPTOPP_API DivideByPowerOf2(Integer &r, Integer &q, const Integer &a, unsigned int n);
 
+		//! r = a*b+c, reusing the storage of r
+		static void CRYPTOPP_API MultiplyAdd(Integer &r, const Integer &a, const Integer &b, const Integer &c);
+		//! r = a*b%m, reusing the storage of r
+		static void CRYPTOPP_API ModMul(Integer &r, const Integer &a, const Integer &b, const Integer &m);
+
 		//! greatest common divisor
 		static Integer CRYPTOPP_API Gcd(const Integer &a, const Integer &n);
 		//! calculate multiplicative inverse of *this mod n
@@ -365,6 +433,7 @@ public:
 private:
 	friend class ModularArithmetic;
 	friend class MontgomeryRepresentation;
+	friend class SolinasArithmetic;
 	friend class HalfMontgomeryRepresentation;
 
 	Integer(word value, size_t length);
@@ -375,7 +444,7 @@ private:
 	friend void PositiveMultiply(Integer &product, const Integer &a, const Integer &b);
 	friend void PositiveDivide(Integer &remainder, Integer &quotient, const Integer &dividend, const Integer &divisor);
 
-	IntegerSecBlock reg;
+	IntegerRegister reg;
 	Sign sign;
 };
 
@@ -406,6 +475,22 @@ inline CryptoPP::Integer operator/(const CryptoPP::Integer &a, CryptoPP::word b)
 //!
 inline CryptoPP::word    operator%(const CryptoPP::Integer &a, CryptoPP::word b) {return a.Modulo(b);}
 
+#ifdef CRYPTOPP_CXX11_RVALUES
+// these add into the storage of a temporary operand instead of allocating the result
+//!
+inline CryptoPP::Integer operator+(CryptoPP::Integer &&a, const CryptoPP::Integer &b) {return std::move(a += b);}
+//!
+inline CryptoPP::Integer operator+(const CryptoPP::Integer &a, CryptoPP::Integer &&b) {return std::move(b += a);}
+//!
+inline CryptoPP::Integer operator+(CryptoPP::Integer &&a, CryptoPP::Integer &&b) {return std::move(a += b);}
+//!
+inline CryptoPP::Integer operator-(CryptoPP::Integer &&a, const CryptoPP::Integer &b) {return std::move(a -= b);}
+//!
+inline CryptoPP::Integer operator-(const CryptoPP::Integer &a, CryptoPP::Integer &&b) {b -= a; b.Negate(); return std::move(b);}
+//!
+inline CryptoPP::Integer operator-(CryptoPP::Integer &&a, CryptoPP::Integer &&b) {return std::move(a -= b);}
+#endif
+
 NAMESPACE_END
 
 #ifndef __BORLANDC__
@@ -74,10 +74,10 @@ public:
 		{return Integer::One();}
 
 	const Integer& Multiply(const Integer &a, const Integer &b) const
-		{return m_result1 = a*b%m_modulus;}
+		{Integer::ModMul(m_result1, a, b, m_modulus); return m_result1;}
 
 	const Integer& Square(const Integer &a) const
-		{return m_result1 = a.Squared()%m_modulus;}
+		{Integer::ModMul(m_result1, a, a, m_modulus); return m_result1;}
 
 	bool IsUnit(const Integer &a) const
 		{return Integer::Gcd(a, m_modulus).IsUnit();}
@@ -88,10 +88,18 @@ public:
 	const Integer& Divide(const Integer &a, const Integer &b) const
 		{return Multiply(a, MultiplicativeInverse(b));}
 
+	Integer Exponentiate(const Integer &a, const Integer &e) const;
+
+	//! like Exponentiate(), for exponents that needn't be kept secret, such as RSA public exponents
+	/*! this may branch on the bits of e, which makes it quicker for short exponents */
+	virtual Integer ExponentiatePublic(const Integer &a, const Integer &e) const;
+
 	Integer CascadeExponentiate(const Integer &x, const Integer &e1, const Integer &y, const Integer &e2) const;
 
 	void SimultaneousExponentiate(Element *results, const Element &base, const Integer *exponents, unsigned int exponentsCount) const;
 
+	Integer MultiExponentiate(const Integer *bases, const Integer *exponents, unsigned int count) const;
+
 	unsigned int MaxElementBitLength() const
 		{return (m_modulus-1).BitCount();}
 
@@ -142,17 +150,57 @@ public:
 
 	const Integer& MultiplicativeInverse(const Integer &a) const;
 
+	//! uses fixed windows, and table lookups that don't depend on e, for exponents that must be kept secret
+	/*! the sequence of operations depends only on the size of the modulus and on e.BitCount() rounded up to a multiple of 32 */
+	Integer Exponentiate(const Integer &a, const Integer &e) const;
+
+	Integer ExponentiatePublic(const Integer &a, const Integer &e) const;
+
+	//! returns 2**e in Montgomery representation, using doublings in place of the multiplications by 2
+	/*! this is faster than Exponentiate(ConvertIn(2), e), and like it doesn't branch on the bits of e */
+	Integer Power2(const Integer &e) const;
+
 	Integer CascadeExponentiate(const Integer &x, const Integer &e1, const Integer &y, const Integer &e2) const
 		{return AbstractRing<Integer>::CascadeExponentiate(x, e1, y, e2);}
 
 	void SimultaneousExponentiate(Element *results, const Element &base, const Integer *exponents, unsigned int exponentsCount) const
 		{AbstractRing<Integer>::SimultaneousExponentiate(results, base, exponents, exponentsCount);}
 
+	Integer MultiExponentiate(const Integer *bases, const Integer *exponents, unsigned int count) const
+		{return AbstractRing<Integer>::MultiExponentiate(bases, exponents, count);}
+
 private:
 	Integer m_u;
 	mutable IntegerSecBlock m_workspace;
 };
 
+//! do modular arithmetics modulo the NIST prime P-384, using Solinas' fast reduction
+/*! \note elements are represented the same way as in ModularArithmetic, so ConvertIn() and ConvertOut() need not be called
+	\note P-256 isn't supported, since the four-word MontgomeryReduce() multiplies faster than a Solinas reduction
+		of the same size. ECP picks this class by comparing the modulus with P-384, not by curve OID, and its point
+		arithmetic keeps using Integer temporaries, which stay off the heap only because 384-bit values fit in an IntegerRegister. */
+class CRYPTOPP_DLL SolinasArithmetic : public ModularArithmetic
+{
+public:
+	SolinasArithmetic(const Integer &modulus);	// modulus must be P-384
+
+	virtual ModularArithmetic * Clone() const {return new SolinasArithmetic(*this);}
+
+	//! returns whether modulus is one of the primes this class supports
+	static bool IsSupportedModulus(const Integer &modulus);
+
+	const Integer& Multiply(const Integer &a, const Integer &b) const;
+
+	const Integer& Square(const Integer &a) const;
+
+	const Integer& MultiplicativeInverse(const Integer &a) const;
+
+private:
+	unsigned int m_modulusBits;
+	Integer m_inverseR;
+	IntegerSecBlock m_table;
+};
+
 NAMESPACE_END
 
 #endif
@@ -0,0 +1,336 @@
+// multiblock.h - placed in the public domain
+
+// private header for block ciphers and hashes that process several blocks in parallel
+
+#ifndef CRYPTOPP_MULTIBLOCK_H
+#define CRYPTOPP_MULTIBLOCK_H
+
+#include "cryptlib.h"
+#include "secblock.h"
+#include "misc.h"
+#include "cpu.h"
+#include "iterhash.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+//! same as BlockTransformation::AdvancedProcessBlocks(), but when BT_AllowParallel is set, groups of LANES blocks are gathered and passed to (cipher.*func)(in, out), which may process them in place
+template <unsigned int LANES, unsigned int BLOCKSIZE, class T>
+size_t AdvancedProcessBlocksInParallel(const T &cipher, void (T::*func)(const byte *inBlocks, byte *outBlocks) const, const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags)
+{
+	size_t inIncrement = (flags & (BlockTransformation::BT_InBlockIsCounter|BlockTransformation::BT_DontIncrementInOutPointers)) ? 0 : BLOCKSIZE;
+	size_t xorIncrement = xorBlocks ? BLOCKSIZE : 0;
+	size_t outIncrement = (flags & BlockTransformation::BT_DontIncrementInOutPointers) ? 0 : BLOCKSIZE;
+
+	if (flags & BlockTransformation::BT_ReverseDirection)
+	{
+		assert(length % BLOCKSIZE == 0);
+		inBlocks += length - BLOCKSIZE;
+		xorBlocks += length - BLOCKSIZE;
+		outBlocks += length - BLOCKSIZE;
+		inIncrement = 0-inIncrement;
+		xorIncrement = 0-xorIncrement;
+		outIncrement = 0-outIncrement;
+	}
+
+	if (flags & BlockTransformation::BT_AllowParallel)
+	{
+		FixedSizeAlignedSecBlock<byte, LANES*BLOCKSIZE> buffer;
+		unsigned int i;
+
+		while (length >= LANES*BLOCKSIZE)
+		{
+			for (i=0; i<LANES; i++)
+			{
+				if (flags & BlockTransformation::BT_XorInput)
+				{
+					xorbuf(buffer+i*BLOCKSIZE, inBlocks, xorBlocks, BLOCKSIZE);
+					xorBlocks += xorIncrement;
+				}
+				else
+					memcpy(buffer+i*BLOCKSIZE, inBlocks, BLOCKSIZE);
+				if (flags & BlockTransformation::BT_InBlockIsCounter)
+					const_cast<byte *>(inBlocks)[BLOCKSIZE-1]++;
+				inBlocks += inIncrement;
+			}
+
+			(cipher.*func)(buffer, buffer);
+
+			// in reverse direction, an output block may overwrite the xor block of the one
+			// processed before it, which is why each block is xored and stored in turn
+			for (i=0; i<LANES; i++)
+			{
+				if (xorBlocks && !(flags & BlockTransformation::BT_XorInput))
+				{
+					xorbuf(outBlocks, buffer+i*BLOCKSIZE, xorBlocks, BLOCKSIZE);
+					xorBlocks += xorIncrement;
+				}
+				else
+					memcpy(outBlocks, buffer+i*BLOCKSIZE, BLOCKSIZE);
+				outBlocks += outIncrement;
+			}
+
+			length -= LANES*BLOCKSIZE;
+		}
+	}
+
+	while (length >= BLOCKSIZE)
+	{
+		if (flags & BlockTransformation::BT_XorInput)
+		{
+			xorbuf(outBlocks, xorBlocks, inBlocks, BLOCKSIZE);
+			cipher.ProcessBlock(outBlocks);
+		}
+		else
+			cipher.ProcessAndXorBlock(inBlocks, xorBlocks, outBlocks);
+		if (flags & BlockTransformation::BT_InBlockIsCounter)
+			const_cast<byte *>(inBlocks)[BLOCKSIZE-1]++;
+		inBlocks += inIncrement;
+		outBlocks += outIncrement;
+		xorBlocks += xorIncrement;
+		length -= BLOCKSIZE;
+	}
+
+	return length;
+}
+
+//! an IteratedHash whose compression function keeps the blocks it's given instead of hashing them, so that
+//! a multi-buffer hash can take the final blocks of a message from IteratedHashBase's own padding
+template <class T, class B, unsigned int BLOCKSIZE>
+class IteratedHashPadding : public IteratedHash<T, B, BLOCKSIZE>
+{
+public:
+	IteratedHashPadding() : m_pad(NULL), m_padBlocks(0) {}
+	unsigned int DigestSize() const {return 0;}
+
+	//! write the padded last block(s) of the message to pad and return their number, the full blocks before them are skipped
+	unsigned int PadLastBlocks(byte *pad, const byte *message, size_t length)
+	{
+		this->Restart();
+		m_pad = NULL;
+		this->Update(message, length);
+		m_pad = pad;
+		m_padBlocks = 0;
+		this->TruncatedFinal(NULL, 0);
+		m_pad = NULL;
+		return m_padBlocks;
+	}
+
+protected:
+	void Init() {}
+	void HashEndianCorrectedBlock(const T *data) {}
+	size_t HashMultipleBlocks(const T *input, size_t length)
+	{
+		// only TruncatedFinal() passes blocks on while m_pad is set, one at a time
+		if (m_pad)
+			memcpy(m_pad + BLOCKSIZE*m_padBlocks++, input, BLOCKSIZE);
+		return length % BLOCKSIZE;
+	}
+	T* StateBuf() {return NULL;}
+
+private:
+	byte *m_pad;
+	unsigned int m_padBlocks;
+};
+
+//! one message being hashed in a lane of a multi-buffer hash, its full blocks are read in place and its padded last block(s) are built up front
+template <class H>
+class MultiBufferLane
+{
+public:
+	void Start(H &hash, const byte *message, size_t length, size_t index)
+	{
+		m_message = message;
+		m_index = index;
+		m_blockSize = hash.BlockSize();
+		m_fullBlocks = length / m_blockSize;
+		m_next = 0;
+		m_totalBlocks = m_fullBlocks + hash.PadLastBlocks(m_pad, message, length);
+	}
+
+	const byte * NextBlock()
+	{
+		const byte *block = m_next < m_fullBlocks ? m_message + m_next*m_blockSize : m_pad + (m_next-m_fullBlocks)*m_blockSize;
+		m_next++;
+		return block;
+	}
+
+	bool Done() const {return m_next == m_totalBlocks;}
+	size_t Index() const {return m_index;}
+
+private:
+	const byte *m_message;
+	size_t m_index, m_fullBlocks, m_totalBlocks, m_next;
+	unsigned int m_blockSize;
+	byte m_pad[H::MAX_PADDING];
+};
+
+//! hash count messages in the H::LANES lanes of hash, refilling a lane with the next message when it finishes
+/*! H provides BlockSize(), DigestSize(), PadLastBlocks(pad, message, length) returning the number of padded
+	blocks, InitLane(j), TransformLanes(blocks) for one block in each lane, TransformLane(j, block) for
+	lane j alone, and GetDigest(j, digest). */
+template <class H>
+void MultiBufferCalculateDigests(H &hash, byte *digests, const byte * const *messages, const size_t *lengths, size_t count)
+{
+	MultiBufferLane<H> lanes[H::LANES];
+	bool active[H::LANES];
+	unsigned int j, activeCount = 0;
+	size_t nextMessage = 0;
+
+	for (j=0; j<H::LANES; j++)
+	{
+		active[j] = nextMessage < count;
+		if (!active[j])
+			continue;
+		lanes[j].Start(hash, messages[nextMessage], lengths[nextMessage], nextMessage);
+		hash.InitLane(j);
+		nextMessage++;
+		activeCount++;
+	}
+
+	while (activeCount > 1)
+	{
+		const byte *blocks[H::LANES];
+		const byte *anyBlock = NULL;
+		for (j=0; j<H::LANES; j++)
+			blocks[j] = active[j] ? (anyBlock = lanes[j].NextBlock()) : NULL;
+		// idle lanes hash a copy of some other lane's block, and their result is ignored
+		for (j=0; j<H::LANES; j++)
+			if (!blocks[j])
+				blocks[j] = anyBlock;
+		hash.TransformLanes(blocks);
+
+		for (j=0; j<H::LANES; j++)
+		{
+			if (!active[j] || !lanes[j].Done())
+				continue;
+			hash.GetDigest(j, digests + lanes[j].Index()*hash.DigestSize());
+			if (nextMessage < count)
+			{
+				lanes[j].Start(hash, messages[nextMessage], lengths[nextMessage], nextMessage);
+				hash.InitLane(j);
+				nextMessage++;
+			}
+			else
+			{
+				active[j] = false;
+				activeCount--;
+			}
+		}
+	}
+
+	// a single remaining message is faster to finish in general registers
+	for (j=0; j<H::LANES; j++)
+	{
+		if (!active[j])
+			continue;
+		while (!lanes[j].Done())
+			hash.TransformLane(j, lanes[j].NextBlock());
+		hash.GetDigest(j, digests + lanes[j].Index()*hash.DigestSize());
+	}
+}
+
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+
+//! four 32-bit words in an SSE2 register, with the operators needed to run word32 round macros on 4 lanes at once
+class word32x4
+{
+public:
+	word32x4() {}
+	word32x4(__m128i v) : m_v(v) {}
+	word32x4(word32 x) : m_v(_mm_set1_epi32(x)) {}
+
+	//! lane j gets word i of the j-th block of 4 consecutive blocks
+	template <class B>
+	static word32x4 LoadLanes(const byte *blocks, unsigned int blockSize, unsigned int i)
+	{
+		return _mm_set_epi32(
+			GetWord<word32>(false, B::ToEnum(), blocks+3*blockSize+4*i),
+			GetWord<word32>(false, B::ToEnum(), blocks+2*blockSize+4*i),
+			GetWord<word32>(false, B::ToEnum(), blocks+1*blockSize+4*i),
+			GetWord<word32>(false, B::ToEnum(), blocks+4*i));
+	}
+
+	//! inverse of LoadLanes()
+	template <class B>
+	void StoreLanes(byte *blocks, unsigned int blockSize, unsigned int i) const
+	{
+		CRYPTOPP_ALIGN_DATA(16) word32 w[4];
+		_mm_store_si128((__m128i *)w, m_v);
+		PutWord(false, B::ToEnum(), blocks+4*i, w[0]);
+		PutWord(false, B::ToEnum(), blocks+1*blockSize+4*i, w[1]);
+		PutWord(false, B::ToEnum(), blocks+2*blockSize+4*i, w[2]);
+		PutWord(false, B::ToEnum(), blocks+3*blockSize+4*i, w[3]);
+	}
+
+	word32x4 operator~() const {return _mm_xor_si128(m_v, _mm_set1_epi32(-1));}
+	word32x4 operator^(const word32x4 &b) const {return _mm_xor_si128(m_v, b.m_v);}
+	word32x4 operator&(const word32x4 &b) const {return _mm_and_si128(m_v, b.m_v);}
+	word32x4 operator|(const word32x4 &b) const {return _mm_or_si128(m_v, b.m_v);}
+	word32x4 operator+(const word32x4 &b) const {return _mm_add_epi32(m_v, b.m_v);}
+	word32x4 operator-(const word32x4 &b) const {return _mm_sub_epi32(m_v, b.m_v);}
+	word32x4 operator<<(unsigned int y) const {return _mm_slli_epi32(m_v, y);}
+	word32x4 operator>>(unsigned int y) const {return _mm_srli_epi32(m_v, y);}
+
+	word32x4 & operator^=(const word32x4 &b) {m_v = _mm_xor_si128(m_v, b.m_v); return *this;}
+	word32x4 & operator&=(const word32x4 &b) {m_v = _mm_and_si128(m_v, b.m_v); return *this;}
+	word32x4 & operator|=(const word32x4 &b) {m_v = _mm_or_si128(m_v, b.m_v); return *this;}
+	word32x4 & operator+=(const word32x4 &b) {m_v = _mm_add_epi32(m_v, b.m_v); return *this;}
+	word32x4 & operator-=(const word32x4 &b) {m_v = _mm_sub_epi32(m_v, b.m_v); return *this;}
+
+	__m128i m_v;
+};
+
+inline word32x4 rotlFixed(const word32x4 &x, unsigned int y)
+{
+	return (x << y) | (x >> (32-y));
+}
+
+inline word32x4 rotrFixed(const word32x4 &x, unsigned int y)
+{
+	return (x >> y) | (x << (32-y));
+}
+
+//! two 64-bit words in an SSE2 register, with the operators needed to run word64 round code on 2 lanes at once
+class word64x2
+{
+public:
+	word64x2() {}
+	word64x2(__m128i v) : m_v(v) {}
+	word64x2(word64 x) : m_v(_mm_set_epi32(int(x>>32), int(x), int(x>>32), int(x))) {}
+
+	//! ~x is only computed when it's used, so that (~x)&y can be done with one pandn
+	class Not
+	{
+	public:
+		Not(__m128i v) : m_v(v) {}
+		operator word64x2() const {return _mm_xor_si128(m_v, _mm_set1_epi32(-1));}
+		word64x2 operator&(const word64x2 &b) const {return _mm_andnot_si128(m_v, b.m_v);}
+
+	private:
+		__m128i m_v;
+	};
+
+	Not operator~() const {return Not(m_v);}
+	word64x2 operator^(const word64x2 &b) const {return _mm_xor_si128(m_v, b.m_v);}
+	word64x2 operator&(const word64x2 &b) const {return _mm_and_si128(m_v, b.m_v);}
+	word64x2 operator|(const word64x2 &b) const {return _mm_or_si128(m_v, b.m_v);}
+	word64x2 operator<<(unsigned int y) const {return _mm_slli_epi64(m_v, y);}
+	word64x2 operator>>(unsigned int y) const {return _mm_srli_epi64(m_v, y);}
+
+	word64x2 & operator^=(const word64x2 &b) {m_v = _mm_xor_si128(m_v, b.m_v); return *this;}
+	word64x2 & operator&=(const word64x2 &b) {m_v = _mm_and_si128(m_v, b.m_v); return *this;}
+	word64x2 & operator|=(const word64x2 &b) {m_v = _mm_or_si128(m_v, b.m_v); return *this;}
+
+	__m128i m_v;
+};
+
+inline word64x2 rotlFixed(const word64x2 &x, unsigned int y)
+{
+	return (x << y) | (x >> (64-y));
+}
+
+#endif
+
+NAMESPACE_END
+
+#endif
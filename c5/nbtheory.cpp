@@ -7,15 +7,11 @@
 #include "nbtheory.h"
 #include "modarith.h"
 #include "algparam.h"
+#include "taskexec.h"
 
 #include <math.h>
 #include <vector>
 
-#ifdef _OPENMP
-// needed in MSVC 2005 to generate correct manifest
-#include <omp.h>
-#endif
-
 NAMESPACE_BEGIN(CryptoPP)
 
 const word s_lastSmallPrime = 32719;
@@ -121,7 +117,15 @@ bool IsStrongProbablePrime(const Integer &n, const Integer &b)
 			break;
 	Integer m = nminus1>>a;
 
-	Integer z = a_exp_b_mod_c(b, m, n);
+	// base 2, which prime generation uses to weed out candidates, needs only doublings
+	Integer z;
+	if (b == 2)
+	{
+		MontgomeryRepresentation mr(n);
+		z = mr.ConvertOut(mr.Power2(m));
+	}
+	else
+		z = a_exp_b_mod_c(b, m, n);
 	if (z==1 || z==nminus1)
 		return true;
 	for (unsigned j=1; j<a; j++)
@@ -135,6 +139,21 @@ bool IsStrongProbablePrime(const Integer &n, const Integer &b)
 	return false;
 }
 
+struct StrongProbablePrimeTests
+{
+	StrongProbablePrimeTests(const Integer &n, unsigned int rounds) : n(n), bases(rounds), pass(rounds) {}
+
+	static void Task(void *context, size_t i)
+	{
+		StrongProbablePrimeTests &t = *(StrongProbablePrimeTests *)context;
+		t.pass[i] = IsStrongProbablePrime(t.n, t.bases[i]);
+	}
+
+	const Integer &n;
+	std::vector<Integer> bases;
+	std::vector<char> pass;
+};
+
 bool RabinMillerTest(RandomNumberGenerator &rng, const Integer &n, unsigned int rounds)
 {
 	if (n <= 3)
@@ -142,13 +161,27 @@ bool RabinMillerTest(RandomNumberGenerator &rng, const Integer &n, unsigned int
 
 	assert(n>3);
 
-	Integer b;
-	for (unsigned int i=0; i<rounds; i++)
+	// one thread stops at the first failing round, otherwise the bases are drawn up front and the rounds run in parallel
+	if (GetDefaultTaskExecutor().GetConcurrency() == 1)
 	{
-		b.Randomize(rng, 2, n-2);
-		if (!IsStrongProbablePrime(n, b))
-			return false;
+		Integer b;
+		for (unsigned int i=0; i<rounds; i++)
+		{
+			b.Randomize(rng, 2, n-2);
+			if (!IsStrongProbablePrime(n, b))
+				return false;
+		}
+		return true;
 	}
+
+	StrongProbablePrimeTests tests(n, rounds);
+	for (unsigned int i=0; i<rounds; i++)
+		tests.bases[i].Randomize(rng, 2, n-2);
+	GetDefaultTaskExecutor().Run(&StrongProbablePrimeTests::Task, &tests, rounds);
+
+	for (unsigned int i=0; i<rounds; i++)
+		if (!tests.pass[i])
+			return false;
 	return true;
 }
 
@@ -234,6 +267,33 @@ struct NewLastSmallPrimeSquared
 	}
 };
 
+struct PrimeTests
+{
+	PrimeTests(const Integer &p) : p(p) {}
+
+	static void Task(void *context, size_t i)
+	{
+		PrimeTests &t = *(PrimeTests *)context;
+		t.pass[i] = i==0 ? IsStrongProbablePrime(t.p, 3) : IsStrongLucasProbablePrime(t.p);
+	}
+
+	const Integer &p;
+	bool pass[2];
+};
+
+// the tests IsPrime() runs on numbers bigger than s_lastSmallPrime squared that have no small divisors
+static bool ProbablePrimeTests(const Integer &p)
+{
+	// most candidates that get here during prime generation are composite and fail the first test,
+	// so the Lucas test only runs alongside it when there is a spare thread to run it on
+	if (p.BitCount() < 256 || GetDefaultTaskExecutor().GetConcurrency() == 1)
+		return IsStrongProbablePrime(p, 3) && IsStrongLucasProbablePrime(p);
+
+	PrimeTests tests(p);
+	GetDefaultTaskExecutor().Run(&PrimeTests::Task, &tests, 2);
+	return tests.pass[0] && tests.pass[1];
+}
+
 bool IsPrime(const Integer &p)
 {
 	if (p <= s_lastSmallPrime)
@@ -241,7 +301,16 @@ bool IsPrime(const Integer &p)
 	else if (p <= Singleton<Integer, NewLastSmallPrimeSquared>().Ref())
 		return SmallDivisorsTest(p);
 	else
-		return SmallDivisorsTest(p) && IsStrongProbablePrime(p, 3) && IsStrongLucasProbablePrime(p);
+		return SmallDivisorsTest(p) && ProbablePrimeTests(p);
+}
+
+// IsPrime() for candidates from a PrimeSieve, which has already divided them by all of the small primes
+static bool IsSievedPrime(const Integer &p)
+{
+	if (p <= Singleton<Integer, NewLastSmallPrimeSquared>().Ref())
+		return IsPrime(p);
+	else
+		return ProbablePrimeTests(p);
 }
 
 bool VerifyPrime(RandomNumberGenerator &rng, const Integer &p, unsigned int level)
@@ -283,6 +352,64 @@ AlgorithmParameters MakeParametersForTwoPrimesOfEqualSize(unsigned int productBi
 	return MakeParameters("RandomNumberType", Integer::PRIME)("Min", minP)("Max", maxP);
 }
 
+// primes up to this bound are available to sieve with, see SievingPrimeBound()
+const word32 s_lastSievingPrime = 4194301;
+
+struct NewSievingPrimeTable
+{
+	std::vector<word32> * operator()() const
+	{
+		// sieve of Eratosthenes over the odd numbers, where entry i stands for 2*i+1
+		std::vector<bool> composite(s_lastSievingPrime/2+1, false);
+
+		std::auto_ptr<std::vector<word32> > pPrimeTable(new std::vector<word32>);
+		std::vector<word32> &primeTable = *pPrimeTable;
+		primeTable.reserve(300000);
+		primeTable.push_back(2);
+
+		for (word32 i=1; i<composite.size(); i++)
+		{
+			if (composite[i])
+				continue;
+			word32 p = 2*i+1;
+			primeTable.push_back(p);
+			if (p <= s_lastSievingPrime/p)
+				for (word32 j=p*p/2; j<composite.size(); j+=p)
+					composite[j] = true;
+		}
+
+		return pPrimeTable.release();
+	}
+};
+
+// candidates are sieved with more primes the bigger they are, since the tests of the candidates
+// that get through cost more, while the remainders the sieve starts from only grow linearly
+static word32 SievingPrimeBound(const Integer &first)
+{
+	const word32 bits = first.BitCount();
+	const word32 bound = bits > 4096 ? s_lastSievingPrime : STDMAX(word32(s_lastSmallPrime), bits*bits/4);
+
+	// none of the primes may equal a candidate, or half of one in a double sieve
+	return first.BitCount() > BitPrecision(bound)+2 ? bound : word32(s_lastSmallPrime);
+}
+
+// r[i] = x%primes[i], with one pass over x for every product of primes that fits into a word
+static void SieveResidues(word32 *r, const Integer &x, const word32 *primes, size_t count)
+{
+	size_t i = 0;
+	while (i < count)
+	{
+		word m = primes[i];
+		size_t k = i+1;
+		while (k < count && BitPrecision(m) + BitPrecision(primes[k]) <= WORD_BITS)
+			m *= primes[k++];
+
+		const word xm = x % m;
+		for (; i<k; i++)
+			r[i] = word32(xm % primes[i]);
+	}
+}
+
 class PrimeSieve
 {
 public:
@@ -291,17 +418,60 @@ public:
 	bool NextCandidate(Integer &c);
 
 	void DoSieve();
-	static void SieveSingle(std::vector<bool> &sieve, word16 p, const Integer &first, const Integer &step, word16 stepInv);
+	static word32 FirstMultiple(word32 p, word32 firstModP, const Integer &first, const Integer &step, word32 stepInv);
 
 	Integer m_first, m_last, m_step;
 	signed int m_delta;
 	word m_next;
 	std::vector<bool> m_sieve;
+
+	// for each sieving prime, or two for each in a double sieve, where in the current window its next multiple is
+	// the offsets carry over from one window to the next, so only the first window needs remainders
+	const word32 *m_primes;
+	std::vector<word32> m_offsets;
 };
 
+// an offset for primes that divide none of the candidates
+const word32 s_noMultiple = 0xffffffff;
+
 PrimeSieve::PrimeSieve(const Integer &first, const Integer &last, const Integer &step, signed int delta)
 	: m_first(first), m_last(last), m_step(step), m_delta(delta), m_next(0)
 {
+	const std::vector<word32> &primeTable = Singleton<std::vector<word32>, NewSievingPrimeTable>().Ref();
+	m_primes = &primeTable[0];
+	const size_t primeCount = std::upper_bound(primeTable.begin(), primeTable.end(), SievingPrimeBound(first)) - primeTable.begin();
+
+	std::vector<word32> firstResidues(primeCount), stepResidues(primeCount);
+	SieveResidues(&firstResidues[0], first, m_primes, primeCount);
+	SieveResidues(&stepResidues[0], step, m_primes, primeCount);
+
+	Integer qFirst, halfStep;
+	if (delta != 0)
+	{
+		assert(step%2==0);
+		qFirst = (first-delta) >> 1;
+		halfStep = step >> 1;
+	}
+
+	m_offsets.resize(delta == 0 ? primeCount : 2*primeCount);
+	for (size_t i = 0; i < primeCount; ++i)
+	{
+		const word32 p = m_primes[i];
+		const word32 stepInv = stepResidues[i] ? (word32)Integer((long)stepResidues[i]).InverseMod(word(p)) : 0;
+
+		if (delta == 0)
+			m_offsets[i] = FirstMultiple(p, firstResidues[i], first, step, stepInv);
+		else
+		{
+			m_offsets[2*i] = FirstMultiple(p, firstResidues[i], first, step, stepInv);
+
+			// q = (first-delta)/2 + j*step/2, and p is odd whenever stepInv isn't 0
+			const word32 qFirstModP = word32(word64(firstResidues[i] + p - delta) * ((p+1)/2) % p);
+			const word32 halfStepInv = 2*stepInv < p ? 2*stepInv : 2*stepInv-p;
+			m_offsets[2*i+1] = FirstMultiple(p, qFirstModP, qFirst, halfStep, halfStepInv);
+		}
+	}
+
 	DoSieve();
 }
 
@@ -329,50 +499,91 @@ bool PrimeSieve::NextCandidate(Integer &c)
 	}
 }
 
-void PrimeSieve::SieveSingle(std::vector<bool> &sieve, word16 p, const Integer &first, const Integer &step, word16 stepInv)
+word32 PrimeSieve::FirstMultiple(word32 p, word32 firstModP, const Integer &first, const Integer &step, word32 stepInv)
 {
-	if (stepInv)
-	{
-		size_t sieveSize = sieve.size();
-		size_t j = (word32(p-(first%p))*stepInv) % p;
-		// if the first multiple of p is p, skip it
-		if (first.WordCount() <= 1 && first + step*long(j) == p)
-			j += p;
-		for (; j < sieveSize; j += p)
-			sieve[j] = true;
-	}
+	if (!stepInv)
+		return s_noMultiple;
+
+	word32 j = word32(word64(p-firstModP) * stepInv % p);
+	// if the first multiple of p is p, skip it
+	if (first.WordCount() <= 1 && first + step*long(j) == p)
+		j += p;
+	return j;
 }
 
 void PrimeSieve::DoSieve()
 {
-	unsigned int primeTableSize;
-	const word16 * primeTable = GetPrimeTable(primeTableSize);
-
 	const unsigned int maxSieveSize = 32768;
 	unsigned int sieveSize = STDMIN(Integer(maxSieveSize), (m_last-m_first)/m_step+1).ConvertToLong();
 
 	m_sieve.clear();
 	m_sieve.resize(sieveSize, false);
 
-	if (m_delta == 0)
+	const unsigned int shift = m_delta == 0 ? 0 : 1;
+	for (size_t i = 0; i < m_offsets.size(); ++i)
 	{
-		for (unsigned int i = 0; i < primeTableSize; ++i)
-			SieveSingle(m_sieve, primeTable[i], m_first, m_step, (word16)m_step.InverseMod(primeTable[i]));
+		word32 j = m_offsets[i];
+		if (j == s_noMultiple)
+			continue;
+
+		const word32 p = m_primes[i >> shift];
+		for (; j < sieveSize; j += p)
+			m_sieve[j] = true;
+		m_offsets[i] = j - sieveSize;
 	}
-	else
+}
+
+// takes candidates from a sieve and runs the base 2 test on as many of them at a time as the default executor can
+// work on, then hands back the ones that passed in sieve order, so that a search ends at the same prime either way
+class ProbablePrimeCandidates
+{
+public:
+	// delta != 0 means (p-delta)/2 has to pass the test as well, as in a double sieve
+	ProbablePrimeCandidates(PrimeSieve &sieve, const PrimeSelector *pSelector, signed int delta=0)
+		: m_sieve(sieve), m_pSelector(pSelector), m_delta(delta)
+		, m_candidates(GetDefaultTaskExecutor().GetConcurrency()), m_pass(m_candidates.size())
+		, m_count(0), m_next(0) {}
+
+	bool Next(Integer &p);
+
+private:
+	static void Task(void *context, size_t i)
 	{
-		assert(m_step%2==0);
-		Integer qFirst = (m_first-m_delta) >> 1;
-		Integer halfStep = m_step >> 1;
-		for (unsigned int i = 0; i < primeTableSize; ++i)
-		{
-			word16 p = primeTable[i];
-			word16 stepInv = (word16)m_step.InverseMod(p);
-			SieveSingle(m_sieve, p, m_first, m_step, stepInv);
+		ProbablePrimeCandidates &t = *(ProbablePrimeCandidates *)context;
+		const Integer &p = t.m_candidates[i];
+		t.m_pass[i] = (t.m_delta == 0 || FastProbablePrimeTest((p-t.m_delta) >> 1)) && FastProbablePrimeTest(p);
+	}
+
+	PrimeSieve &m_sieve;
+	const PrimeSelector *m_pSelector;
+	signed int m_delta;
+	std::vector<Integer> m_candidates;
+	std::vector<char> m_pass;
+	size_t m_count, m_next;
+};
 
-			word16 halfStepInv = 2*stepInv < p ? 2*stepInv : 2*stepInv-p;
-			SieveSingle(m_sieve, p, qFirst, halfStep, halfStepInv);
+bool ProbablePrimeCandidates::Next(Integer &p)
+{
+	while (true)
+	{
+		while (m_next < m_count)
+		{
+			size_t i = m_next++;
+			if (m_pass[i])
+			{
+				p = m_candidates[i];
+				return true;
+			}
 		}
+
+		m_count = m_next = 0;
+		while (m_count < m_candidates.size() && m_sieve.NextCandidate(m_candidates[m_count]))
+			if (!m_pSelector || m_pSelector->IsAcceptable(m_candidates[m_count]))
+				++m_count;
+		if (m_count == 0)
+			return false;
+
+		GetDefaultTaskExecutor().Run(&ProbablePrimeCandidates::Task, this, m_count);
 	}
 }
 
@@ -429,10 +640,11 @@ bool FirstPrime(Integer &p, const Integer &max, const Integer &equiv, const Inte
 		return false;
 
 	PrimeSieve sieve(p, max, mod);
+	ProbablePrimeCandidates candidates(sieve, pSelector);
 
-	while (sieve.NextCandidate(p))
+	while (candidates.Next(p))
 	{
-		if ((!pSelector || pSelector->IsAcceptable(p)) && FastProbablePrimeTest(p) && IsPrime(p))
+		if (IsSievedPrime(p))
 			return true;
 	}
 
@@ -495,10 +707,11 @@ Integer MihailescuProvablePrime(RandomNumberGenerator &rng, unsigned int pbits)
 
 		p.Randomize(rng, minP, maxP, Integer::ANY, 1, q2);
 		PrimeSieve sieve(p, STDMIN(p+PrimeSearchInterval(maxP)*q2, maxP), q2);
+		ProbablePrimeCandidates candidates(sieve, NULL);
 
-		while (sieve.NextCandidate(p))
+		while (candidates.Next(p))
 		{
-			if (FastProbablePrimeTest(p) && ProvePrime(p, q))
+			if (ProvePrime(p, q))
 				return p;
 		}
 	}
@@ -552,8 +765,12 @@ Integer MaurerProvablePrime(RandomNumberGenerator &rng, unsigned int bits)
 
 Integer CRT(const Integer &xp, const Integer &p, const Integer &xq, const Integer &q, const Integer &u)
 {
-	// isn't operator overloading great?
-	return p * (u * (xq-xp) % q) + xp;
+	// p * (u * (xq-xp) % q) + xp, without the temporaries
+	Integer t(xq), r;
+	t -= xp;
+	Integer::ModMul(t, u, t, q);
+	Integer::MultiplyAdd(r, p, t, xp);
+	return r;
 /*
 	Integer t1 = xq-xp;
 	cout << hex << t1 << endl;
@@ -643,19 +860,44 @@ bool SolveModularQuadraticEquation(Integer &r1, Integer &r2, const Integer &a, c
 	}
 }
 
+// the mod p and mod q halves of ModularRoot(), run as two tasks
+template <class MODULUS>
+struct ModularRootHalves
+{
+	ModularRootHalves(const Integer &a, const Integer &dp, const Integer &dq, const MODULUS &p, const MODULUS &q)
+		: a(a) {d[0] = &dp; d[1] = &dq; m[0] = &p; m[1] = &q;}
+
+	static void Task(void *context, size_t i)
+	{
+		ModularRootHalves &h = *(ModularRootHalves *)context;
+		h.result[i] = Exponentiate(h.a, *h.d[i], *h.m[i]);
+	}
+
+	static Integer Exponentiate(const Integer &a, const Integer &d, const Integer &m)
+		{return ModularExponentiation((a % m), d, m);}
+	static Integer Exponentiate(const Integer &a, const Integer &d, const MontgomeryRepresentation &m)
+		{return m.ConvertOut(m.Exponentiate(m.ConvertIn(a), d));}
+
+	const Integer &a;
+	const Integer *d[2];
+	const MODULUS *m[2];
+	Integer result[2];
+};
+
 Integer ModularRoot(const Integer &a, const Integer &dp, const Integer &dq,
 					const Integer &p, const Integer &q, const Integer &u)
 {
-	Integer p2, q2;
-	#pragma omp parallel
-		#pragma omp sections
-		{
-			#pragma omp section
-				p2 = ModularExponentiation((a % p), dp, p);
-			#pragma omp section
-				q2 = ModularExponentiation((a % q), dq, q);
-		}
-	return CRT(p2, p, q2, q, u);
+	ModularRootHalves<Integer> halves(a, dp, dq, p, q);
+	GetDefaultTaskExecutor().Run(&ModularRootHalves<Integer>::Task, &halves, 2);
+	return CRT(halves.result[0], p, halves.result[1], q, u);
+}
+
+Integer ModularRoot(const Integer &a, const Integer &dp, const Integer &dq,
+					const MontgomeryRepresentation &p, const MontgomeryRepresentation &q, const Integer &u)
+{
+	ModularRootHalves<MontgomeryRepresentation> halves(a, dp, dq, p, q);
+	GetDefaultTaskExecutor().Run(&ModularRootHalves<MontgomeryRepresentation>::Task, &halves, 2);
+	return CRT(halves.result[0], p.GetModulus(), halves.result[1], q.GetModulus(), u);
 }
 
 Integer ModularRoot(const Integer &a, const Integer &e,
@@ -995,25 +1237,29 @@ Integer Lucas(const Integer &n, const Integer &P, const Integer &modulus)
 }
 */
 
+struct InverseLucasHalves
+{
+	InverseLucasHalves(const Integer &e, const Integer &m, const Integer &p, const Integer &q)
+		: e(e), m(m), d(m*m-4) {primes[0] = &p; primes[1] = &q;}
+
+	static void Task(void *context, size_t i)
+	{
+		InverseLucasHalves &h = *(InverseLucasHalves *)context;
+		const Integer &p = *h.primes[i];
+		h.result[i] = Lucas(EuclideanMultiplicativeInverse(h.e, p-Jacobi(h.d,p)), h.m, p);
+	}
+
+	const Integer &e, &m;
+	Integer d;
+	const Integer *primes[2];
+	Integer result[2];
+};
+
 Integer InverseLucas(const Integer &e, const Integer &m, const Integer &p, const Integer &q, const Integer &u)
 {
-	Integer d = (m*m-4);
-	Integer p2, q2;
-	#pragma omp parallel
-		#pragma omp sections
-		{
-			#pragma omp section
-			{
-				p2 = p-Jacobi(d,p);
-				p2 = Lucas(EuclideanMultiplicativeInverse(e,p2), m, p);
-			}
-			#pragma omp section
-			{
-				q2 = q-Jacobi(d,q);
-				q2 = Lucas(EuclideanMultiplicativeInverse(e,q2), m, q);
-			}
-		}
-	return CRT(p2, p, q2, q, u);
+	InverseLucasHalves halves(e, m, p, q);
+	GetDefaultTaskExecutor().Run(&InverseLucasHalves::Task, &halves, 2);
+	return CRT(halves.result[0], p, halves.result[1], q, u);
 }
 
 unsigned int FactoringWorkFactor(unsigned int n)
@@ -1049,13 +1295,14 @@ void PrimeAndGenerator::Generate(signed int delta, RandomNumberGenerator &rng, u
 		{
 			p.Randomize(rng, minP, maxP, Integer::ANY, 6+5*delta, 12);
 			PrimeSieve sieve(p, STDMIN(p+PrimeSearchInterval(maxP)*12, maxP), 12, delta);
+			ProbablePrimeCandidates candidates(sieve, NULL, delta);
 
-			while (sieve.NextCandidate(p))
+			while (candidates.Next(p))
 			{
 				assert(IsSmallPrime(p) || SmallDivisorsTest(p));
 				q = (p-delta) >> 1;
 				assert(IsSmallPrime(q) || SmallDivisorsTest(q));
-				if (FastProbablePrimeTest(q) && FastProbablePrimeTest(p) && IsPrime(q) && IsPrime(p))
+				if (IsSievedPrime(q) && IsSievedPrime(p))
 				{
 					success = true;
 					break;
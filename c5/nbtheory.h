@@ -8,6 +8,8 @@
 
 NAMESPACE_BEGIN(CryptoPP)
 
+class MontgomeryRepresentation;
+
 // obtain pointer to small prime table and get its size
 CRYPTOPP_DLL const word16 * CRYPTOPP_API GetPrimeTable(unsigned int &size);
 
@@ -90,6 +92,8 @@ CRYPTOPP_DLL Integer CRYPTOPP_API ModularSquareRoot(const Integer &a, const Inte
 // dp=d%(p-1), dq=d%(q-1), (d is inverse of e mod (p-1)*(q-1))
 // and u=inverse of p mod q
 CRYPTOPP_DLL Integer CRYPTOPP_API ModularRoot(const Integer &a, const Integer &dp, const Integer &dq, const Integer &p, const Integer &q, const Integer &u);
+// same as above, using Montgomery representations of p and q precomputed by the caller
+CRYPTOPP_DLL Integer CRYPTOPP_API ModularRoot(const Integer &a, const Integer &dp, const Integer &dq, const MontgomeryRepresentation &p, const MontgomeryRepresentation &q, const Integer &u);
 
 // find r1 and r2 such that ax^2 + bx + c == 0 (mod p) for x in {r1, r2}, p prime
 // returns true if solutions exist
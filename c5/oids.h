@@ -55,6 +55,10 @@ DEFINE_OID(1, iso)
 					DEFINE_OID(teletrust_ellipticCurve()+1+11, brainpoolP384r1)
 					DEFINE_OID(teletrust_ellipticCurve()+1+13, brainpoolP512r1)
 
+		DEFINE_OID(identified_organization()+101, thawte);
+			DEFINE_OID(thawte()+110, id_X25519);
+			DEFINE_OID(thawte()+112, id_Ed25519);
+
 		DEFINE_OID(identified_organization()+132, certicom);
 			DEFINE_OID(certicom()+0, certicom_ellipticCurve);
 				// these are sorted by curve type and then by OID
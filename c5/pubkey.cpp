@@ -41,6 +41,50 @@ bool PK_RecoverableSignatureMessageEncodingMethod::VerifyMessageRepresentative(
 	return result.isValidCoding && result.messageLength == 0;
 }
 
+size_t RandomizedTrapdoorFunctionInverse::CalculateRandomizedInverseBatch(RandomNumberGenerator &rng, const Integer *x, Integer *results, size_t count, bool *failed) const
+{
+	size_t failures = 0;
+	for (size_t i=0; i<count; i++)
+	{
+		if (!failed)
+			results[i] = CalculateRandomizedInverse(rng, x[i]);
+		else try
+		{
+			results[i] = CalculateRandomizedInverse(rng, x[i]);
+			failed[i] = false;
+		}
+		catch (const Exception &)
+		{
+			results[i] = Integer::Zero();
+			failed[i] = true;
+			failures++;
+		}
+	}
+	return failures;
+}
+
+size_t TrapdoorFunctionInverse::CalculateInverseBatch(RandomNumberGenerator &rng, const Integer *x, Integer *results, size_t count, bool *failed) const
+{
+	size_t failures = 0;
+	for (size_t i=0; i<count; i++)
+	{
+		if (!failed)
+			results[i] = CalculateInverse(rng, x[i]);
+		else try
+		{
+			results[i] = CalculateInverse(rng, x[i]);
+			failed[i] = false;
+		}
+		catch (const Exception &)
+		{
+			results[i] = Integer::Zero();
+			failed[i] = true;
+			failures++;
+		}
+	}
+	return failures;
+}
+
 void TF_SignerBase::InputRecoverableMessage(PK_MessageAccumulator &messageAccumulator, const byte *recoverableMessage, size_t recoverableMessageLength) const
 {
 	PK_MessageAccumulatorBase &ma = static_cast<PK_MessageAccumulatorBase &>(messageAccumulator);
@@ -86,6 +130,49 @@ size_t TF_SignerBase::SignAndRestart(RandomNumberGenerator &rng, PK_MessageAccum
 	return signatureLength;
 }
 
+size_t TF_SignerBase::SignMessageBatch(RandomNumberGenerator &rng, const byte *const *messages, const size_t *messageLengths, byte *const *signatures, size_t *signatureLengths, size_t count) const
+{
+	if (count == 0)
+		return 0;
+
+	HashIdentifier id = GetHashIdentifier();
+	const MessageEncodingInterface &encoding = GetMessageEncodingInterface();
+	SecByteBlock representative(MessageRepresentativeLength());
+	std::vector<Integer> x(count), y(count);
+	SecBlock<bool> failed(count);
+
+	// encode all the messages first, so the trapdoor function sees the whole batch
+	for (size_t i=0; i<count; i++)
+	{
+		std::auto_ptr<PK_MessageAccumulator> m(NewSignatureAccumulator(rng));
+		PK_MessageAccumulatorBase &ma = static_cast<PK_MessageAccumulatorBase &>(*m);
+		if (MessageRepresentativeBitLength() < encoding.MinRepresentativeBitLength(id.second, ma.AccessHash().DigestSize()))
+			throw PK_SignatureScheme::KeyTooShort();
+
+		ma.Update(messages[i], messageLengths[i]);
+		encoding.ComputeMessageRepresentative(rng, 
+			ma.m_recoverableMessage, ma.m_recoverableMessage.size(), 
+			ma.AccessHash(), id, ma.m_empty,
+			representative, MessageRepresentativeBitLength());
+		x[i].Decode(representative, representative.size());
+	}
+
+	size_t failures = GetTrapdoorFunctionInterface().CalculateRandomizedInverseBatch(rng, &x[0], &y[0], count, failed);
+
+	size_t signatureLength = SignatureLength();
+	for (size_t i=0; i<count; i++)
+	{
+		if (failed[i])
+			signatureLengths[i] = 0;
+		else
+		{
+			y[i].Encode(signatures[i], signatureLength);
+			signatureLengths[i] = signatureLength;
+		}
+	}
+	return failures;
+}
+
 void TF_VerifierBase::InputSignature(PK_MessageAccumulator &messageAccumulator, const byte *signature, size_t signatureLength) const
 {
 	PK_MessageAccumulatorBase &ma = static_cast<PK_MessageAccumulatorBase &>(messageAccumulator);
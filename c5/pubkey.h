@@ -83,6 +83,11 @@ public:
 
 	virtual Integer CalculateRandomizedInverse(RandomNumberGenerator &rng, const Integer &x) const =0;
 	virtual bool IsRandomized() const {return true;}
+
+	//! calculate the inverses of count elements
+	/*! if failed is not NULL, failed[i] is set instead of throwing an exception when the calculation of results[i] fails
+		\return number of elements that failed */
+	virtual size_t CalculateRandomizedInverseBatch(RandomNumberGenerator &rng, const Integer *x, Integer *results, size_t count, bool *failed = NULL) const;
 };
 
 //! _
@@ -93,9 +98,13 @@ public:
 
 	Integer CalculateRandomizedInverse(RandomNumberGenerator &rng, const Integer &x) const
 		{return CalculateInverse(rng, x);}
+	size_t CalculateRandomizedInverseBatch(RandomNumberGenerator &rng, const Integer *x, Integer *results, size_t count, bool *failed = NULL) const
+		{return CalculateInverseBatch(rng, x, results, count, failed);}
 	bool IsRandomized() const {return false;}
 
 	virtual Integer CalculateInverse(RandomNumberGenerator &rng, const Integer &x) const =0;
+	//! see RandomizedTrapdoorFunctionInverse::CalculateRandomizedInverseBatch()
+	virtual size_t CalculateInverseBatch(RandomNumberGenerator &rng, const Integer *x, Integer *results, size_t count, bool *failed = NULL) const;
 };
 
 // ********************************************************
@@ -337,6 +346,7 @@ class CRYPTOPP_DLL CRYPTOPP_NO_VTABLE TF_SignerBase : public TF_SignatureSchemeB
 public:
 	void InputRecoverableMessage(PK_MessageAccumulator &messageAccumulator, const byte *recoverableMessage, size_t recoverableMessageLength) const;
 	size_t SignAndRestart(RandomNumberGenerator &rng, PK_MessageAccumulator &messageAccumulator, byte *signature, bool restart=true) const;
+	size_t SignMessageBatch(RandomNumberGenerator &rng, const byte *const *messages, const size_t *messageLengths, byte *const *signatures, size_t *signatureLengths, size_t count) const;
 };
 
 //! _
@@ -902,6 +912,15 @@ class CRYPTOPP_NO_VTABLE DL_ElgamalLikeSignatureAlgorithm
 public:
 	virtual void Sign(const DL_GroupParameters<T> &params, const Integer &privateKey, const Integer &k, const Integer &e, Integer &r, Integer &s) const =0;
 	virtual bool Verify(const DL_GroupParameters<T> &params, const DL_PublicKey<T> &publicKey, const Integer &e, const Integer &r, const Integer &s) const =0;
+	//! results[i] = Verify(params, *publicKeys[i], e[i], r[i], s[i]), returns the number of false results
+	virtual size_t VerifyBatch(const DL_GroupParameters<T> &params, const DL_PublicKey<T> *const *publicKeys, const Integer *e, const Integer *r, const Integer *s, bool *results, size_t count) const
+	{
+		size_t failures = 0;
+		for (size_t i=0; i<count; i++)
+			if (!(results[i] = Verify(params, *publicKeys[i], e[i], r[i], s[i])))
+				failures++;
+		return failures;
+	}
 	virtual Integer RecoverPresignature(const DL_GroupParameters<T> &params, const DL_PublicKey<T> &publicKey, const Integer &r, const Integer &s) const
 		{throw NotImplemented("DL_ElgamalLikeSignatureAlgorithm: this signature scheme does not support message recovery");}
 	virtual size_t RLen(const DL_GroupParameters<T> &params) const
@@ -1116,6 +1135,60 @@ public:
 		return alg.Verify(params, key, e, r, ma.m_s);
 	}
 
+	size_t VerifyMessageBatch(const byte *const *messages, const size_t *messageLengths, const byte *const *signatures, const size_t *signatureLengths, bool *results, size_t count) const
+	{
+		std::vector<const DL_PublicKey<T> *> publicKeys(count, &this->GetKeyInterface());
+		return count ? VerifyMessageBatch(&publicKeys[0], messages, messageLengths, signatures, signatureLengths, results, count) : 0;
+	}
+
+	//! like VerifyMessageBatch() above, but verifies signature i with publicKeys[i] instead of this verifier's key
+	/*! \pre the group parameters of publicKeys[i] are the same as this verifier's */
+	size_t VerifyMessageBatch(const DL_PublicKey<T> *const *publicKeys, const byte *const *messages, const size_t *messageLengths, const byte *const *signatures, const size_t *signatureLengths, bool *results, size_t count) const
+	{
+		this->GetMaterial().DoQuickSanityCheck();
+
+		const DL_ElgamalLikeSignatureAlgorithm<T> &alg = this->GetSignatureAlgorithm();
+		const DL_GroupParameters<T> &params = this->GetAbstractGroupParameters();
+		const size_t signatureLength = this->SignatureLength();
+
+		// signatures of the wrong length fail here, and the rest are verified together
+		std::vector<size_t> indices;
+		std::vector<const DL_PublicKey<T> *> keys;
+		std::vector<Integer> e, r, s;
+		indices.reserve(count);
+		SecByteBlock representative(this->MessageRepresentativeLength());
+		for (size_t i=0; i<count; i++)
+		{
+			results[i] = false;
+			if (signatureLengths[i] != signatureLength)
+				continue;
+
+			std::auto_ptr<PK_MessageAccumulator> m(this->NewVerificationAccumulator());
+			PK_MessageAccumulatorBase &ma = static_cast<PK_MessageAccumulatorBase &>(*m);
+			InputSignature(ma, signatures[i], signatureLengths[i]);
+			ma.Update(messages[i], messageLengths[i]);
+			this->GetMessageEncodingInterface().ComputeMessageRepresentative(NullRNG(), ma.m_recoverableMessage, ma.m_recoverableMessage.size(), 
+				ma.AccessHash(), this->GetHashIdentifier(), ma.m_empty,
+				representative, this->MessageRepresentativeBitLength());
+
+			indices.push_back(i);
+			keys.push_back(publicKeys[i]);
+			e.push_back(Integer(representative, representative.size()));
+			r.push_back(Integer(ma.m_semisignature, ma.m_semisignature.size()));
+			s.push_back(ma.m_s);
+		}
+
+		if (!indices.empty())
+		{
+			SecBlock<bool> verified(indices.size());
+			alg.VerifyBatch(params, &keys[0], &e[0], &r[0], &s[0], verified, indices.size());
+			for (size_t j=0; j<indices.size(); j++)
+				results[indices[j]] = verified[j];
+		}
+
+		return std::count(results, results+count, false);
+	}
+
 	DecodingResult RecoverAndRestart(byte *recoveredMessage, PK_MessageAccumulator &messageAccumulator) const
 	{
 		this->GetMaterial().DoQuickSanityCheck();
@@ -58,6 +58,7 @@ void RegisterFactories()
 
 	RegisterDefaultFactoryFor<SimpleKeyAgreementDomain, DH>();
 	RegisterDefaultFactoryFor<HashTransformation, CRC32>();
+	RegisterDefaultFactoryFor<HashTransformation, CRC32C>();
 	RegisterDefaultFactoryFor<HashTransformation, Adler32>();
 	RegisterDefaultFactoryFor<HashTransformation, Weak::MD5>();
 	RegisterDefaultFactoryFor<HashTransformation, SHA1>();
@@ -22,6 +22,9 @@ class CRYPTOPP_DLL Rijndael : public Rijndael_Info, public BlockCipherDocumentat
 	{
 	public:
 		void UncheckedSetKey(const byte *userKey, unsigned int length, const NameValuePairs &params);
+#if CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE
+		unsigned int OptimalNumberOfParallelBlocks() const;
+#endif
 
 	protected:
 		static void FillEncTable();
@@ -43,6 +46,11 @@ class CRYPTOPP_DLL Rijndael : public Rijndael_Info, public BlockCipherDocumentat
 		void ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const;
 #if CRYPTOPP_BOOL_X64 || CRYPTOPP_BOOL_X86
 		size_t AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const;
+#endif
+#if CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE
+		// round keys in the layout used by AES-NI, for GCM's stitched CTR/GHASH kernel
+		const word32 * GetRoundKeys() const {return m_key;}
+		unsigned int GetRounds() const {return m_rounds;}
 #endif
 	};
 
@@ -9,6 +9,7 @@
 #include "sha.h"
 #include "algparam.h"
 #include "fips140.h"
+#include "taskexec.h"
 
 #if !defined(NDEBUG) && !defined(CRYPTOPP_IS_DLL)
 #include "pssr.h"
@@ -64,7 +65,7 @@ void RSAFunction::DEREncodePublicKey(BufferedTransformation &bt) const
 Integer RSAFunction::ApplyFunction(const Integer &x) const
 {
 	DoQuickSanityCheck();
-	return a_exp_b_mod_c(x, m_e, m_n);
+	return ModularArithmetic(m_n).ExponentiatePublic(x, m_e);
 }
 
 bool RSAFunction::Validate(RandomNumberGenerator &rng, unsigned int level) const
@@ -220,26 +221,151 @@ void InvertibleRSAFunction::DEREncodePrivateKey(BufferedTransformation &bt) cons
 	privateKey.MessageEnd();
 }
 
+void InvertibleRSAFunction::RefreshInverseCache(RandomNumberGenerator &rng) const
+{
+	if (!m_cache.modn.get() || m_cache.modn->GetModulus() != m_n)
+	{
+		m_cache.modn.reset(new MontgomeryRepresentation(m_n));
+		m_cache.e = Integer::Zero();
+	}
+	if (!m_cache.modp.get() || m_cache.modp->GetModulus() != m_p)
+		m_cache.modp.reset(new MontgomeryRepresentation(m_p));
+	if (!m_cache.modq.get() || m_cache.modq->GetModulus() != m_q)
+		m_cache.modq.reset(new MontgomeryRepresentation(m_q));
+
+	const MontgomeryRepresentation &modn = *m_cache.modn;
+	if (m_cache.e != m_e)
+	{
+		Integer r, rInv;
+		do {	// do this in a loop for people using small numbers for testing
+			r.Randomize(rng, Integer::One(), m_n - Integer::One());
+			rInv = r.InverseMod(m_n);
+		} while (rInv.IsZero());
+		m_cache.re = modn.ExponentiatePublic(modn.ConvertIn(r), m_e);
+		m_cache.rInv = modn.ConvertIn(rInv);
+		m_cache.e = m_e;
+	}
+	else
+	{
+		// squaring both halves of the pair gives (r^2)^e and (r^2)^-1, another valid pair, for two multiplications
+		// instead of an exponentiation and an inversion. This is the update Kocher suggests for timing attack
+		// blinding. An attacker who doesn't know r can't predict r^2 any better than a fresh random value, and
+		// the squarings are done on the cache, so no two operations are blinded by the same pair
+		m_cache.re = modn.Square(m_cache.re);
+		m_cache.rInv = modn.Square(m_cache.rInv);
+	}
+}
+
 Integer InvertibleRSAFunction::CalculateInverse(RandomNumberGenerator &rng, const Integer &x) const 
 {
 	DoQuickSanityCheck();
-	ModularArithmetic modn(m_n);
-	Integer r, rInv;
-	do {	// do this in a loop for people using small numbers for testing
-		r.Randomize(rng, Integer::One(), m_n - Integer::One());
-		rInv = modn.MultiplicativeInverse(r);
-	} while (rInv.IsZero());
-	Integer re = modn.Exponentiate(r, m_e);
-	re = modn.Multiply(re, x);			// blind
+
+	member_ptr<MontgomeryRepresentation> pmodn, pmodp, pmodq;
+	Integer blind, unblind;
+	{
+		MutexLock lock(m_cache.mutex);
+		RefreshInverseCache(rng);
+		pmodn.reset(new MontgomeryRepresentation(*m_cache.modn));
+		pmodp.reset(new MontgomeryRepresentation(*m_cache.modp));
+		pmodq.reset(new MontgomeryRepresentation(*m_cache.modq));
+		blind = m_cache.re;
+		unblind = m_cache.rInv;
+	}
+
+	const MontgomeryRepresentation &modn = *pmodn;
+	Integer re = modn.Multiply(x < m_n ? x : x % m_n, blind);			// blind
 	// here we follow the notation of PKCS #1 and let u=q inverse mod p
 	// but in ModRoot, u=p inverse mod q, so we reverse the order of p and q
-	Integer y = ModularRoot(re, m_dq, m_dp, m_q, m_p, m_u);
-	y = modn.Multiply(y, rInv);				// unblind
-	if (modn.Exponentiate(y, m_e) != x)		// check
+	Integer y = ModularRoot(re, m_dq, m_dp, *pmodq, *pmodp, m_u);
+	y = modn.Multiply(y, unblind);				// unblind
+	if (modn.ConvertOut(modn.ExponentiatePublic(modn.ConvertIn(y), m_e)) != x)		// check
 		throw Exception(Exception::OTHER_ERROR, "InvertibleRSAFunction: computational error during private key operation");
 	return y;
 }
 
+// the private key operations of CalculateInverseBatch(), run as tasks that each work with their own copies of the contexts
+struct RSABatch
+{
+	static void Halve(void *context, size_t j)
+	{
+		const RSABatch &b = *(const RSABatch *)context;
+		size_t i = j/2;
+		if (j%2 == 0)
+		{
+			MontgomeryRepresentation modp(*b.modp);
+			b.yp[i] = modp.ConvertOut(modp.Exponentiate(modp.ConvertIn(b.blinded[i]), *b.dp));
+		}
+		else
+		{
+			MontgomeryRepresentation modq(*b.modq);
+			b.yq[i] = modq.ConvertOut(modq.Exponentiate(modq.ConvertIn(b.blinded[i]), *b.dq));
+		}
+	}
+
+	static void Combine(void *context, size_t i)
+	{
+		const RSABatch &b = *(const RSABatch *)context;
+		MontgomeryRepresentation modn(*b.modn);
+		// u is q inverse mod p, see CalculateInverse()
+		Integer y = CRT(b.yq[i], *b.q, b.yp[i], *b.p, *b.u);
+		b.results[i] = modn.Multiply(y, b.rInv[i]);
+		b.bad[i] = modn.ConvertOut(modn.ExponentiatePublic(modn.ConvertIn(b.results[i]), *b.e)) != b.x[i];
+	}
+
+	const Integer *x;
+	Integer *results, *blinded, *rInv, *yp, *yq;
+	char *bad;
+	const MontgomeryRepresentation *modn, *modp, *modq;
+	const Integer *e, *dp, *dq, *p, *q, *u;
+};
+
+size_t InvertibleRSAFunction::CalculateInverseBatch(RandomNumberGenerator &rng, const Integer *x, Integer *results, size_t count, bool *failed) const
+{
+	DoQuickSanityCheck();
+	if (count == 0)
+		return 0;
+
+	std::vector<Integer> blinded(count), rInv(count), yp(count), yq(count);
+	std::vector<char> bad(count);
+
+	member_ptr<MontgomeryRepresentation> pmodn, pmodp, pmodq;
+	{
+		MutexLock lock(m_cache.mutex);
+		for (size_t i=0; i<count; i++)
+		{
+			RefreshInverseCache(rng);
+			blinded[i] = m_cache.re;
+			rInv[i] = m_cache.rInv;
+		}
+		pmodn.reset(new MontgomeryRepresentation(*m_cache.modn));
+		pmodp.reset(new MontgomeryRepresentation(*m_cache.modp));
+		pmodq.reset(new MontgomeryRepresentation(*m_cache.modq));
+	}
+
+	for (size_t i=0; i<count; i++)
+		blinded[i] = pmodn->Multiply(x[i] < m_n ? x[i] : x[i] % m_n, blinded[i]);
+
+	RSABatch batch = {x, results, &blinded[0], &rInv[0], &yp[0], &yq[0], &bad[0],
+		pmodn.get(), pmodp.get(), pmodq.get(), &m_e, &m_dp, &m_dq, &m_p, &m_q, &m_u};
+	GetDefaultTaskExecutor().Run(&RSABatch::Halve, &batch, 2*count);
+	GetDefaultTaskExecutor().Run(&RSABatch::Combine, &batch, count);
+
+	size_t failures = 0;
+	for (size_t i=0; i<count; i++)
+	{
+		if (bad[i])
+		{
+			if (!failed)
+				throw Exception(Exception::OTHER_ERROR, "InvertibleRSAFunction: computational error during private key operation");
+			results[i] = Integer::Zero();
+			failures++;
+		}
+		if (failed)
+			failed[i] = bad[i] != 0;
+	}
+	return failures;
+}
+
 bool InvertibleRSAFunction::Validate(RandomNumberGenerator &rng, unsigned int level) const
 {
 	bool pass = RSAFunction::Validate(rng, level);
@@ -299,6 +425,15 @@ Integer InvertibleRSAFunction_ISO::CalculateInverse(RandomNumberGenerator &rng,
 	return STDMIN(t, m_n-t);
 }
 
+size_t InvertibleRSAFunction_ISO::CalculateInverseBatch(RandomNumberGenerator &rng, const Integer *x, Integer *results, size_t count, bool *failed) const
+{
+	size_t failures = InvertibleRSAFunction::CalculateInverseBatch(rng, x, results, count, failed);
+	for (size_t i=0; i<count; i++)
+		if (!results[i].IsZero())
+			results[i] = STDMIN(results[i], m_n-results[i]);
+	return failures;
+}
+
 NAMESPACE_END
 
 #endif
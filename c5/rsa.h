@@ -11,6 +11,7 @@
 #include "pkcspad.h"
 #include "oaep.h"
 #include "emsa2.h"
+#include "trdlocal.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -76,6 +77,7 @@ public:
 
 	// TrapdoorFunctionInverse
 	Integer CalculateInverse(RandomNumberGenerator &rng, const Integer &x) const;
+	size_t CalculateInverseBatch(RandomNumberGenerator &rng, const Integer *x, Integer *results, size_t count, bool *failed = NULL) const;
 
 	// GeneratableCryptoMaterial
 	bool Validate(RandomNumberGenerator &rng, unsigned int level) const;
@@ -101,6 +103,27 @@ public:
 
 protected:
 	Integer m_d, m_p, m_q, m_dp, m_dq, m_u;
+
+private:
+	// Montgomery representations of n, p and q, and the blinding pair r^e and r^-1 mod n (in Montgomery form),
+	// rebuilt by CalculateInverse() when the key changes, and left behind when the key is copied
+	// a const key may be used by several threads at once, so the cache is only touched with mutex locked,
+	// and each private key operation works on its own copies of what it takes from it
+	struct InverseCache
+	{
+		InverseCache() {}
+		InverseCache(const InverseCache &) {}
+		InverseCache & operator=(const InverseCache &) {return *this;}
+
+		member_ptr<MontgomeryRepresentation> modn, modp, modq;
+		Integer e, re, rInv;
+		Mutex mutex;
+	};
+
+	// m_cache.mutex must be locked
+	void RefreshInverseCache(RandomNumberGenerator &rng) const;
+
+	mutable InverseCache m_cache;
 };
 
 class CRYPTOPP_DLL RSAFunction_ISO : public RSAFunction
@@ -114,6 +137,7 @@ class CRYPTOPP_DLL InvertibleRSAFunction_ISO : public InvertibleRSAFunction
 {
 public:
 	Integer CalculateInverse(RandomNumberGenerator &rng, const Integer &x) const;
+	size_t CalculateInverseBatch(RandomNumberGenerator &rng, const Integer *x, Integer *results, size_t count, bool *failed = NULL) const;
 	Integer PreimageBound() const {return ++(m_n>>1);}
 };
 
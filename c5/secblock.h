@@ -151,6 +151,12 @@ public:
 		assert(false);
 	}
 
+	pointer reallocate(pointer p, size_type oldSize, size_type newSize, bool preserve)
+	{
+		assert(false);
+		return NULL;
+	}
+
 	size_type max_size() const {return 0;}
 };
 
@@ -212,6 +218,10 @@ public:
 			return p;
 		}
 
+		// a heap block that stays on the heap is left to the fallback allocator, which keeps it if the size doesn't change
+		if (p != GetAlignedArray() && newSize > S)
+			return m_fallbackAllocator.reallocate(p, oldSize, newSize, preserve);
+
 		pointer newPointer = allocate(newSize, NULL);
 		if (preserve)
 			memcpy(newPointer, p, sizeof(T)*STDMIN(oldSize, newSize));
@@ -221,6 +231,47 @@ public:
 
 	size_type max_size() const {return STDMAX(m_fallbackAllocator.max_size(), S);}
 
+	//! exchange block p of pSize elements, allocated by this object, with block q of qSize elements, allocated by b
+	/*! a block in the fixed array can't change hands, so its contents are moved to the other object's array instead */
+	void swap(pointer &p, size_type &pSize, FixedSizeAllocatorWithCleanup<T, S, A, T_Align16> &b, pointer &q, size_type &qSize)
+	{
+		const bool pFixed = p == GetAlignedArray(), qFixed = q == b.GetAlignedArray();
+
+		if (pFixed && qFixed)
+		{
+			T temp[S];
+			memcpy(temp, p, pSize*sizeof(T));
+			memcpy(p, q, qSize*sizeof(T));
+			memcpy(q, temp, pSize*sizeof(T));
+			SecureWipeArray(temp, pSize);
+			// deallocate() only wipes as many elements as the block holds, so wipe what the larger block leaves behind
+			if (pSize > qSize)
+				SecureWipeArray(p+qSize, pSize-qSize);
+			else
+				SecureWipeArray(q+pSize, qSize-pSize);
+		}
+		else if (pFixed)
+		{
+			memcpy(b.GetAlignedArray(), p, pSize*sizeof(T));
+			SecureWipeArray(p, pSize);
+			std::swap(m_allocated, b.m_allocated);
+			p = q;
+			q = b.GetAlignedArray();
+		}
+		else if (qFixed)
+		{
+			memcpy(GetAlignedArray(), q, qSize*sizeof(T));
+			SecureWipeArray(q, qSize);
+			std::swap(m_allocated, b.m_allocated);
+			q = p;
+			p = GetAlignedArray();
+		}
+		else
+			std::swap(p, q);
+
+		std::swap(pSize, qSize);
+	}
+
 private:
 #ifdef __BORLANDC__
 	T* GetAlignedArray() {return m_array;}
@@ -233,6 +284,21 @@ private:
 	bool m_allocated;
 };
 
+// used by SecBlock::swap()
+template <class A>
+inline void SwapAllocatedBlocks(A &a, typename A::pointer &p, typename A::size_type &pSize, A &b, typename A::pointer &q, typename A::size_type &qSize)
+{
+	std::swap(a, b);
+	std::swap(p, q);
+	std::swap(pSize, qSize);
+}
+
+template <class T, size_t S, class A, bool T_Align16>
+inline void SwapAllocatedBlocks(FixedSizeAllocatorWithCleanup<T, S, A, T_Align16> &a, T *&p, size_t &pSize, FixedSizeAllocatorWithCleanup<T, S, A, T_Align16> &b, T *&q, size_t &qSize)
+{
+	a.swap(p, pSize, b, q, qSize);
+}
+
 //! a block of memory allocated using A
 template <class T, class A = AllocatorWithCleanup<T> >
 class SecBlock
@@ -402,9 +468,7 @@ public:
 	//! swap contents and size with another SecBlock
 	void swap(SecBlock<T, A> &b)
 	{
-		std::swap(m_alloc, b.m_alloc);
-		std::swap(m_size, b.m_size);
-		std::swap(m_ptr, b.m_ptr);
+		SwapAllocatedBlocks(m_alloc, m_ptr, m_size, b.m_alloc, b.m_ptr, b.m_size);
 	}
 
 //private:
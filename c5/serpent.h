@@ -31,12 +31,26 @@ class Serpent : public Serpent_Info, public BlockCipherDocumentation
 	{
 	public:
 		void ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const;
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+		unsigned int OptimalNumberOfParallelBlocks() const;
+		size_t AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const;
+
+	private:
+		void SSE2_Process4Blocks(const byte *inBlocks, byte *outBlocks) const;
+#endif
 	};
 
 	class CRYPTOPP_NO_VTABLE Dec : public Base
 	{
 	public:
 		void ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const;
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+		unsigned int OptimalNumberOfParallelBlocks() const;
+		size_t AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const;
+
+	private:
+		void SSE2_Process4Blocks(const byte *inBlocks, byte *outBlocks) const;
+#endif
 	};
 
 public:
@@ -13,6 +13,7 @@
 #include "sha.h"
 #include "misc.h"
 #include "cpu.h"
+#include "multiblock.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -42,8 +43,214 @@ void SHA1::InitState(HashWordType *state)
 #define R3(v,w,x,y,z,i) z+=f3(w,x,y)+blk1(i)+0x8F1BBCDC+rotlFixed(v,5);w=rotlFixed(w,30);
 #define R4(v,w,x,y,z,i) z+=f4(w,x,y)+blk1(i)+0xCA62C1D6+rotlFixed(v,5);w=rotlFixed(w,30);
 
+#if CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE
+
+// byte shuffles applied to each 16 bytes of input, for input that is in big endian
+// order (straight from the message) and for input that is already in words
+CRYPTOPP_ALIGN_DATA(16) static const word64 s_shaniMasks64[] = {
+	W64LIT(0x08090a0b0c0d0e0f), W64LIT(0x0001020304050607),
+	W64LIT(0x0b0a09080f0e0d0c), W64LIT(0x0302010007060504),
+	W64LIT(0x0405060700010203), W64LIT(0x0c0d0e0f08090a0b),
+	W64LIT(0x0706050403020100), W64LIT(0x0f0e0d0c0b0a0908)};
+static const __m128i *s_shaniMasks = (const __m128i *)s_shaniMasks64;
+
+// hash length bytes with the SHA extensions, length must be a multiple of 64
+static void SHANI_SHA1_HashBlocks(word32 *state, const word32 *data, size_t length, ByteOrder order)
+{
+	const __m128i mask = s_shaniMasks[order == BIG_ENDIAN_ORDER ? 0 : 1];
+	__m128i ABCD, ABCD_SAVE, E0, E0_SAVE, E1;
+	__m128i MSG0, MSG1, MSG2, MSG3;
+
+	ABCD = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0x1b);
+	E0 = _mm_set_epi32(state[4], 0, 0, 0);
+
+	for (; length; length-=64, data+=16)
+	{
+		ABCD_SAVE = ABCD;
+		E0_SAVE = E0;
+
+		// rounds 0-3
+		MSG0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data+0)), mask);
+		E0 = _mm_add_epi32(E0, MSG0);
+		E1 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+
+		// rounds 4-7
+		MSG1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data+4)), mask);
+		E1 = _mm_sha1nexte_epu32(E1, MSG1);
+		E0 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 0);
+		MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+
+		// rounds 8-11
+		MSG2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data+8)), mask);
+		E0 = _mm_sha1nexte_epu32(E0, MSG2);
+		E1 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+		MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+		MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+		// rounds 12-15
+		MSG3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data+12)), mask);
+		E1 = _mm_sha1nexte_epu32(E1, MSG3);
+		E0 = ABCD;
+		MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 0);
+		MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+		MSG1 = _mm_xor_si128(MSG1, MSG3);
+
+		// rounds 16-19
+		E0 = _mm_sha1nexte_epu32(E0, MSG0);
+		E1 = ABCD;
+		MSG1 = _mm_sha1msg2_epu32(MSG1, MSG0);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+		MSG3 = _mm_sha1msg1_epu32(MSG3, MSG0);
+		MSG2 = _mm_xor_si128(MSG2, MSG0);
+
+		// rounds 20-23
+		E1 = _mm_sha1nexte_epu32(E1, MSG1);
+		E0 = ABCD;
+		MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 1);
+		MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+		MSG3 = _mm_xor_si128(MSG3, MSG1);
+
+		// rounds 24-27
+		E0 = _mm_sha1nexte_epu32(E0, MSG2);
+		E1 = ABCD;
+		MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 1);
+		MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+		MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+		// rounds 28-31
+		E1 = _mm_sha1nexte_epu32(E1, MSG3);
+		E0 = ABCD;
+		MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 1);
+		MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+		MSG1 = _mm_xor_si128(MSG1, MSG3);
+
+		// rounds 32-35
+		E0 = _mm_sha1nexte_epu32(E0, MSG0);
+		E1 = ABCD;
+		MSG1 = _mm_sha1msg2_epu32(MSG1, MSG0);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 1);
+		MSG3 = _mm_sha1msg1_epu32(MSG3, MSG0);
+		MSG2 = _mm_xor_si128(MSG2, MSG0);
+
+		// rounds 36-39
+		E1 = _mm_sha1nexte_epu32(E1, MSG1);
+		E0 = ABCD;
+		MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 1);
+		MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+		MSG3 = _mm_xor_si128(MSG3, MSG1);
+
+		// rounds 40-43
+		E0 = _mm_sha1nexte_epu32(E0, MSG2);
+		E1 = ABCD;
+		MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 2);
+		MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+		MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+		// rounds 44-47
+		E1 = _mm_sha1nexte_epu32(E1, MSG3);
+		E0 = ABCD;
+		MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 2);
+		MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+		MSG1 = _mm_xor_si128(MSG1, MSG3);
+
+		// rounds 48-51
+		E0 = _mm_sha1nexte_epu32(E0, MSG0);
+		E1 = ABCD;
+		MSG1 = _mm_sha1msg2_epu32(MSG1, MSG0);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 2);
+		MSG3 = _mm_sha1msg1_epu32(MSG3, MSG0);
+		MSG2 = _mm_xor_si128(MSG2, MSG0);
+
+		// rounds 52-55
+		E1 = _mm_sha1nexte_epu32(E1, MSG1);
+		E0 = ABCD;
+		MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 2);
+		MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+		MSG3 = _mm_xor_si128(MSG3, MSG1);
+
+		// rounds 56-59
+		E0 = _mm_sha1nexte_epu32(E0, MSG2);
+		E1 = ABCD;
+		MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 2);
+		MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+		MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+		// rounds 60-63
+		E1 = _mm_sha1nexte_epu32(E1, MSG3);
+		E0 = ABCD;
+		MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 3);
+		MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+		MSG1 = _mm_xor_si128(MSG1, MSG3);
+
+		// rounds 64-67
+		E0 = _mm_sha1nexte_epu32(E0, MSG0);
+		E1 = ABCD;
+		MSG1 = _mm_sha1msg2_epu32(MSG1, MSG0);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 3);
+		MSG3 = _mm_sha1msg1_epu32(MSG3, MSG0);
+		MSG2 = _mm_xor_si128(MSG2, MSG0);
+
+		// rounds 68-71
+		E1 = _mm_sha1nexte_epu32(E1, MSG1);
+		E0 = ABCD;
+		MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 3);
+		MSG3 = _mm_xor_si128(MSG3, MSG1);
+
+		// rounds 72-75
+		E0 = _mm_sha1nexte_epu32(E0, MSG2);
+		E1 = ABCD;
+		MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 3);
+
+		// rounds 76-79
+		E1 = _mm_sha1nexte_epu32(E1, MSG3);
+		E0 = ABCD;
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E1, 3);
+
+		E0 = _mm_sha1nexte_epu32(E0, E0_SAVE);
+		ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+	}
+
+	_mm_storeu_si128((__m128i *)state, _mm_shuffle_epi32(ABCD, 0x1b));
+	state[4] = _mm_cvtsi128_si32(_mm_shuffle_epi32(E0, 0x1b));
+}
+
+size_t SHA1::HashMultipleBlocks(const word32 *input, size_t length)
+{
+	if (HasSHA())
+	{
+		SHANI_SHA1_HashBlocks(m_state, input, length & (size_t(0)-BLOCKSIZE), BIG_ENDIAN_ORDER);
+		return length % BLOCKSIZE;
+	}
+	return IteratedHashWithStaticTransform<word32, BigEndian, 64, 20, SHA1>::HashMultipleBlocks(input, length);
+}
+
+#endif
+
 void SHA1::Transform(word32 *state, const word32 *data)
 {
+#if CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE
+	if (HasSHA())
+	{
+		SHANI_SHA1_HashBlocks(state, data, BLOCKSIZE, LITTLE_ENDIAN_ORDER);
+		return;
+	}
+#endif
+
 	word32 W[16];
     /* Copy context->state[] to working vars */
     word32 a = state[0];
@@ -446,16 +653,184 @@ void CRYPTOPP_FASTCALL X86_SHA256_HashBlocks(word32 *state, const word32 *data,
 }
 #endif
 
+#if CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE
+
+// hash length bytes with the SHA extensions, length must be a multiple of 64
+static void SHANI_SHA256_HashBlocks(word32 *state, const word32 *data, size_t length, ByteOrder order)
+{
+	const __m128i mask = s_shaniMasks[order == BIG_ENDIAN_ORDER ? 2 : 3];
+	__m128i STATE0, STATE1, ABEF_SAVE, CDGH_SAVE;
+	__m128i MSG, TMP, MSG0, MSG1, MSG2, MSG3;
+
+	// the instructions want the state as ABEF and CDGH
+	TMP = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0xb1);
+	STATE1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(state+4)), 0x1b);
+	STATE0 = _mm_alignr_epi8(TMP, STATE1, 8);
+	STATE1 = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(STATE1), _mm_castsi128_pd(TMP), 2));
+
+	for (; length; length-=64, data+=16)
+	{
+		ABEF_SAVE = STATE0;
+		CDGH_SAVE = STATE1;
+
+		// rounds 0-3
+		MSG0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data+0)), mask);
+		MSG = _mm_add_epi32(MSG0, _mm_loadu_si128((const __m128i *)(SHA256_K+0)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+
+		// rounds 4-7
+		MSG1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data+4)), mask);
+		MSG = _mm_add_epi32(MSG1, _mm_loadu_si128((const __m128i *)(SHA256_K+4)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG0 = _mm_sha256msg1_epu32(MSG0, MSG1);
+
+		// rounds 8-11
+		MSG2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data+8)), mask);
+		MSG = _mm_add_epi32(MSG2, _mm_loadu_si128((const __m128i *)(SHA256_K+8)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG1 = _mm_sha256msg1_epu32(MSG1, MSG2);
+
+		// rounds 12-15
+		MSG3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data+12)), mask);
+		MSG = _mm_add_epi32(MSG3, _mm_loadu_si128((const __m128i *)(SHA256_K+12)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG3, MSG2, 4);
+		MSG0 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG0, TMP), MSG3);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG2 = _mm_sha256msg1_epu32(MSG2, MSG3);
+
+		// rounds 16-19
+		MSG = _mm_add_epi32(MSG0, _mm_loadu_si128((const __m128i *)(SHA256_K+16)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG0, MSG3, 4);
+		MSG1 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG1, TMP), MSG0);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG3 = _mm_sha256msg1_epu32(MSG3, MSG0);
+
+		// rounds 20-23
+		MSG = _mm_add_epi32(MSG1, _mm_loadu_si128((const __m128i *)(SHA256_K+20)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG1, MSG0, 4);
+		MSG2 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG2, TMP), MSG1);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG0 = _mm_sha256msg1_epu32(MSG0, MSG1);
+
+		// rounds 24-27
+		MSG = _mm_add_epi32(MSG2, _mm_loadu_si128((const __m128i *)(SHA256_K+24)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG2, MSG1, 4);
+		MSG3 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG3, TMP), MSG2);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG1 = _mm_sha256msg1_epu32(MSG1, MSG2);
+
+		// rounds 28-31
+		MSG = _mm_add_epi32(MSG3, _mm_loadu_si128((const __m128i *)(SHA256_K+28)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG3, MSG2, 4);
+		MSG0 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG0, TMP), MSG3);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG2 = _mm_sha256msg1_epu32(MSG2, MSG3);
+
+		// rounds 32-35
+		MSG = _mm_add_epi32(MSG0, _mm_loadu_si128((const __m128i *)(SHA256_K+32)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG0, MSG3, 4);
+		MSG1 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG1, TMP), MSG0);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG3 = _mm_sha256msg1_epu32(MSG3, MSG0);
+
+		// rounds 36-39
+		MSG = _mm_add_epi32(MSG1, _mm_loadu_si128((const __m128i *)(SHA256_K+36)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG1, MSG0, 4);
+		MSG2 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG2, TMP), MSG1);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG0 = _mm_sha256msg1_epu32(MSG0, MSG1);
+
+		// rounds 40-43
+		MSG = _mm_add_epi32(MSG2, _mm_loadu_si128((const __m128i *)(SHA256_K+40)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG2, MSG1, 4);
+		MSG3 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG3, TMP), MSG2);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG1 = _mm_sha256msg1_epu32(MSG1, MSG2);
+
+		// rounds 44-47
+		MSG = _mm_add_epi32(MSG3, _mm_loadu_si128((const __m128i *)(SHA256_K+44)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG3, MSG2, 4);
+		MSG0 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG0, TMP), MSG3);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG2 = _mm_sha256msg1_epu32(MSG2, MSG3);
+
+		// rounds 48-51
+		MSG = _mm_add_epi32(MSG0, _mm_loadu_si128((const __m128i *)(SHA256_K+48)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG0, MSG3, 4);
+		MSG1 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG1, TMP), MSG0);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+		MSG3 = _mm_sha256msg1_epu32(MSG3, MSG0);
+
+		// rounds 52-55
+		MSG = _mm_add_epi32(MSG1, _mm_loadu_si128((const __m128i *)(SHA256_K+52)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG1, MSG0, 4);
+		MSG2 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG2, TMP), MSG1);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+
+		// rounds 56-59
+		MSG = _mm_add_epi32(MSG2, _mm_loadu_si128((const __m128i *)(SHA256_K+56)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		TMP = _mm_alignr_epi8(MSG2, MSG1, 4);
+		MSG3 = _mm_sha256msg2_epu32(_mm_add_epi32(MSG3, TMP), MSG2);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+
+		// rounds 60-63
+		MSG = _mm_add_epi32(MSG3, _mm_loadu_si128((const __m128i *)(SHA256_K+60)));
+		STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+		STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, _mm_shuffle_epi32(MSG, 0x0e));
+
+		STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+		STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+	}
+
+	TMP = _mm_shuffle_epi32(STATE0, 0x1b);
+	STATE1 = _mm_shuffle_epi32(STATE1, 0xb1);
+	STATE0 = _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(TMP), _mm_castsi128_pd(STATE1), 2));
+	STATE1 = _mm_alignr_epi8(STATE1, TMP, 8);
+	_mm_storeu_si128((__m128i *)state, STATE0);
+	_mm_storeu_si128((__m128i *)(state+4), STATE1);
+}
+
+#endif
+
 #if defined(CRYPTOPP_X86_ASM_AVAILABLE) || defined(CRYPTOPP_X64_MASM_AVAILABLE)
 
 size_t SHA256::HashMultipleBlocks(const word32 *input, size_t length)
 {
+#if CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE
+	if (HasSHA())
+	{
+		SHANI_SHA256_HashBlocks(m_state, input, length & (size_t(0)-BLOCKSIZE), BIG_ENDIAN_ORDER);
+		return length % BLOCKSIZE;
+	}
+#endif
 	X86_SHA256_HashBlocks(m_state, input, (length&(size_t(0)-BLOCKSIZE)) - !HasSSE2());
 	return length % BLOCKSIZE;
 }
 
 size_t SHA224::HashMultipleBlocks(const word32 *input, size_t length)
 {
+#if CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE
+	if (HasSHA())
+	{
+		SHANI_SHA256_HashBlocks(m_state, input, length & (size_t(0)-BLOCKSIZE), BIG_ENDIAN_ORDER);
+		return length % BLOCKSIZE;
+	}
+#endif
 	X86_SHA256_HashBlocks(m_state, input, (length&(size_t(0)-BLOCKSIZE)) - !HasSSE2());
 	return length % BLOCKSIZE;
 }
@@ -487,6 +862,14 @@ size_t SHA224::HashMultipleBlocks(const word32 *input, size_t length)
 
 void SHA256::Transform(word32 *state, const word32 *data)
 {
+#if CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE
+	if (HasSHA())
+	{
+		SHANI_SHA256_HashBlocks(state, data, BLOCKSIZE, LITTLE_ENDIAN_ORDER);
+		return;
+	}
+#endif
+
 	word32 W[16];
 #if defined(CRYPTOPP_X86_ASM_AVAILABLE) || defined(CRYPTOPP_X64_MASM_AVAILABLE)
 	// this byte reverse is a waste of time, but this function is only called by MDC
@@ -591,6 +974,162 @@ void SHA256::Transform(word32 *state, const word32 *data)
 }
 */
 
+// *************************************************************
+
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+
+// same rounds as SHA256::Transform(), but on 4 independent states in the lanes of SSE2 registers
+static void SSE2_SHA256_Transform4(word32x4 *state, const word32x4 *data)
+{
+	word32x4 W[16];
+	word32x4 T[8];
+	unsigned int i;
+
+	for (i=0; i<8; i++)
+		T[i] = state[i];
+	for (unsigned int j=0; j<64; j+=16)
+	{
+		R( 0); R( 1); R( 2); R( 3);
+		R( 4); R( 5); R( 6); R( 7);
+		R( 8); R( 9); R(10); R(11);
+		R(12); R(13); R(14); R(15);
+	}
+	state[0] += a(0);
+	state[1] += b(0);
+	state[2] += c(0);
+	state[3] += d(0);
+	state[4] += e(0);
+	state[5] += f(0);
+	state[6] += g(0);
+	state[7] += h(0);
+}
+
+// load word i of blocks[j] into lane j of data[i], converting from big endian
+static void SSE2_SHA256_LoadBlocks(word32x4 *data, const byte * const *blocks)
+{
+	for (unsigned int i=0; i<16; i+=4)
+	{
+		__m128i b0 = _mm_loadu_si128((const __m128i *)(blocks[0]+4*i));
+		__m128i b1 = _mm_loadu_si128((const __m128i *)(blocks[1]+4*i));
+		__m128i b2 = _mm_loadu_si128((const __m128i *)(blocks[2]+4*i));
+		__m128i b3 = _mm_loadu_si128((const __m128i *)(blocks[3]+4*i));
+		__m128i t0 = _mm_unpacklo_epi32(b0, b1);
+		__m128i t1 = _mm_unpacklo_epi32(b2, b3);
+		__m128i t2 = _mm_unpackhi_epi32(b0, b1);
+		__m128i t3 = _mm_unpackhi_epi32(b2, b3);
+		b0 = _mm_unpacklo_epi64(t0, t1);
+		b1 = _mm_unpackhi_epi64(t0, t1);
+		b2 = _mm_unpacklo_epi64(t2, t3);
+		b3 = _mm_unpackhi_epi64(t2, t3);
+
+#define SSE2_BYTE_REVERSE_32(x)	\
+		x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(2,3,0,1)), _MM_SHUFFLE(2,3,0,1));	\
+		x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+
+		SSE2_BYTE_REVERSE_32(b0)
+		SSE2_BYTE_REVERSE_32(b1)
+		SSE2_BYTE_REVERSE_32(b2)
+		SSE2_BYTE_REVERSE_32(b3)
+#undef SSE2_BYTE_REVERSE_32
+
+		data[i] = b0;
+		data[i+1] = b1;
+		data[i+2] = b2;
+		data[i+3] = b3;
+	}
+}
+
+// 4 SHA-256 states for MultiBufferCalculateDigests(), m_state[4*i+j] is word i of the state in lane j
+class SSE2_SHA256_Lanes
+{
+public:
+	enum {LANES = 4, MAX_PADDING = 2*SHA256::BLOCKSIZE};
+
+	unsigned int BlockSize() const {return SHA256::BLOCKSIZE;}
+	unsigned int DigestSize() const {return SHA256::DIGESTSIZE;}
+	unsigned int PadLastBlocks(byte *pad, const byte *message, size_t length)
+		{return m_padding.PadLastBlocks(pad, message, length);}
+
+	void InitLane(unsigned int j)
+	{
+		word32 iv[8];
+		SHA256::InitState(iv);
+		for (unsigned int i=0; i<8; i++)
+			m_state[4*i+j] = iv[i];
+	}
+
+	void TransformLanes(const byte * const *blocks)
+	{
+		word32x4 data[16], x[8];
+		unsigned int i;
+		SSE2_SHA256_LoadBlocks(data, blocks);
+		for (i=0; i<8; i++)
+			x[i] = _mm_load_si128((const __m128i *)(m_state+4*i));
+		SSE2_SHA256_Transform4(x, data);
+		for (i=0; i<8; i++)
+			_mm_store_si128((__m128i *)(m_state+4*i), x[i].m_v);
+	}
+
+	void TransformLane(unsigned int j, const byte *block)
+	{
+		word32 s[8], W[16];
+		unsigned int i;
+		for (i=0; i<8; i++)
+			s[i] = m_state[4*i+j];
+		GetUserKey(BIG_ENDIAN_ORDER, W, 16, block, SHA256::BLOCKSIZE);
+		SHA256::Transform(s, W);
+		for (i=0; i<8; i++)
+			m_state[4*i+j] = s[i];
+	}
+
+	void GetDigest(unsigned int j, byte *digest) const
+	{
+		for (unsigned int i=0; i<8; i++)
+			PutWord(false, BIG_ENDIAN_ORDER, digest + 4*i, m_state[4*i+j]);
+	}
+
+private:
+	IteratedHashPadding<word32, BigEndian, SHA256::BLOCKSIZE> m_padding;
+	FixedSizeAlignedSecBlock<word32, 8*4> m_state;
+};
+
+// hashing one message at a time with the SHA extensions is several times faster than 4 SSE2 lanes
+static bool UseSSE2MultiBuffer(bool allowSHAExtensions)
+{
+#if CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE
+	if (allowSHAExtensions && HasSHA())
+		return false;
+#endif
+	return HasSSE2();
+}
+
+#endif
+
+unsigned int SHA256_MultiBuffer::Lanes(bool allowSHAExtensions)
+{
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+	if (UseSSE2MultiBuffer(allowSHAExtensions))
+		return 4;
+#endif
+	return 1;
+}
+
+void SHA256_MultiBuffer::CalculateDigests(byte *digests, const byte * const *messages, const size_t *lengths, size_t count, bool allowSHAExtensions)
+{
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+	if (UseSSE2MultiBuffer(allowSHAExtensions) && count > 1)
+	{
+		SSE2_SHA256_Lanes lanes;
+		MultiBufferCalculateDigests(lanes, digests, messages, lengths, count);
+		return;
+	}
+#endif
+
+	SHA256 sha;
+	for (size_t k=0; k<count; k++)
+		sha.CalculateDigest(digests + k*DIGESTSIZE, messages[k], lengths[k]);
+}
+
 #undef S0
 #undef S1
 #undef s0
@@ -9,6 +9,9 @@ NAMESPACE_BEGIN(CryptoPP)
 class CRYPTOPP_DLL SHA1 : public IteratedHashWithStaticTransform<word32, BigEndian, 64, 20, SHA1>
 {
 public:
+#if CRYPTOPP_BOOL_SHANI_INTRINSICS_AVAILABLE
+	size_t HashMultipleBlocks(const word32 *input, size_t length);
+#endif
 	static void CRYPTOPP_API InitState(HashWordType *state);
 	static void CRYPTOPP_API Transform(word32 *digest, const word32 *data);
 	static const char * CRYPTOPP_API StaticAlgorithmName() {return "SHA-1";}
@@ -28,6 +31,23 @@ public:
 	static const char * CRYPTOPP_API StaticAlgorithmName() {return "SHA-256";}
 };
 
+//! hashes many independent messages with SHA-256, several at a time in parallel SIMD lanes
+/*! Each lane runs its own message through the SHA-256 compression function, and a lane that
+	finishes is refilled with the next message, so this is fastest for many short messages of
+	similar length. The digests are identical to those of SHA256. */
+class CRYPTOPP_DLL SHA256_MultiBuffer
+{
+public:
+	CRYPTOPP_CONSTANT(DIGESTSIZE = SHA256::DIGESTSIZE)
+
+	//! number of messages that are hashed concurrently on this CPU
+	static unsigned int CRYPTOPP_API Lanes(bool allowSHAExtensions=true);
+	//! write the digest of messages[i], which is lengths[i] bytes long, to digests + i*DIGESTSIZE, for i < count
+	/*! On CPUs with the SHA extensions the messages are hashed one at a time with them, which is faster,
+		unless allowSHAExtensions is false. */
+	static void CRYPTOPP_API CalculateDigests(byte *digests, const byte * const *messages, const size_t *lengths, size_t count, bool allowSHAExtensions=true);
+};
+
 //! implements the SHA-224 standard
 class CRYPTOPP_DLL SHA224 : public IteratedHashWithStaticTransform<word32, BigEndian, 64, 32, SHA224, 28, true>
 {
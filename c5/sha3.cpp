@@ -16,6 +16,8 @@ http://creativecommons.org/publicdomain/zero/1.0/
 
 #include "pch.h"
 #include "sha3.h"
+#include "cpu.h"
+#include "multiblock.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -31,25 +33,31 @@ static const word64 KeccakF_RoundConstants[24] =
     W64LIT(0x8000000000008080), W64LIT(0x0000000080000001), W64LIT(0x8000000080008008)
 };
 
-static void KeccakF1600(word64 *state)
+// the permutation is a template so the same code can run on word64 or on several states in SIMD lanes,
+// and state holds the 25 lanes in native byte order
+template <class W>
+static inline void KeccakF1600_Template(W *state)
 {
     {
-        word64 Aba, Abe, Abi, Abo, Abu;
-        word64 Aga, Age, Agi, Ago, Agu;
-        word64 Aka, Ake, Aki, Ako, Aku;
-        word64 Ama, Ame, Ami, Amo, Amu;
-        word64 Asa, Ase, Asi, Aso, Asu;
-        word64 BCa, BCe, BCi, BCo, BCu;
-        word64 Da, De, Di, Do, Du;
-        word64 Eba, Ebe, Ebi, Ebo, Ebu;
-        word64 Ega, Ege, Egi, Ego, Egu;
-        word64 Eka, Eke, Eki, Eko, Eku;
-        word64 Ema, Eme, Emi, Emo, Emu;
-        word64 Esa, Ese, Esi, Eso, Esu;
+        W Aba, Abe, Abi, Abo, Abu;
+        W Aga, Age, Agi, Ago, Agu;
+        W Aka, Ake, Aki, Ako, Aku;
+        W Ama, Ame, Ami, Amo, Amu;
+        W Asa, Ase, Asi, Aso, Asu;
+        W BCa, BCe, BCi, BCo, BCu;
+        W Da, De, Di, Do, Du;
+        W Eba, Ebe, Ebi, Ebo, Ebu;
+        W Ega, Ege, Egi, Ego, Egu;
+        W Eka, Eke, Eki, Eko, Eku;
+        W Ema, Eme, Emi, Emo, Emu;
+        W Esa, Ese, Esi, Eso, Esu;
 
         //copyFromState(A, state)
-		typedef BlockGetAndPut<word64, LittleEndian, true, true> Block;
-		Block::Get(state)(Aba)(Abe)(Abi)(Abo)(Abu)(Aga)(Age)(Agi)(Ago)(Agu)(Aka)(Ake)(Aki)(Ako)(Aku)(Ama)(Ame)(Ami)(Amo)(Amu)(Asa)(Ase)(Asi)(Aso)(Asu);
+        Aba = state[ 0]; Abe = state[ 1]; Abi = state[ 2]; Abo = state[ 3]; Abu = state[ 4];
+        Aga = state[ 5]; Age = state[ 6]; Agi = state[ 7]; Ago = state[ 8]; Agu = state[ 9];
+        Aka = state[10]; Ake = state[11]; Aki = state[12]; Ako = state[13]; Aku = state[14];
+        Ama = state[15]; Ame = state[16]; Ami = state[17]; Amo = state[18]; Amu = state[19];
+        Asa = state[20]; Ase = state[21]; Asi = state[22]; Aso = state[23]; Asu = state[24];
 
         for( unsigned int round = 0; round < 24; round += 2 )
         {
@@ -78,7 +86,7 @@ static void KeccakF1600(word64 *state)
             Asu ^= Du;
             BCu = rotlFixed(Asu, 14);
             Eba =   BCa ^((~BCe)&  BCi );
-            Eba ^= (word64)KeccakF_RoundConstants[round];
+            Eba ^= W(KeccakF_RoundConstants[round]);
             Ebe =   BCe ^((~BCi)&  BCo );
             Ebi =   BCi ^((~BCo)&  BCu );
             Ebo =   BCo ^((~BCu)&  BCa );
@@ -173,7 +181,7 @@ static void KeccakF1600(word64 *state)
             Esu ^= Du;
             BCu = rotlFixed(Esu, 14);
             Aba =   BCa ^((~BCe)&  BCi );
-            Aba ^= (word64)KeccakF_RoundConstants[round+1];
+            Aba ^= W(KeccakF_RoundConstants[round+1]);
             Abe =   BCe ^((~BCi)&  BCo );
             Abi =   BCi ^((~BCo)&  BCu );
             Abo =   BCo ^((~BCu)&  BCa );
@@ -245,10 +253,21 @@ static void KeccakF1600(word64 *state)
         }
 
         //copyToState(state, A)
-		Block::Put(NULL, state)(Aba)(Abe)(Abi)(Abo)(Abu)(Aga)(Age)(Agi)(Ago)(Agu)(Aka)(Ake)(Aki)(Ako)(Aku)(Ama)(Ame)(Ami)(Amo)(Amu)(Asa)(Ase)(Asi)(Aso)(Asu);
+        state[ 0] = Aba; state[ 1] = Abe; state[ 2] = Abi; state[ 3] = Abo; state[ 4] = Abu;
+        state[ 5] = Aga; state[ 6] = Age; state[ 7] = Agi; state[ 8] = Ago; state[ 9] = Agu;
+        state[10] = Aka; state[11] = Ake; state[12] = Aki; state[13] = Ako; state[14] = Aku;
+        state[15] = Ama; state[16] = Ame; state[17] = Ami; state[18] = Amo; state[19] = Amu;
+        state[20] = Asa; state[21] = Ase; state[22] = Asi; state[23] = Aso; state[24] = Asu;
     }
 }
 
+static void KeccakF1600(word64 *state)
+{
+	ConditionalByteReverse(LITTLE_ENDIAN_ORDER, state, state, 200);
+	KeccakF1600_Template(state);
+	ConditionalByteReverse(LITTLE_ENDIAN_ORDER, state, state, 200);
+}
+
 void SHA3::Update(const byte *input, size_t length)
 {
 	size_t spaceLeft;
@@ -281,4 +300,106 @@ void SHA3::TruncatedFinal(byte *hash, size_t size)
 	Restart();
 }
 
+// *************************************************************
+
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+
+// 2 SHA-3 states for MultiBufferCalculateDigests(), m_state[2*i+j] is word i of the state in lane j, in native byte order
+class SSE2_SHA3_Lanes
+{
+public:
+	enum {LANES = 2, MAX_PADDING = 200};
+
+	SSE2_SHA3_Lanes(unsigned int digestSize) : m_digestSize(digestSize) {}
+	unsigned int BlockSize() const {return 200 - 2 * m_digestSize;}
+	unsigned int DigestSize() const {return m_digestSize;}
+
+	// the same padding SHA3::TruncatedFinal() applies to the state
+	unsigned int PadLastBlocks(byte *pad, const byte *message, size_t length) const
+	{
+		const unsigned int rate = BlockSize();
+		size_t tail = length % rate;
+		memset(pad, 0, rate);
+		if (tail)
+			memcpy(pad, message + length - tail, tail);
+		pad[tail] ^= 1;
+		pad[rate-1] ^= 0x80;
+		return 1;
+	}
+
+	void InitLane(unsigned int j)
+	{
+		for (unsigned int i=0; i<25; i++)
+			m_state[2*i+j] = 0;
+	}
+
+	void TransformLanes(const byte * const *blocks)
+	{
+		const unsigned int rate = BlockSize();
+		word64x2 A[25];
+		unsigned int i, j;
+		for (j=0; j<2; j++)
+			for (i=0; i<rate/8; i++)
+				m_state[2*i+j] ^= GetWord<word64>(false, LITTLE_ENDIAN_ORDER, blocks[j]+8*i);
+		for (i=0; i<25; i++)
+			A[i] = _mm_load_si128((const __m128i *)(m_state+2*i));
+		KeccakF1600_Template(A);
+		for (i=0; i<25; i++)
+			_mm_store_si128((__m128i *)(m_state+2*i), A[i].m_v);
+	}
+
+	void TransformLane(unsigned int j, const byte *block)
+	{
+		const unsigned int rate = BlockSize();
+		word64 s[25];
+		unsigned int i;
+		for (i=0; i<25; i++)
+			s[i] = m_state[2*i+j];
+		for (i=0; i<rate/8; i++)
+			s[i] ^= GetWord<word64>(false, LITTLE_ENDIAN_ORDER, block+8*i);
+		KeccakF1600_Template(s);
+		for (i=0; i<25; i++)
+			m_state[2*i+j] = s[i];
+	}
+
+	void GetDigest(unsigned int j, byte *digest) const
+	{
+		byte output[200];
+		for (unsigned int i=0; i<m_digestSize/8+1; i++)
+			PutWord(false, LITTLE_ENDIAN_ORDER, output+8*i, m_state[2*i+j]);
+		memcpy(digest, output, m_digestSize);
+	}
+
+private:
+	unsigned int m_digestSize;
+	FixedSizeAlignedSecBlock<word64, 25*2> m_state;
+};
+
+#endif
+
+unsigned int SHA3_MultiBuffer::Lanes()
+{
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+	if (HasSSE2())
+		return 2;
+#endif
+	return 1;
+}
+
+void SHA3_MultiBuffer::CalculateDigests(byte *digests, const byte * const *messages, const size_t *lengths, size_t count) const
+{
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+	if (HasSSE2() && count > 1)
+	{
+		SSE2_SHA3_Lanes lanes(m_digestSize);
+		MultiBufferCalculateDigests(lanes, digests, messages, lengths, count);
+		return;
+	}
+#endif
+
+	SHA3 sha3(m_digestSize);
+	for (size_t k=0; k<count; k++)
+		sha3.CalculateDigest(digests + k*m_digestSize, messages[k], lengths[k]);
+}
+
 NAMESPACE_END
@@ -1,65 +1,83 @@
-// sha3.h - written and placed in the public domain by Wei Dai
-
-#ifndef CRYPTOPP_SHA3_H
-#define CRYPTOPP_SHA3_H
-
-#include "cryptlib.h"
-#include "secblock.h"
-
-NAMESPACE_BEGIN(CryptoPP)
-
-/// <a href="http://en.wikipedia.org/wiki/SHA-3">SHA-3</a>
-class SHA3 : public HashTransformation
-{
-public:
-	SHA3(unsigned int digestSize) : m_digestSize(digestSize) {Restart();}
-	unsigned int DigestSize() const {return m_digestSize;}
-	std::string AlgorithmName() const {return "SHA-3-" + IntToString(m_digestSize*8);}
-	unsigned int OptimalDataAlignment() const {return GetAlignmentOf<word64>();}
-
-	void Update(const byte *input, size_t length);
-	void Restart();
-	void TruncatedFinal(byte *hash, size_t size);
-
-protected:
-	inline unsigned int r() const {return 200 - 2 * m_digestSize;}
-
-	FixedSizeSecBlock<word64, 25> m_state;
-	unsigned int m_digestSize, m_counter;
-};
-
-class SHA3_224 : public SHA3
-{
-public:
-	CRYPTOPP_CONSTANT(DIGESTSIZE = 28)
-	SHA3_224() : SHA3(DIGESTSIZE) {}
-	static const char * StaticAlgorithmName() {return "SHA-3-224";}
-};
-
-class SHA3_256 : public SHA3
-{
-public:
-	CRYPTOPP_CONSTANT(DIGESTSIZE = 32)
-	SHA3_256() : SHA3(DIGESTSIZE) {}
-	static const char * StaticAlgorithmName() {return "SHA-3-256";}
-};
-
-class SHA3_384 : public SHA3
-{
-public:
-	CRYPTOPP_CONSTANT(DIGESTSIZE = 48)
-	SHA3_384() : SHA3(DIGESTSIZE) {}
-	static const char * StaticAlgorithmName() {return "SHA-3-384";}
-};
-
-class SHA3_512 : public SHA3
-{
-public:
-	CRYPTOPP_CONSTANT(DIGESTSIZE = 64)
-	SHA3_512() : SHA3(DIGESTSIZE) {}
-	static const char * StaticAlgorithmName() {return "SHA-3-512";}
-};
-
-NAMESPACE_END
-
-#endif
+// sha3.h - written and placed in the public domain by Wei Dai
+
+#ifndef CRYPTOPP_SHA3_H
+#define CRYPTOPP_SHA3_H
+
+#include "cryptlib.h"
+#include "secblock.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+/// <a href="http://en.wikipedia.org/wiki/SHA-3">SHA-3</a>
+class SHA3 : public HashTransformation
+{
+public:
+	SHA3(unsigned int digestSize) : m_digestSize(digestSize) {Restart();}
+	unsigned int DigestSize() const {return m_digestSize;}
+	std::string AlgorithmName() const {return "SHA-3-" + IntToString(m_digestSize*8);}
+	unsigned int OptimalDataAlignment() const {return GetAlignmentOf<word64>();}
+
+	void Update(const byte *input, size_t length);
+	void Restart();
+	void TruncatedFinal(byte *hash, size_t size);
+
+protected:
+	inline unsigned int r() const {return 200 - 2 * m_digestSize;}
+
+	FixedSizeSecBlock<word64, 25> m_state;
+	unsigned int m_digestSize, m_counter;
+};
+
+//! hashes many independent messages with SHA-3 at once, several states in the lanes of SSE2 registers
+/*! A lane that finishes its message is refilled with the next one, so this is fastest for many
+	short messages, such as the leaves of a hash tree. The digests are identical to those of SHA3. */
+class SHA3_MultiBuffer
+{
+public:
+	SHA3_MultiBuffer(unsigned int digestSize) : m_digestSize(digestSize) {}
+	unsigned int DigestSize() const {return m_digestSize;}
+
+	//! number of messages that are hashed concurrently on this CPU
+	static unsigned int Lanes();
+	//! write the digest of messages[i], which is lengths[i] bytes long, to digests + i*DigestSize(), for i < count
+	void CalculateDigests(byte *digests, const byte * const *messages, const size_t *lengths, size_t count) const;
+
+protected:
+	unsigned int m_digestSize;
+};
+
+class SHA3_224 : public SHA3
+{
+public:
+	CRYPTOPP_CONSTANT(DIGESTSIZE = 28)
+	SHA3_224() : SHA3(DIGESTSIZE) {}
+	static const char * StaticAlgorithmName() {return "SHA-3-224";}
+};
+
+class SHA3_256 : public SHA3
+{
+public:
+	CRYPTOPP_CONSTANT(DIGESTSIZE = 32)
+	SHA3_256() : SHA3(DIGESTSIZE) {}
+	static const char * StaticAlgorithmName() {return "SHA-3-256";}
+};
+
+class SHA3_384 : public SHA3
+{
+public:
+	CRYPTOPP_CONSTANT(DIGESTSIZE = 48)
+	SHA3_384() : SHA3(DIGESTSIZE) {}
+	static const char * StaticAlgorithmName() {return "SHA-3-384";}
+};
+
+class SHA3_512 : public SHA3
+{
+public:
+	CRYPTOPP_CONSTANT(DIGESTSIZE = 64)
+	SHA3_512() : SHA3(DIGESTSIZE) {}
+	static const char * StaticAlgorithmName() {return "SHA-3-512";}
+};
+
+NAMESPACE_END
+
+#endif
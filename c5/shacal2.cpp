@@ -8,6 +8,7 @@
 #include "pch.h"
 #include "shacal2.h"
 #include "misc.h"
+#include "multiblock.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -52,16 +53,10 @@ void SHACAL2::Base::UncheckedSetKey(const byte *userKey, unsigned int keylen, co
 
 typedef BlockGetAndPut<word32, BigEndian> Block;
 
-void SHACAL2::Enc::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const
+// the rounds are written as templates so the same code can run on word32 or on 4 SSE2 lanes
+template <class T>
+inline void SHACAL2_EncryptRounds(T &a, T &b, T &c, T &d, T &e, T &f, T &g, T &h, const word32 *rk)
 {
-	word32 a, b, c, d, e, f, g, h;
-	const word32 *rk = m_key;
-
-	/*
-	 * map byte array block to cipher state:
-	 */
-	Block::Get(inBlock)(a)(b)(c)(d)(e)(f)(g)(h);
-
 	// Perform SHA-256 transformation.
 
 	/* 64 operations, partially loop unrolled */
@@ -76,23 +71,12 @@ void SHACAL2::Enc::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock,
 		R(c,d,e,f,g,h,a,b,rk);
 		R(b,c,d,e,f,g,h,a,rk);
 	}
-
-	/*
-	 * map cipher state to byte array block:
-	 */
-
-	Block::Put(xorBlock, outBlock)(a)(b)(c)(d)(e)(f)(g)(h);
 }
 
-void SHACAL2::Dec::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const
+template <class T>
+inline void SHACAL2_DecryptRounds(T &a, T &b, T &c, T &d, T &e, T &f, T &g, T &h, const word32 *rk)
 {
-	word32 a, b, c, d, e, f, g, h;
-	const word32 *rk = m_key + 64;
-
-	/*
-	 * map byte array block to cipher state:
-	 */
-	Block::Get(inBlock)(a)(b)(c)(d)(e)(f)(g)(h);
+	rk += 64;
 
 	// Perform inverse SHA-256 transformation.
 
@@ -108,6 +92,18 @@ void SHACAL2::Dec::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock,
 		P(h,a,b,c,d,e,f,g,rk);
 		P(a,b,c,d,e,f,g,h,rk);
 	}
+}
+
+void SHACAL2::Enc::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const
+{
+	word32 a, b, c, d, e, f, g, h;
+
+	/*
+	 * map byte array block to cipher state:
+	 */
+	Block::Get(inBlock)(a)(b)(c)(d)(e)(f)(g)(h);
+
+	SHACAL2_EncryptRounds(a, b, c, d, e, f, g, h, m_key);
 
 	/*
 	 * map cipher state to byte array block:
@@ -116,6 +112,80 @@ void SHACAL2::Dec::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock,
 	Block::Put(xorBlock, outBlock)(a)(b)(c)(d)(e)(f)(g)(h);
 }
 
+void SHACAL2::Dec::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const
+{
+	word32 a, b, c, d, e, f, g, h;
+
+	/*
+	 * map byte array block to cipher state:
+	 */
+	Block::Get(inBlock)(a)(b)(c)(d)(e)(f)(g)(h);
+
+	SHACAL2_DecryptRounds(a, b, c, d, e, f, g, h, m_key);
+
+	/*
+	 * map cipher state to byte array block:
+	 */
+
+	Block::Put(xorBlock, outBlock)(a)(b)(c)(d)(e)(f)(g)(h);
+}
+
+#if CRYPTOPP_BOOL_SSE2_INTRINSICS_AVAILABLE
+
+#define SHACAL2_LOAD_LANES(x, i)	word32x4 x = word32x4::LoadLanes<BigEndian>(inBlocks, 32, i);
+#define SHACAL2_STORE_LANES(x, i)	x.StoreLanes<BigEndian>(outBlocks, 32, i);
+
+void SHACAL2::Enc::SSE2_Process4Blocks(const byte *inBlocks, byte *outBlocks) const
+{
+	SHACAL2_LOAD_LANES(a, 0) SHACAL2_LOAD_LANES(b, 1) SHACAL2_LOAD_LANES(c, 2) SHACAL2_LOAD_LANES(d, 3)
+	SHACAL2_LOAD_LANES(e, 4) SHACAL2_LOAD_LANES(f, 5) SHACAL2_LOAD_LANES(g, 6) SHACAL2_LOAD_LANES(h, 7)
+
+	SHACAL2_EncryptRounds(a, b, c, d, e, f, g, h, m_key);
+
+	SHACAL2_STORE_LANES(a, 0) SHACAL2_STORE_LANES(b, 1) SHACAL2_STORE_LANES(c, 2) SHACAL2_STORE_LANES(d, 3)
+	SHACAL2_STORE_LANES(e, 4) SHACAL2_STORE_LANES(f, 5) SHACAL2_STORE_LANES(g, 6) SHACAL2_STORE_LANES(h, 7)
+}
+
+void SHACAL2::Dec::SSE2_Process4Blocks(const byte *inBlocks, byte *outBlocks) const
+{
+	SHACAL2_LOAD_LANES(a, 0) SHACAL2_LOAD_LANES(b, 1) SHACAL2_LOAD_LANES(c, 2) SHACAL2_LOAD_LANES(d, 3)
+	SHACAL2_LOAD_LANES(e, 4) SHACAL2_LOAD_LANES(f, 5) SHACAL2_LOAD_LANES(g, 6) SHACAL2_LOAD_LANES(h, 7)
+
+	SHACAL2_DecryptRounds(a, b, c, d, e, f, g, h, m_key);
+
+	SHACAL2_STORE_LANES(a, 0) SHACAL2_STORE_LANES(b, 1) SHACAL2_STORE_LANES(c, 2) SHACAL2_STORE_LANES(d, 3)
+	SHACAL2_STORE_LANES(e, 4) SHACAL2_STORE_LANES(f, 5) SHACAL2_STORE_LANES(g, 6) SHACAL2_STORE_LANES(h, 7)
+}
+
+#undef SHACAL2_LOAD_LANES
+#undef SHACAL2_STORE_LANES
+
+unsigned int SHACAL2::Enc::OptimalNumberOfParallelBlocks() const
+{
+	return HasSSE2() ? 4 : 1;
+}
+
+size_t SHACAL2::Enc::AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const
+{
+	if (HasSSE2())
+		return AdvancedProcessBlocksInParallel<4, BLOCKSIZE>(*this, &Enc::SSE2_Process4Blocks, inBlocks, xorBlocks, outBlocks, length, flags);
+	return BlockTransformation::AdvancedProcessBlocks(inBlocks, xorBlocks, outBlocks, length, flags);
+}
+
+unsigned int SHACAL2::Dec::OptimalNumberOfParallelBlocks() const
+{
+	return HasSSE2() ? 4 : 1;
+}
+
+size_t SHACAL2::Dec::AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const
+{
+	if (HasSSE2())
+		return AdvancedProcessBlocksInParallel<4, BLOCKSIZE>(*this, &Dec::SSE2_Process4Blocks, inBlocks, xorBlocks, outBlocks, length, flags);
+	return BlockTransformation::AdvancedProcessBlocks(inBlocks, xorBlocks, outBlocks, length, flags);
+}
+
+#endif
+
 // The SHACAL-2 round constants are identical to the SHA-256 round constants.
 const word32 SHACAL2::Base::K[64] =
 {
@@ -0,0 +1,269 @@
+// taskexec.cpp - written and placed in the public domain
+
+#include "pch.h"
+
+#ifndef CRYPTOPP_IMPORTS
+
+#include "taskexec.h"
+
+#ifdef CRYPTOPP_THREAD_POOL_AVAILABLE
+#ifdef HAS_WINTHREADS
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#include <vector>
+#endif
+
+NAMESPACE_BEGIN(CryptoPP)
+
+void SerialTaskExecutor::Run(Task task, void *context, size_t count) const
+{
+	for (size_t i=0; i<count; i++)
+		task(context, i);
+}
+
+#ifdef CRYPTOPP_THREAD_POOL_AVAILABLE
+
+// a call to Run() in progress
+struct TaskExecutorJob
+{
+	TaskExecutor::Task task;
+	void *context;
+	size_t count, next, finished, failedIndex;
+	bool failed;
+	TaskExecutorJob *link;
+};
+
+struct ThreadPoolTaskExecutor::State
+{
+	State() : queue(NULL), stop(false)
+	{
+#ifdef HAS_WINTHREADS
+		InitializeCriticalSection(&mutex);
+		InitializeConditionVariable(&workAvailable);
+		InitializeConditionVariable(&jobFinished);
+#else
+		pthread_mutex_init(&mutex, NULL);
+		pthread_cond_init(&workAvailable, NULL);
+		pthread_cond_init(&jobFinished, NULL);
+#endif
+	}
+
+	~State()
+	{
+#ifdef HAS_WINTHREADS
+		DeleteCriticalSection(&mutex);
+#else
+		pthread_cond_destroy(&jobFinished);
+		pthread_cond_destroy(&workAvailable);
+		pthread_mutex_destroy(&mutex);
+#endif
+	}
+
+#ifdef HAS_WINTHREADS
+	void Lock() {EnterCriticalSection(&mutex);}
+	void Unlock() {LeaveCriticalSection(&mutex);}
+	void Wait(CONDITION_VARIABLE &c) {SleepConditionVariableCS(&c, &mutex, INFINITE);}
+	void Broadcast(CONDITION_VARIABLE &c) {WakeAllConditionVariable(&c);}
+#else
+	void Lock() {pthread_mutex_lock(&mutex);}
+	void Unlock() {pthread_mutex_unlock(&mutex);}
+	void Wait(pthread_cond_t &c) {pthread_cond_wait(&c, &mutex);}
+	void Broadcast(pthread_cond_t &c) {pthread_cond_broadcast(&c);}
+#endif
+
+	// hand out the next task of job, and take job off the queue once all of its tasks have been handed out
+	// the mutex must be held
+	size_t TakeTask(TaskExecutorJob &job)
+	{
+		assert(job.next < job.count);
+		size_t i = job.next++;
+		if (job.next == job.count)
+		{
+			TaskExecutorJob **p = &queue;
+			while (*p != &job)
+				p = &(*p)->link;
+			*p = job.link;
+		}
+		return i;
+	}
+
+	// run a task that has been handed out, with the mutex held on entry and exit
+	// once a task of the job has failed, the rest are skipped
+	void RunTask(TaskExecutorJob &job, size_t i)
+	{
+		if (!job.failed)
+		{
+			bool failed = false;
+			Unlock();
+			try
+			{
+				job.task(job.context, i);
+			}
+			catch (...)
+			{
+				failed = true;
+			}
+			Lock();
+			if (failed && !job.failed)
+			{
+				job.failed = true;
+				job.failedIndex = i;
+			}
+		}
+		if (++job.finished == job.count)
+			Broadcast(jobFinished);
+	}
+
+	void WorkerLoop()
+	{
+		Lock();
+		while (true)
+		{
+			while (!stop && !queue)
+				Wait(workAvailable);
+			if (stop)
+				break;
+			// the newest job first, so that jobs started by tasks finish before the tasks waiting for them
+			TaskExecutorJob &job = *queue;
+			RunTask(job, TakeTask(job));
+		}
+		Unlock();
+	}
+
+#ifdef HAS_WINTHREADS
+	static unsigned int __stdcall ThreadProc(void *state)
+		{static_cast<State *>(state)->WorkerLoop(); return 0;}
+
+	CRITICAL_SECTION mutex;
+	CONDITION_VARIABLE workAvailable, jobFinished;
+	std::vector<HANDLE> threads;
+#else
+	static void * ThreadProc(void *state)
+		{static_cast<State *>(state)->WorkerLoop(); return NULL;}
+
+	pthread_mutex_t mutex;
+	pthread_cond_t workAvailable, jobFinished;
+	std::vector<pthread_t> threads;
+#endif
+
+	TaskExecutorJob *queue;
+	bool stop;
+};
+
+static unsigned int GetProcessorCount()
+{
+#ifdef HAS_WINTHREADS
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	long n = info.dwNumberOfProcessors;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return n > 1 ? (unsigned int)n : 1;
+}
+
+ThreadPoolTaskExecutor::ThreadPoolTaskExecutor(unsigned int workerCount)
+	: m_state(new State), m_workerCount(workerCount ? workerCount : GetProcessorCount()-1)
+{
+	for (unsigned int i=0; i<m_workerCount; i++)
+	{
+#ifdef HAS_WINTHREADS
+		HANDLE thread = (HANDLE)_beginthreadex(NULL, 0, &State::ThreadProc, m_state, 0, NULL);
+		if (!thread)
+		{
+			m_workerCount = i;
+			break;
+		}
+#else
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, &State::ThreadProc, m_state) != 0)
+		{
+			m_workerCount = i;
+			break;
+		}
+#endif
+		m_state->threads.push_back(thread);
+	}
+}
+
+ThreadPoolTaskExecutor::~ThreadPoolTaskExecutor()
+{
+	Shutdown();
+	delete m_state;
+}
+
+void ThreadPoolTaskExecutor::Shutdown()
+{
+	m_state->Lock();
+	m_state->stop = true;
+	m_state->Broadcast(m_state->workAvailable);
+	m_state->Unlock();
+
+	for (size_t i=0; i<m_state->threads.size(); i++)
+	{
+#ifdef HAS_WINTHREADS
+		WaitForSingleObject(m_state->threads[i], INFINITE);
+		CloseHandle(m_state->threads[i]);
+#else
+		pthread_join(m_state->threads[i], NULL);
+#endif
+	}
+
+	m_state->threads.clear();
+	m_workerCount = 0;
+}
+
+void ThreadPoolTaskExecutor::Run(Task task, void *context, size_t count) const
+{
+	if (m_workerCount == 0 || count < 2)
+	{
+		SerialTaskExecutor().Run(task, context, count);
+		return;
+	}
+
+	TaskExecutorJob job = {task, context, count, 0, 0, 0, false, NULL};
+	State &state = *m_state;
+
+	state.Lock();
+	job.link = state.queue;
+	state.queue = &job;
+	state.Broadcast(state.workAvailable);
+
+	// the calling thread works on its own job until all of the tasks are handed out, so nested calls can't deadlock
+	while (job.next < job.count)
+		state.RunTask(job, state.TakeTask(job));
+	while (job.finished < job.count)
+		state.Wait(state.jobFinished);
+	state.Unlock();
+
+	// there's no portable way to carry an exception over from another thread, so let the task throw it again here
+	if (job.failed)
+	{
+		task(context, job.failedIndex);
+		throw Err("a task threw an exception on another thread but not on the calling one");
+	}
+}
+
+#endif	// #ifdef CRYPTOPP_THREAD_POOL_AVAILABLE
+
+static const TaskExecutor *s_defaultTaskExecutor = NULL;
+
+const TaskExecutor & CRYPTOPP_API GetDefaultTaskExecutor()
+{
+	if (s_defaultTaskExecutor)
+		return *s_defaultTaskExecutor;
+	return Singleton<SerialTaskExecutor>().Ref();
+}
+
+void CRYPTOPP_API SetDefaultTaskExecutor(const TaskExecutor *executor)
+{
+	s_defaultTaskExecutor = executor;
+}
+
+NAMESPACE_END
+
+#endif
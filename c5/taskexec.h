@@ -0,0 +1,96 @@
+#ifndef CRYPTOPP_TASKEXEC_H
+#define CRYPTOPP_TASKEXEC_H
+
+/** \file
+	This file contains the interface the library uses to run independent parts of a computation
+	in parallel, such as the two halves of an RSA private key operation, and its implementations.
+*/
+
+#include "cryptlib.h"
+#include "misc.h"
+
+#if defined(HAS_PTHREADS) || (defined(HAS_WINTHREADS) && defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0600)
+#	define CRYPTOPP_THREAD_POOL_AVAILABLE
+#endif
+
+NAMESPACE_BEGIN(CryptoPP)
+
+//! interface for running a set of independent tasks
+class CRYPTOPP_DLL CRYPTOPP_NO_VTABLE TaskExecutor
+{
+public:
+	typedef void (* Task)(void *context, size_t index);
+
+	//! thrown by Run() when a task threw an exception on another thread but not when it was called again
+	class Err : public Exception
+	{
+	public:
+		Err(const std::string &s) : Exception(OTHER_ERROR, "TaskExecutor: " + s) {}
+	};
+
+	virtual ~TaskExecutor() {}
+
+	//! call task(context, i) for each i in [0, count), and return when all of the calls have returned
+	/*! The calls may be made in any order and concurrently from different threads, including the calling one.
+		Tasks may call Run() themselves. If a task throws an exception, the tasks that haven't been started
+		are skipped, and once the others are finished Run() calls the task that threw again on the calling
+		thread, so that its exception reaches the caller. Tasks that can throw must allow for that second call. */
+	virtual void Run(Task task, void *context, size_t count) const =0;
+
+	//! returns how many tasks Run() can work on at the same time
+	/*! callers that can choose how much work to hand over at once, such as prime generation, use this to size it */
+	virtual unsigned int GetConcurrency() const {return 1;}
+};
+
+//! runs the tasks one after another on the calling thread
+class CRYPTOPP_DLL SerialTaskExecutor : public TaskExecutor
+{
+public:
+	void Run(Task task, void *context, size_t count) const;
+};
+
+#ifdef CRYPTOPP_THREAD_POOL_AVAILABLE
+
+//! runs the tasks on a persistent set of worker threads, which the threads calling Run() join in on
+/*! The workers take tasks from a single queue guarded by one mutex, rather than stealing from queues of
+	their own. The library hands over a few coarse tasks at a time, such as the two halves of an RSA private
+	key operation or a batch of prime candidates, so the lock is taken rarely. Call Shutdown() before the
+	pool is destroyed during process or DLL exit, since joining threads from a static destructor or DllMain()
+	can deadlock on Windows. */
+class CRYPTOPP_DLL ThreadPoolTaskExecutor : public TaskExecutor, public NotCopyable
+{
+public:
+	//! start workerCount threads, or one less than the number of processors if workerCount is 0
+	ThreadPoolTaskExecutor(unsigned int workerCount = 0);
+	~ThreadPoolTaskExecutor();
+
+	//! stop the worker threads and wait for them to exit, after which Run() calls the tasks on the calling thread
+	/*! this must not be called while Run() is in progress, and is called by the destructor if it hasn't been */
+	void Shutdown();
+
+	unsigned int GetWorkerCount() const {return m_workerCount;}
+	unsigned int GetConcurrency() const {return m_workerCount+1;}
+
+	void Run(Task task, void *context, size_t count) const;
+
+private:
+	struct State;
+	State *m_state;
+	unsigned int m_workerCount;
+};
+
+#endif
+
+//! returns the executor the library runs its parallel work on
+/*! This is a SerialTaskExecutor unless SetDefaultTaskExecutor() has been called. The library doesn't start
+	a thread pool of its own, since it would have to join the workers during static destruction, so
+	applications that want parallel work create a ThreadPoolTaskExecutor, pass it to SetDefaultTaskExecutor(), and shut it down
+	before exit. */
+CRYPTOPP_DLL const TaskExecutor & CRYPTOPP_API GetDefaultTaskExecutor();
+//! make the library run its parallel work on executor, or on the default one again if executor is NULL
+/*! executor must stay valid until it's replaced, and this must not be called while the library is using the previous one */
+CRYPTOPP_DLL void CRYPTOPP_API SetDefaultTaskExecutor(const TaskExecutor *executor);
+
+NAMESPACE_END
+
+#endif
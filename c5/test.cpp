@@ -841,6 +841,10 @@ bool Validate(int alg, bool thorough, const char *seedInput)
 	case 67: result = ValidateCCM(); break;
 	case 68: result = ValidateGCM(); break;
 	case 69: result = ValidateCMAC(); break;
+	case 70: result = ValidateSHA3(); break;
+	case 71: result = ValidateCRC32C(); break;
+	case 72: result = ValidateX25519(); break;
+	case 73: result = ValidateEd25519(); break;
 	default: return false;
 	}
 
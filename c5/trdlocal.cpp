@@ -67,6 +67,55 @@ void *ThreadLocalStorage::GetValue() const
 	return result;
 }
 
+Mutex::Err::Err(const std::string& operation, int error)
+	: OS_Error(OTHER_ERROR, "Mutex: " + operation + " operation failed with error 0x" + IntToString(error, 16), operation, error)
+{
+}
+
+Mutex::Mutex()
+{
+#ifdef HAS_WINTHREADS
+	CRITICAL_SECTION *cs = new CRITICAL_SECTION;
+	InitializeCriticalSection(cs);
+	m_criticalSection = cs;
+#else
+	int error = pthread_mutex_init(&m_mutex, NULL);
+	if (error)
+		throw Err("pthread_mutex_init", error);
+#endif
+}
+
+Mutex::~Mutex()
+{
+#ifdef HAS_WINTHREADS
+	CRITICAL_SECTION *cs = (CRITICAL_SECTION *)m_criticalSection;
+	DeleteCriticalSection(cs);
+	delete cs;
+#else
+	pthread_mutex_destroy(&m_mutex);
+#endif
+}
+
+void Mutex::Lock()
+{
+#ifdef HAS_WINTHREADS
+	EnterCriticalSection((CRITICAL_SECTION *)m_criticalSection);
+#else
+	int error = pthread_mutex_lock(&m_mutex);
+	if (error)
+		throw Err("pthread_mutex_lock", error);
+#endif
+}
+
+void Mutex::Unlock()
+{
+#ifdef HAS_WINTHREADS
+	LeaveCriticalSection((CRITICAL_SECTION *)m_criticalSection);
+#else
+	pthread_mutex_unlock(&m_mutex);
+#endif
+}
+
 NAMESPACE_END
 
 #endif	// #ifdef THREADS_AVAILABLE
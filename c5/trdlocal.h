@@ -37,8 +37,64 @@ private:
 	ThreadLocalIndexType m_index;
 };
 
+//! mutual exclusion lock, for data shared between threads such as a cache kept by a const object
+class CRYPTOPP_DLL Mutex : public NotCopyable
+{
+public:
+	//! exception thrown by Mutex class
+	class Err : public OS_Error
+	{
+	public:
+		Err(const std::string& operation, int error);
+	};
+
+	Mutex();
+	~Mutex();
+
+	void Lock();
+	void Unlock();
+
+private:
+#ifdef HAS_WINTHREADS
+	void *m_criticalSection;
+#else
+	pthread_mutex_t m_mutex;
+#endif
+};
+
+NAMESPACE_END
+
+#else	// #ifdef THREADS_AVAILABLE
+
+#include "misc.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+
+// without threads there's nothing to exclude
+class Mutex : public NotCopyable
+{
+public:
+	void Lock() {}
+	void Unlock() {}
+};
+
 NAMESPACE_END
 
 #endif	// #ifdef THREADS_AVAILABLE
 
+NAMESPACE_BEGIN(CryptoPP)
+
+//! holds a Mutex locked for as long as it's in scope
+class MutexLock : public NotCopyable
+{
+public:
+	MutexLock(Mutex &mutex) : m_mutex(mutex) {m_mutex.Lock();}
+	~MutexLock() {m_mutex.Unlock();}
+
+private:
+	Mutex &m_mutex;
+};
+
+NAMESPACE_END
+
 #endif
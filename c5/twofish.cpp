@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "twofish.h"
 #include "misc.h"
+#include "multiblock.h"
 
 NAMESPACE_BEGIN(CryptoPP)
 
@@ -105,6 +106,43 @@ void Twofish::Base::UncheckedSetKey(const byte *userKey, unsigned int keylength,
 	DECROUND (2 * (n) + 1, c, d, a, b); \
 	DECROUND (2 * (n), a, b, c, d)
 
+// the table lookups in G1 and G2 form long dependency chains, so two blocks are
+// interleaved to give the processor independent work while it waits on them
+
+#define ENCROUND_2(n, a, b, c, d, a2, b2, c2, d2) \
+	x = G1 (a); y = G2 (b); \
+	x2 = G1 (a2); y2 = G2 (b2); \
+	x += y; y += x + k[2 * (n) + 1]; \
+	x2 += y2; y2 += x2 + k[2 * (n) + 1]; \
+	(c) ^= x + k[2 * (n)]; \
+	(c2) ^= x2 + k[2 * (n)]; \
+	(c) = rotrFixed(c, 1); \
+	(c2) = rotrFixed(c2, 1); \
+	(d) = rotlFixed(d, 1) ^ y; \
+	(d2) = rotlFixed(d2, 1) ^ y2
+
+#define ENCCYCLE_2(n) \
+	ENCROUND_2 (2 * (n), a, b, c, d, a2, b2, c2, d2); \
+	ENCROUND_2 (2 * (n) + 1, c, d, a, b, c2, d2, a2, b2)
+
+#define DECROUND_2(n, a, b, c, d, a2, b2, c2, d2) \
+	x = G1 (a); y = G2 (b); \
+	x2 = G1 (a2); y2 = G2 (b2); \
+	x += y; y += x; \
+	x2 += y2; y2 += x2; \
+	(d) ^= y + k[2 * (n) + 1]; \
+	(d2) ^= y2 + k[2 * (n) + 1]; \
+	(d) = rotrFixed(d, 1); \
+	(d2) = rotrFixed(d2, 1); \
+	(c) = rotlFixed(c, 1); \
+	(c2) = rotlFixed(c2, 1); \
+	(c) ^= (x + k[2 * (n)]); \
+	(c2) ^= (x2 + k[2 * (n)])
+
+#define DECCYCLE_2(n) \
+	DECROUND_2 (2 * (n) + 1, c, d, a, b, c2, d2, a2, b2); \
+	DECROUND_2 (2 * (n), a, b, c, d, a2, b2, c2, d2)
+
 typedef BlockGetAndPut<word32, LittleEndian> Block;
 
 void Twofish::Enc::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const
@@ -165,4 +203,72 @@ void Twofish::Dec::ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock,
 	Block::Put(xorBlock, outBlock)(a)(b)(c)(d);
 }
 
+void Twofish::Enc::Process2Blocks(const byte *inBlocks, byte *outBlocks) const
+{
+	word32 x, y, a, b, c, d, x2, y2, a2, b2, c2, d2;
+
+	Block::Get(inBlocks)(a)(b)(c)(d)(a2)(b2)(c2)(d2);
+
+	a ^= m_k[0]; a2 ^= m_k[0];
+	b ^= m_k[1]; b2 ^= m_k[1];
+	c ^= m_k[2]; c2 ^= m_k[2];
+	d ^= m_k[3]; d2 ^= m_k[3];
+
+	const word32 *k = m_k+8;
+	ENCCYCLE_2 (0);
+	ENCCYCLE_2 (1);
+	ENCCYCLE_2 (2);
+	ENCCYCLE_2 (3);
+	ENCCYCLE_2 (4);
+	ENCCYCLE_2 (5);
+	ENCCYCLE_2 (6);
+	ENCCYCLE_2 (7);
+
+	c ^= m_k[4]; c2 ^= m_k[4];
+	d ^= m_k[5]; d2 ^= m_k[5];
+	a ^= m_k[6]; a2 ^= m_k[6];
+	b ^= m_k[7]; b2 ^= m_k[7];
+
+	Block::Put(NULL, outBlocks)(c)(d)(a)(b)(c2)(d2)(a2)(b2);
+}
+
+size_t Twofish::Enc::AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const
+{
+	return AdvancedProcessBlocksInParallel<2, BLOCKSIZE>(*this, &Enc::Process2Blocks, inBlocks, xorBlocks, outBlocks, length, flags);
+}
+
+void Twofish::Dec::Process2Blocks(const byte *inBlocks, byte *outBlocks) const
+{
+	word32 x, y, a, b, c, d, x2, y2, a2, b2, c2, d2;
+
+	Block::Get(inBlocks)(c)(d)(a)(b)(c2)(d2)(a2)(b2);
+
+	c ^= m_k[4]; c2 ^= m_k[4];
+	d ^= m_k[5]; d2 ^= m_k[5];
+	a ^= m_k[6]; a2 ^= m_k[6];
+	b ^= m_k[7]; b2 ^= m_k[7];
+
+	const word32 *k = m_k+8;
+	DECCYCLE_2 (7);
+	DECCYCLE_2 (6);
+	DECCYCLE_2 (5);
+	DECCYCLE_2 (4);
+	DECCYCLE_2 (3);
+	DECCYCLE_2 (2);
+	DECCYCLE_2 (1);
+	DECCYCLE_2 (0);
+
+	a ^= m_k[0]; a2 ^= m_k[0];
+	b ^= m_k[1]; b2 ^= m_k[1];
+	c ^= m_k[2]; c2 ^= m_k[2];
+	d ^= m_k[3]; d2 ^= m_k[3];
+
+	Block::Put(NULL, outBlocks)(a)(b)(c)(d)(a2)(b2)(c2)(d2);
+}
+
+size_t Twofish::Dec::AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const
+{
+	return AdvancedProcessBlocksInParallel<2, BLOCKSIZE>(*this, &Dec::Process2Blocks, inBlocks, xorBlocks, outBlocks, length, flags);
+}
+
 NAMESPACE_END
@@ -38,12 +38,22 @@ class Twofish : public Twofish_Info, public BlockCipherDocumentation
 	{
 	public:
 		void ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const;
+		unsigned int OptimalNumberOfParallelBlocks() const {return 2;}
+		size_t AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const;
+
+	private:
+		void Process2Blocks(const byte *inBlocks, byte *outBlocks) const;
 	};
 
 	class CRYPTOPP_NO_VTABLE Dec : public Base
 	{
 	public:
 		void ProcessAndXorBlock(const byte *inBlock, const byte *xorBlock, byte *outBlock) const;
+		unsigned int OptimalNumberOfParallelBlocks() const {return 2;}
+		size_t AdvancedProcessBlocks(const byte *inBlocks, const byte *xorBlocks, byte *outBlocks, size_t length, word32 flags) const;
+
+	private:
+		void Process2Blocks(const byte *inBlocks, byte *outBlocks) const;
 	};
 
 public:
@@ -31,9 +31,14 @@
 #include "skipjack.h"
 #include "shacal2.h"
 #include "camellia.h"
+#include "gcm.h"
 #include "osrng.h"
 #include "zdeflate.h"
 #include "cpu.h"
+#include "taskexec.h"
+#include "nbtheory.h"
+#include "gf2n.h"
+#include "modarith.h"
 
 #include <time.h>
 #include <memory>
@@ -49,13 +54,19 @@ bool ValidateAll(bool thorough)
 {
 	bool pass=TestSettings();
 	pass=TestOS_RNG() && pass;
+	pass=TestTaskExecutor() && pass;
+	pass=TestIntegerStorage() && pass;
+	pass=TestIntegerMultiply() && pass;
+	pass=TestModularExponentiation() && pass;
+	pass=TestPrimeSearch() && pass;
 
 	pass=ValidateCRC32() && pass;
+	pass=ValidateCRC32C() && pass;
 	pass=ValidateAdler32() && pass;
 	pass=ValidateMD2() && pass;
 	pass=ValidateMD5() && pass;
 	pass=ValidateSHA() && pass;
-	pass=RunTestDataFile("TestVectors/sha3.txt") && pass;
+	pass=ValidateSHA3() && pass;
 	pass=ValidateTiger() && pass;
 	pass=ValidateRIPEMD() && pass;
 	pass=ValidatePanama() && pass;
@@ -116,6 +127,8 @@ bool ValidateAll(bool thorough)
 	pass=ValidateEC2N() && pass;
 	pass=ValidateECDSA() && pass;
 	pass=ValidateESIGN() && pass;
+	pass=ValidateX25519() && pass;
+	pass=ValidateEd25519() && pass;
 
 	if (pass)
 		cout << "\nAll tests passed!\n";
@@ -253,7 +266,7 @@ bool TestSettings()
 	else
 		cout << "passed:  ";
 
-	cout << "hasMMX == " << hasMMX << ", hasISSE == " << hasISSE << ", hasSSE2 == " << hasSSE2 << ", hasSSSE3 == " << hasSSSE3 << ", hasAESNI == " << HasAESNI() << ", hasCLMUL == " << HasCLMUL() << ", isP4 == " << isP4 << ", cacheLineSize == " << cacheLineSize;
+	cout << "hasMMX == " << hasMMX << ", hasISSE == " << hasISSE << ", hasSSE2 == " << hasSSE2 << ", hasSSSE3 == " << hasSSSE3 << ", hasAESNI == " << HasAESNI() << ", hasCLMUL == " << HasCLMUL() << ", hasSHA == " << HasSHA() << ", hasBMI2 == " << HasBMI2() << ", hasADX == " << HasADX() << ", isP4 == " << isP4 << ", cacheLineSize == " << cacheLineSize;
 	cout << ", AESNI_INTRINSICS == " << CRYPTOPP_BOOL_AESNI_INTRINSICS_AVAILABLE << endl;
 #endif
 
@@ -375,6 +388,417 @@ bool TestOS_RNG()
 	return pass;
 }
 
+struct TaskExecutorTest
+{
+	static void Count(void *context, size_t i)
+	{
+		TaskExecutorTest &t = *(TaskExecutorTest *)context;
+		t.counts[t.offset+i]++;
+	}
+
+	static void Nest(void *context, size_t i)
+	{
+		TaskExecutorTest &t = *(TaskExecutorTest *)context;
+		TaskExecutorTest inner = {t.executor, t.counts, i*100};
+		t.executor->Run(&Count, &inner, 100);
+	}
+
+	static void Throw(void *context, size_t i)
+	{
+		if (i == 5)
+			throw InvalidArgument("TaskExecutorTest");
+	}
+
+	const TaskExecutor *executor;
+	word32 *counts;
+	size_t offset;
+};
+
+bool TestTaskExecutor()
+{
+	cout << "\nTesting task executors...\n\n";
+	bool pass = true, fail;
+
+	SerialTaskExecutor serial;
+#ifdef CRYPTOPP_THREAD_POOL_AVAILABLE
+	ThreadPoolTaskExecutor pool(3);
+	const TaskExecutor *executors[] = {&serial, &pool};
+	const char *names[] = {"serial", "thread pool"};
+	const unsigned int executorCount = 2;
+#else
+	const TaskExecutor *executors[] = {&serial};
+	const char *names[] = {"serial"};
+	const unsigned int executorCount = 1;
+#endif
+
+	for (unsigned int i=0; i<executorCount; i++)
+	{
+		const TaskExecutor &executor = *executors[i];
+		SecBlock<word32> counts(1000);
+		TaskExecutorTest t = {&executor, counts, 0};
+		memset(counts, 0, counts.SizeInBytes());
+
+		executor.Run(&TaskExecutorTest::Count, &t, 1000);
+		executor.Run(&TaskExecutorTest::Nest, &t, 10);
+		fail = false;
+		for (unsigned int j=0; j<1000; j++)
+			fail = fail || counts[j] != 2;
+
+		// the exception a task throws on a worker thread reaches the caller as it was thrown
+		try
+		{
+			executor.Run(&TaskExecutorTest::Throw, &t, 10);
+			fail = true;
+		}
+		catch (const InvalidArgument &e)
+		{
+			fail = fail || e.GetWhat() != "TaskExecutorTest";
+		}
+		catch (const Exception &)
+		{
+			fail = true;
+		}
+
+		// CRT computations and prime tests that go through the default executor
+		SetDefaultTaskExecutor(&executor);
+		const Integer min = Integer::Power2(383), max = Integer::Power2(384)-1;
+		Integer p(GlobalRNG(), min, max, Integer::PRIME), q(GlobalRNG(), min, max, Integer::PRIME), x(GlobalRNG(), 2, p*q-1), e(65537);
+		if (Integer::Gcd(e, (p-1)*(q-1)) == Integer::One())
+			fail = fail || a_exp_b_mod_c(ModularRoot(x, e.InverseMod(p-1), e.InverseMod(q-1), p, q, p.InverseMod(q)), e, p*q) != x;
+		fail = fail || !RabinMillerTest(GlobalRNG(), p, 10) || RabinMillerTest(GlobalRNG(), p*q, 10);
+		SetDefaultTaskExecutor(NULL);
+
+		cout << (fail ? "FAILED    " : "passed    ") << names[i] << endl;
+		pass = pass && !fail;
+	}
+
+#ifdef CRYPTOPP_THREAD_POOL_AVAILABLE
+	// after the workers have been stopped, the tasks run on the calling thread
+	pool.Shutdown();
+	SecBlock<word32> counts(1000);
+	TaskExecutorTest t = {&pool, counts, 0};
+	memset(counts, 0, counts.SizeInBytes());
+	pool.Run(&TaskExecutorTest::Nest, &t, 10);
+	fail = pool.GetConcurrency() != 1;
+	for (unsigned int j=0; j<1000; j++)
+		fail = fail || counts[j] != 1;
+	cout << (fail ? "FAILED    " : "passed    ") << "thread pool after shutdown" << endl;
+	pass = pass && !fail;
+#endif
+
+	return pass;
+}
+
+bool TestIntegerStorage()
+{
+	cout << "\nTesting Integer storage...\n\n";
+	bool pass = true, fail;
+
+	// values on either side of the 512 bits kept inside an Integer, swapped every way and resized across the limit
+	const unsigned int bits[] = {1, 256, 512, 513, 2048};
+	fail = false;
+	for (unsigned int i=0; i<5; i++)
+		for (unsigned int j=0; j<5; j++)
+		{
+			const Integer a0(GlobalRNG(), bits[i]), b0(GlobalRNG(), bits[j]);
+			Integer a(a0), b(b0);
+			std::swap(a, b);
+			fail = fail || a != b0 || b != a0;
+			a.swap(b);
+			fail = fail || a != a0 || b != b0;
+			a = a * b0 + 1;
+			fail = fail || a != a0 * b0 + 1;
+			a >>= bits[j];
+			b = a0 * b0 + 1;
+			fail = fail || a != b >> bits[j];
+		}
+
+	SecBlockWithHint<word32, 4> small(2), large(8);
+	large[7] = 7;
+	small[1] = 1;
+	small.swap(large);
+	fail = fail || small.size() != 8 || small[7] != 7 || large.size() != 2 || large[1] != 1;
+	small.swap(large);
+	fail = fail || small.size() != 2 || small[1] != 1 || large.size() != 8 || large[7] != 7;
+
+	// both blocks in their fixed arrays: the words the smaller block doesn't cover must be wiped
+	SecBlockWithHint<word32, 8> fixedSmall(2), fixedLarge(8);
+	for (unsigned int i=0; i<8; i++)
+		fixedLarge[i] = i+1;
+	fixedSmall[0] = fixedSmall[1] = 0xffffffff;
+	fixedSmall.swap(fixedLarge);
+	fail = fail || fixedSmall.size() != 8 || fixedSmall[7] != 8 || fixedLarge.size() != 2 || fixedLarge[1] != 0xffffffff;
+	for (unsigned int i=2; i<8; i++)
+		fail = fail || fixedLarge.begin()[i] != 0;
+	fixedSmall.swap(fixedLarge);
+	fail = fail || fixedSmall.size() != 2 || fixedSmall[1] != 0xffffffff || fixedLarge.size() != 8 || fixedLarge[7] != 8;
+	for (unsigned int i=2; i<8; i++)
+		fail = fail || fixedSmall.begin()[i] != 0;
+
+	cout << (fail ? "FAILED    " : "passed    ") << "Integer and SecBlock swap and resize" << endl;
+	pass = pass && !fail;
+
+	// including results that are also operands
+	fail = false;
+	for (unsigned int i=0; i<5; i++)
+	{
+		const Integer a(GlobalRNG(), bits[i]), b(GlobalRNG(), bits[4-i]), m = Integer(GlobalRNG(), bits[(i+2)%5]) + 1;
+		const Integer c = i%2 ? -a : a;
+		Integer r;
+		Integer::MultiplyAdd(r, a, b, c);
+		fail = fail || r != a*b+c;
+		Integer::ModMul(r, c, b, m);
+		fail = fail || r != c*b%m;
+		r = a;
+		Integer::MultiplyAdd(r, r, b, r);
+		fail = fail || r != a*b+a;
+		r = m;
+		Integer::ModMul(r, a, b, r);
+		fail = fail || r != a*b%m;
+		r = b;
+		Integer::ModMul(r, r, r, m);
+		fail = fail || r != b*b%m;
+		fail = fail || CRT(a%m, m, b%(m+2), m+2, m.InverseMod(m+2)) % m != a%m;
+
+#ifdef CRYPTOPP_CXX11_RVALUES
+		Integer moved(std::move(r));
+		fail = fail || moved != b*b%m || r != Integer::Zero();
+		r = std::move(moved);
+		fail = fail || r != b*b%m;
+		fail = fail || (a+b)-(b+c) != a-c || a-(b+c) != a-b-c || (a+b)+c != c+(a+b);
+
+		PolynomialMod2 p(bits[i], 64), q = PolynomialMod2::AllOnes(bits[4-i]);
+		fail = fail || (p+q)-(q+p) != PolynomialMod2::Zero() || ((p^q)^q) != p || p+(p-q) != q;
+#endif
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "Integer::MultiplyAdd, Integer::ModMul, and operators on temporaries" << endl;
+	pass = pass && !fail;
+
+	return pass;
+}
+
+bool TestIntegerMultiply()
+{
+	cout << "\nTesting Integer multiplication...\n\n";
+	bool pass = true;
+
+	// a*b one word of b at a time, which doesn't go through the multiplication and squaring kernels
+	struct Reference
+	{
+		static Integer Multiply(const Integer &a, const Integer &b)
+		{
+			Integer r;
+			for (unsigned int i=0; i<b.WordCount(); i++)
+				r += (a * Integer(Integer::POSITIVE, b.GetBits(i*WORD_BITS, WORD_BITS))) << (i*WORD_BITS);
+			return r;
+		}
+	};
+
+	// every size the kernels handle directly, and sizes that are split up once or twice, with all-ones operands for the longest carries
+	const unsigned int words[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 12, 15, 16, 17, 24, 31, 32, 33, 48, 63, 64};
+	bool fail = false;
+	for (unsigned int i=0; i<sizeof(words)/sizeof(words[0]); i++)
+	{
+		const unsigned int bits = words[i]*WORD_BITS;
+		const Integer ones = Integer::Power2(bits) - 1;
+		for (unsigned int j=0; j<4; j++)
+		{
+			const Integer a = j==0 ? ones : Integer(GlobalRNG(), bits);
+			const Integer b = j==1 ? ones : Integer(GlobalRNG(), bits - (j==3 ? WORD_BITS/2 : 0));
+			const Integer ab = Reference::Multiply(a, b);
+			fail = fail || a*b != ab || b*a != ab || a.Squared() != Reference::Multiply(a, a);
+
+			Integer m = ones - Integer(GlobalRNG(), bits/2);
+			m.SetBit(0);
+			const MontgomeryRepresentation mr(m);
+			fail = fail || mr.ConvertOut(mr.Multiply(mr.ConvertIn(a%m), mr.ConvertIn(b%m))) != ab%m;
+			fail = fail || mr.ConvertOut(mr.Square(mr.ConvertIn(b%m))) != Reference::Multiply(b, b)%m;
+		}
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "products, squares and Montgomery products of 1 to 64 words" << endl;
+	pass = pass && !fail;
+
+	// Toom-Cook and NTT sizes, too big for the reference, so check the products modulo random numbers
+	const unsigned int bigWords[][2] = {{512, 512}, {700, 1024}, {1024, 4096}, {2048, 2048}, {32768, 32768}, {32768, 65536}};
+	fail = false;
+	for (unsigned int i=0; i<sizeof(bigWords)/sizeof(bigWords[0]); i++)
+	{
+		const Integer ones = Integer::Power2(bigWords[i][0]*WORD_BITS) - 1;
+		for (unsigned int j=0; j<2; j++)
+		{
+			const Integer a = j==0 ? ones : Integer(GlobalRNG(), bigWords[i][0]*WORD_BITS);
+			const Integer b = Integer(GlobalRNG(), bigWords[i][1]*WORD_BITS);
+			const Integer ab = a*b, aa = a.Squared();
+			for (unsigned int k=0; k<4; k++)
+			{
+				const Integer m = Integer(GlobalRNG(), 3*WORD_BITS/2) + 1;
+				fail = fail || ab%m != a%m*(b%m)%m || aa%m != a%m*(a%m)%m;
+			}
+			fail = fail || ab.BitCount() < a.BitCount()+b.BitCount()-1;
+		}
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "products and squares of 512 to 65536 words" << endl;
+	pass = pass && !fail;
+
+	// Newton division, with divisors that are just over a power of 2 and all ones
+	const unsigned int divWords[][2] = {{100, 300}, {200, 500}, {300, 1000}, {1000, 2500}, {1000, 5000}};
+	fail = false;
+	for (unsigned int i=0; i<sizeof(divWords)/sizeof(divWords[0]); i++)
+	{
+		for (unsigned int j=0; j<4; j++)
+		{
+			const unsigned int bits = divWords[i][0]*WORD_BITS;
+			Integer a(GlobalRNG(), divWords[i][1]*WORD_BITS);
+			const Integer b = j==0 ? Integer::Power2(bits)-1 : j==1 ? Integer::Power2(bits-1)+1 : Integer(GlobalRNG(), bits);
+			if (j==3)
+				a = a - a%b - 1;
+			Integer q, r;
+			Integer::Divide(r, q, a, b);
+			fail = fail || q*b+r != a || r.IsNegative() || r >= b;
+		}
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "quotients and remainders with divisors of 100 to 1000 words" << endl;
+	pass = pass && !fail;
+
+	return pass;
+}
+
+bool TestModularExponentiation()
+{
+	cout << "\nTesting modular exponentiation...\n\n";
+	bool pass = true;
+
+	// a^e mod m a bit at a time, which doesn't go through the Montgomery code
+	struct Reference
+	{
+		static Integer Exponentiate(const Integer &a, const Integer &e, const Integer &m)
+		{
+			Integer r = Integer::One();
+			for (unsigned int i=e.BitCount(); i>0; i--)
+			{
+				r = r.Squared()%m;
+				if (e.GetBit(i-1))
+					r = r*a%m;
+			}
+			return r;
+		}
+	};
+
+	// sizes just over a power of two words leave the Montgomery form of 1 shorter than the modulus about a fifth of the time
+	const unsigned int modulusBits[] = {64, 129, 521, 1030, 2048};
+	for (unsigned int i=0; i<sizeof(modulusBits)/sizeof(modulusBits[0]); i++)
+	{
+		bool fail = false;
+
+		// exponent lengths on either side of the short public exponent cutoff, and long enough for each window size
+		const unsigned int exponentBits[] = {0, 1, 17, 64, 65, 200, 450, 1100, 2048, 4000};
+		for (unsigned int j=0; j<sizeof(exponentBits)/sizeof(exponentBits[0]) && !fail; j++)
+		{
+			Integer m(GlobalRNG(), modulusBits[i]);
+			m.SetBit(0);
+			m.SetBit(modulusBits[i]-1);
+			const ModularArithmetic ma(m), even(m+1);
+			const Integer a(GlobalRNG(), Integer::Zero(), m-1);
+			const Integer e = exponentBits[j] ? Integer::Power2(exponentBits[j]-1) + Integer(GlobalRNG(), exponentBits[j]-1) : Integer::Zero();
+			const Integer expected = Reference::Exponentiate(a, e, m);
+			fail = ma.Exponentiate(a, e) != expected || ma.ExponentiatePublic(a, e) != expected;
+			fail = fail || ma.Exponentiate(Integer::Zero(), e) != Reference::Exponentiate(Integer::Zero(), e, m);
+			fail = fail || even.Exponentiate(a, e) != Reference::Exponentiate(a, e, m+1);
+
+			// the table is kept in the workspace between calls, including ones with other window sizes
+			const MontgomeryRepresentation mr(m);
+			for (unsigned int k=0; k<=j; k++)
+			{
+				const Integer ek = exponentBits[k] ? Integer(GlobalRNG(), exponentBits[k]) : Integer::Zero();
+				fail = fail || mr.ConvertOut(mr.Exponentiate(mr.ConvertIn(a), ek)) != Reference::Exponentiate(a, ek, m);
+			}
+		}
+
+		cout << (fail ? "FAILED    " : "passed    ") << modulusBits[i] << " bit modulus" << endl;
+		pass = pass && !fail;
+	}
+
+	return pass;
+}
+
+bool TestPrimeSearch()
+{
+	cout << "\nTesting prime search...\n\n";
+	bool pass = true, fail = false;
+
+	for (unsigned int bits=64; bits<=2048; bits*=2)
+	{
+		Integer m(GlobalRNG(), bits);
+		m.SetBit(bits-1);
+		m.SetBit(0);
+		const MontgomeryRepresentation mr(m);
+		const Integer es[] = {Integer::Zero(), Integer::One(), Integer(GlobalRNG(), 64), Integer(GlobalRNG(), bits), m-1};
+		for (unsigned int i=0; i<sizeof(es)/sizeof(es[0]); i++)
+			fail = fail || mr.Power2(es[i]) != mr.Exponentiate(mr.ConvertIn(2), es[i]);
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "powers of 2 in Montgomery representation" << endl;
+	pass = pass && !fail;
+
+	// the sieve uses more primes for bigger candidates, and the candidates are tested in batches
+	// when threads are available, but the search must still end at the first prime in the progression
+	SerialTaskExecutor serial;
+#ifdef CRYPTOPP_THREAD_POOL_AVAILABLE
+	ThreadPoolTaskExecutor pool(3);
+	const TaskExecutor *executors[] = {&serial, &pool};
+#else
+	const TaskExecutor *executors[] = {&serial};
+#endif
+	// candidates below the minimum are turned down, so that the sieve has to carry on over several of its windows
+	struct MinimumSelector : public PrimeSelector
+	{
+		MinimumSelector(const Integer &min) : min(min) {}
+		bool IsAcceptable(const Integer &candidate) const {return candidate >= min;}
+		Integer min;
+	};
+
+	fail = false;
+	for (unsigned int bits=256; bits<=1024; bits*=2)
+	{
+		for (unsigned int j=0; j<3; j++)
+		{
+			const Integer mod = j==1 ? Integer(30) : Integer(2);
+			const Integer equiv = j==1 ? Integer(7) : Integer::One();
+			const Integer start = Integer(GlobalRNG(), bits-1) + Integer::Power2(bits-1);
+			const MinimumSelector selector(start + mod*(j==0 ? 0 : 100000));
+
+			Integer expected = selector.min + (equiv-selector.min)%mod;
+			while (!IsPrime(expected))
+				expected += mod;
+
+			for (unsigned int i=0; i<sizeof(executors)/sizeof(executors[0]); i++)
+			{
+				SetDefaultTaskExecutor(executors[i]);
+				Integer p = start;
+				fail = fail || !FirstPrime(p, start+mod*200000, equiv, mod, &selector) || p != expected;
+				SetDefaultTaskExecutor(NULL);
+			}
+		}
+	}
+
+	for (unsigned int i=0; i<sizeof(executors)/sizeof(executors[0]); i++)
+	{
+		SetDefaultTaskExecutor(executors[i]);
+		PrimeAndGenerator pg(1, GlobalRNG(), 512);
+		fail = fail || pg.SubPrime() != (pg.Prime()-1)/2 || !IsPrime(pg.Prime()) || !IsPrime(pg.SubPrime());
+		SetDefaultTaskExecutor(NULL);
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "first primes in progressions, and safe primes" << endl;
+	pass = pass && !fail;
+
+	return pass;
+}
+
 // VC50 workaround
 typedef auto_ptr<BlockTransformation> apbt;
 
@@ -552,6 +976,65 @@ bool TestModeIV(SymmetricCipher &e, SymmetricCipher &d)
 	return true;
 }
 
+// checks AdvancedProcessBlocks against one ProcessBlock call per block, on runs of 1 to 40 blocks so that
+// every tail length behind an 8-block (or narrower) multi-block path is covered
+bool TestParallelBlocks(BlockCipher &e, BlockCipher &d)
+{
+	const unsigned int s = e.BlockSize(), maxBlocks = 40;
+	SecByteBlock input(s*maxBlocks), expected(s*maxBlocks), output(s*maxBlocks), iv(s), counter(s), t(s);
+	GlobalRNG().GenerateBlock(input, input.size());
+	GlobalRNG().GenerateBlock(iv, s);
+	iv[s-1] = 0xf0;		// so the counter carries into the next byte
+
+	ECB_Mode_ExternalCipher::Encryption ecb(e);
+	CTR_Mode_ExternalCipher::Encryption ctr(e, iv);
+	CBC_Mode_ExternalCipher::Decryption cbc(d, iv);
+	bool fail = false;
+
+	for (unsigned int n=1; n<=maxBlocks; n++)
+	{
+		for (unsigned int i=0; i<n; i++)
+			e.ProcessBlock(input+i*s, expected+i*s);
+		ecb.ProcessData(output, input, n*s);
+		fail = fail || memcmp(output, expected, n*s) != 0;
+
+		memcpy(counter, iv, s);
+		for (unsigned int i=0; i<n; i++)
+		{
+			e.ProcessAndXorBlock(counter, input+i*s, expected+i*s);
+			IncrementCounterByOne(counter, s);
+		}
+		ctr.Resynchronize(iv);
+		ctr.ProcessData(output, input, n*s);
+		fail = fail || memcmp(output, expected, n*s) != 0;
+
+		for (unsigned int i=0; i<n; i++)
+			d.ProcessAndXorBlock(input+i*s, i ? input+(i-1)*s : iv.begin(), expected+i*s);
+		cbc.Resynchronize(iv);
+		cbc.ProcessData(output, input, n*s);
+		fail = fail || memcmp(output, expected, n*s) != 0;
+
+		// CBC decryption runs backwards so it can work in place
+		memcpy(output, input, n*s);
+		cbc.Resynchronize(iv);
+		cbc.ProcessData(output, output, n*s);
+		fail = fail || memcmp(output, expected, n*s) != 0;
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "multi-block ECB, CTR and CBC decryption against single blocks" << endl;
+	return !fail;
+}
+
+template <class E, class D>
+bool TestParallelBlocks(size_t keylen)
+{
+	SecByteBlock key(keylen);
+	GlobalRNG().GenerateBlock(key, keylen);
+	E e(key, keylen);
+	D d(key, keylen);
+	return TestParallelBlocks(e, d);
+}
+
 bool ValidateCipherModes()
 {
 	cout << "\nTesting DES modes...\n\n";
@@ -1128,6 +1611,8 @@ bool ValidateRijndael()
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<RijndaelEncryption, RijndaelDecryption>(24), valdata, 3) && pass;
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<RijndaelEncryption, RijndaelDecryption>(32), valdata, 2) && pass;
 	pass = RunTestDataFile("TestVectors/aes.txt") && pass;
+	pass = TestParallelBlocks<RijndaelEncryption, RijndaelDecryption>(16) && pass;
+	pass = TestParallelBlocks<RijndaelEncryption, RijndaelDecryption>(32) && pass;
 	return pass;
 }
 
@@ -1140,6 +1625,8 @@ bool ValidateTwofish()
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<TwofishEncryption, TwofishDecryption>(16), valdata, 4) && pass;
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<TwofishEncryption, TwofishDecryption>(24), valdata, 3) && pass;
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<TwofishEncryption, TwofishDecryption>(32), valdata, 2) && pass;
+	pass = TestParallelBlocks<TwofishEncryption, TwofishDecryption>(16) && pass;
+	pass = TestParallelBlocks<TwofishEncryption, TwofishDecryption>(32) && pass;
 	return pass;
 }
 
@@ -1152,6 +1639,8 @@ bool ValidateSerpent()
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<SerpentEncryption, SerpentDecryption>(16), valdata, 5) && pass;
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<SerpentEncryption, SerpentDecryption>(24), valdata, 4) && pass;
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<SerpentEncryption, SerpentDecryption>(32), valdata, 3) && pass;
+	pass = TestParallelBlocks<SerpentEncryption, SerpentDecryption>(16) && pass;
+	pass = TestParallelBlocks<SerpentEncryption, SerpentDecryption>(32) && pass;
 	return pass;
 }
 
@@ -1353,6 +1842,8 @@ bool ValidateSHACAL2()
 	FileSource valdata("TestData/shacal2v.dat", true, new HexDecoder);
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<SHACAL2Encryption, SHACAL2Decryption>(16), valdata, 4) && pass;
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<SHACAL2Encryption, SHACAL2Decryption>(64), valdata, 10) && pass;
+	pass = TestParallelBlocks<SHACAL2Encryption, SHACAL2Decryption>(16) && pass;
+	pass = TestParallelBlocks<SHACAL2Encryption, SHACAL2Decryption>(64) && pass;
 	return pass;
 }
 
@@ -1365,6 +1856,8 @@ bool ValidateCamellia()
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<CamelliaEncryption, CamelliaDecryption>(16), valdata, 15) && pass;
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<CamelliaEncryption, CamelliaDecryption>(24), valdata, 15) && pass;
 	pass = BlockTransformationTest(FixedRoundsCipherFactory<CamelliaEncryption, CamelliaDecryption>(32), valdata, 15) && pass;
+	pass = TestParallelBlocks<CamelliaEncryption, CamelliaDecryption>(16) && pass;
+	pass = TestParallelBlocks<CamelliaEncryption, CamelliaDecryption>(32) && pass;
 	return pass;
 }
 
@@ -1393,13 +1886,66 @@ bool ValidateCCM()
 	return RunTestDataFile("TestVectors/ccm.txt");
 }
 
+// GCM<AES> only hands calls of 8 blocks or more to the stitched AES-NI/CLMUL kernel, so feeding the
+// same message in pieces shorter than that gives a reference from the separate CTR and GHASH path
+bool TestGCMProcessData()
+{
+	const unsigned int maxLength = 3*128+127, piece = 61;
+	const unsigned int headerLengths[] = {0, 5, 16, 33};
+	byte key[32], iv[12], header[33], tag[16], expectedTag[16];
+	SecByteBlock plaintext(maxLength+1), ciphertext(maxLength+1), expected(maxLength+1), decrypted(maxLength+1);
+	GlobalRNG().GenerateBlock(key, sizeof(key));
+	GlobalRNG().GenerateBlock(iv, sizeof(iv));
+	GlobalRNG().GenerateBlock(header, sizeof(header));
+	GlobalRNG().GenerateBlock(plaintext, plaintext.size());
+	bool fail = false;
+
+	for (unsigned int keylen=16; keylen<=32; keylen+=16)
+	{
+		GCM<AES>::Encryption e, reference;
+		GCM<AES>::Decryption d;
+		e.SetKeyWithIV(key, keylen, iv, sizeof(iv));
+		reference.SetKeyWithIV(key, keylen, iv, sizeof(iv));
+		d.SetKeyWithIV(key, keylen, iv, sizeof(iv));
+
+		for (unsigned int h=0; h<sizeof(headerLengths)/sizeof(headerLengths[0]); h++)
+			for (unsigned int length=0; length<=maxLength; length+=(length < 160 ? 1 : 7))
+			{
+				// odd offsets so the kernel's loads and stores are unaligned
+				unsigned int i;
+				reference.Resynchronize(iv);
+				reference.Update(header, headerLengths[h]);
+				for (i=0; i<length; i+=piece)
+					reference.ProcessData(expected+i, plaintext+1+i, STDMIN(piece, length-i));
+				reference.TruncatedFinal(expectedTag, sizeof(expectedTag));
+
+				e.Resynchronize(iv);
+				e.Update(header, headerLengths[h]);
+				e.ProcessData(ciphertext+1, plaintext+1, length);
+				e.TruncatedFinal(tag, sizeof(tag));
+				fail = fail || memcmp(ciphertext+1, expected, length) != 0 || memcmp(tag, expectedTag, sizeof(tag)) != 0;
+
+				d.Resynchronize(iv);
+				d.Update(header, headerLengths[h]);
+				d.ProcessData(decrypted, ciphertext+1, length);
+				d.TruncatedFinal(tag, sizeof(tag));
+				fail = fail || memcmp(decrypted, plaintext+1, length) != 0 || memcmp(tag, expectedTag, sizeof(tag)) != 0;
+			}
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "whole-message encryption and decryption against 61-byte pieces" << endl;
+	return !fail;
+}
+
 bool ValidateGCM()
 {
 	cout << "\nAES/GCM validation suite running...\n";
 	cout << "\n2K tables:";
 	bool pass = RunTestDataFile("TestVectors/gcm.txt", MakeParameters(Name::TableSize(), (int)2048));
 	cout << "\n64K tables:";
-	return RunTestDataFile("TestVectors/gcm.txt", MakeParameters(Name::TableSize(), (int)64*1024)) && pass;
+	pass = RunTestDataFile("TestVectors/gcm.txt", MakeParameters(Name::TableSize(), (int)64*1024)) && pass;
+	cout << endl;
+	return TestGCMProcessData() && pass;
 }
 
 bool ValidateCMAC()
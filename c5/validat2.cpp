@@ -25,6 +25,8 @@
 #include "oids.h"
 #include "esign.h"
 #include "osrng.h"
+#include "taskexec.h"
+#include "curve25519.h"
 
 #include <iostream>
 #include <iomanip>
@@ -253,6 +255,28 @@ bool AuthenticatedKeyAgreementValidate(AuthenticatedKeyAgreementDomain &d)
 	return true;
 }
 
+// private key operations on one key from several threads at once, see ValidateRSA()
+struct RSAConcurrentInverses
+{
+	static void Run(void *context, size_t i)
+	{
+		const RSAConcurrentInverses &c = *(const RSAConcurrentInverses *)context;
+		try
+		{
+			// the blinding pair has been made, so squaring it shouldn't need an RNG
+			c.bad[i] = c.key->CalculateInverse(NullRNG(), c.x[i%4]) != c.y[i%4];
+		}
+		catch (...)
+		{
+			c.bad[i] = true;
+		}
+	}
+
+	const InvertibleRSAFunction *key;
+	const Integer *x, *y;
+	char *bad;
+};
+
 bool ValidateRSA()
 {
 	cout << "\nRSA validation suite running...\n\n";
@@ -336,6 +360,80 @@ bool ValidateRSA()
 		cout << (fail ? "FAILED    " : "passed    ");
 		cout << "PKCS 2.0 encryption and decryption\n";
 	}
+	{
+		// the blinding pair is refreshed on each call, and the cached contexts must follow changes to the key
+		FileSource keys1("TestData/rsa1024.dat", true, new HexDecoder);
+		FileSource keys2("TestData/rsa512a.dat", true, new HexDecoder);
+		InvertibleRSAFunction key, other;
+		key.BERDecode(keys1);
+		other.BERDecode(keys2);
+
+		fail = false;
+		for (unsigned int i=0; i<20 && !fail; i++)
+		{
+			if (i == 10)
+				key = other;
+			InvertibleRSAFunction copy(key);
+			Integer x(GlobalRNG(), Integer::Zero(), key.GetModulus()-1);
+			Integer y = a_exp_b_mod_c(x, key.GetPrivateExponent(), key.GetModulus());
+			fail = key.CalculateInverse(GlobalRNG(), x) != y || copy.CalculateInverse(GlobalRNG(), x) != y;
+		}
+
+#ifdef CRYPTOPP_THREAD_POOL_AVAILABLE
+		Integer x[4], y[4];
+		char bad[64] = {0};
+		for (unsigned int i=0; i<4; i++)
+		{
+			x[i] = Integer(GlobalRNG(), Integer::Zero(), key.GetModulus()-1);
+			y[i] = a_exp_b_mod_c(x[i], key.GetPrivateExponent(), key.GetModulus());
+		}
+		RSAConcurrentInverses inverses = {&key, x, y, bad};
+		ThreadPoolTaskExecutor pool(3);
+		pool.Run(&RSAConcurrentInverses::Run, &inverses, sizeof(bad));
+		for (unsigned int i=0; i<sizeof(bad); i++)
+			fail = fail || bad[i];
+#endif
+		pass = pass && !fail;
+
+		cout << (fail ? "FAILED    " : "passed    ");
+		cout << "private key operation with cached blinding\n";
+	}
+	{
+		FileSource keys("TestData/rsa1024.dat", true, new HexDecoder);
+		RSASS<PKCS1v15, SHA>::Signer rsaPriv(keys);
+		RSASS<PKCS1v15, SHA>::Verifier rsaPub(rsaPriv);
+
+		const unsigned int count = 5;
+		byte messages[count][16], signatures[count][128];
+		const byte *messagePtrs[count];
+		byte *signaturePtrs[count];
+		size_t messageLengths[count], signatureLengths[count];
+		for (unsigned int i=0; i<count; i++)
+		{
+			GlobalRNG().GenerateBlock(messages[i], sizeof(messages[i]));
+			messagePtrs[i] = messages[i];
+			messageLengths[i] = i+10;
+			signaturePtrs[i] = signatures[i];
+		}
+
+		fail = rsaPriv.SignMessageBatch(GlobalRNG(), messagePtrs, messageLengths, signaturePtrs, signatureLengths, count) != 0;
+		for (unsigned int i=0; i<count; i++)
+			fail = fail || !rsaPub.VerifyMessage(messages[i], messageLengths[i], signatures[i], signatureLengths[i]);
+
+		// an element out of range fails on its own, without affecting the rest of the batch
+		const InvertibleRSAFunction &key = rsaPriv.GetKey();
+		Integer x[3], y[3];
+		bool failed[3];
+		x[0] = Integer(GlobalRNG(), Integer::Zero(), key.GetModulus()-1);
+		x[1] = key.GetModulus()+1;
+		x[2] = Integer::Two();
+		fail = fail || key.CalculateInverseBatch(GlobalRNG(), x, y, 3, failed) != 1 || failed[0] || !failed[1] || failed[2];
+		fail = fail || y[0] != key.CalculateInverse(GlobalRNG(), x[0]) || y[2] != key.CalculateInverse(GlobalRNG(), x[2]);
+		pass = pass && !fail;
+
+		cout << (fail ? "FAILED    " : "passed    ");
+		cout << "batch signature generation\n";
+	}
 
 	return pass;
 }
@@ -572,12 +670,150 @@ bool ValidateECP()
 	pass = SimpleKeyAgreementValidate(ecdhc) && pass;
 	pass = AuthenticatedKeyAgreementValidate(ecmqvc) && pass;
 
+	cout << "Testing Solinas reduction modulo P-384..." << endl;
+	{
+		Integer p = DL_GroupParameters_EC<ECP>(ASN1::secp384r1()).GetCurve().GetField().GetModulus();
+		ModularArithmetic ma(p);
+		SolinasArithmetic sa(p);
+		bool fail = !SolinasArithmetic::IsSupportedModulus(p) || SolinasArithmetic::IsSupportedModulus(p+2);
+		fail = fail || SolinasArithmetic::IsSupportedModulus(DL_GroupParameters_EC<ECP>(ASN1::secp256r1()).GetCurve().GetField().GetModulus());
+
+		// edge values drive the column sums to the ends of their range
+		const Integer edges[] = {Integer::Zero(), Integer::One(), p-1, p-2, Integer::Power2(p.BitCount()-1), Integer::Power2(p.BitCount()/2), p >> 32, (p+1) >> 1};
+		for (unsigned int j=0; j<100 && !fail; j++)
+		{
+			Integer a = j < 8 ? edges[j] : Integer(GlobalRNG(), Integer::Zero(), p-1);
+			Integer b = j < 8 ? edges[(j*5+3)%8] : Integer(GlobalRNG(), Integer::Zero(), p-1);
+			Integer r = sa.Multiply(a, b);
+			fail = r != ma.Multiply(a, b);
+			r = sa.Square(a);
+			fail = fail || r != ma.Square(a);
+			if (!!b)
+			{
+				r = sa.MultiplicativeInverse(b);
+				fail = fail || r != ma.MultiplicativeInverse(b);
+			}
+		}
+
+		cout << (fail ? "FAILED" : "passed") << "    " << dec << p.BitCount() << " bits" << endl;
+		pass = pass && !fail;
+	}
+
+	// the counts and lengths pick Straus' method, Pippenger's buckets, and Bos-Coster's remainders, and the bases repeat and cancel
+	cout << "Testing multi-scalar multiplication..." << endl;
+	{
+		const DL_GroupParameters_EC<ECP> params(ASN1::secp256r1());
+		const ECP &ec = params.GetCurve();
+		const unsigned int counts[] = {3, 12, 40, 300}, lengths[] = {256, 8, 8, 256};
+		bool fail = false;
+		for (unsigned int i=0; i<4; i++)
+		{
+			std::vector<ECPPoint> bases(counts[i]);
+			std::vector<Integer> exponents(counts[i]);
+			ECPPoint expected;
+			for (unsigned int j=0; j<counts[i]; j++)
+			{
+				if (j%7 == 1)
+					bases[j] = ec.Inverse(bases[j-1]);
+				else if (j%7 == 2)
+					bases[j] = bases[j-2];
+				else if (j%7 != 3)
+					bases[j] = params.ExponentiateBase(Integer(GlobalRNG(), 64));
+				exponents[j] = j%5 == 4 ? Integer::Zero() : Integer(GlobalRNG(), lengths[i]);
+				expected = ec.Add(expected, ec.ScalarMultiply(bases[j], exponents[j]));
+			}
+			fail = fail || !(ec.MultiScalarMultiply(&bases[0], &exponents[0], counts[i]) == expected);
+		}
+
+		const Integer moduli[] = {params.GetSubgroupOrder(), params.GetSubgroupOrder()+1};
+		const unsigned int modCounts[] = {3, 20, 20, 200}, modLengths[] = {200, 200, 16, 16};
+		for (unsigned int m=0; m<2; m++)
+		{
+			const ModularArithmetic ma(moduli[m]);
+			for (unsigned int i=0; i<4; i++)
+			{
+				std::vector<Integer> bases(modCounts[i]), exponents(modCounts[i]);
+				Integer expected = Integer::One();
+				for (unsigned int j=0; j<modCounts[i]; j++)
+				{
+					bases[j] = Integer(GlobalRNG(), Integer::One(), moduli[m]-1);
+					exponents[j] = j%5 == 4 ? Integer::Zero() : Integer(GlobalRNG(), modLengths[i]);
+					expected = ma.Multiply(expected, a_exp_b_mod_c(bases[j], exponents[j], moduli[m]));
+				}
+				fail = fail || ma.MultiExponentiate(&bases[0], &exponents[0], modCounts[i]) != expected;
+			}
+		}
+
+		cout << (fail ? "FAILED" : "passed") << "    " << "Straus, Pippenger, and Bos-Coster" << endl;
+		pass = pass && !fail;
+
+		// the results are converted to affine coordinates together, so some of them are the identity, and the cascades add points to themselves and their inverses
+		fail = false;
+		const ECPPoint P = params.ExponentiateBase(Integer(GlobalRNG(), 64));
+		const Integer n = params.GetSubgroupOrder(), k(GlobalRNG(), 256);
+		const Integer exponents[] = {k, Integer::Zero(), n, Integer(GlobalRNG(), 256), Integer::One(), k+1};
+		ECPPoint results[6];
+		ec.SimultaneousMultiply(results, P, exponents, 6);
+		for (unsigned int i=0; i<6; i++)
+			fail = fail || !(results[i] == ec.AbstractGroup<ECPPoint>::ScalarMultiply(P, exponents[i] % n));
+		fail = fail || !(ec.CascadeScalarMultiply(P, k, P, n-k) == ECPPoint());
+		fail = fail || !(ec.CascadeScalarMultiply(P, k, ec.Inverse(P), k) == ECPPoint());
+		fail = fail || !(ec.CascadeScalarMultiply(P, k, P, k) == ec.ScalarMultiply(P, 2*k));
+		fail = fail || !(ec.CascadeScalarMultiply(ECPPoint(), k, P, k) == ec.ScalarMultiply(P, k));
+
+		cout << (fail ? "FAILED" : "passed") << "    " << "simultaneous and cascade multiplication" << endl;
+		pass = pass && !fail;
+	}
+
+	cout << "Testing secp256k1 endomorphism..." << endl;
+	{
+		// secp256k1 splits exponents below the order with its endomorphism, compare against a copy of the curve without it
+		DL_GroupParameters_EC<ECP> params(ASN1::secp256k1());
+		const ECP &ec = params.GetCurve();
+		const ECP plain(ec.GetField().GetModulus(), ec.GetA(), ec.GetB());
+		const Integer n = params.GetSubgroupOrder();
+		const ECPPoint G = params.GetSubgroupGenerator();
+		bool fail = !ec.HasEndomorphism() || plain.HasEndomorphism();
+
+		const Integer exponents[] = {Integer::One(), n-1, n>>1, Integer::Power2(128)-1, Integer(GlobalRNG(), Integer::Zero(), n-1), Integer(GlobalRNG(), 256)};
+		for (unsigned int i=0; i<6; i++)
+		{
+			const ECPPoint P = plain.ScalarMultiply(G, Integer(GlobalRNG(), 256));
+			const Integer k(GlobalRNG(), Integer::Zero(), n-1);
+			const ECPPoint expected = plain.AbstractGroup<ECPPoint>::ScalarMultiply(P, exponents[i]);
+			fail = fail || !(ec.ScalarMultiply(P, exponents[i]) == expected);
+			fail = fail || !(ec.CascadeScalarMultiply(P, exponents[i], G, k) == plain.Add(expected, plain.ScalarMultiply(G, k)));
+			fail = fail || !(ec.MultiScalarMultiply(&P, exponents+i, 1) == expected);
+		}
+
+		ECDSA<ECP, SHA256>::Signer signer(GlobalRNG(), ASN1::secp256k1());
+		ECDSA<ECP, SHA256>::Verifier verifier(signer);
+		fail = fail || !SignatureValidate(signer, verifier, false);
+
+		cout << (fail ? "FAILED" : "passed") << "    " << "secp256k1 endomorphism" << endl;
+		pass = pass && !fail;
+	}
+
 	cout << "Testing SEC 2, NIST, and Brainpool recommended curves..." << endl;
 	OID oid;
 	while (!(oid = DL_GroupParameters_EC<ECP>::GetNextRecommendedParametersOID(oid)).m_values.empty())
 	{
 		DL_GroupParameters_EC<ECP> params(oid);
 		bool fail = !params.Validate(GlobalRNG(), 2);
+
+		// comb precomputation, directly and loaded from the format saved by DL_FixedBasePrecomputationImpl
+		DL_GroupParameters_EC<ECP> precomputed(oid), loaded(oid);
+		DL_FixedBasePrecomputationImpl<ECPPoint> generic;
+		ByteQueue queue;
+		precomputed.Precompute(16);
+		generic.SetBase(params.GetGroupPrecomputation(), params.GetSubgroupGenerator());
+		generic.Precompute(params.GetGroupPrecomputation(), params.GetSubgroupOrder().BitCount(), 16);
+		generic.Save(params.GetGroupPrecomputation(), queue);
+		loaded.LoadPrecomputation(queue);
+		Integer k(GlobalRNG(), Integer::One(), params.GetSubgroupOrder()-1);
+		ECPPoint Q = params.ExponentiateBase(k);
+		fail = fail || !(precomputed.ExponentiateBase(k) == Q) || !(loaded.ExponentiateBase(k) == Q);
+
 		cout << (fail ? "FAILED" : "passed") << "    " << dec << params.GetCurve().GetField().MaxElementBitLength() << " bits" << endl;
 		pass = pass && !fail;
 	}
@@ -681,6 +917,110 @@ bool ValidateECDSA()
 
 	pass = SignatureValidate(priv, pub) && pass;
 
+#ifdef CRYPTOPP_INTEGER_ARENA
+	// the key is generated under the arena, and used again after it's gone
+	member_ptr<ECDSA<ECP, SHA256>::Signer> arenaSigner;
+	SecByteBlock arenaSignature;
+	fail = false;
+	{
+		IntegerArena arena;
+		arenaSigner.reset(new ECDSA<ECP, SHA256>::Signer(GlobalRNG(), ASN1::secp256r1()));
+		ECDSA<ECP, SHA256>::Verifier arenaVerifier(*arenaSigner);
+		arenaSignature.resize(arenaSigner->MaxSignatureLength());
+		for (unsigned int i=0; i<10 && !fail; i++)
+		{
+			IntegerArena nested;
+			arenaSigner->SignMessage(GlobalRNG(), (byte *)"abc", 3, arenaSignature);
+			fail = !arenaVerifier.VerifyMessage((byte *)"abc", 3, arenaSignature, arenaSignature.size());
+		}
+
+		// storage comes back from the arena wiped
+		const word *recycled;
+		{
+			IntegerSecBlock block(64);
+			memset(block, 0xff, block.SizeInBytes());
+			recycled = block;
+		}
+		IntegerSecBlock block(64);
+		fail = fail || block.begin() != recycled;
+		for (unsigned int i=0; i<64; i++)
+			fail = fail || block[i] != 0;
+	}
+	ECDSA<ECP, SHA256>::Verifier arenaVerifier(*arenaSigner);
+	fail = fail || !arenaVerifier.VerifyMessage((byte *)"abc", 3, arenaSignature, arenaSignature.size());
+	fail = fail || arenaVerifier.VerifyMessage((byte *)"xyz", 3, arenaSignature, arenaSignature.size());
+	pass = pass && !fail;
+
+	cout << (fail ? "FAILED    " : "passed    ");
+	cout << "signing and verification with an IntegerArena\n";
+#endif
+
+	// batches mix keys with and without precomputation, and hold some bad signatures, which must fail on their own
+	{
+		const unsigned int keyCount = 3, batchSize = 9;
+		std::vector<ECDSA<ECP, SHA256>::Signer> signers;
+		std::vector<ECDSA<ECP, SHA256>::Verifier> verifiers;
+		for (unsigned int i=0; i<keyCount; i++)
+		{
+			signers.push_back(ECDSA<ECP, SHA256>::Signer(GlobalRNG(), ASN1::secp256r1()));
+			verifiers.push_back(ECDSA<ECP, SHA256>::Verifier(signers.back()));
+		}
+		verifiers[1].AccessKey().Precompute();
+
+		const size_t signatureLength = verifiers[0].SignatureLength();
+		SecByteBlock messageBuffer(batchSize*16), signatureBuffer(batchSize*signatureLength);
+		GlobalRNG().GenerateBlock(messageBuffer, messageBuffer.size());
+		const DL_PublicKey<ECP::Point> *keys[batchSize];
+		const byte *messages[batchSize], *signatures[batchSize];
+		size_t messageLengths[batchSize], signatureLengths[batchSize];
+		for (unsigned int i=0; i<batchSize; i++)
+		{
+			keys[i] = &verifiers[i%keyCount].GetKey();
+			messages[i] = messageBuffer + i*16;
+			messageLengths[i] = 16;
+			signatures[i] = signatureBuffer + i*signatureLength;
+			signatureLengths[i] = signers[i%keyCount].SignMessage(GlobalRNG(), messages[i], messageLengths[i], signatureBuffer + i*signatureLength);
+		}
+		signatureBuffer[2*signatureLength+5] ^= 1;
+		messageBuffer[4*16] ^= 1;
+		signatureLengths[6]--;
+		signers[0].SignMessage(GlobalRNG(), messages[7], messageLengths[7], signatureBuffer + 7*signatureLength);
+
+		SerialTaskExecutor serial;
+#ifdef CRYPTOPP_THREAD_POOL_AVAILABLE
+		ThreadPoolTaskExecutor pool(3);
+		const TaskExecutor *executors[] = {&serial, &pool};
+#else
+		const TaskExecutor *executors[] = {&serial};
+#endif
+		fail = false;
+		for (unsigned int i=0; i<sizeof(executors)/sizeof(executors[0]); i++)
+		{
+			SetDefaultTaskExecutor(executors[i]);
+			bool results[batchSize], singleKeyResults[batchSize];
+			size_t failures = verifiers[0].VerifyMessageBatch(keys, messages, messageLengths, signatures, signatureLengths, results, batchSize);
+			size_t singleKeyFailures = verifiers[1].VerifyMessageBatch(messages, messageLengths, signatures, signatureLengths, singleKeyResults, batchSize);
+			SetDefaultTaskExecutor(NULL);
+
+			size_t expectedFailures = 0, expectedSingleKeyFailures = 0;
+			for (unsigned int j=0; j<batchSize; j++)
+			{
+				// VerifyMessage() reads a whole signature whatever length it's given, but the batch turns down the short one
+				bool expected = j != 6 && verifiers[j%keyCount].VerifyMessage(messages[j], messageLengths[j], signatures[j], signatureLength);
+				bool expectedSingleKey = j != 6 && verifiers[1].VerifyMessage(messages[j], messageLengths[j], signatures[j], signatureLength);
+				expectedFailures += !expected;
+				expectedSingleKeyFailures += !expectedSingleKey;
+				fail = fail || results[j] != expected || singleKeyResults[j] != expectedSingleKey;
+				fail = fail || expected != (j != 2 && j != 4 && j != 6 && j != 7);
+			}
+			fail = fail || failures != expectedFailures || singleKeyFailures != expectedSingleKeyFailures;
+		}
+		pass = pass && !fail;
+
+		cout << (fail ? "FAILED    " : "passed    ");
+		cout << "batch verification\n";
+	}
+
 	return pass;
 }
 
@@ -720,3 +1060,180 @@ bool ValidateESIGN()
 
 	return pass;
 }
+
+bool ValidateX25519()
+{
+	cout << "\nX25519 validation suite running...\n\n";
+
+	// RFC 7748, sections 5.2 and 6.1
+	struct
+	{
+		const char *hexPrivateKey, *hexPublicKey, *hexAgreedValue;
+	} tuples[] =
+	{
+		{"a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4", "e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c", "c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552"},
+		{"77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a", "de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f", "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742"},
+		{"5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb", "8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a", "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742"},
+	};
+
+	X25519 x25519;
+	byte agreedValue[X25519::SHARED_KEYLENGTH], publicKey[X25519::PUBLIC_KEYLENGTH];
+	bool pass = true, fail = false;
+
+	for (unsigned int i=0; i<sizeof(tuples)/sizeof(tuples[0]); i++)
+	{
+		string privateKey, otherPublicKey, expected;
+		StringSource(tuples[i].hexPrivateKey, true, new HexDecoder(new StringSink(privateKey)));
+		StringSource(tuples[i].hexPublicKey, true, new HexDecoder(new StringSink(otherPublicKey)));
+		StringSource(tuples[i].hexAgreedValue, true, new HexDecoder(new StringSink(expected)));
+		fail = !x25519.Agree(agreedValue, (const byte *)privateKey.data(), (const byte *)otherPublicKey.data()) || memcmp(agreedValue, expected.data(), sizeof(agreedValue)) != 0 || fail;
+	}
+
+	// the public keys of section 6.1 come from the comb table, not the ladder
+	string alice, alicePublic;
+	StringSource(tuples[1].hexPrivateKey, true, new HexDecoder(new StringSink(alice)));
+	StringSource(tuples[2].hexPublicKey, true, new HexDecoder(new StringSink(alicePublic)));
+	x25519.GeneratePublicKey(GlobalRNG(), (const byte *)alice.data(), publicKey);
+	fail = memcmp(publicKey, alicePublic.data(), sizeof(publicKey)) != 0 || fail;
+
+	byte privateKey[X25519::SECRET_KEYLENGTH], basePoint[X25519::PUBLIC_KEYLENGTH] = {9};
+	for (unsigned int i=0; i<16; i++)
+	{
+		GlobalRNG().GenerateBlock(privateKey, sizeof(privateKey));
+		x25519.GeneratePublicKey(GlobalRNG(), privateKey, publicKey);
+		fail = !x25519.Agree(agreedValue, privateKey, basePoint) || memcmp(agreedValue, publicKey, sizeof(publicKey)) != 0 || fail;
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "key generation and agreement against test vectors" << endl;
+	pass = pass && !fail;
+
+	// section 5.2, after 1 and 1000 iterations
+	byte k[32] = {9}, u[32] = {9};
+	fail = false;
+	for (unsigned int i=1; i<=1000; i++)
+	{
+		x25519.Agree(agreedValue, k, u);
+		memcpy(u, k, 32);
+		memcpy(k, agreedValue, 32);
+		if (i == 1)
+			fail = memcmp(k, "\x42\x2c\x8e\x7a\x62\x27\xd7\xbc\xa1\x35\x0b\x3e\x2b\xb7\x27\x9f\x78\x97\xb8\x7b\xb6\x85\x4b\x78\x3c\x60\xe8\x03\x11\xae\x30\x79", 32) != 0;
+	}
+	fail = memcmp(k, "\x68\x4c\xf5\x9b\xa8\x33\x09\x55\x28\x00\xef\x56\x6f\x2f\x4d\x3c\x1c\x38\x87\xc4\x93\x60\xe3\x87\x5f\x2e\xb9\x4d\x99\x53\x2c\x51", 32) != 0 || fail;
+
+	cout << (fail ? "FAILED    " : "passed    ") << "iterated test vectors" << endl;
+	pass = pass && !fail;
+
+	// points of small order give an all zero value
+	byte zero[32] = {0}, one[32] = {1};
+	fail = x25519.Agree(agreedValue, privateKey, zero) || x25519.Agree(agreedValue, privateKey, one);
+
+	cout << (fail ? "FAILED    " : "passed    ") << "rejection of small order points" << endl;
+	pass = pass && !fail;
+
+	pass = SimpleKeyAgreementValidate(x25519) && pass;
+
+	return pass;
+}
+
+bool ValidateEd25519()
+{
+	cout << "\nEd25519 validation suite running...\n\n";
+
+	// RFC 8032, section 7.1
+	struct
+	{
+		const char *hexSeed, *hexPublicKey, *hexMessage, *hexSignature;
+	} tuples[] =
+	{
+		{"9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60", "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a", "",
+			"e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"},
+		{"4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb", "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", "72",
+			"92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"},
+		{"c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7", "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025", "af82",
+			"6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a"},
+	};
+
+	byte signature[Ed25519Signer::SIGNATURE_LENGTH];
+	bool pass = true, fail = false;
+
+	for (unsigned int i=0; i<sizeof(tuples)/sizeof(tuples[0]); i++)
+	{
+		string seed, publicKey, message, expected;
+		StringSource(tuples[i].hexSeed, true, new HexDecoder(new StringSink(seed)));
+		StringSource(tuples[i].hexPublicKey, true, new HexDecoder(new StringSink(publicKey)));
+		StringSource(tuples[i].hexMessage, true, new HexDecoder(new StringSink(message)));
+		StringSource(tuples[i].hexSignature, true, new HexDecoder(new StringSink(expected)));
+
+		Ed25519::Signer signer((const byte *)seed.data());
+		Ed25519::Verifier verifier((const byte *)publicKey.data());
+		fail = memcmp(signer.GetKey().GetPublicKeyBytes(), publicKey.data(), publicKey.size()) != 0 || fail;
+		signer.SignMessage(GlobalRNG(), (const byte *)message.data(), message.size(), signature);
+		fail = memcmp(signature, expected.data(), sizeof(signature)) != 0 || fail;
+		fail = !verifier.VerifyMessage((const byte *)message.data(), message.size(), signature, sizeof(signature)) || fail;
+		fail = verifier.VerifyMessage((const byte *)"x", 1, signature, sizeof(signature)) || fail;
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "signature and verification against test vectors" << endl;
+	pass = pass && !fail;
+
+	// random keys and messages exercise the carries of the scalar reduction, and S must come out below l to verify
+	fail = false;
+	for (unsigned int i=0; i<64; i++)
+	{
+		Ed25519::Signer randomSigner(GlobalRNG());
+		Ed25519::Verifier randomVerifier(randomSigner);
+		SecByteBlock message(GlobalRNG().GenerateWord32(0, 200));
+		GlobalRNG().GenerateBlock(message, message.size());
+		randomSigner.SignMessage(GlobalRNG(), message, message.size(), signature);
+		fail = !randomVerifier.VerifyMessage(message, message.size(), signature, sizeof(signature)) || fail;
+	}
+
+	cout << (fail ? "FAILED    " : "passed    ") << "signature and verification with random keys" << endl;
+	pass = pass && !fail;
+
+	// S + l verifies the same equation, but must be turned down
+	Ed25519::Signer signer(GlobalRNG());
+	Ed25519::Verifier verifier(signer);
+	signer.SignMessage(GlobalRNG(), (const byte *)"abc", 3, signature);
+	const byte order[32] = {0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10};
+	byte malleated[Ed25519Signer::SIGNATURE_LENGTH];
+	memcpy(malleated, signature, 32);
+	for (unsigned int i=0, carry=0; i<32; i++)
+	{
+		carry += signature[32+i] + order[i];
+		malleated[32+i] = byte(carry);
+		carry >>= 8;
+	}
+	fail = verifier.VerifyMessage((const byte *)"abc", 3, malleated, sizeof(malleated));
+
+	cout << (fail ? "FAILED    " : "passed    ") << "rejection of non-canonical signatures" << endl;
+	pass = pass && !fail;
+
+	// the verifier buffers a message given before the signature
+	std::auto_ptr<PK_MessageAccumulator> accumulator(verifier.NewVerificationAccumulator());
+	accumulator->Update((const byte *)"ab", 2);
+	verifier.InputSignature(*accumulator, signature, sizeof(signature));
+	accumulator->Update((const byte *)"c", 1);
+	fail = !verifier.VerifyAndRestart(*accumulator);
+	verifier.InputSignature(*accumulator, signature, sizeof(signature));
+	accumulator->Update((const byte *)"abc", 3);
+	fail = !verifier.VerifyAndRestart(*accumulator) || fail;
+
+	// keys are saved in the RFC 8410 formats
+	ByteQueue privateKeyInfo, publicKeyInfo;
+	signer.GetKey().Save(privateKeyInfo);
+	verifier.GetKey().Save(publicKeyInfo);
+	fail = publicKeyInfo.CurrentSize() != 44 || privateKeyInfo.CurrentSize() != 48 || fail;
+	Ed25519::Signer loadedSigner(privateKeyInfo);
+	Ed25519::Verifier loadedVerifier(publicKeyInfo);
+	fail = !loadedVerifier.VerifyMessage((const byte *)"abc", 3, signature, sizeof(signature)) || fail;
+	loadedSigner.SignMessage(GlobalRNG(), (const byte *)"abc", 3, malleated);
+	fail = memcmp(signature, malleated, sizeof(signature)) != 0 || fail;
+
+	cout << (fail ? "FAILED    " : "passed    ") << "message accumulation and key encoding" << endl;
+	pass = pass && !fail;
+
+	pass = SignatureValidate(signer, verifier, true) && pass;
+
+	return pass;
+}
@@ -11,6 +11,7 @@
 #include "md4.h"
 #include "md5.h"
 #include "sha.h"
+#include "sha3.h"
 #include "tiger.h"
 #include "ripemd.h"
 
@@ -69,6 +70,29 @@ bool HashModuleTest(HashTransformation &md, const HashTestTuple *testSet, unsign
 	return pass;
 }
 
+// compare Update() on buffers of various alignments and lengths with updating one byte at a time
+static bool ValidateChecksumUpdate(HashTransformation &md)
+{
+	SecByteBlock data(0x10000+16), digest1(md.DigestSize()), digest2(md.DigestSize());
+	bool pass = true;
+
+	GlobalRNG().GenerateBlock(data, 1024+16);
+	memset(data+1024+16, 0xff, data.size()-1024-16);	// long runs of 0xff put the largest values in the accumulators
+	for (unsigned int offset=0; offset<16; offset++)
+		for (unsigned int length=0; length<=data.size()-16; length+=(length<160 ? 1 : length<1024 ? 97 : 7919))
+		{
+			md.Update(data+offset, length);
+			md.Final(digest1);
+			for (unsigned int i=0; i<length; i++)
+				md.Update(data+offset+i, 1);
+			md.Final(digest2);
+			pass = pass && memcmp(digest1, digest2, md.DigestSize()) == 0;
+		}
+
+	cout << (pass ? "passed" : "FAILED") << "    " << md.AlgorithmName() << " on unaligned data of various lengths\n";
+	return pass;
+}
+
 bool ValidateCRC32()
 {
 	HashTestTuple testSet[] = 
@@ -86,7 +110,29 @@ bool ValidateCRC32()
 	CRC32 crc;
 
 	cout << "\nCRC-32 validation suite running...\n\n";
-	return HashModuleTest(crc, testSet, sizeof(testSet)/sizeof(testSet[0]));
+	bool pass = HashModuleTest(crc, testSet, sizeof(testSet)/sizeof(testSet[0]));
+	return ValidateChecksumUpdate(crc) && pass;
+}
+
+bool ValidateCRC32C()
+{
+	HashTestTuple testSet[] = 
+	{
+		HashTestTuple("", "\x00\x00\x00\x00"),
+		HashTestTuple("a", "\x30\x43\xd0\xc1"),
+		HashTestTuple("abc", "\xb7\x3f\x4b\x36"),
+		HashTestTuple("message digest", "\xd0\x79\xbd\x02"),
+		HashTestTuple("abcdefghijklmnopqrstuvwxyz", "\x25\xef\xe6\x9e"),
+		HashTestTuple("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", "\x7d\xd5\x45\xa2"),
+		HashTestTuple("12345678901234567890123456789012345678901234567890123456789012345678901234567890", "\x81\x67\x7a\x47"),
+		HashTestTuple("123456789", "\x83\x92\x06\xe3")
+	};
+
+	CRC32C crc;
+
+	cout << "\nCRC-32C validation suite running...\n\n";
+	bool pass = HashModuleTest(crc, testSet, sizeof(testSet)/sizeof(testSet[0]));
+	return ValidateChecksumUpdate(crc) && pass;
 }
 
 bool ValidateAdler32()
@@ -105,7 +151,8 @@ bool ValidateAdler32()
 	Adler32 md;
 
 	cout << "\nAdler-32 validation suite running...\n\n";
-	return HashModuleTest(md, testSet, sizeof(testSet)/sizeof(testSet[0]));
+	bool pass = HashModuleTest(md, testSet, sizeof(testSet)/sizeof(testSet[0]));
+	return ValidateChecksumUpdate(md) && pass;
 }
 
 bool ValidateMD2()
@@ -165,10 +212,48 @@ bool ValidateMD5()
 	return HashModuleTest(md5, testSet, sizeof(testSet)/sizeof(testSet[0]));
 }
 
+bool ValidateSHA256MultiBuffer()
+{
+	// messages of all lengths up to a few blocks, so lanes finish and are refilled at different times
+	const unsigned int count = 200;
+	SecByteBlock data(count), digests(count*SHA256::DIGESTSIZE), digest(SHA256::DIGESTSIZE);
+	const byte *messages[count];
+	size_t lengths[count];
+	bool pass = true;
+
+	GlobalRNG().GenerateBlock(data, data.size());
+	for (unsigned int i=0; i<count; i++)
+	{
+		messages[i] = data + i/2;
+		lengths[i] = (i*37) % (count-i/2);
+	}
+
+	// the second pass keeps to the SSE2 lanes on CPUs with the SHA extensions
+	for (int allowSHAExtensions=1; allowSHAExtensions>=0; allowSHAExtensions--)
+	{
+		bool fail = false;
+		for (unsigned int n=0; n<=count; n+=(n<8 ? 1 : 64))
+		{
+			SHA256_MultiBuffer::CalculateDigests(digests, messages, lengths, n, allowSHAExtensions != 0);
+			for (unsigned int i=0; i<n; i++)
+			{
+				SHA256().CalculateDigest(digest, messages[i], lengths[i]);
+				fail = fail || memcmp(digest, digests+i*SHA256::DIGESTSIZE, SHA256::DIGESTSIZE) != 0;
+			}
+		}
+
+		unsigned int lanes = SHA256_MultiBuffer::Lanes(allowSHAExtensions != 0);
+		cout << (fail ? "FAILED" : "passed") << "    SHA-256 multi-buffer with " << lanes << (lanes == 1 ? " lane\n" : " lanes\n");
+		pass = pass && !fail;
+	}
+	return pass;
+}
+
 bool ValidateSHA()
 {
 	cout << "\nSHA validation suite running...\n\n";
-	return RunTestDataFile("TestVectors/sha.txt");
+	bool pass = RunTestDataFile("TestVectors/sha.txt");
+	return ValidateSHA256MultiBuffer() && pass;
 }
 
 bool ValidateSHA2()
@@ -177,6 +262,60 @@ bool ValidateSHA2()
 	return RunTestDataFile("TestVectors/sha.txt");
 }
 
+bool ValidateSHA3MultiBuffer()
+{
+	// lengths just below, at and just above multiples of the rate, where the padding byte moves into its own block,
+	// then random lengths so lanes finish at different times, all at different alignments
+	const unsigned int count = 40, maxLength = 3*144+1;
+	const unsigned int batchSizes[] = {1, 2, 3, 11, count};
+	SecByteBlock data(maxLength+count), digests(count*64), digest(64);
+	const byte *messages[count];
+	size_t lengths[count];
+	bool pass = true;
+
+	GlobalRNG().GenerateBlock(data, data.size());
+	for (unsigned int i=0; i<count; i++)
+		messages[i] = data + i;
+
+	for (unsigned int digestSize=28; digestSize<=64; digestSize+=(digestSize==28 ? 4 : 16))
+	{
+		const unsigned int rate = 200 - 2*digestSize;
+		unsigned int i = 0;
+		lengths[i++] = 0;
+		lengths[i++] = 1;
+		for (unsigned int k=1; k<=3; k++)
+		{
+			lengths[i++] = k*rate-1;
+			lengths[i++] = k*rate;
+			lengths[i++] = k*rate+1;
+		}
+		while (i < count)
+			lengths[i++] = GlobalRNG().GenerateWord32(0, maxLength);
+
+		SHA3_MultiBuffer sha3(digestSize);
+		for (unsigned int b=0; b<sizeof(batchSizes)/sizeof(batchSizes[0]); b++)
+		{
+			const unsigned int n = batchSizes[b];
+			sha3.CalculateDigests(digests, messages, lengths, n);
+			for (i=0; i<n; i++)
+			{
+				SHA3(digestSize).CalculateDigest(digest, messages[i], lengths[i]);
+				pass = pass && memcmp(digest, digests+i*digestSize, digestSize) == 0;
+			}
+		}
+	}
+
+	cout << (pass ? "passed" : "FAILED") << "    SHA-3 multi-buffer with " << SHA3_MultiBuffer::Lanes() << " lanes\n";
+	return pass;
+}
+
+bool ValidateSHA3()
+{
+	cout << "\nSHA-3 validation suite running...\n\n";
+	bool pass = RunTestDataFile("TestVectors/sha3.txt");
+	return ValidateSHA3MultiBuffer() && pass;
+}
+
 bool ValidateTiger()
 {
 	cout << "\nTiger validation suite running...\n\n";
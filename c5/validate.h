@@ -6,15 +6,22 @@
 bool ValidateAll(bool thorough);
 bool TestSettings();
 bool TestOS_RNG();
+bool TestTaskExecutor();
+bool TestIntegerStorage();
+bool TestIntegerMultiply();
+bool TestModularExponentiation();
+bool TestPrimeSearch();
 bool ValidateBaseCode();
 
 bool ValidateCRC32();
+bool ValidateCRC32C();
 bool ValidateAdler32();
 bool ValidateMD2();
 bool ValidateMD4();
 bool ValidateMD5();
 bool ValidateSHA();
 bool ValidateSHA2();
+bool ValidateSHA3();
 bool ValidateTiger();
 bool ValidateRIPEMD();
 bool ValidatePanama();
@@ -74,6 +81,8 @@ bool ValidateECP();
 bool ValidateEC2N();
 bool ValidateECDSA();
 bool ValidateESIGN();
+bool ValidateX25519();
+bool ValidateEd25519();
 
 CryptoPP::RandomNumberGenerator & GlobalRNG();
 bool RunTestDataFile(const char *filename, const CryptoPP::NameValuePairs &overrideParameters=CryptoPP::g_nullNameValuePairs, bool thorough=true);